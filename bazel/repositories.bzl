@@ -14,6 +14,7 @@ WINDOWS_SKIP_TARGETS = [
     "envoy.tracers.datadog",
     "envoy.tracers.opencensus",
     "envoy.watchdog.abort_action",
+    "envoy.network.socket_interface.io_uring",
 ]
 
 # Make all contents of an external repository accessible under a filegroup.  Used for external HTTP
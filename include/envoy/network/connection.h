@@ -11,6 +11,7 @@
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/ssl/connection.h"
+#include "envoy/stats/histogram.h"
 #include "envoy/stream_info/stream_info.h"
 
 namespace Envoy {
@@ -91,6 +92,8 @@ public:
     Stats::Counter* bind_errors_;
     // Optional counter. Delayed close timeouts will not be tracked if this is nullptr.
     Stats::Counter* delayed_close_timeouts_;
+    // Optional histogram of the bytes read each time the connection is read from.
+    Stats::Histogram* read_size_{};
   };
 
   ~Connection() override = default;
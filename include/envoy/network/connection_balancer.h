@@ -27,6 +27,20 @@ public:
    */
   virtual void incNumConnections() PURE;
 
+  /**
+   * @return a relative measure of how loaded the handler is. This may be called from any thread.
+   *         Larger values mean more loaded. Values are only comparable between handlers of the same
+   *         listener, and are only meaningful once enableLoadTracking() has been called.
+   */
+  virtual uint64_t loadScore() const PURE;
+
+  /**
+   * Start sampling the signals used by loadScore(). This is called from the handler's own thread
+   * by balancers that use loadScore(), typically from registerHandler(). Sampling is not free, so
+   * handlers of listeners that do not need it should not do it.
+   */
+  virtual void enableLoadTracking() PURE;
+
   /**
    * Post a connected socket to this connection handler. This is used for cross-thread connection
    * transfer during the balancing process.
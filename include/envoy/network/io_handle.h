@@ -258,6 +258,12 @@ public:
    * Shut down part of a full-duplex connection (see man 2 shutdown)
    */
   virtual Api::SysCallIntResult shutdown(int how) PURE;
+
+  /**
+   * @return the number of bytes which can be read without blocking (see FIONREAD in man 7 tcp), or
+   *         nullopt if it is unknown. This is a hint which may change before the next read.
+   */
+  virtual absl::optional<uint64_t> bytesAvailable() PURE;
 };
 
 using IoHandlePtr = std::unique_ptr<IoHandle>;
@@ -5,6 +5,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/stats/allocator.h"
 #include "envoy/stats/store.h"
 #include "envoy/thread/thread.h"
@@ -99,6 +100,14 @@ public:
    * @return Thread::BasicLockable& a lock for access logs.
    */
   virtual Thread::BasicLockable& accessLogLock() PURE;
+
+  /**
+   * Creates, or attaches to the one of the parent process, a TLS session cache shared with the
+   * other processes taking part in hot restarts. Only the first call has an effect.
+   * @param max_sessions supplies the number of sessions the cache holds at least.
+   * @return the cache, or nullptr if there is none.
+   */
+  virtual Ssl::SessionCache* sslSessionCache(uint32_t max_sessions) PURE;
 };
 
 /**
@@ -13,6 +13,7 @@
 #include "envoy/server/drain_manager.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/guarddog.h"
+#include "envoy/server/worker.h"
 
 #include "common/protobuf/protobuf.h"
 
@@ -190,6 +191,11 @@ public:
    */
   virtual uint64_t numConnections() const PURE;
 
+  /**
+   * @return the placement of each worker thread, indexed by worker. @see Worker::placement().
+   */
+  virtual std::vector<WorkerPlacement> workerPlacements() const PURE;
+
   /**
    * Remove a listener by name.
    * @param name supplies the listener name to remove.
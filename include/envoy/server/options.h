@@ -244,6 +244,16 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return the CPUs to pin worker threads to, in worker order. Empty if workers are not pinned.
+   */
+  virtual const std::vector<uint32_t>& workerCpuAffinity() const PURE;
+
+  /**
+   * @return bool indicating whether worker threads allocate memory on their local NUMA node.
+   */
+  virtual bool numaLocalWorkersEnabled() const PURE;
+
   /**
    * @return the names of extensions to disable.
    */
@@ -1,13 +1,26 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload_manager.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Server {
 
+/**
+ * The CPUs a worker thread runs on and the NUMA node it allocates memory from.
+ */
+struct WorkerPlacement {
+  // The CPUs the thread is restricted to. Empty if the thread is not pinned.
+  std::vector<uint32_t> cpus_;
+  // The NUMA node the thread allocates memory from, if it is NUMA local.
+  absl::optional<uint32_t> numa_node_;
+};
+
 /**
  * Interface for a threaded connection handling worker. All routines are thread safe.
  */
@@ -41,6 +54,13 @@ public:
    */
   virtual uint64_t numConnections() const PURE;
 
+  /**
+   * @return the placement that has been applied to the worker thread. This is empty until the
+   *         thread has started, and stays empty if no placement was configured or it could not be
+   *         applied.
+   */
+  virtual WorkerPlacement placement() const PURE;
+
   /**
    * Start the worker thread.
    * @param guard_dog supplies the guard dog to use for thread watching.
@@ -100,11 +120,12 @@ public:
   virtual ~WorkerFactory() = default;
 
   /**
+   * @param index supplies the index of the worker, starting at 0.
    * @param overload_manager supplies the server's overload manager.
    * @param worker_name supplies the name of the worker, used for per-worker stats.
    * @return WorkerPtr a new worker.
    */
-  virtual WorkerPtr createWorker(OverloadManager& overload_manager,
+  virtual WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager,
                                  const std::string& worker_name) PURE;
 };
 
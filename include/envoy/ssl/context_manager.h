@@ -7,6 +7,7 @@
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
 #include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/stats/scope.h"
 
 namespace Envoy {
@@ -47,6 +48,14 @@ public:
    * context manager.
    */
   virtual PrivateKeyMethodManager& privateKeyMethodManager() PURE;
+
+  /**
+   * Sets the cache which server contexts created from now on store their sessions in, instead of
+   * a cache per context.
+   * @param cache supplies the cache, or nullptr to use a cache per context. It must outlive the
+   *        contexts.
+   */
+  virtual void setSessionCache(SessionCache* cache) PURE;
 };
 
 using ContextManagerPtr = std::unique_ptr<ContextManager>;
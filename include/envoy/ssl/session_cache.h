@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+
+#include "absl/types/span.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * A cache of serialized TLS sessions for session ID based resumption, shared by the server
+ * contexts of a process and possibly by other processes. Implementations must be thread safe.
+ */
+class SessionCache {
+public:
+  virtual ~SessionCache() = default;
+
+  enum class InsertResult {
+    // The session was stored.
+    Inserted,
+    // The session was stored in place of another session which had not expired.
+    Evicted,
+    // The session was not stored, e.g. because it does not fit in the cache.
+    Rejected,
+  };
+
+  /**
+   * Stores a session, replacing any session stored under the same id.
+   * @param id supplies the session id.
+   * @param session supplies the serialized session.
+   * @param expiry supplies the time after which the session can not be resumed.
+   * @param now supplies the current time.
+   * @return whether the session was stored, and whether that evicted another session.
+   */
+  virtual InsertResult insert(absl::Span<const uint8_t> id, absl::Span<const uint8_t> session,
+                              SystemTime expiry, SystemTime now) PURE;
+
+  /**
+   * Copies the session stored under id into session.
+   * @return whether a session which has not expired at now is stored under id.
+   */
+  virtual bool lookup(absl::Span<const uint8_t> id, SystemTime now,
+                      std::vector<uint8_t>& session) PURE;
+
+  /**
+   * Removes the session stored under id, if any.
+   */
+  virtual void remove(absl::Span<const uint8_t> id) PURE;
+};
+
+} // namespace Ssl
+} // namespace Envoy
@@ -3,6 +3,8 @@
 #endif
 
 #include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include <cerrno>
 
@@ -17,5 +19,18 @@ SysCallIntResult LinuxOsSysCallsImpl::sched_getaffinity(pid_t pid, size_t cpuset
   return {rc, errno};
 }
 
+SysCallIntResult LinuxOsSysCallsImpl::sched_setaffinity(pid_t pid, size_t cpusetsize,
+                                                        const cpu_set_t* mask) {
+  const int rc = ::sched_setaffinity(pid, cpusetsize, mask);
+  return {rc, errno};
+}
+
+SysCallIntResult LinuxOsSysCallsImpl::set_mempolicy(int mode, const unsigned long* nodemask,
+                                                    unsigned long maxnode) {
+  // glibc has no wrapper for set_mempolicy, it is provided by libnuma which is not a dependency.
+  const int rc = ::syscall(SYS_set_mempolicy, mode, nodemask, maxnode);
+  return {rc, errno};
+}
+
 } // namespace Api
 } // namespace Envoy
@@ -1,11 +1,16 @@
 #include "common/buffer/buffer_impl.h"
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 
 #include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/common/thread.h"
 
 #include "absl/container/fixed_array.h"
+#include "absl/container/flat_hash_set.h"
 #include "event2/buffer.h"
 
 namespace Envoy {
@@ -563,5 +568,205 @@ std::vector<OwnedSlice::SliceRepresentation> OwnedImpl::describeSlicesForTest()
   return slices;
 }
 
+namespace {
+
+// Storage sizes of the SlicePool size classes: the storage of slices created for up to 4KiB (a page
+// including the slice itself), 16KiB and 64KiB of content. Only storage of exactly these sizes is
+// cached, so a slice never holds more storage than it would get from the allocator.
+constexpr uint64_t PageSize = 4096;
+constexpr uint64_t SizeClasses[] = {PageSize, 16384 + PageSize, 65536 + PageSize};
+constexpr uint32_t NumSizeClasses = sizeof(SizeClasses) / sizeof(SizeClasses[0]);
+constexpr uint32_t NoSizeClass = NumSizeClasses;
+
+uint32_t sizeClass(uint64_t size) {
+  for (uint32_t i = 0; i < NumSizeClasses; i++) {
+    if (size == SizeClasses[i]) {
+      return i;
+    }
+  }
+  return NoSizeClass;
+}
+
+std::atomic<uint64_t> max_cached_bytes{SlicePool::DefaultMaxCachedBytes};
+
+// Counters are only written by the thread owning them, so they need not be incremented atomically,
+// but are atomic so that stats() can read them from other threads.
+void add(std::atomic<uint64_t>& counter, int64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+class ThreadCache;
+
+struct Registry {
+  Thread::MutexBasicLockable mutex_;
+  absl::flat_hash_set<const ThreadCache*> caches_ ABSL_GUARDED_BY(mutex_);
+  // The counts of the threads which have exited.
+  uint64_t exited_hits_ ABSL_GUARDED_BY(mutex_){0};
+  uint64_t exited_misses_ ABSL_GUARDED_BY(mutex_){0};
+};
+
+Registry& registry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Registry); }
+
+class ThreadCache {
+public:
+  ThreadCache() {
+    Registry& r = registry();
+    Thread::LockGuard lock(r.mutex_);
+    r.caches_.insert(this);
+  }
+
+  ~ThreadCache();
+
+  void* allocate(uint64_t size) {
+    const uint32_t size_class = sizeClass(size);
+    if (size_class == NoSizeClass) {
+      return ::operator new(size);
+    }
+    FreeBlock* block = free_lists_[size_class];
+    if (block == nullptr) {
+      add(misses_, 1);
+      return ::operator new(size);
+    }
+    free_lists_[size_class] = block->next_;
+    add(hits_, 1);
+    add(cached_bytes_, -static_cast<int64_t>(SizeClasses[size_class]));
+    return block;
+  }
+
+  void deallocate(void* address, uint64_t size) {
+    const uint32_t size_class = sizeClass(size);
+    if (size_class == NoSizeClass) {
+      ::operator delete(address);
+      return;
+    }
+    if (!enabled_ || cached_bytes_.load(std::memory_order_relaxed) + SizeClasses[size_class] >
+                         max_cached_bytes.load(std::memory_order_relaxed)) {
+      ::operator delete(address);
+      return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(address);
+    block->next_ = free_lists_[size_class];
+    free_lists_[size_class] = block;
+    add(cached_bytes_, SizeClasses[size_class]);
+  }
+
+  void release() {
+    for (FreeBlock*& free_list : free_lists_) {
+      while (free_list != nullptr) {
+        FreeBlock* next = free_list->next_;
+        ::operator delete(free_list);
+        free_list = next;
+      }
+    }
+    cached_bytes_.store(0, std::memory_order_relaxed);
+  }
+
+  void setEnabled(bool enabled) {
+    enabled_ = enabled;
+    if (!enabled) {
+      release();
+    }
+  }
+
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+  uint64_t cachedBytes() const { return cached_bytes_.load(std::memory_order_relaxed); }
+
+  // Passed from the destructor of the slice being freed to its operator delete.
+  uint64_t deallocation_size_{0};
+
+private:
+  // Free storage holds the next free storage of its class.
+  struct FreeBlock {
+    FreeBlock* next_;
+  };
+
+  FreeBlock* free_lists_[NumSizeClasses]{};
+  bool enabled_{true};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> cached_bytes_{0};
+};
+
+// Set once the cache of the thread has been destroyed at thread exit, after which slices destroyed
+// by later thread local destructors go directly to the allocator. Trivially destructible so that it
+// remains usable for the whole thread exit.
+thread_local bool thread_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+  release();
+  thread_cache_destroyed = true;
+  Registry& r = registry();
+  Thread::LockGuard lock(r.mutex_);
+  r.caches_.erase(this);
+  r.exited_hits_ += hits();
+  r.exited_misses_ += misses();
+}
+
+ThreadCache* threadCache() {
+  if (thread_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+} // namespace
+
+void SlicePool::setMaxCachedBytes(uint64_t max_cached_bytes_per_thread) {
+  max_cached_bytes.store(max_cached_bytes_per_thread, std::memory_order_relaxed);
+}
+
+uint64_t SlicePool::maxCachedBytes() { return max_cached_bytes.load(std::memory_order_relaxed); }
+
+void SlicePool::setThreadCacheEnabled(bool enabled) {
+  ThreadCache* cache = threadCache();
+  if (cache != nullptr) {
+    cache->setEnabled(enabled);
+  }
+}
+
+void SlicePool::releaseThreadCache() {
+  ThreadCache* cache = threadCache();
+  if (cache != nullptr) {
+    cache->release();
+  }
+}
+
+SlicePool::Stats SlicePool::stats() {
+  Registry& r = registry();
+  Thread::LockGuard lock(r.mutex_);
+  Stats stats{r.exited_hits_, r.exited_misses_, 0};
+  for (const ThreadCache* cache : r.caches_) {
+    stats.hits_ += cache->hits();
+    stats.misses_ += cache->misses();
+    stats.cached_bytes_ += cache->cachedBytes();
+  }
+  return stats;
+}
+
+void* SlicePool::allocate(uint64_t size) {
+  ThreadCache* cache = threadCache();
+  return cache != nullptr ? cache->allocate(size) : ::operator new(size);
+}
+
+void SlicePool::setDeallocationSize(uint64_t size) {
+  ThreadCache* cache = threadCache();
+  if (cache != nullptr) {
+    cache->deallocation_size_ = size;
+  }
+}
+
+void SlicePool::deallocate(void* address) {
+  ThreadCache* cache = threadCache();
+  if (cache == nullptr || cache->deallocation_size_ == 0) {
+    ::operator delete(address);
+    return;
+  }
+  const uint64_t size = cache->deallocation_size_;
+  cache->deallocation_size_ = 0;
+  cache->deallocate(address, size);
+}
+
 } // namespace Buffer
 } // namespace Envoy
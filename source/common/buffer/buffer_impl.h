@@ -254,6 +254,58 @@ protected:
 
 using SlicePtr = std::unique_ptr<Slice>;
 
+/**
+ * A per thread cache of OwnedSlice storage. The storage of a freed slice whose size is exactly one
+ * of a few size classes is kept on a free list of the freeing thread and reused by the next slice
+ * of that size created on the thread, rather than being returned to the allocator and allocated
+ * again for every read and drain. Slices may be freed on a different thread than the one which created them.
+ * The bytes cached by each thread are capped, and a thread's cache can be disabled, e.g. while the
+ * heap is shrunk under overload.
+ */
+class SlicePool {
+public:
+  static constexpr uint64_t DefaultMaxCachedBytes = 2 * 1024 * 1024;
+
+  struct Stats {
+    // Allocations of a size class served from a free list.
+    uint64_t hits_;
+    // Allocations of a size class which had to be made by the allocator.
+    uint64_t misses_;
+    // Bytes currently held by free lists.
+    uint64_t cached_bytes_;
+  };
+
+  /**
+   * Sets the number of bytes each thread may cache, 0 disabling caching. Threads over the limit
+   * free slices to the allocator until they fall under it.
+   */
+  static void setMaxCachedBytes(uint64_t max_cached_bytes);
+  static uint64_t maxCachedBytes();
+
+  /**
+   * Enables or disables the cache of the calling thread. Disabling it frees the cached storage.
+   */
+  static void setThreadCacheEnabled(bool enabled);
+
+  /**
+   * Frees the storage cached by the calling thread.
+   */
+  static void releaseThreadCache();
+
+  /**
+   * @return the stats summed over every thread, including threads which have exited.
+   */
+  static Stats stats();
+
+private:
+  friend class OwnedSlice;
+
+  static void* allocate(uint64_t size);
+  // Records the size of the slice being destroyed for the deallocate() following its destructor.
+  static void setDeallocationSize(uint64_t size);
+  static void deallocate(void* address);
+};
+
 // OwnedSlice can not be derived from as it has variable sized array as member.
 class OwnedSlice final : public Slice, public InlineStorage {
 public:
@@ -282,9 +334,24 @@ public:
     return slice;
   }
 
+  ~OwnedSlice() override {
+    // Run the drain trackers before recording the size, so that slices they free are not
+    // interleaved between this and the deallocation of this slice.
+    callAndClearDrainTrackers();
+    SlicePool::setDeallocationSize(sizeof(OwnedSlice) + capacity_);
+  }
+
+  // The storage comes from the SlicePool of the thread. The size of the storage being freed is
+  // passed by the destructor, as the slice can not be inspected once destroyed.
+  static void operator delete(void* address) { SlicePool::deallocate(address); }
+
 private:
   OwnedSlice(uint64_t size) : Slice(0, 0, size) { base_ = storage_; }
 
+  static void* operator new(size_t object_size, size_t data_size_bytes) {
+    return SlicePool::allocate(object_size + data_size_bytes);
+  }
+
   bool isMutable() const override { return true; }
 
   /**
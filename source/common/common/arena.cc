@@ -0,0 +1,82 @@
+#include "common/common/arena.h"
+
+#include <algorithm>
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+Arena::Arena(uint64_t initial_size, uint64_t max_size, void* initial_block)
+    : max_size_(max_size), next_block_size_(initial_size) {
+  ASSERT(initial_size > 0);
+  if (initial_block != nullptr) {
+    ASSERT(reinterpret_cast<uintptr_t>(initial_block) % alignof(std::max_align_t) == 0);
+    current_ = static_cast<char*>(initial_block);
+    remaining_ = initial_size;
+    bytes_reserved_ = initial_size;
+    next_block_size_ = initial_size * 2;
+  }
+}
+
+Arena::~Arena() {
+  while (blocks_ != nullptr) {
+    Block* next = blocks_->next_;
+    ::operator delete(blocks_);
+    blocks_ = next;
+  }
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  ASSERT(alignment <= alignof(std::max_align_t));
+
+  if (current_ != nullptr) {
+    const size_t padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+    if (padding + size <= remaining_) {
+      void* memory = current_ + padding;
+      current_ += padding + size;
+      remaining_ -= padding + size;
+      bytes_allocated_ += padding + size;
+      return memory;
+    }
+  }
+
+  // The memory of new blocks is aligned for any type, so no padding is needed.
+  const uint64_t block_size = std::max<uint64_t>(next_block_size_, size);
+  if (bytes_reserved_ + block_size > max_size_) {
+    overflows_++;
+    return nullptr;
+  }
+  Block* block = static_cast<Block*>(::operator new(BlockHeaderSize + block_size));
+  block->next_ = blocks_;
+  blocks_ = block;
+  bytes_reserved_ += block_size;
+  next_block_size_ = std::max(next_block_size_, block_size) * 2;
+  char* memory = reinterpret_cast<char*>(block) + BlockHeaderSize;
+  current_ = memory + size;
+  remaining_ = block_size - size;
+  bytes_allocated_ += size;
+  return memory;
+}
+
+thread_local bool ArenaAllocated::in_arena_handoff_ = false;
+
+void* ArenaAllocated::operator new(size_t size, Arena* arena) {
+  void* memory = arena != nullptr ? arena->allocate(size) : nullptr;
+  in_arena_handoff_ = memory != nullptr;
+  if (memory == nullptr) {
+    memory = ::operator new(size);
+  }
+  return memory;
+}
+
+void ArenaAllocated::operator delete(void* ptr) {
+  // The destructor, or operator new if the constructor threw before this base was constructed,
+  // has just recorded where the memory comes from.
+  if (ptr != nullptr && !in_arena_handoff_) {
+    ::operator delete(ptr);
+  }
+}
+
+} // namespace Envoy
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * A monotonic allocator. Memory is carved out of blocks owned by the arena and is only released,
+ * all at once, when the arena is destroyed. The first block has the initial size, each further
+ * block is twice as large as the previous one. Once the blocks would exceed the size limit,
+ * allocations are refused and callers fall back to the heap.
+ *
+ * The first block may be supplied by the owner of the arena, e.g. as storage inline with the
+ * owner, so that an arena which is not outgrown does not allocate at all.
+ *
+ * The arena does not run destructors. Objects placed in it must be destroyed before the arena,
+ * see ArenaAllocated.
+ */
+class Arena : NonCopyable {
+public:
+  /**
+   * @param initial_size supplies the size of the first block.
+   * @param max_size supplies the maximum number of bytes the blocks may hold in total.
+   * @param initial_block supplies optional storage of initial_size bytes, aligned for any type, to
+   *        be used as the first block. It is not owned by the arena and must outlive it.
+   */
+  Arena(uint64_t initial_size, uint64_t max_size, void* initial_block = nullptr);
+  ~Arena();
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the alignment of the memory, which must be a power of two no larger
+   *        than alignof(std::max_align_t).
+   * @return the memory, or nullptr if the arena has reached its size limit. In that case the
+   *         request is counted as an overflow.
+   */
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * @return the number of bytes handed out by allocate(), including alignment padding. As memory
+   *         is never released before the arena is destroyed, this is the high-water mark.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return the number of bytes held in blocks, including the initial block if supplied.
+   */
+  uint64_t bytesReserved() const { return bytes_reserved_; }
+
+  /**
+   * @return the number of allocations refused because of the size limit.
+   */
+  uint64_t overflows() const { return overflows_; }
+
+private:
+  // Blocks allocated by the arena start with this header, which links them together. It is as
+  // large as the maximum alignment so that the memory following it stays aligned.
+  struct Block {
+    Block* next_;
+  };
+  static constexpr size_t BlockHeaderSize = alignof(std::max_align_t);
+
+  const uint64_t max_size_;
+  Block* blocks_{nullptr};
+  char* current_{nullptr};
+  size_t remaining_{0};
+  uint64_t next_block_size_;
+  uint64_t bytes_allocated_{0};
+  uint64_t bytes_reserved_{0};
+  uint64_t overflows_{0};
+};
+
+/**
+ * Base for classes whose instances may be placed in an Arena with new (arena) T(...), where arena
+ * may be nullptr. Instances are always destroyed with delete, so they can still be owned by a
+ * std::unique_ptr: delete releases instances which were allocated from the heap, either because no
+ * arena was given or because it overflowed, and leaves the others to be released with the arena.
+ *
+ * Where the memory of an instance comes from is recorded in the instance itself, as operator new
+ * and operator delete cannot see it. It is handed from operator new to the constructor, and from
+ * the destructor to operator delete, through a thread local, so the arguments of the constructor
+ * must not create other ArenaAllocated instances. Deriving classes should list this base last, so
+ * that the flag can share padding with their own members.
+ */
+class ArenaAllocated {
+public:
+  ArenaAllocated() : in_arena_(in_arena_handoff_) {}
+  ~ArenaAllocated() { in_arena_handoff_ = in_arena_; }
+
+  static void* operator new(size_t size) { return operator new(size, nullptr); }
+  static void* operator new(size_t size, Arena* arena);
+  static void operator delete(void* ptr);
+  // Called if the constructor of an instance placed with new (arena) T(...) throws.
+  static void operator delete(void* ptr, Arena*) { operator delete(ptr); }
+
+private:
+  static thread_local bool in_arena_handoff_;
+
+  const bool in_arena_;
+};
+
+} // namespace Envoy
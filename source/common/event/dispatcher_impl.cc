@@ -11,7 +11,6 @@
 #include "envoy/network/listener.h"
 
 #include "common/buffer/buffer_impl.h"
-#include "common/common/lock_guard.h"
 #include "common/common/thread.h"
 #include "common/event/file_event_impl.h"
 #include "common/event/libevent_scheduler.h"
@@ -22,6 +21,7 @@
 #include "common/network/dns_impl.h"
 #include "common/network/tcp_listener_impl.h"
 #include "common/network/udp_listener_impl.h"
+#include "common/runtime/runtime_features.h"
 
 #include "event2/event.h"
 
@@ -45,6 +45,12 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Buffer::WatermarkFactory
       post_cb_(base_scheduler_.createSchedulableCallback([this]() -> void { runPostCallbacks(); })),
       current_to_delete_(&to_delete_1_) {
   ASSERT(!name_.empty());
+  // Only read the runtime feature if the runtime loader singleton has already been created, as in
+  // TimerImpl. The main thread dispatcher is created before it, and never uses the timer wheel.
+  if (Runtime::LoaderSingleton::getExisting() &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.dispatcher_timer_wheel")) {
+    timer_wheel_ = std::make_unique<TimerWheel>(*scheduler_, time_system, *this);
+  }
   FatalErrorHandler::registerFatalErrorHandler(*this);
   updateApproximateMonotonicTimeInternal();
   base_scheduler_.registerOnPrepareCallback(
@@ -60,7 +66,8 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
   post([this, &scope, effective_prefix] {
     stats_prefix_ = effective_prefix + "dispatcher";
     stats_ = std::make_unique<DispatcherStats>(
-        DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
+        DispatcherStats{ALL_DISPATCHER_STATS(POOL_GAUGE_PREFIX(scope, stats_prefix_ + "."),
+                                             POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
@@ -161,6 +168,9 @@ Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::fun
 }
 
 TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
+  if (timer_wheel_ != nullptr) {
+    return timer_wheel_->createTimer(cb, *this);
+  }
   return scheduler_->createTimer(cb, *this);
 }
 
@@ -181,14 +191,7 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
-  }
-
-  if (do_post) {
+  if (post_queue_.push(std::move(callback))) {
     post_cb_->scheduleCallbackCurrentIteration();
   }
 }
@@ -215,23 +218,21 @@ void DispatcherImpl::updateApproximateMonotonicTimeInternal() {
 }
 
 void DispatcherImpl::runPostCallbacks() {
-  while (true) {
-    // It is important that this declaration is inside the body of the loop so that the callback is
-    // destructed while post_lock_ is not held. If callback is declared outside the loop and reused
-    // for each iteration, the previous iteration's callback is destructed when callback is
-    // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
-    // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
-    // callstack calls post() on this dispatcher.
-    std::function<void()> callback;
-    {
-      Thread::LockGuard lock(post_lock_);
-      if (post_callbacks_.empty()) {
-        return;
-      }
-      callback = post_callbacks_.front();
-      post_callbacks_.pop_front();
-    }
-    callback();
+  if (stats_) {
+    stats_->post_queue_depth_.set(post_queue_.size());
+  }
+  // Callbacks posted while the batch runs are run by another batch in the current iteration, so
+  // that post() keeps its latency. Callbacks whose post() is still in progress are waited for in the
+  // next iteration rather than by spinning on the event loop.
+  switch (post_queue_.runBatch()) {
+  case PostQueue::BatchResult::Empty:
+    break;
+  case PostQueue::BatchResult::Queued:
+    post_cb_->scheduleCallbackCurrentIteration();
+    break;
+  case PostQueue::BatchResult::PushInProgress:
+    post_cb_->scheduleCallbackNextIteration();
+    break;
   }
 }
 
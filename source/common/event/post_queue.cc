@@ -0,0 +1,155 @@
+#include "common/event/post_queue.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+// Nodes are usually released by the thread draining a queue and allocated by the threads posting
+// to it, so each thread caches a bounded number of nodes and hands its surplus over to the others
+// through a shared stack.
+constexpr uint64_t MaxCachedNodes = 256;
+
+// Set once the cache of the thread has been destroyed at thread exit, after which queues destroyed
+// by later thread local destructors allocate and free their nodes directly. Trivially destructible
+// so that it remains usable for the whole thread exit.
+thread_local bool node_cache_destroyed = false;
+
+template <class Node> struct NodeCache {
+  ~NodeCache() {
+    while (head_ != nullptr) {
+      Node* node = head_;
+      head_ = node->next_.load(std::memory_order_relaxed);
+      delete node;
+    }
+    node_cache_destroyed = true;
+  }
+
+  Node* head_{};
+  uint64_t size_{};
+};
+
+template <class Node> NodeCache<Node>* nodeCache() {
+  if (node_cache_destroyed) {
+    return nullptr;
+  }
+  thread_local NodeCache<Node> cache;
+  return &cache;
+}
+
+template <class Node> std::atomic<Node*>& sharedNodes() {
+  static std::atomic<Node*> nodes{};
+  return nodes;
+}
+
+} // namespace
+
+PostQueue::PostQueue() : head_(allocateNode()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+PostQueue::~PostQueue() {
+  Node* node = tail_;
+  while (node != nullptr) {
+    Node* next = node->next_.load(std::memory_order_acquire);
+    node->callback_ = nullptr;
+    releaseNode(node);
+    node = next;
+  }
+}
+
+bool PostQueue::push(std::function<void()> callback) {
+  Node* node = allocateNode();
+  node->callback_ = std::move(callback);
+  // The count is raised before the node is linked, so that the consumer never lowers it below the
+  // number of linked nodes. The consumer is only woken up by the push which finds the queue empty.
+  const bool was_empty = size_.fetch_add(1, std::memory_order_acq_rel) == 0;
+  Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+  previous->next_.store(node, std::memory_order_release);
+  return was_empty;
+}
+
+PostQueue::BatchResult PostQueue::runBatch() {
+  const uint64_t batch = size_.load(std::memory_order_acquire);
+  uint64_t ran = 0;
+  while (ran < batch) {
+    Node* next = tail_->next_.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      // A producer has been counted but hasn't linked its node yet.
+      break;
+    }
+    releaseNode(tail_);
+    tail_ = next;
+    // The callback is moved out of the node so that it is destroyed, possibly posting again, once
+    // the node is back in the cache.
+    std::function<void()> callback = std::move(next->callback_);
+    next->callback_ = nullptr;
+    ran++;
+    callback();
+  }
+  if (size_.fetch_sub(ran, std::memory_order_acq_rel) == ran) {
+    return BatchResult::Empty;
+  }
+  return tail_->next_.load(std::memory_order_acquire) != nullptr ? BatchResult::Queued
+                                                                 : BatchResult::PushInProgress;
+}
+
+PostQueue::Node* PostQueue::allocateNode() {
+  NodeCache<Node>* cache_ptr = nodeCache<Node>();
+  if (cache_ptr == nullptr) {
+    return new Node();
+  }
+  NodeCache<Node>& cache = *cache_ptr;
+  if (cache.head_ == nullptr) {
+    // Only ever taking the whole shared stack keeps it free of ABA races.
+    Node* node = sharedNodes<Node>().exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+      Node* next = node->next_.load(std::memory_order_relaxed);
+      node->next_.store(cache.head_, std::memory_order_relaxed);
+      cache.head_ = node;
+      cache.size_++;
+      node = next;
+    }
+  }
+  if (cache.head_ == nullptr) {
+    return new Node();
+  }
+  Node* node = cache.head_;
+  cache.head_ = node->next_.load(std::memory_order_relaxed);
+  cache.size_--;
+  node->next_.store(nullptr, std::memory_order_relaxed);
+  return node;
+}
+
+void PostQueue::releaseNode(Node* node) {
+  ASSERT(!node->callback_);
+  NodeCache<Node>* cache_ptr = nodeCache<Node>();
+  if (cache_ptr == nullptr) {
+    delete node;
+    return;
+  }
+  NodeCache<Node>& cache = *cache_ptr;
+  node->next_.store(cache.head_, std::memory_order_relaxed);
+  cache.head_ = node;
+  if (++cache.size_ < MaxCachedNodes) {
+    return;
+  }
+
+  // Hand half of the cache over to the shared stack.
+  Node* first = cache.head_;
+  Node* last = first;
+  for (uint64_t i = 1; i < MaxCachedNodes / 2; i++) {
+    last = last->next_.load(std::memory_order_relaxed);
+  }
+  cache.head_ = last->next_.load(std::memory_order_relaxed);
+  cache.size_ -= MaxCachedNodes / 2;
+  std::atomic<Node*>& shared_nodes = sharedNodes<Node>();
+  Node* shared = shared_nodes.load(std::memory_order_relaxed);
+  do {
+    last->next_.store(shared, std::memory_order_relaxed);
+  } while (!shared_nodes.compare_exchange_weak(shared, first, std::memory_order_release,
+                                               std::memory_order_relaxed));
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Multi-producer, single-consumer queue of the callbacks posted to a dispatcher. Producers never
+ * lock: a callback is linked into the queue with a single atomic exchange (Vyukov's intrusive MPSC
+ * queue), and its node comes from a per-thread cache instead of being allocated for every post.
+ */
+class PostQueue : NonCopyable {
+public:
+  PostQueue();
+  // Pending callbacks are destroyed without being run.
+  ~PostQueue();
+
+  /**
+   * Appends a callback to the queue. Thread safe.
+   * @return whether the queue was empty, in which case the consumer has to be woken up.
+   */
+  bool push(std::function<void()> callback);
+
+  enum class BatchResult {
+    // No callbacks remain queued.
+    Empty,
+    // Callbacks are queued for another batch.
+    Queued,
+    // Only callbacks whose push() has not linked them into the queue yet remain. They can be run
+    // once their producer has been scheduled again.
+    PushInProgress,
+  };
+
+  /**
+   * Runs the callbacks which were queued when it was called, so that callbacks posting more
+   * callbacks can't starve the event loop. May only be called by the consumer.
+   * @return whether callbacks remain, in which case the consumer has to run another batch.
+   */
+  BatchResult runBatch();
+
+  /**
+   * @return the number of queued callbacks. Only a snapshot when producers are active.
+   */
+  uint64_t size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+  struct Node {
+    std::atomic<Node*> next_{};
+    std::function<void()> callback_;
+  };
+
+  static Node* allocateNode();
+  static void releaseNode(Node* node);
+
+  // Producers append after head_. The consumer owns tail_, a node whose callback has already been
+  // taken, so that the queue is never without a node and push() never has to touch tail_.
+  std::atomic<Node*> head_;
+  Node* tail_;
+  // Counts callbacks from the start of their push() until their batch has run.
+  std::atomic<uint64_t> size_{};
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,284 @@
+#include "common/event/timer_wheel.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/common/scope_tracker.h"
+
+namespace Envoy {
+namespace Event {
+
+TimerWheel::TimerWheel(Scheduler& scheduler, TimeSource& time_source, Dispatcher& dispatcher,
+                       std::chrono::milliseconds tick)
+    : scheduler_(scheduler), time_source_(time_source), tick_(tick),
+      start_(time_source.monotonicTime()),
+      driver_(scheduler.createTimer([this]() -> void { onTick(); }, dispatcher)) {
+  ASSERT(tick_.count() > 0);
+  for (Entry& head : inner_) {
+    initList(head);
+  }
+  for (auto& level : outer_) {
+    for (Entry& head : level) {
+      initList(head);
+    }
+  }
+  initList(running_);
+}
+
+TimerWheel::~TimerWheel() = default;
+
+TimerPtr TimerWheel::createTimer(const TimerCb& cb, Dispatcher& dispatcher) {
+  return std::make_unique<WheelTimerImpl>(*this, cb, dispatcher);
+}
+
+void TimerWheel::link(Entry& head, Entry& entry) {
+  entry.prev_ = head.prev_;
+  entry.next_ = &head;
+  head.prev_->next_ = &entry;
+  head.prev_ = &entry;
+}
+
+void TimerWheel::unlink(Entry& entry) {
+  entry.prev_->next_ = entry.next_;
+  entry.next_->prev_ = entry.prev_;
+  entry.prev_ = entry.next_ = nullptr;
+}
+
+uint64_t TimerWheel::nowTick() const { return (time_source_.monotonicTime() - start_) / tick_; }
+
+void TimerWheel::add(WheelTimerImpl& timer, std::chrono::milliseconds duration) {
+  // Clipped like TimerUtils::durationToTimeval(), which keeps the deadline from overflowing.
+  duration = std::min<std::chrono::milliseconds>(duration, std::chrono::seconds(INT32_MAX));
+  const MonotonicTime::duration deadline = time_source_.monotonicTime() - start_ + duration;
+  // Rounded up, so that timers never fire early.
+  timer.expiry_ = (deadline + tick_ - MonotonicTime::duration(1)) / tick_;
+  if (size_ == 0 && !expiring_) {
+    // There is nothing to expire or cascade in the ticks which have passed since the wheel was
+    // last driven.
+    current_ = std::max(current_, nowTick());
+  }
+  insert(timer);
+  size_++;
+  if (!expiring_ && timer.expiry_ < armed_tick_) {
+    arm();
+  }
+}
+
+void TimerWheel::remove(WheelTimerImpl& timer) {
+  unlink(timer);
+  size_--;
+  if (timer.level_ == 0) {
+    if (emptyList(inner_[timer.slot_])) {
+      inner_occupied_[timer.slot_ / 64] &= ~slotBit(timer.slot_);
+    }
+  } else if (emptyList(outer_[timer.level_ - 1][timer.slot_])) {
+    outer_occupied_[timer.level_ - 1] &= ~slotBit(timer.slot_);
+  }
+  // The driver is left armed, as firing for nothing is cheaper than rearming it on every removal.
+}
+
+void TimerWheel::insert(WheelTimerImpl& timer) {
+  const uint64_t expiry = std::max(timer.expiry_, current_);
+  const uint64_t delta = expiry - current_;
+  if (delta < InnerSlots) {
+    const uint64_t index = expiry & (InnerSlots - 1);
+    timer.level_ = 0;
+    timer.slot_ = index;
+    link(inner_[index], timer);
+    inner_occupied_[index / 64] |= slotBit(index);
+    return;
+  }
+
+  uint32_t level = 1;
+  while (level < OuterLevels && (delta >> (InnerBits + level * OuterBits)) != 0) {
+    level++;
+  }
+  // Timers beyond the outermost level wait in the slot of its furthest rotation, and are placed
+  // again when that slot is cascaded.
+  const uint64_t position = current_ + std::min(delta, MaxDelta);
+  const uint64_t index = (position >> (InnerBits + (level - 1) * OuterBits)) & (OuterSlots - 1);
+  timer.level_ = level;
+  timer.slot_ = index;
+  link(outer_[level - 1][index], timer);
+  outer_occupied_[level - 1] |= slotBit(index);
+}
+
+void TimerWheel::cascade(uint32_t level, uint64_t index) {
+  Entry& head = outer_[level - 1][index];
+  outer_occupied_[level - 1] &= ~slotBit(index);
+  while (!emptyList(head)) {
+    WheelTimerImpl& timer = WheelTimerImpl::fromEntry(*head.next_);
+    unlink(timer);
+    insert(timer);
+  }
+}
+
+void TimerWheel::expire(uint64_t index) {
+  Entry& head = inner_[index];
+  if (emptyList(head)) {
+    return;
+  }
+  // The timers are moved to a list of their own, from which they can still be disabled by the
+  // callbacks of the timers expiring before them. No timer can be added to this slot meanwhile, as
+  // it would have to expire a full rotation from now.
+  running_.next_ = head.next_;
+  running_.prev_ = head.prev_;
+  running_.next_->prev_ = &running_;
+  running_.prev_->next_ = &running_;
+  initList(head);
+  inner_occupied_[index / 64] &= ~slotBit(index);
+
+  while (!emptyList(running_)) {
+    WheelTimerImpl& timer = WheelTimerImpl::fromEntry(*running_.next_);
+    unlink(timer);
+    size_--;
+    timer.fire();
+  }
+}
+
+void TimerWheel::onTick() {
+  armed_tick_ = NotArmed;
+  expiring_ = true;
+  const uint64_t now = nowTick();
+  while (size_ > 0 && current_ <= now) {
+    const uint64_t next = nextTick(current_);
+    if (next > now) {
+      current_ = now + 1;
+      break;
+    }
+    current_ = next;
+
+    const uint64_t index = current_ & (InnerSlots - 1);
+    if (index == 0) {
+      // Cascade the outer levels whose rotation starts with this tick, outermost first.
+      for (uint32_t level = OuterLevels; level > 0; level--) {
+        const uint32_t shift = InnerBits + (level - 1) * OuterBits;
+        if ((current_ & ((uint64_t(1) << shift) - 1)) == 0) {
+          cascade(level, (current_ >> shift) & (OuterSlots - 1));
+        }
+      }
+    }
+    expire(index);
+    current_++;
+  }
+  expiring_ = false;
+  arm();
+}
+
+void TimerWheel::arm() {
+  if (size_ == 0) {
+    armed_tick_ = NotArmed;
+    driver_->disableTimer();
+    return;
+  }
+  armed_tick_ = nextTick(current_);
+  const MonotonicTime deadline = start_ + tick_ * static_cast<int64_t>(armed_tick_);
+  const MonotonicTime now = time_source_.monotonicTime();
+  driver_->enableHRTimer(
+      deadline > now ? std::chrono::ceil<std::chrono::microseconds>(deadline - now)
+                     : std::chrono::microseconds(0));
+}
+
+uint64_t TimerWheel::nextTick(uint64_t from) const {
+  ASSERT(size_ > 0);
+  // The innermost level only holds the timers of the next InnerSlots ticks, so those in the slots
+  // before the one of from expire in the next rotation.
+  const uint64_t index = from & (InnerSlots - 1);
+  const uint64_t rotation = from - index;
+  uint64_t next = UINT64_MAX;
+  uint64_t occupied = firstOccupied(index);
+  if (occupied < InnerSlots) {
+    next = rotation + occupied;
+  } else if ((occupied = firstOccupied(0)) < InnerSlots) {
+    next = rotation + InnerSlots + occupied;
+  }
+
+  // Outer slots are cascaded at the start of the rotations they cover, and empty ones are skipped.
+  for (uint32_t level = 1; level <= OuterLevels; level++) {
+    const uint64_t bits = outer_occupied_[level - 1];
+    if (bits == 0) {
+      continue;
+    }
+    const uint32_t shift = InnerBits + (level - 1) * OuterBits;
+    const uint64_t first = (from + (uint64_t(1) << shift) - 1) >> shift;
+    const uint64_t offset = first & (OuterSlots - 1);
+    const uint64_t rotated = offset == 0 ? bits : (bits >> offset) | (bits << (64 - offset));
+    next = std::min(next, (first + __builtin_ctzll(rotated)) << shift);
+  }
+  return next;
+}
+
+uint64_t TimerWheel::firstOccupied(uint64_t index) const {
+  for (uint64_t word = index / 64; word < inner_occupied_.size(); word++) {
+    uint64_t bits = inner_occupied_[word];
+    if (word == index / 64) {
+      bits &= ~uint64_t(0) << (index % 64);
+    }
+    if (bits != 0) {
+      return word * 64 + __builtin_ctzll(bits);
+    }
+  }
+  return InnerSlots;
+}
+
+WheelTimerImpl::WheelTimerImpl(TimerWheel& wheel, const TimerCb& cb, Dispatcher& dispatcher)
+    : wheel_(wheel), cb_(cb), dispatcher_(dispatcher) {
+  ASSERT(cb_);
+}
+
+WheelTimerImpl::~WheelTimerImpl() {
+  if (next_ != nullptr) {
+    wheel_.remove(*this);
+  }
+}
+
+void WheelTimerImpl::disableTimer() {
+  if (next_ != nullptr) {
+    wheel_.remove(*this);
+  }
+  if (precise_ != nullptr) {
+    precise_->disableTimer();
+  }
+}
+
+void WheelTimerImpl::enableTimer(const std::chrono::milliseconds& d,
+                                 const ScopeTrackedObject* object) {
+  disableTimer();
+  object_ = object;
+  if (d.count() > 0) {
+    wheel_.add(*this, d);
+  } else {
+    precise().enableTimer(d);
+  }
+}
+
+void WheelTimerImpl::enableHRTimer(const std::chrono::microseconds& us,
+                                   const ScopeTrackedObject* object) {
+  disableTimer();
+  object_ = object;
+  precise().enableHRTimer(us);
+}
+
+bool WheelTimerImpl::enabled() {
+  return next_ != nullptr || (precise_ != nullptr && precise_->enabled());
+}
+
+void WheelTimerImpl::fire() {
+  if (object_ == nullptr) {
+    cb_();
+    return;
+  }
+  ScopeTrackerScopeState scope(object_, dispatcher_);
+  object_ = nullptr;
+  cb_();
+}
+
+Timer& WheelTimerImpl::precise() {
+  if (precise_ == nullptr) {
+    precise_ = wheel_.scheduler_.createTimer([this]() -> void { fire(); }, dispatcher_);
+  }
+  return *precise_;
+}
+
+} // namespace Event
+} // namespace Envoy
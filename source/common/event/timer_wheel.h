@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+class WheelTimerImpl;
+
+/**
+ * Hierarchical timing wheel (Varghese and Lauck) for coarse-grained timers. Timers enabled with a
+ * millisecond duration are bucketed by the tick they expire in, so that enabling and disabling
+ * them is O(1) however many timers are armed, where libevent's min-heap is O(log n). The whole
+ * wheel is driven by a single timer of the underlying scheduler, armed for the next tick with
+ * timers to expire or to cascade, and timers fire up to one tick late. High resolution and zero
+ * duration timers are delegated to the underlying scheduler.
+ */
+class TimerWheel : public Scheduler, NonCopyable {
+public:
+  TimerWheel(Scheduler& scheduler, TimeSource& time_source, Dispatcher& dispatcher,
+             std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+  ~TimerWheel() override;
+
+  // Scheduler
+  TimerPtr createTimer(const TimerCb& cb, Dispatcher& dispatcher) override;
+
+  /**
+   * @return the number of timers armed on the wheel, excluding those delegated to the underlying
+   *         scheduler.
+   */
+  uint64_t size() const { return size_; }
+
+private:
+  friend class WheelTimerImpl;
+
+  // The innermost level has a slot per tick. Each outer level has a slot per rotation of the
+  // level inside it, which is cascaded into the inner levels when that rotation starts. With 1ms
+  // ticks the levels span 256ms, 16s, 17min, 18h and 49 days; timers further away are parked in
+  // the outermost level until they are close enough.
+  static constexpr uint32_t InnerBits = 8;
+  static constexpr uint32_t OuterBits = 6;
+  static constexpr uint32_t OuterLevels = 4;
+  static constexpr uint64_t InnerSlots = 1 << InnerBits;
+  static constexpr uint64_t OuterSlots = 1 << OuterBits;
+  static_assert(OuterSlots == 64, "outer levels are tracked by a 64 bit bitmap");
+  static constexpr uint64_t MaxDelta = (uint64_t(1) << (InnerBits + OuterLevels * OuterBits)) - 1;
+  static constexpr uint64_t NotArmed = UINT64_MAX;
+
+  // Link of an intrusive circular list. Slots are list heads, and timers are unlinked when next_ is
+  // null.
+  struct Entry {
+    Entry* prev_{};
+    Entry* next_{};
+  };
+
+  void add(WheelTimerImpl& timer, std::chrono::milliseconds duration);
+  void remove(WheelTimerImpl& timer);
+  void insert(WheelTimerImpl& timer);
+  void cascade(uint32_t level, uint64_t index);
+  void expire(uint64_t index);
+  void onTick();
+  void arm();
+  uint64_t nowTick() const;
+  uint64_t nextTick(uint64_t from) const;
+  uint64_t firstOccupied(uint64_t index) const;
+  static uint64_t slotBit(uint64_t index) { return uint64_t(1) << (index % 64); }
+
+  static void initList(Entry& head) { head.prev_ = head.next_ = &head; }
+  static bool emptyList(const Entry& head) { return head.next_ == &head; }
+  static void link(Entry& head, Entry& entry);
+  static void unlink(Entry& entry);
+
+  Scheduler& scheduler_;
+  TimeSource& time_source_;
+  const MonotonicTime::duration tick_;
+  const MonotonicTime start_;
+  TimerPtr driver_;
+  // The next tick to expire.
+  uint64_t current_{};
+  uint64_t armed_tick_{NotArmed};
+  uint64_t size_{};
+  bool expiring_{};
+  std::array<Entry, InnerSlots> inner_;
+  // Bitmaps of the slots with timers.
+  std::array<uint64_t, InnerSlots / 64> inner_occupied_{};
+  std::array<std::array<Entry, OuterSlots>, OuterLevels> outer_;
+  std::array<uint64_t, OuterLevels> outer_occupied_{};
+  // Timers of the tick being expired.
+  Entry running_;
+};
+
+/**
+ * Timer armed on a TimerWheel.
+ */
+class WheelTimerImpl : public Timer, private TimerWheel::Entry {
+public:
+  WheelTimerImpl(TimerWheel& wheel, const TimerCb& cb, Dispatcher& dispatcher);
+  ~WheelTimerImpl() override;
+
+  // Timer
+  void disableTimer() override;
+  void enableTimer(const std::chrono::milliseconds& d, const ScopeTrackedObject* object) override;
+  void enableHRTimer(const std::chrono::microseconds& us,
+                     const ScopeTrackedObject* object) override;
+  bool enabled() override;
+
+private:
+  friend class TimerWheel;
+
+  static WheelTimerImpl& fromEntry(TimerWheel::Entry& entry) {
+    return static_cast<WheelTimerImpl&>(entry);
+  }
+  void fire();
+  Timer& precise();
+
+  TimerWheel& wheel_;
+  TimerCb cb_;
+  Dispatcher& dispatcher_;
+  const ScopeTrackedObject* object_{};
+  // Created on first use for the durations which aren't handled by the wheel.
+  TimerPtr precise_;
+  uint64_t expiry_{};
+  uint8_t level_{};
+  uint8_t slot_{};
+};
+
+} // namespace Event
+} // namespace Envoy
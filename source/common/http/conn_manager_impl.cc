@@ -1,5 +1,6 @@
 #include "common/http/conn_manager_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -125,7 +126,8 @@ void ConnectionManagerImpl::initializeReadFilterCallbacks(Network::ReadFilterCal
   read_callbacks_->connection().setConnectionStats(
       {stats_.named_.downstream_cx_rx_bytes_total_, stats_.named_.downstream_cx_rx_bytes_buffered_,
        stats_.named_.downstream_cx_tx_bytes_total_, stats_.named_.downstream_cx_tx_bytes_buffered_,
-       nullptr, &stats_.named_.downstream_cx_delayed_close_timeout_});
+       nullptr, &stats_.named_.downstream_cx_delayed_close_timeout_,
+       &stats_.named_.downstream_cx_rx_bytes_per_read_});
 }
 
 ConnectionManagerImpl::~ConnectionManagerImpl() {
@@ -208,6 +210,14 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
 
   stream.filter_manager_.destroyFilters();
 
+  if (stream.arena_enabled_) {
+    stats_.named_.downstream_rq_arena_bytes_.recordValue(stream.arena_.bytesAllocated());
+    stats_.named_.downstream_rq_arena_overflow_.add(stream.arena_.overflows());
+    stream_arena_size_ =
+        std::clamp<uint64_t>((stream.arena_.bytesAllocated() + 63) & ~uint64_t(63),
+                             ActiveStream::ArenaMinSize, ActiveStream::ArenaMaxSize);
+  }
+
   read_callbacks_->connection().dispatcher().deferredDelete(stream.removeFromList(streams_));
 
   if (connection_idle_timer_ && streams_.empty()) {
@@ -222,7 +232,8 @@ RequestDecoder& ConnectionManagerImpl::newStream(ResponseEncoder& response_encod
   }
 
   ENVOY_CONN_LOG(debug, "new stream", read_callbacks_->connection());
-  ActiveStreamPtr new_stream(new ActiveStream(*this, response_encoder.getStream().bufferLimit()));
+  ActiveStreamPtr new_stream(
+      ActiveStream::create(*this, response_encoder.getStream().bufferLimit()));
   new_stream->state_.is_internally_created_ = is_internally_created;
   new_stream->response_encoder_ = &response_encoder;
   new_stream->response_encoder_->getStream().addCallbacks(*new_stream);
@@ -536,10 +547,25 @@ void ConnectionManagerImpl::RdsRouteConfigUpdateRequester::requestSrdsUpdate(
                                                    std::move(scoped_route_config_updated_cb));
 }
 
+ConnectionManagerImpl::ActiveStreamPtr
+ConnectionManagerImpl::ActiveStream::create(ConnectionManagerImpl& connection_manager,
+                                            uint32_t buffer_limit) {
+  const uint64_t arena_block_size =
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http_stream_arena")
+          ? connection_manager.stream_arena_size_
+          : 0;
+  return ActiveStreamPtr(new (arena_block_size)
+                             ActiveStream(connection_manager, buffer_limit, arena_block_size));
+}
+
 ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connection_manager,
-                                                  uint32_t buffer_limit)
+                                                  uint32_t buffer_limit,
+                                                  uint64_t arena_block_size)
     : connection_manager_(connection_manager),
       stream_id_(connection_manager.random_generator_.random()),
+      arena_enabled_(arena_block_size > 0),
+      arena_(arena_enabled_ ? arena_block_size : ArenaMinSize, ArenaMaxSize,
+             arena_enabled_ ? arena_block_ : nullptr),
       filter_manager_(*this, connection_manager_.read_callbacks_->connection().dispatcher(),
                       connection_manager_.read_callbacks_->connection(), stream_id_,
                       connection_manager_.config_.proxy100Continue(), buffer_limit,
@@ -547,7 +573,7 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
                       connection_manager_.config_.localReply(),
                       connection_manager_.codec_->protocol(), connection_manager_.timeSource(),
                       connection_manager_.read_callbacks_->connection().streamInfo().filterState(),
-                      StreamInfo::FilterState::LifeSpan::Connection),
+                      StreamInfo::FilterState::LifeSpan::Connection, arena()),
       request_response_timespan_(new Stats::HistogramCompletableTimespanImpl(
           connection_manager_.stats_.named_.downstream_rq_time_,
           connection_manager_.timeSource())) {
@@ -567,14 +593,14 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   if (connection_manager_.config_.isRoutable() &&
       connection_manager.config_.routeConfigProvider() != nullptr) {
-    route_config_update_requester_ =
-        std::make_unique<ConnectionManagerImpl::RdsRouteConfigUpdateRequester>(
-            connection_manager.config_.routeConfigProvider(), *this);
+    route_config_update_requester_.reset(
+        new (arena()) ConnectionManagerImpl::RdsRouteConfigUpdateRequester(
+            connection_manager.config_.routeConfigProvider(), *this));
   } else if (connection_manager_.config_.isRoutable() &&
              connection_manager.config_.scopedRouteConfigProvider() != nullptr) {
-    route_config_update_requester_ =
-        std::make_unique<ConnectionManagerImpl::RdsRouteConfigUpdateRequester>(
-            connection_manager.config_.scopedRouteConfigProvider(), *this);
+    route_config_update_requester_.reset(
+        new (arena()) ConnectionManagerImpl::RdsRouteConfigUpdateRequester(
+            connection_manager.config_.scopedRouteConfigProvider(), *this));
   }
   ScopeTrackerScopeState scope(this,
                                connection_manager_.read_callbacks_->connection().dispatcher());
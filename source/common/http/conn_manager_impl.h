@@ -35,8 +35,10 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/linked_object.h"
+#include "common/common/utility.h"
 #include "common/grpc/common.h"
 #include "common/http/conn_manager_config.h"
 #include "common/http/filter_manager.h"
@@ -113,7 +115,7 @@ public:
 private:
   struct ActiveStream;
 
-  class RdsRouteConfigUpdateRequester {
+  class RdsRouteConfigUpdateRequester : public ArenaAllocated {
   public:
     RdsRouteConfigUpdateRequester(Router::RouteConfigProvider* route_config_provider,
                                   ActiveStream& parent)
@@ -149,13 +151,16 @@ private:
    * or pushes.
    */
   struct ActiveStream : LinkedObject<ActiveStream>,
+                        public InlineStorage,
                         public Event::DeferredDeletable,
                         public StreamCallbacks,
                         public RequestDecoder,
                         public Tracing::Config,
                         public ScopeTrackedObject,
                         public FilterManagerCallbacks {
-    ActiveStream(ConnectionManagerImpl& connection_manager, uint32_t buffer_limit);
+    // Allocates a stream along with the first block of its arena.
+    static std::unique_ptr<ActiveStream> create(ConnectionManagerImpl& connection_manager,
+                                                uint32_t buffer_limit);
     void completeRequest();
 
     void chargeStats(const ResponseHeaderMap& headers);
@@ -337,6 +342,17 @@ private:
     // both locations, then refer to the FM when doing stream logs.
     const uint64_t stream_id_;
 
+    // Per-stream objects, e.g. the filter wrappers, are allocated from this arena when enabled with
+    // the envoy.reloadable_features.http_stream_arena runtime feature. It must outlive all of them.
+    // Its first block is stored inline with the stream, see arena_block_, and is as large as the
+    // arena of the connection's previous stream ended up, which usually fits the whole stream as
+    // streams of a connection share their filter chain.
+    static constexpr uint64_t ArenaMinSize = 256;
+    static constexpr uint64_t ArenaMaxSize = 64 * 1024;
+    Arena* arena() { return arena_enabled_ ? &arena_ : nullptr; }
+    const bool arena_enabled_;
+    Arena arena_;
+
     RequestHeaderMapPtr request_headers_;
     RequestTrailerMapPtr request_trailers_;
 
@@ -366,8 +382,14 @@ private:
     const std::string* decorated_operation_{nullptr};
     std::unique_ptr<RdsRouteConfigUpdateRequester> route_config_update_requester_;
     std::unique_ptr<Tracing::CustomTagMap> tracing_custom_tags_{nullptr};
+    // The first block of arena_, allocated along with the stream by create(). Must be last.
+    alignas(std::max_align_t) char arena_block_[];
 
     friend FilterManager;
+
+  private:
+    ActiveStream(ConnectionManagerImpl& connection_manager, uint32_t buffer_limit,
+                 uint64_t arena_block_size);
   };
 
   using ActiveStreamPtr = std::unique_ptr<ActiveStream>;
@@ -431,6 +453,8 @@ private:
   const Server::OverloadActionState& overload_stop_accepting_requests_ref_;
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
   TimeSource& time_source_;
+  // The size of the first arena block of the next stream.
+  uint64_t stream_arena_size_{ActiveStream::ArenaMinSize};
   bool remote_close_{};
 };
 
@@ -4,6 +4,7 @@
 #include "envoy/http/header_map.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/linked_object.h"
 #include "common/common/logger.h"
@@ -20,7 +21,8 @@ class FilterManager;
  * Base class wrapper for both stream encoder and decoder filters.
  */
 struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
-                                Logger::Loggable<Logger::Id::http> {
+                                Logger::Loggable<Logger::Id::http>,
+                                public ArenaAllocated {
   ActiveStreamFilterBase(FilterManager& parent, bool dual_filter)
       : parent_(parent), iteration_state_(IterationState::Continue),
         iterate_from_current_filter_(false), headers_continued_(false),
@@ -484,12 +486,13 @@ public:
                 uint32_t buffer_limit, FilterChainFactory& filter_chain_factory,
                 const LocalReply::LocalReply& local_reply, Http::Protocol protocol,
                 TimeSource& time_source, StreamInfo::FilterStateSharedPtr parent_filter_state,
-                StreamInfo::FilterState::LifeSpan filter_state_life_span)
+                StreamInfo::FilterState::LifeSpan filter_state_life_span, Arena* arena)
       : filter_manager_callbacks_(filter_manager_callbacks), dispatcher_(dispatcher),
         connection_(connection), stream_id_(stream_id), proxy_100_continue_(proxy_100_continue),
         buffer_limit_(buffer_limit), filter_chain_factory_(filter_chain_factory),
         local_reply_(local_reply),
-        stream_info_(protocol, time_source, parent_filter_state, filter_state_life_span) {}
+        stream_info_(protocol, time_source, parent_filter_state, filter_state_life_span),
+        arena_(arena) {}
   ~FilterManager() override {
     ASSERT(state_.destroyed_);
     ASSERT(state_.filter_call_state_ == 0);
@@ -768,6 +771,9 @@ private:
   FilterChainFactory& filter_chain_factory_;
   const LocalReply::LocalReply& local_reply_;
   StreamInfo::StreamInfoImpl stream_info_;
+  // The arena the filter wrappers are allocated from, owned by the stream. May be nullptr, in which
+  // case they are allocated from the heap.
+  Arena* const arena_;
   // TODO(snowp): Once FM has been moved to its own file we'll make these private classes of FM,
   // at which point they no longer need to be friends.
   friend ActiveStreamFilterBase;
@@ -1,7 +1,7 @@
 #include "common/http/header_map_impl.h"
 
+#include <algorithm>
 #include <cstdint>
-#include <list>
 #include <memory>
 #include <string>
 
@@ -178,6 +178,86 @@ template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString
   return key.get().c_str()[0] == ':';
 }
 
+HeaderMapImpl::HeaderList::~HeaderList() {
+  for (Order* order : {&pseudo_headers_, &headers_}) {
+    for (HeaderEntryImpl* entry : *order) {
+      if (entry != nullptr) {
+        entry->~HeaderEntryImpl();
+      }
+    }
+  }
+}
+
+void* HeaderMapImpl::HeaderList::allocate() {
+  if (free_list_ != nullptr) {
+    void* storage = free_list_;
+    free_list_ = *static_cast<void**>(storage);
+    return storage;
+  }
+  if (block_used_ == block_size_) {
+    block_size_ = block_size_ == 0 ? MinBlockSize : std::min(block_size_ * 2, MaxBlockSize);
+    block_used_ = 0;
+    blocks_.emplace_back(new Storage[block_size_]);
+  }
+  return &blocks_.back()[block_used_++];
+}
+
+void HeaderMapImpl::HeaderList::release(HeaderEntryImpl* entry) {
+  size_--;
+  pseudo_size_ -= entry->pseudo_header_;
+  entry->~HeaderEntryImpl();
+  void* storage = entry;
+  *static_cast<void**>(storage) = free_list_;
+  free_list_ = storage;
+}
+
+void HeaderMapImpl::HeaderList::maybeCompact(Order& order) {
+  // Tombstones at the end can always be dropped.
+  while (!order.empty() && order.back() == nullptr) {
+    order.pop_back();
+  }
+  const size_t live = &order == &pseudo_headers_ ? pseudo_size_ : size_ - pseudo_size_;
+  if (order.size() - live <= std::max(live, MinTombstones)) {
+    return;
+  }
+  uint32_t index = 0;
+  for (HeaderEntryImpl* entry : order) {
+    if (entry != nullptr) {
+      entry->index_ = index;
+      order[index++] = entry;
+    }
+  }
+  order.resize(index);
+}
+
+void HeaderMapImpl::HeaderList::erase(HeaderEntryImpl& entry) {
+  Order& order = entry.pseudo_header_ ? pseudo_headers_ : headers_;
+  ASSERT(order[entry.index_] == &entry);
+  order[entry.index_] = nullptr;
+  release(&entry);
+  maybeCompact(order);
+}
+
+void HeaderMapImpl::HeaderList::clear() {
+  for (Order* order : {&pseudo_headers_, &headers_}) {
+    for (HeaderEntryImpl* entry : *order) {
+      if (entry != nullptr) {
+        entry->~HeaderEntryImpl();
+      }
+    }
+    order->clear();
+  }
+  size_ = 0;
+  pseudo_size_ = 0;
+  // Keep the first block, as a cleared map is usually filled again.
+  if (!blocks_.empty()) {
+    blocks_.resize(1);
+    block_size_ = MinBlockSize;
+  }
+  block_used_ = 0;
+  free_list_ = nullptr;
+}
+
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key) : key_(key) {}
 
 HeaderMapImpl::HeaderEntryImpl::HeaderEntryImpl(const LowerCaseString& key, HeaderString&& value)
@@ -299,15 +379,18 @@ bool HeaderMapImpl::operator==(const HeaderMap& rhs) const {
   rhs_headers.reserve(rhs.size());
   rhs.iterate(collectAllHeaders(&rhs_headers));
 
-  auto i = headers_.begin();
+  bool equal = true;
   auto j = rhs_headers.begin();
-  for (; i != headers_.end(); ++i, ++j) {
-    if (i->key() != j->first || i->value() != j->second) {
-      return false;
+  headers_.iterate([&equal, &j](const HeaderEntryImpl& header) -> HeaderMap::Iterate {
+    if (header.key() != j->first || header.value() != j->second) {
+      equal = false;
+      return HeaderMap::Iterate::Break;
     }
-  }
+    ++j;
+    return HeaderMap::Iterate::Continue;
+  });
 
-  return true;
+  return equal;
 }
 
 bool HeaderMapImpl::operator!=(const HeaderMap& rhs) const { return !operator==(rhs); }
@@ -326,8 +409,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     }
   } else {
     addSize(key.size() + value.size());
-    std::list<HeaderEntryImpl>::iterator i = headers_.insert(std::move(key), std::move(value));
-    i->entry_ = i;
+    headers_.insert(std::move(key), std::move(value));
   }
 }
 
@@ -425,10 +507,11 @@ uint64_t HeaderMapImpl::byteSize() const { return cached_byte_size_; }
 void HeaderMapImpl::verifyByteSizeInternalForTest() const {
   // Computes the total byte size by summing the byte size of the keys and values.
   uint64_t byte_size = 0;
-  for (const HeaderEntryImpl& header : headers_) {
+  headers_.iterate([&byte_size](const HeaderEntryImpl& header) -> HeaderMap::Iterate {
     byte_size += header.key().size();
     byte_size += header.value().size();
-  }
+    return HeaderMap::Iterate::Continue;
+  });
   ASSERT(cached_byte_size_ == byte_size);
 }
 
@@ -452,29 +535,24 @@ HeaderEntry* HeaderMapImpl::getExisting(const LowerCaseString& key) {
   // TODO(mattklein123): The full scan here and in remove() are the biggest issues with this
   // implementation for certain use cases. We can either replace this with a totally different
   // implementation or potentially create a lazy map if the size of the map is above a threshold.
-  for (HeaderEntryImpl& header : headers_) {
+  HeaderEntryImpl* found = nullptr;
+  headers_.iterate([&found, &key](HeaderEntryImpl& header) -> HeaderMap::Iterate {
     if (header.key() == key.get().c_str()) {
-      return &header;
+      found = &header;
+      return HeaderMap::Iterate::Break;
     }
-  }
+    return HeaderMap::Iterate::Continue;
+  });
 
-  return nullptr;
+  return found;
 }
 
 void HeaderMapImpl::iterate(HeaderMap::ConstIterateCb cb) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (cb(header) == HeaderMap::Iterate::Break) {
-      break;
-    }
-  }
+  headers_.iterate([&cb](const HeaderEntryImpl& header) { return cb(header); });
 }
 
 void HeaderMapImpl::iterateReverse(HeaderMap::ConstIterateCb cb) const {
-  for (auto it = headers_.rbegin(); it != headers_.rend(); it++) {
-    if (cb(*it) == HeaderMap::Iterate::Break) {
-      break;
-    }
-  }
+  headers_.iterateReverse([&cb](const HeaderEntryImpl& header) { return cb(header); });
 }
 
 void HeaderMapImpl::clear() {
@@ -543,9 +621,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size());
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key);
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.insert(key);
   return **entry;
 }
 
@@ -558,9 +634,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   }
 
   addSize(key.get().size() + value.size());
-  std::list<HeaderEntryImpl>::iterator i = headers_.insert(key, std::move(value));
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.insert(key, std::move(value));
   return **entry;
 }
 
@@ -570,10 +644,10 @@ size_t HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
   }
 
   HeaderEntryImpl* entry = *ptr_to_entry;
-  const uint64_t size_to_subtract = entry->entry_->key().size() + entry->entry_->value().size();
+  const uint64_t size_to_subtract = entry->key().size() + entry->value().size();
   subtractSize(size_to_subtract);
   *ptr_to_entry = nullptr;
-  headers_.erase(entry->entry_);
+  headers_.erase(*entry);
   return 1;
 }
 
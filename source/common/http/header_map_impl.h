@@ -2,10 +2,11 @@
 
 #include <array>
 #include <cstdint>
-#include <list>
 #include <memory>
+#include <new>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
@@ -13,6 +14,8 @@
 #include "common/common/utility.h"
 #include "common/http/headers.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -112,7 +115,9 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    // The position of the entry in the HeaderList, see HeaderList.
+    uint32_t index_{0};
+    bool pseudo_header_{false};
   };
 
   /**
@@ -171,68 +176,112 @@ protected:
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
    * of the list (as required by nghttp2) and otherwise maintains insertion order.
    *
-   * Note: the internal iterators held in fields make this unsafe to copy and move, since the
-   * reference to end() is not preserved across a move (see Notes in
-   * https://en.cppreference.com/w/cpp/container/list/list). The NonCopyable will suppress both copy
-   * and move constructors/assignment.
+   * Entries are allocated from blocks of several entries owned by the list, and are never moved,
+   * so pointers to them (e.g. the inline headers) stay valid until they are removed. The order is
+   * kept separately in two flat arrays of entry pointers, one for pseudo headers and one for the
+   * other headers, so iteration walks contiguous memory instead of chasing list nodes. A removed
+   * entry leaves a null tombstone in its array, which is compacted once tombstones make up half of
+   * it. The storage of removed entries is reused for new entries.
+   *
+   * Note: entries hold their position in the arrays, which makes this unsafe to copy and move. The
+   * NonCopyable will suppress both copy and move constructors/assignment.
    * TODO(htuch): Maybe we want this to movable one day; for now, our header map moves happen on
    * HeaderMapPtr, so the performance impact should not be evident.
    */
   class HeaderList : NonCopyable {
   public:
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList() = default;
+    ~HeaderList();
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
     }
 
-    template <class Key, class... Value>
-    std::list<HeaderEntryImpl>::iterator insert(Key&& key, Value&&... value) {
+    template <class Key, class... Value> HeaderEntryImpl& insert(Key&& key, Value&&... value) {
       const bool is_pseudo_header = isPseudoHeader(key);
-      std::list<HeaderEntryImpl>::iterator i =
-          headers_.emplace(is_pseudo_header ? pseudo_headers_end_ : headers_.end(),
-                           std::forward<Key>(key), std::forward<Value>(value)...);
-      if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
-        pseudo_headers_end_ = i;
-      }
-      return i;
+      HeaderEntryImpl* entry =
+          new (allocate()) HeaderEntryImpl(std::forward<Key>(key), std::forward<Value>(value)...);
+      Order& order = is_pseudo_header ? pseudo_headers_ : headers_;
+      entry->pseudo_header_ = is_pseudo_header;
+      entry->index_ = order.size();
+      order.push_back(entry);
+      size_++;
+      pseudo_size_ += is_pseudo_header;
+      return *entry;
     }
 
-    std::list<HeaderEntryImpl>::iterator erase(std::list<HeaderEntryImpl>::iterator i) {
-      if (pseudo_headers_end_ == i) {
-        pseudo_headers_end_++;
+    void erase(HeaderEntryImpl& entry);
+
+    template <class UnaryPredicate> void remove_if(UnaryPredicate p) {
+      for (Order* order : {&pseudo_headers_, &headers_}) {
+        for (HeaderEntryImpl*& entry : *order) {
+          if (entry != nullptr && p(*entry)) {
+            release(entry);
+            entry = nullptr;
+          }
+        }
+        maybeCompact(*order);
       }
-      return headers_.erase(i);
     }
 
-    template <class UnaryPredicate> void remove_if(UnaryPredicate p) {
-      headers_.remove_if([&](const HeaderEntryImpl& entry) {
-        const bool to_remove = p(entry);
-        if (to_remove) {
-          if (pseudo_headers_end_ == entry.entry_) {
-            pseudo_headers_end_++;
+    /**
+     * Call the callback for each header in order, until it returns HeaderMap::Iterate::Break.
+     */
+    template <class Callback> void iterate(Callback cb) const {
+      for (const Order* order : {&pseudo_headers_, &headers_}) {
+        for (HeaderEntryImpl* entry : *order) {
+          if (entry != nullptr && cb(*entry) == HeaderMap::Iterate::Break) {
+            return;
           }
         }
-        return to_remove;
-      });
+      }
     }
 
-    std::list<HeaderEntryImpl>::iterator begin() { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::iterator end() { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_iterator begin() const { return headers_.begin(); }
-    std::list<HeaderEntryImpl>::const_iterator end() const { return headers_.end(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rbegin() const { return headers_.rbegin(); }
-    std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
-    size_t size() const { return headers_.size(); }
-    bool empty() const { return headers_.empty(); }
-    void clear() {
-      headers_.clear();
-      pseudo_headers_end_ = headers_.end();
+    /**
+     * Call the callback for each header in reverse order, until it returns
+     * HeaderMap::Iterate::Break.
+     */
+    template <class Callback> void iterateReverse(Callback cb) const {
+      for (const Order* order : {&headers_, &pseudo_headers_}) {
+        for (auto it = order->rbegin(); it != order->rend(); ++it) {
+          if (*it != nullptr && cb(**it) == HeaderMap::Iterate::Break) {
+            return;
+          }
+        }
+      }
     }
 
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
+
   private:
-    std::list<HeaderEntryImpl> headers_;
-    std::list<HeaderEntryImpl>::iterator pseudo_headers_end_;
+    // Sized for the pseudo headers of a request, and for trailers.
+    using Order = absl::InlinedVector<HeaderEntryImpl*, 4>;
+    using Storage = std::aligned_storage_t<sizeof(HeaderEntryImpl), alignof(HeaderEntryImpl)>;
+
+    // The first block holds this many entries, and each further block twice as many as the
+    // previous one, up to MaxBlockSize. The first block is small as every entry is several hundred
+    // bytes and many maps, e.g. trailers, hold only a few headers.
+    static constexpr uint32_t MinBlockSize = 2;
+    static constexpr uint32_t MaxBlockSize = 64;
+    // An order array is not compacted until it has this many tombstones.
+    static constexpr size_t MinTombstones = 8;
+
+    void* allocate();
+    void release(HeaderEntryImpl* entry);
+    void maybeCompact(Order& order);
+
+    Order pseudo_headers_;
+    Order headers_;
+    size_t size_{0};
+    size_t pseudo_size_{0};
+    std::vector<std::unique_ptr<Storage[]>> blocks_;
+    // The number of entries in the last block, and how many of them have been handed out.
+    uint32_t block_size_{0};
+    uint32_t block_used_{0};
+    // Storage of removed entries, linked through their first bytes.
+    void* free_list_{nullptr};
   };
 
   void insertByKey(HeaderString&& key, HeaderString&& value);
@@ -0,0 +1,134 @@
+#include "common/http/http1/header_scanner.h"
+
+#include <array>
+#include <cstdint>
+
+#include "common/common/assert.h"
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(_MSC_VER)
+#define ENVOY_HTTP1_HEADER_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+constexpr std::array<bool, 256> makeInvalidValueChars() {
+  std::array<bool, 256> invalid{};
+  for (size_t c = 0; c < 0x20; c++) {
+    invalid[c] = c != '\t';
+  }
+  invalid[0x7f] = true;
+  return invalid;
+}
+
+constexpr std::array<bool, 256> InvalidValueChars = makeInvalidValueChars();
+
+size_t findScalar(const char* data, size_t begin, size_t size) {
+  for (size_t i = begin; i < size; i++) {
+    if (InvalidValueChars[static_cast<uint8_t>(data[i])]) {
+      return i;
+    }
+  }
+  return absl::string_view::npos;
+}
+
+#ifdef ENVOY_HTTP1_HEADER_SCANNER_X86
+// Only whole 16 or 32 byte blocks are loaded, so that the scan never reads past the end of the
+// value. The remaining bytes are scanned by the narrower implementations.
+
+__attribute__((target("sse4.2"))) size_t findSse42(const char* data, size_t begin, size_t size) {
+  // The invalid characters, as pairs of inclusive bounds.
+  alignas(16) static const char ranges[16] = "\x00\x08\x0a\x1f\x7f\x7f";
+  const __m128i ranges_vector = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+  size_t i = begin;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const int index = _mm_cmpestri(ranges_vector, 6, chars, 16,
+                                   _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+    if (index != 16) {
+      return i + index;
+    }
+  }
+  return findScalar(data, i, size);
+}
+
+__attribute__((target("avx2,sse4.2"))) size_t findAvx2(const char* data, size_t size) {
+  const __m256i minus_one = _mm256_set1_epi8(-1);
+  const __m256i space = _mm256_set1_epi8(0x20);
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i del = _mm256_set1_epi8(0x7f);
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    // Compared as signed chars, the bytes from 0x80 are negative and valid, so the control
+    // characters are the bytes greater than -1 and less than a space.
+    const __m256i control = _mm256_and_si256(_mm256_cmpgt_epi8(chars, minus_one),
+                                             _mm256_cmpgt_epi8(space, chars));
+    const __m256i invalid = _mm256_or_si256(
+        _mm256_andnot_si256(_mm256_cmpeq_epi8(chars, tab), control), _mm256_cmpeq_epi8(chars, del));
+    const uint32_t mask = _mm256_movemask_epi8(invalid);
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return findSse42(data, i, size);
+}
+#endif
+
+} // namespace
+
+size_t HeaderScanner::findInvalidValueChar(absl::string_view value) {
+  return findInvalidValueChar(value, bestImplementation());
+}
+
+size_t HeaderScanner::findInvalidValueChar(absl::string_view value,
+                                           Implementation implementation) {
+  ASSERT(supported(implementation));
+  switch (implementation) {
+  case Implementation::Scalar:
+    return findScalar(value.data(), 0, value.size());
+#ifdef ENVOY_HTTP1_HEADER_SCANNER_X86
+  case Implementation::Sse42:
+    return findSse42(value.data(), 0, value.size());
+  case Implementation::Avx2:
+    return findAvx2(value.data(), value.size());
+#else
+  case Implementation::Sse42:
+  case Implementation::Avx2:
+    break;
+#endif
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+bool HeaderScanner::supported(Implementation implementation) {
+  switch (implementation) {
+  case Implementation::Scalar:
+    return true;
+#ifdef ENVOY_HTTP1_HEADER_SCANNER_X86
+  case Implementation::Sse42:
+    return __builtin_cpu_supports("sse4.2");
+  case Implementation::Avx2:
+    return __builtin_cpu_supports("avx2");
+#else
+  case Implementation::Sse42:
+  case Implementation::Avx2:
+    return false;
+#endif
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+HeaderScanner::Implementation HeaderScanner::bestImplementation() {
+  static const Implementation best = supported(Implementation::Avx2)    ? Implementation::Avx2
+                                     : supported(Implementation::Sse42) ? Implementation::Sse42
+                                                                        : Implementation::Scalar;
+  return best;
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Scans received header values for characters which are not allowed in them, 16 or 32 bytes at a
+ * time with SIMD instructions where the CPU supports them. The characters are the same as those
+ * rejected by Http::HeaderUtility::headerValueIsValid(): the control characters except horizontal
+ * tab, and DEL.
+ */
+class HeaderScanner {
+public:
+  enum class Implementation {
+    // A lookup table, one byte at a time.
+    Scalar,
+    // SSE4.2 PCMPESTRI with character ranges, 16 bytes at a time.
+    Sse42,
+    // AVX2 comparisons, 32 bytes at a time.
+    Avx2,
+  };
+
+  /**
+   * @return whether the header value contains only valid characters.
+   */
+  static bool valueIsValid(absl::string_view value) {
+    return findInvalidValueChar(value) == absl::string_view::npos;
+  }
+
+  /**
+   * @return the position of the first invalid character in the header value, or npos if there is
+   *         none. Uses the best implementation supported by the CPU.
+   */
+  static size_t findInvalidValueChar(absl::string_view value);
+
+  /**
+   * Same as above, with the given implementation, which must be supported.
+   */
+  static size_t findInvalidValueChar(absl::string_view value, Implementation implementation);
+
+  /**
+   * @return whether the CPU supports the implementation.
+   */
+  static bool supported(Implementation implementation);
+
+  /**
+   * @return the best implementation supported by the CPU.
+   */
+  static Implementation bestImplementation();
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
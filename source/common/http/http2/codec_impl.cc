@@ -139,6 +139,7 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
 
 void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_headers,
                                               const HeaderMap& headers) {
+  final_headers.clear();
   final_headers.reserve(headers.size());
   headers.iterate([&final_headers](const HeaderEntry& header) -> HeaderMap::Iterate {
     insertHeader(final_headers, header);
@@ -179,9 +180,9 @@ void ConnectionImpl::StreamImpl::encodeHeadersBase(const std::vector<nghttp2_nv>
 
 void ConnectionImpl::ClientStreamImpl::encodeHeaders(const RequestHeaderMap& headers,
                                                      bool end_stream) {
+  std::vector<nghttp2_nv>& final_headers = parent_.headers_nv_;
   // This must exist outside of the scope of isUpgrade as the underlying memory is
   // needed until encodeHeadersBase has been called.
-  std::vector<nghttp2_nv> final_headers;
   Http::RequestHeaderMapPtr modified_headers;
   if (Http::Utility::isUpgrade(headers)) {
     modified_headers = createHeaderMap<RequestHeaderMapImpl>(headers);
@@ -212,9 +213,9 @@ void ConnectionImpl::ServerStreamImpl::encodeHeaders(const ResponseHeaderMap& he
   // The contract is that client codecs must ensure that :status is present.
   ASSERT(headers.Status() != nullptr);
 
+  std::vector<nghttp2_nv>& final_headers = parent_.headers_nv_;
   // This must exist outside of the scope of isUpgrade as the underlying memory is
   // needed until encodeHeadersBase has been called.
-  std::vector<nghttp2_nv> final_headers;
   Http::ResponseHeaderMapPtr modified_headers;
   if (Http::Utility::isUpgrade(headers)) {
     modified_headers = createHeaderMap<ResponseHeaderMapImpl>(headers);
@@ -367,7 +368,7 @@ void ConnectionImpl::StreamImpl::submitTrailers(const HeaderMap& trailers) {
     return;
   }
 
-  std::vector<nghttp2_nv> final_headers;
+  std::vector<nghttp2_nv>& final_headers = parent_.headers_nv_;
   buildHeaders(final_headers, trailers);
   int rc = nghttp2_submit_trailer(parent_.session_, stream_id_, final_headers.data(),
                                   final_headers.size());
@@ -517,6 +517,13 @@ protected:
   // flag.
   const bool skip_encoding_empty_trailers_;
 
+  // The name/value pairs of the header block being submitted to nghttp2, reused across the HEADERS
+  // frames of all streams of the connection so that its capacity is only allocated once. nghttp2
+  // copies the array when the frame is submitted, so that it is free again once the
+  // nghttp2_submit_*() call returns. Header names and values which are references to static
+  // strings, such as the names of the inline headers, are not copied by nghttp2.
+  std::vector<nghttp2_nv> headers_nv_;
+
 private:
   virtual ConnectionCallbacks& callbacks() PURE;
   virtual Status onBeginHeaders(const nghttp2_frame* frame) PURE;
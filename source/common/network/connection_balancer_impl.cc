@@ -1,5 +1,8 @@
 #include "common/network/connection_balancer_impl.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace Envoy {
 namespace Network {
 
@@ -34,5 +37,65 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+LoadAwareConnectionBalancerImpl::LoadAwareConnectionBalancerImpl(Stats::Scope& scope,
+                                                                 Random::RandomGenerator& random)
+    : scope_(scope.createScope("connection_balance.")),
+      stats_({ALL_LOAD_AWARE_CONNECTION_BALANCER_STATS(POOL_COUNTER(*scope_),
+                                                       POOL_GAUGE(*scope_))}),
+      random_(random) {}
+
+void LoadAwareConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  // This is called on the handler's thread, which is where load tracking has to be started.
+  handler.enableLoadTracking();
+  absl::MutexLock lock(&lock_);
+  handlers_.push_back(&handler);
+}
+
+void LoadAwareConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  handlers_.erase(std::find(handlers_.begin(), handlers_.end(), &handler));
+}
+
+BalancedConnectionHandler&
+LoadAwareConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  BalancedConnectionHandler* target = &current_handler;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    if (handlers_.size() > 1) {
+      // Power of two choices: compare the accepting handler with one random other handler. Staying
+      // on the current handler when the scores are equal avoids a cross-thread post.
+      BalancedConnectionHandler* candidate = handlers_[random_.random() % handlers_.size()];
+      if (candidate != &current_handler &&
+          candidate->loadScore() < current_handler.loadScore()) {
+        target = candidate;
+      }
+    }
+
+    if (++picks_ % ImbalanceSampleInterval == 0) {
+      updateImbalanceStats();
+    }
+  }
+
+  if (target != &current_handler) {
+    stats_.rebalanced_.inc();
+  }
+  target->incNumConnections();
+  return *target;
+}
+
+void LoadAwareConnectionBalancerImpl::updateImbalanceStats() {
+  uint64_t max_score = 0;
+  uint64_t min_score = std::numeric_limits<uint64_t>::max();
+  for (const BalancedConnectionHandler* handler : handlers_) {
+    const uint64_t score = handler->loadScore();
+    max_score = std::max(max_score, score);
+    min_score = std::min(min_score, score);
+  }
+
+  stats_.max_load_score_.set(max_score);
+  stats_.min_load_score_.set(min_score);
+  stats_.load_imbalance_percent_.set(max_score == 0 ? 0 : (max_score - min_score) * 100 / max_score);
+}
+
 } // namespace Network
 } // namespace Envoy
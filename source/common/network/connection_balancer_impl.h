@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+
+#include "envoy/common/random_generator.h"
 #include "envoy/network/connection_balancer.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "absl/synchronization/mutex.h"
 
@@ -27,6 +32,54 @@ private:
   std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
 };
 
+/**
+ * All load aware connection balancer stats. @see stats_macros.h
+ */
+#define ALL_LOAD_AWARE_CONNECTION_BALANCER_STATS(COUNTER, GAUGE)                                   \
+  COUNTER(rebalanced)                                                                              \
+  GAUGE(load_imbalance_percent, NeverImport)                                                       \
+  GAUGE(max_load_score, NeverImport)                                                               \
+  GAUGE(min_load_score, NeverImport)
+
+/**
+ * Struct definition for all load aware connection balancer stats. @see stats_macros.h
+ */
+struct LoadAwareConnectionBalancerStats {
+  ALL_LOAD_AWARE_CONNECTION_BALANCER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Implementation of connection balancer that balances on the load of the handlers' workers rather
+ * than on connection counts. Each accept compares the accepting handler against one other handler
+ * picked at random (power of two choices) using BalancedConnectionHandler::loadScore(), which is
+ * read without locking. The handler list itself is only read under a shared lock, so accepts on
+ * different workers do not serialize. Every 64 picks the scores of all handlers are scanned to
+ * update the imbalance gauges.
+ */
+class LoadAwareConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  LoadAwareConnectionBalancerImpl(Stats::Scope& scope, Random::RandomGenerator& random);
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+  const LoadAwareConnectionBalancerStats& stats() const { return stats_; }
+
+private:
+  static constexpr uint64_t ImbalanceSampleInterval = 64;
+
+  void updateImbalanceStats() ABSL_SHARED_LOCKS_REQUIRED(lock_);
+
+  Stats::ScopePtr scope_;
+  LoadAwareConnectionBalancerStats stats_;
+  Random::RandomGenerator& random_;
+  std::atomic<uint64_t> picks_{};
+  absl::Mutex lock_;
+  std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
@@ -673,6 +673,9 @@ void ConnectionImpl::updateReadBufferStats(uint64_t num_read, uint64_t new_size)
   ConnectionImplUtility::updateBufferStats(num_read, new_size, last_read_buffer_size_,
                                            connection_stats_->read_total_,
                                            connection_stats_->read_current_);
+  if (num_read > 0 && connection_stats_->read_size_ != nullptr) {
+    connection_stats_->read_size_->recordValue(num_read);
+  }
 }
 
 void ConnectionImpl::updateWriteBufferStats(uint64_t num_written, uint64_t new_size) {
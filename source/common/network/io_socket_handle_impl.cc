@@ -492,5 +492,17 @@ Event::FileEventPtr IoSocketHandleImpl::createFileEvent(Event::Dispatcher& dispa
 Api::SysCallIntResult IoSocketHandleImpl::shutdown(int how) {
   return Api::OsSysCallsSingleton::get().shutdown(fd_, how);
 }
+
+absl::optional<uint64_t> IoSocketHandleImpl::bytesAvailable() {
+  // An int on POSIX and a u_long, of the same size, on Windows.
+  int available = 0;
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().ioctl(fd_, FIONREAD, &available);
+  if (result.rc_ != 0 || available < 0) {
+    return absl::nullopt;
+  }
+  return available;
+}
+
 } // namespace Network
 } // namespace Envoy
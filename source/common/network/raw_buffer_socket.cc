@@ -1,5 +1,7 @@
 #include "common/network/raw_buffer_socket.h"
 
+#include <algorithm>
+
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
@@ -18,8 +20,7 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
   uint64_t bytes_read = 0;
   bool end_stream = false;
   do {
-    // 16K read is arbitrary. TODO(mattklein123) PERF: Tune the read size.
-    Api::IoCallUint64Result result = buffer.read(callbacks_->ioHandle(), 16384);
+    Api::IoCallUint64Result result = buffer.read(callbacks_->ioHandle(), read_size_.value());
 
     if (result.ok()) {
       ENVOY_CONN_LOG(trace, "read returns: {}", callbacks_->connection(), result.rc_);
@@ -29,6 +30,7 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
         break;
       }
       bytes_read += result.rc_;
+      read_size_.update(callbacks_->ioHandle(), result.rc_);
       if (callbacks_->shouldDrainReadBuffer()) {
         callbacks_->setReadBufferReady();
         break;
@@ -47,6 +49,30 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
   return {action, bytes_read, end_stream};
 }
 
+void AdaptiveReadSize::update(IoHandle& io_handle, uint64_t bytes_read) {
+  if (bytes_read >= read_size_) {
+    short_reads_ = 0;
+    if (read_size_ == MaxReadSize) {
+      return;
+    }
+    // More data is likely waiting. Size the next read by what the socket has, if it can tell,
+    // rather than growing one step per read.
+    const absl::optional<uint64_t> available = io_handle.bytesAvailable();
+    uint64_t read_size = read_size_ * 2;
+    while (available.has_value() && read_size < available.value() && read_size < MaxReadSize) {
+      read_size *= 2;
+    }
+    read_size_ = std::min(read_size, MaxReadSize);
+  } else if (bytes_read < read_size_ / 2) {
+    if (++short_reads_ == ShortReadsBeforeShrink) {
+      short_reads_ = 0;
+      read_size_ = std::max(read_size_ / 2, MinReadSize);
+    }
+  } else {
+    short_reads_ = 0;
+  }
+}
+
 IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
   PostIoAction action;
   uint64_t bytes_written = 0;
@@ -2,6 +2,7 @@
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/connection.h"
+#include "envoy/network/io_handle.h"
 #include "envoy/network/transport_socket.h"
 
 #include "common/common/logger.h"
@@ -9,8 +10,43 @@
 namespace Envoy {
 namespace Network {
 
+/**
+ * The size of the reads of a connection. It grows while reads fill it, sized by the data the
+ * socket reports as available, and shrinks after a run of reads which use less than half of it, so
+ * that bulk transfers need fewer reads and mostly idle connections do not reserve large slices.
+ */
+class AdaptiveReadSize {
+public:
+  static constexpr uint64_t MinReadSize = 4096;
+  static constexpr uint64_t InitialReadSize = 16384;
+  static constexpr uint64_t MaxReadSize = 65536;
+  // Reads which use less than half of the read size in a row before it is halved.
+  static constexpr uint32_t ShortReadsBeforeShrink = 4;
+
+  uint64_t value() const { return read_size_; }
+
+  /**
+   * Updates the read size after a successful read.
+   * @param io_handle supplies the socket which has been read from.
+   * @param bytes_read supplies the number of bytes returned by the read.
+   */
+  void update(IoHandle& io_handle, uint64_t bytes_read);
+
+private:
+  uint64_t read_size_{InitialReadSize};
+  uint32_t short_reads_{};
+};
+
+/**
+ * Transport socket which reads and writes the connection's data unmodified. The size of each read
+ * adapts to the connection, see AdaptiveReadSize.
+ */
 class RawBufferSocket : public TransportSocket, protected Logger::Loggable<Logger::Id::connection> {
 public:
+  static constexpr uint64_t MinReadSize = AdaptiveReadSize::MinReadSize;
+  static constexpr uint64_t InitialReadSize = AdaptiveReadSize::InitialReadSize;
+  static constexpr uint64_t MaxReadSize = AdaptiveReadSize::MaxReadSize;
+
   // Network::TransportSocket
   void setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) override;
   std::string protocol() const override;
@@ -22,9 +58,12 @@ public:
   IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   Ssl::ConnectionInfoConstSharedPtr ssl() const override { return nullptr; }
 
+  uint64_t readSize() const { return read_size_.value(); }
+
 private:
   TransportSocketCallbacks* callbacks_{};
   bool shutdown_{};
+  AdaptiveReadSize read_size_;
 };
 
 class RawBufferSocketFactory : public TransportSocketFactory {
@@ -0,0 +1,162 @@
+#include "common/network/reuse_port_steering.h"
+
+#include <algorithm>
+
+#include "envoy/common/platform.h"
+
+#include "common/common/assert.h"
+#include "common/common/utility.h"
+
+#ifdef __linux__
+#include <linux/filter.h>
+#include <sched.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+
+#ifndef SO_INCOMING_CPU
+#define SO_INCOMING_CPU 49
+#endif
+
+#ifndef SO_DETACH_REUSEPORT_BPF
+#define SO_DETACH_REUSEPORT_BPF 68
+#endif
+#endif
+
+namespace Envoy {
+namespace Network {
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+static_assert(sizeof(ReusePortCpuSteering::Instruction) == sizeof(sock_filter),
+              "Instruction must have the layout of sock_filter");
+
+bool ReusePortCpuSteering::supported() { return true; }
+
+absl::optional<uint32_t> ReusePortCpuSteering::currentThreadCpu() {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  // A pid of zero is the calling thread.
+  const Api::SysCallIntResult result =
+      Api::LinuxOsSysCallsSingleton::get().sched_getaffinity(0, sizeof(cpu_set_t), &mask);
+  if (result.rc_ == -1 || CPU_COUNT(&mask) != 1) {
+    return absl::nullopt;
+  }
+  for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &mask)) {
+      return cpu;
+    }
+  }
+  return absl::nullopt;
+}
+
+std::vector<ReusePortCpuSteering::Instruction> ReusePortCpuSteering::program() const {
+  std::vector<Instruction> program;
+  // A = the CPU that is processing the connection.
+  program.push_back(
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)});
+  for (uint32_t index = 0; index < members_.size(); ++index) {
+    if (members_[index].cpu_.has_value()) {
+      // if (A == cpu) return index;
+      program.push_back({BPF_JMP | BPF_JEQ | BPF_K, 0, 1, members_[index].cpu_.value()});
+      program.push_back({BPF_RET | BPF_K, 0, 0, index});
+    }
+  }
+  // return A % group size;
+  const uint32_t group_size = std::max<size_t>(members_.size(), 1);
+  program.push_back({BPF_ALU | BPF_MOD | BPF_K, 0, 0, group_size});
+  program.push_back({BPF_RET | BPF_A, 0, 0, 0});
+  return program;
+}
+
+bool ReusePortCpuSteering::addSocket(Socket& socket, absl::optional<uint32_t> cpu) {
+  if (cpu.has_value()) {
+    const int incoming_cpu = cpu.value();
+    const Api::SysCallIntResult result =
+        socket.setSocketOption(SOL_SOCKET, SO_INCOMING_CPU, &incoming_cpu, sizeof(incoming_cpu));
+    if (result.rc_ != 0) {
+      ENVOY_LOG(debug, "failed to set SO_INCOMING_CPU of {}: {}", socket.localAddress()->asString(),
+                errorDetails(result.errno_));
+    }
+  }
+  members_.push_back({&socket, cpu});
+  if (!enabled_) {
+    // Another process may have attached a program which does not know about this socket.
+    detach(socket);
+    return false;
+  }
+  return attach();
+}
+
+bool ReusePortCpuSteering::removeSocket(const Socket& socket) {
+  ASSERT(!socket.isOpen());
+  auto it = std::find_if(members_.begin(), members_.end(),
+                         [&socket](const Member& member) { return member.socket_ == &socket; });
+  if (it == members_.end()) {
+    return false;
+  }
+  // The kernel moves the last socket of the group into the position of the removed one.
+  *it = members_.back();
+  members_.pop_back();
+  return enabled_ && !members_.empty() && attach();
+}
+
+void ReusePortCpuSteering::disable() {
+  if (!enabled_) {
+    return;
+  }
+  enabled_ = false;
+  if (!members_.empty()) {
+    detach(*members_.front().socket_);
+  }
+}
+
+bool ReusePortCpuSteering::attach() {
+  Socket& socket = *members_.back().socket_;
+  std::vector<Instruction> instructions = program();
+  sock_fprog prog;
+  prog.len = instructions.size();
+  prog.filter = reinterpret_cast<sock_filter*>(instructions.data());
+  // The program belongs to the group, so attaching it through any member replaces it for all.
+  const Api::SysCallIntResult result =
+      socket.setSocketOption(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "failed to attach SO_REUSEPORT steering program to {}: {}",
+              socket.localAddress()->asString(), errorDetails(result.errno_));
+    return false;
+  }
+  ENVOY_LOG(debug, "attached SO_REUSEPORT steering program for {} sockets to {}", members_.size(),
+            socket.localAddress()->asString());
+  return true;
+}
+
+void ReusePortCpuSteering::detach(Socket& socket) {
+  // Fails with ENOENT if no program is attached, which is fine.
+  const int unused = 0;
+  socket.setSocketOption(SOL_SOCKET, SO_DETACH_REUSEPORT_BPF, &unused, sizeof(unused));
+}
+#else
+bool ReusePortCpuSteering::supported() { return false; }
+
+absl::optional<uint32_t> ReusePortCpuSteering::currentThreadCpu() { return absl::nullopt; }
+
+std::vector<ReusePortCpuSteering::Instruction> ReusePortCpuSteering::program() const { return {}; }
+
+bool ReusePortCpuSteering::addSocket(Socket& socket, absl::optional<uint32_t> cpu) {
+  members_.push_back({&socket, cpu});
+  return false;
+}
+
+bool ReusePortCpuSteering::removeSocket(const Socket& socket) {
+  auto it = std::find_if(members_.begin(), members_.end(),
+                         [&socket](const Member& member) { return member.socket_ == &socket; });
+  if (it != members_.end()) {
+    *it = members_.back();
+    members_.pop_back();
+  }
+  return false;
+}
+
+void ReusePortCpuSteering::disable() { enabled_ = false; }
+#endif
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/network/socket.h"
+
+#include "common/common/logger.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Steers the connections of a SO_REUSEPORT group to the socket whose worker runs on the CPU that
+ * received the connection. This keeps a connection on the CPU whose RSS queue it arrived on
+ * when workers are pinned one per CPU.
+ *
+ * The CPU of a pinned worker is set as the SO_INCOMING_CPU of its socket, which kernels that
+ * support it for SO_REUSEPORT groups use to select the socket themselves. In addition, a classic
+ * BPF program is attached to the group with SO_ATTACH_REUSEPORT_CBPF. It returns the index of the
+ * socket to use. Sockets used by a worker pinned to a single CPU are selected when that CPU
+ * receives the connection. Other CPUs are mapped to cpu % group size, so that each CPU still
+ * consistently uses one socket.
+ *
+ * The kernel appends a socket to the group when it joins, i.e. when listen() is called for TCP and
+ * bind() for UDP, and moves the last socket into the position of a socket that is closed. The
+ * sockets are tracked in the same way, and the program is rebuilt and re-attached whenever a socket
+ * is added or removed. This requires the group to consist only of the sockets added here. If it
+ * may have other members, e.g. the sockets of a hot restart parent, steering must be disabled and
+ * is left to SO_INCOMING_CPU.
+ *
+ * This class is not thread safe. Sockets must be added in the order they join the group and
+ * removed after they have been closed.
+ */
+class ReusePortCpuSteering : Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * One instruction of a classic BPF program, laid out as struct sock_filter.
+   */
+  struct Instruction {
+    uint16_t code;
+    uint8_t jt;
+    uint8_t jf;
+    uint32_t k;
+  };
+
+  /**
+   * @return whether steering programs can be attached on this platform.
+   */
+  static bool supported();
+
+  /**
+   * @return the CPU the calling thread is pinned to, if it is allowed to run on exactly one CPU.
+   */
+  static absl::optional<uint32_t> currentThreadCpu();
+
+  /**
+   * Record that a socket joined the group and re-attach the steering program to the group. If
+   * steering is disabled, the program attached to the group, if any, is detached instead.
+   * @param socket supplies the socket that joined the group.
+   * @param cpu supplies the CPU of the worker using the socket, if the worker is pinned to one.
+   * @return whether the program was attached. If not, the kernel selects the socket itself.
+   */
+  bool addSocket(Socket& socket, absl::optional<uint32_t> cpu);
+
+  /**
+   * Record that a socket left the group and re-attach the steering program to the remaining
+   * sockets.
+   * @param socket supplies the socket, which must already be closed.
+   * @return whether the program was attached.
+   */
+  bool removeSocket(const Socket& socket);
+
+  /**
+   * Stop attaching steering programs and detach the program attached to the group, if any.
+   */
+  void disable();
+
+  /**
+   * @return whether steering programs are attached to the group.
+   */
+  bool enabled() const { return enabled_; }
+
+  /**
+   * @return the steering program for the current members of the group.
+   */
+  std::vector<Instruction> program() const;
+
+private:
+  struct Member {
+    Socket* socket_;
+    // The CPU of the worker using the socket.
+    absl::optional<uint32_t> cpu_;
+  };
+
+  bool attach();
+  void detach(Socket& socket);
+
+  // The sockets of the group, in group order.
+  std::vector<Member> members_;
+  bool enabled_{true};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -1109,7 +1109,14 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
     hedge_policy_ = virtual_host.hedge_policy();
   }
 
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.indexed_route_matching")) {
+    route_index_ = std::make_unique<RouteIndex>();
+  }
+
   for (const auto& route : virtual_host.routes()) {
+    if (route_index_ != nullptr) {
+      addToRouteIndex(routes_.size(), route.match());
+    }
     switch (route.match().path_specifier_case()) {
     case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix: {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context, validator));
@@ -1144,6 +1151,10 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
     }
   }
 
+  if (route_index_ != nullptr) {
+    route_index_->compile();
+  }
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(
         VirtualClusterEntry(virtual_cluster, stat_name_pool_, *vcluster_scope_));
@@ -1154,6 +1165,27 @@ VirtualHostImpl::VirtualHostImpl(const envoy::config::route::v3::VirtualHost& vi
   }
 }
 
+void VirtualHostImpl::addToRouteIndex(uint32_t route,
+                                      const envoy::config::route::v3::RouteMatch& match) {
+  const bool case_sensitive = PROTOBUF_GET_WRAPPED_OR_DEFAULT(match, case_sensitive, true);
+  switch (match.path_specifier_case()) {
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+    route_index_->addPrefix(route, match.prefix(), case_sensitive);
+    break;
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+    route_index_->addPath(route, match.path(), case_sensitive);
+    break;
+  case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex:
+    route_index_->addRegex(route, match.safe_regex().regex());
+    break;
+  default:
+    // CONNECT matchers and std::regex, whose syntax RE2 doesn't share, are evaluated for every
+    // request.
+    route_index_->addUnindexed(route);
+    break;
+  }
+}
+
 VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
     const envoy::config::route::v3::VirtualCluster& virtual_cluster, Stats::StatNamePool& pool,
     Stats::Scope& scope)
@@ -1271,36 +1303,64 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (auto route = routes_.begin(); route != routes_.end(); ++route) {
-    if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
-      continue;
+  // Check for a route that matches the request. Routes which are not candidates of the index can't
+  // match, so evaluating only the candidates, in order, finds the same route as evaluating all
+  // routes.
+  if (route_index_ == nullptr) {
+    for (uint32_t index = 0; index < routes_.size(); index++) {
+      absl::optional<RouteConstSharedPtr> result =
+          evaluateRoute(cb, index, headers, stream_info, random_value);
+      if (result.has_value()) {
+        return result.value();
+      }
     }
+    return nullptr;
+  }
 
-    RouteConstSharedPtr route_entry = (*route)->matches(headers, stream_info, random_value);
-    if (nullptr == route_entry) {
-      continue;
+  RouteIndex::Candidates candidates;
+  route_index_->candidates(headers.getPathValue(), candidates);
+  for (const uint32_t index : candidates) {
+    absl::optional<RouteConstSharedPtr> result =
+        evaluateRoute(cb, index, headers, stream_info, random_value);
+    if (result.has_value()) {
+      return result.value();
     }
+  }
+  return nullptr;
+}
 
-    if (cb) {
-      RouteEvalStatus eval_status = (std::next(route) == routes_.end())
-                                        ? RouteEvalStatus::NoMoreRoutes
-                                        : RouteEvalStatus::HasMoreRoutes;
-      RouteMatchStatus match_status = cb(route_entry, eval_status);
-      if (match_status == RouteMatchStatus::Accept) {
-        return route_entry;
-      }
-      if (match_status == RouteMatchStatus::Continue &&
-          eval_status == RouteEvalStatus::NoMoreRoutes) {
-        return nullptr;
-      }
-      continue;
+absl::optional<RouteConstSharedPtr>
+VirtualHostImpl::evaluateRoute(const RouteCallback& cb, uint32_t index,
+                               const Http::RequestHeaderMap& headers,
+                               const StreamInfo::StreamInfo& stream_info,
+                               uint64_t random_value) const {
+  const RouteEntryImplBaseConstSharedPtr& route = routes_[index];
+  if (!headers.Path() && !route->supportsPathlessHeaders()) {
+    return absl::nullopt;
+  }
+
+  RouteConstSharedPtr route_entry = route->matches(headers, stream_info, random_value);
+  if (nullptr == route_entry) {
+    return absl::nullopt;
+  }
+
+  if (cb) {
+    // The status is relative to all routes of the virtual host, so the callback sees the same
+    // statuses whether or not the routes are indexed.
+    RouteEvalStatus eval_status = (index + 1 == routes_.size()) ? RouteEvalStatus::NoMoreRoutes
+                                                                : RouteEvalStatus::HasMoreRoutes;
+    RouteMatchStatus match_status = cb(route_entry, eval_status);
+    if (match_status == RouteMatchStatus::Accept) {
+      return route_entry;
     }
-
-    return route_entry;
+    if (match_status == RouteMatchStatus::Continue &&
+        eval_status == RouteEvalStatus::NoMoreRoutes) {
+      return RouteConstSharedPtr{};
+    }
+    return absl::nullopt;
   }
 
-  return nullptr;
+  return route_entry;
 }
 
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMap& headers) const {
@@ -27,6 +27,7 @@
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/route_index.h"
 #include "common/router/router_ratelimit.h"
 #include "common/router/tls_context_match_criteria_impl.h"
 #include "common/stats/symbol_table_impl.h"
@@ -192,6 +193,14 @@ public:
 private:
   enum class SslRequirements { None, ExternalOnly, All };
 
+  void addToRouteIndex(uint32_t route, const envoy::config::route::v3::RouteMatch& match);
+  // Evaluate the route at the index. Returns the result of the route lookup, which may be null, if
+  // evaluation stops at this route, or nullopt if it continues with the next route.
+  absl::optional<RouteConstSharedPtr> evaluateRoute(const RouteCallback& cb, uint32_t index,
+                                                    const Http::RequestHeaderMap& headers,
+                                                    const StreamInfo::StreamInfo& stream_info,
+                                                    uint64_t random_value) const;
+
   struct VirtualClusterBase : public VirtualCluster {
   public:
     VirtualClusterBase(Stats::StatName stat_name, Stats::ScopePtr&& scope)
@@ -225,6 +234,8 @@ private:
   const Stats::StatName stat_name_;
   Stats::ScopePtr vcluster_scope_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Narrows down the routes evaluated for a request. Null if indexed route matching is disabled.
+  std::unique_ptr<RouteIndex> route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -0,0 +1,153 @@
+#include "common/router/route_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "common/common/assert.h"
+#include "common/http/path_utility.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+RouteIndex::Node& RouteIndex::Trie::insert(absl::string_view key, bool case_sensitive) {
+  uint32_t current = 0;
+  for (char c : key) {
+    if (!case_sensitive) {
+      c = absl::ascii_tolower(c);
+    }
+    auto& children = nodes_[current].children_;
+    auto it = std::lower_bound(
+        children.begin(), children.end(), c,
+        [](const std::pair<char, uint32_t>& child, char c) { return child.first < c; });
+    if (it != children.end() && it->first == c) {
+      current = it->second;
+      continue;
+    }
+    const uint32_t next = nodes_.size();
+    children.insert(it, {c, next});
+    // This may reallocate nodes_, so children must not be used afterwards.
+    nodes_.emplace_back();
+    current = next;
+  }
+  return nodes_[current];
+}
+
+void RouteIndex::Trie::find(absl::string_view path, bool case_sensitive,
+                            Candidates& candidates) const {
+  const Node* current = &nodes_[0];
+  for (char c : path) {
+    candidates.insert(candidates.end(), current->prefix_routes_.begin(),
+                      current->prefix_routes_.end());
+    if (!case_sensitive) {
+      c = absl::ascii_tolower(c);
+    }
+    const auto& children = current->children_;
+    auto it = std::lower_bound(
+        children.begin(), children.end(), c,
+        [](const std::pair<char, uint32_t>& child, char c) { return child.first < c; });
+    if (it == children.end() || it->first != c) {
+      return;
+    }
+    current = &nodes_[it->second];
+  }
+  // The whole path was consumed, so both the prefixes equal to the path and the exact path match.
+  candidates.insert(candidates.end(), current->prefix_routes_.begin(),
+                    current->prefix_routes_.end());
+  candidates.insert(candidates.end(), current->path_routes_.begin(), current->path_routes_.end());
+}
+
+RouteIndex::RouteIndex() = default;
+
+void RouteIndex::addPrefix(uint32_t route, absl::string_view prefix, bool case_sensitive) {
+  ASSERT(!compiled_ && route >= last_route_);
+  last_route_ = route;
+  Trie& trie = case_sensitive ? case_sensitive_ : case_insensitive_;
+  trie.insert(prefix, case_sensitive).prefix_routes_.push_back(route);
+}
+
+void RouteIndex::addPath(uint32_t route, absl::string_view path, bool case_sensitive) {
+  ASSERT(!compiled_ && route >= last_route_);
+  last_route_ = route;
+  Trie& trie = case_sensitive ? case_sensitive_ : case_insensitive_;
+  trie.insert(path, case_sensitive).path_routes_.push_back(route);
+}
+
+void RouteIndex::addRegex(uint32_t route, const std::string& regex) {
+  ASSERT(!compiled_ && route >= last_route_);
+  last_route_ = route;
+  regexes_.push_back(regex);
+  regex_routes_.push_back(route);
+}
+
+void RouteIndex::addUnindexed(uint32_t route) {
+  ASSERT(!compiled_ && route >= last_route_);
+  last_route_ = route;
+  unindexed_routes_.push_back(route);
+}
+
+void RouteIndex::compile() {
+  ASSERT(!compiled_);
+  compiled_ = true;
+  if (regexes_.empty()) {
+    return;
+  }
+
+  re2::RE2::Options options;
+  options.set_log_errors(false);
+  // Regex routes match the whole path, see RegexRouteEntryImpl.
+  auto regex_set = std::make_unique<re2::RE2::Set>(options, re2::RE2::ANCHOR_BOTH);
+  bool ok = true;
+  for (const std::string& regex : regexes_) {
+    // Each regex was already compiled on its own by its route, but the set may still reject it,
+    // e.g. if it exceeds the memory budget of the set.
+    if (regex_set->Add(regex, nullptr) < 0) {
+      ok = false;
+      break;
+    }
+  }
+  if (ok && regex_set->Compile()) {
+    regex_set_ = std::move(regex_set);
+  } else {
+    // Fall back to evaluating every regex route.
+    std::vector<uint32_t> unindexed;
+    std::merge(unindexed_routes_.begin(), unindexed_routes_.end(), regex_routes_.begin(),
+               regex_routes_.end(), std::back_inserter(unindexed));
+    unindexed_routes_ = std::move(unindexed);
+    regex_routes_.clear();
+  }
+  regexes_.clear();
+}
+
+void RouteIndex::candidates(absl::string_view path, Candidates& candidates) const {
+  ASSERT(compiled_);
+  candidates.insert(candidates.end(), unindexed_routes_.begin(), unindexed_routes_.end());
+
+  // Path matchers ignore the query string and fragment, see Matchers::PathMatcher.
+  const absl::string_view path_only = Http::PathUtil::removeQueryAndFragment(path);
+  case_sensitive_.find(path_only, true, candidates);
+  if (!case_insensitive_.empty()) {
+    case_insensitive_.find(path_only, false, candidates);
+  }
+
+  if (regex_set_ != nullptr) {
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    if (regex_set_->Match(path_only, &matches, &error_info)) {
+      for (const int match : matches) {
+        candidates.push_back(regex_routes_[match]);
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // The DFA ran out of memory. Evaluate every regex route rather than miss a match.
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  // Each route is indexed once, so the candidates are unique and only need to be put back into
+  // configuration order.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * An index over the routes of a virtual host, compiled when the route configuration is loaded.
+ * Given a request path it returns the routes whose path matcher may match, in configuration order,
+ * so that only those have to be evaluated to find the first matching route:
+ * - exact and prefix paths are looked up in a trie, one for case sensitive and one for case
+ *   insensitive matchers.
+ * - safe regexes are matched at once with an RE2::Set.
+ * - all other routes, e.g. CONNECT routes and routes using std::regex, are always candidates.
+ * The index only narrows down the routes by their path. Candidates must still be fully matched,
+ * including their header, query parameter, runtime and TLS context conditions.
+ */
+class RouteIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 16>;
+
+  RouteIndex();
+
+  /**
+   * Add a route matching paths starting with the prefix.
+   * @param route supplies the position of the route in the virtual host. Routes must be added in
+   *        increasing position.
+   */
+  void addPrefix(uint32_t route, absl::string_view prefix, bool case_sensitive);
+
+  /**
+   * Add a route matching the exact path.
+   */
+  void addPath(uint32_t route, absl::string_view path, bool case_sensitive);
+
+  /**
+   * Add a route matching the whole path with an RE2 regex.
+   */
+  void addRegex(uint32_t route, const std::string& regex);
+
+  /**
+   * Add a route which can't be indexed, and is a candidate for every request.
+   */
+  void addUnindexed(uint32_t route);
+
+  /**
+   * Compile the index. Must be called once after all routes are added and before candidates().
+   */
+  void compile();
+
+  /**
+   * Find the routes which may match a request.
+   * @param path supplies the path of the request, including the query string.
+   * @param candidates receives the positions of the routes, in increasing order.
+   */
+  void candidates(absl::string_view path, Candidates& candidates) const;
+
+private:
+  /**
+   * A trie node. Children are kept sorted by their character, and nodes are stored in a single
+   * vector so the trie stays compact for large route tables.
+   */
+  struct Node {
+    std::vector<std::pair<char, uint32_t>> children_;
+    std::vector<uint32_t> prefix_routes_;
+    std::vector<uint32_t> path_routes_;
+  };
+
+  class Trie {
+  public:
+    Trie() : nodes_(1) {}
+    Node& insert(absl::string_view key, bool case_sensitive);
+    void find(absl::string_view path, bool case_sensitive, Candidates& candidates) const;
+    bool empty() const {
+      return nodes_.size() == 1 && nodes_[0].prefix_routes_.empty() &&
+             nodes_[0].path_routes_.empty();
+    }
+
+  private:
+    std::vector<Node> nodes_;
+  };
+
+  Trie case_sensitive_;
+  Trie case_insensitive_;
+  std::vector<std::string> regexes_;
+  std::vector<uint32_t> regex_routes_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  std::vector<uint32_t> unindexed_routes_;
+  uint32_t last_route_{0};
+  bool compiled_{false};
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -75,6 +75,7 @@ constexpr const char* runtime_features[] = {
     "envoy.reloadable_features.http_default_alpn",
     "envoy.reloadable_features.http_transport_failure_reason_in_body",
     "envoy.reloadable_features.http2_skip_encoding_empty_trailers",
+    "envoy.reloadable_features.indexed_route_matching",
     "envoy.reloadable_features.listener_in_place_filterchain_update",
     "envoy.reloadable_features.overload_manager_disable_keepalive_drain_http2",
     "envoy.reloadable_features.preserve_query_string_in_path_redirects",
@@ -94,6 +95,10 @@ constexpr const char* runtime_features[] = {
 // When features are added here, there should be a tracking bug assigned to the
 // code owner to flip the default after sufficient testing.
 constexpr const char* disabled_runtime_features[] = {
+    // Per-dispatcher hierarchical timer wheel for millisecond timers.
+    "envoy.reloadable_features.dispatcher_timer_wheel",
+    // Per-stream arena for the objects of an HTTP stream.
+    "envoy.reloadable_features.http_stream_arena",
     // TODO(asraa) flip this feature after codec errors are handled
     "envoy.reloadable_features.new_codec_behavior",
     // TODO(alyssawilk) flip true after the release.
@@ -35,7 +35,13 @@ WasmAccessLogFactory::createAccessLogInstance(const Protobuf::Message& proto_con
       envoy::config::core::v3::TrafficDirection::UNSPECIFIED, context.localInfo(),
       nullptr /* listener_metadata */);
 
-  auto callback = [access_log, &context, plugin](Common::Wasm::WasmHandleSharedPtr base_wasm) {
+  // The access log owns the creation of its base Wasm, which it cancels if it goes away first.
+  auto callback = [weak_access_log = std::weak_ptr<WasmAccessLog>(access_log), &context,
+                   plugin](Common::Wasm::WasmHandleSharedPtr base_wasm) {
+    auto access_log = weak_access_log.lock();
+    if (!access_log) {
+      return;
+    }
     auto tls_slot = context.threadLocal().allocateSlot();
 
     // NB: the Slot set() call doesn't complete inline, so all arguments must outlive this call.
@@ -57,13 +63,16 @@ WasmAccessLogFactory::createAccessLogInstance(const Protobuf::Message& proto_con
     access_log->setTlsSlot(std::move(tls_slot));
   };
 
+  Common::Wasm::CreateWasmHandlePtr create_wasm_handle;
   if (!Common::Wasm::createWasm(
           config.config().vm_config(), plugin, context.scope().createScope(""),
           context.clusterManager(), context.initManager(), context.dispatcher(), context.random(),
-          context.api(), context.lifecycleNotifier(), remote_data_provider_, std::move(callback))) {
+          context.api(), context.lifecycleNotifier(), remote_data_provider_, create_wasm_handle,
+          std::move(callback))) {
     throw Common::Wasm::WasmException(
         fmt::format("Unable to create Wasm access log {}", plugin->name_));
   }
+  access_log->setCreateWasmHandle(std::move(create_wasm_handle));
 
   return access_log;
 }
@@ -30,7 +30,8 @@ public:
       }
     }
 
-    if (tls_slot_->get()) {
+    // The slot is set once the VM is created, which may be in the background.
+    if (tls_slot_ && tls_slot_->get()) {
       tls_slot_->getTyped<WasmHandle>().wasm()->log(root_id_, request_headers, response_headers,
                                                     response_trailers, stream_info);
     }
@@ -41,10 +42,15 @@ public:
     tls_slot_ = std::move(tls_slot);
   }
 
+  void setCreateWasmHandle(Common::Wasm::CreateWasmHandlePtr create_wasm_handle) {
+    create_wasm_handle_ = std::move(create_wasm_handle);
+  }
+
 private:
   std::string root_id_;
   ThreadLocal::SlotPtr tls_slot_;
   AccessLog::FilterPtr filter_;
+  Common::Wasm::CreateWasmHandlePtr create_wasm_handle_;
 };
 
 } // namespace Wasm
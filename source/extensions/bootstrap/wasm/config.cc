@@ -18,6 +18,7 @@ static const std::string INLINE_STRING = "<inline>";
 
 void WasmFactory::createWasm(const envoy::extensions::wasm::v3::WasmService& config,
                              Server::Configuration::ServerFactoryContext& context,
+                             Common::Wasm::CreateWasmHandlePtr& create_wasm_handle,
                              CreateWasmServiceCallback&& cb) {
   auto plugin = std::make_shared<Common::Wasm::Plugin>(
       config.config().name(), config.config().root_id(), config.config().vm_config().vm_id(),
@@ -54,7 +55,8 @@ void WasmFactory::createWasm(const envoy::extensions::wasm::v3::WasmService& con
   if (!Common::Wasm::createWasm(
           config.config().vm_config(), plugin, context.scope().createScope(""),
           context.clusterManager(), context.initManager(), context.dispatcher(), context.random(),
-          context.api(), context.lifecycleNotifier(), remote_data_provider_, std::move(callback))) {
+          context.api(), context.lifecycleNotifier(), remote_data_provider_, create_wasm_handle,
+          std::move(callback))) {
     // NB: throw if we get a synchronous configuration failures as this is how such failures are
     // reported to xDS.
     throw Common::Wasm::WasmException(
@@ -70,7 +72,7 @@ WasmFactory::createBootstrapExtension(const Protobuf::Message& config,
           config, context.messageValidationContext().staticValidationVisitor());
 
   auto wasm_service_extension = std::make_unique<WasmServiceExtension>();
-  createWasm(typed_config, context,
+  createWasm(typed_config, context, wasm_service_extension->create_wasm_handle_,
              [extension = wasm_service_extension.get()](WasmServicePtr wasm) {
                extension->wasm_service_ = std::move(wasm);
              });
@@ -36,6 +36,7 @@ public:
   std::string name() const override { return "envoy.bootstrap.wasm"; }
   void createWasm(const envoy::extensions::wasm::v3::WasmService& config,
                   Server::Configuration::ServerFactoryContext& context,
+                  Common::Wasm::CreateWasmHandlePtr& create_wasm_handle,
                   CreateWasmServiceCallback&& cb);
   Server::BootstrapExtensionPtr
   createBootstrapExtension(const Protobuf::Message& config,
@@ -57,6 +58,7 @@ public:
 
 private:
   WasmServicePtr wasm_service_;
+  Common::Wasm::CreateWasmHandlePtr create_wasm_handle_;
   friend class WasmFactory;
 };
 
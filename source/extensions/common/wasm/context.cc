@@ -5,6 +5,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/extensions/wasm/v3/wasm.pb.validate.h"
@@ -25,12 +26,14 @@
 #include "common/http/utility.h"
 #include "common/tracing/http_tracer_impl.h"
 
+#include "extensions/common/wasm/shared_data.h"
 #include "extensions/common/wasm/wasm.h"
 #include "extensions/common/wasm/well_known_names.h"
 #include "extensions/filters/common/expr/context.h"
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
@@ -54,6 +57,15 @@ namespace {
 
 using HashPolicy = envoy::config::route::v3::RouteAction::HashPolicy;
 
+// Serialized integers passed to and from the VM may be unaligned.
+uint32_t readUint32(const char* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+void writeUint32(char* p, uint32_t value) { memcpy(p, &value, sizeof(value)); }
+
 Http::RequestTrailerMapPtr buildRequestTrailerMapFromPairs(const Pairs& pairs) {
   auto map = Http::RequestTrailerMapImpl::create();
   for (auto& p : pairs) {
@@ -111,6 +123,58 @@ WasmResult Buffer::copyTo(WasmBase* wasm, size_t start, size_t length, uint64_t
   return proxy_wasm::BufferBase::copyTo(wasm, start, length, ptr_ptr, size_ptr);
 }
 
+WasmResult Buffer::getSliceSizes(char* buffer, size_t buffer_size, size_t* result_size) const {
+  if (const_buffer_instance_) {
+    const auto slices = const_buffer_instance_->getRawSlices();
+    *result_size = (1 + slices.size()) * sizeof(uint32_t);
+    if (*result_size > buffer_size) {
+      return WasmResult::ResultMismatch;
+    }
+    writeUint32(buffer, slices.size());
+    for (size_t i = 0; i < slices.size(); i++) {
+      writeUint32(buffer + (1 + i) * sizeof(uint32_t), slices[i].len_);
+    }
+    return WasmResult::Ok;
+  }
+  // Data not backed by a Buffer::Instance is contiguous.
+  const uint32_t n = data_.empty() ? 0 : 1;
+  *result_size = (1 + n) * sizeof(uint32_t);
+  if (*result_size > buffer_size) {
+    return WasmResult::ResultMismatch;
+  }
+  writeUint32(buffer, n);
+  if (n) {
+    writeUint32(buffer + sizeof(uint32_t), data_.size());
+  }
+  return WasmResult::Ok;
+}
+
+size_t Buffer::copyOut(size_t start, size_t length, char* dest) const {
+  const size_t buffer_size = size();
+  if (start >= buffer_size) {
+    return 0;
+  }
+  length = std::min(length, buffer_size - start);
+  if (const_buffer_instance_) {
+    const_buffer_instance_->copyOut(start, length, dest);
+  } else {
+    memcpy(dest, data_.data() + start, length);
+  }
+  return length;
+}
+
+absl::InlinedVector<absl::string_view, 16> Buffer::slices() const {
+  absl::InlinedVector<absl::string_view, 16> result;
+  if (const_buffer_instance_) {
+    for (const auto& slice : const_buffer_instance_->getRawSlices()) {
+      result.emplace_back(static_cast<const char*>(slice.mem_), slice.len_);
+    }
+  } else if (!data_.empty()) {
+    result.push_back(data_);
+  }
+  return result;
+}
+
 WasmResult Buffer::copyFrom(size_t start, size_t length, absl::string_view data) {
   if (buffer_instance_) {
     if (start == 0) {
@@ -137,6 +201,74 @@ WasmResult Buffer::copyFrom(size_t start, size_t length, absl::string_view data)
   return proxy_wasm::BufferBase::copyFrom(start, length, data);
 }
 
+// Host side state for Context::onStatsDeltaUpdate(): the ids assigned to metrics and the values
+// last sent to the plugin. A reference to each metric is held so that its id can not be reused
+// by a different metric allocated at the same address. Once that reference is the only one left,
+// the metric has been deleted and its id is released.
+struct StatsDeltaState {
+  // Deleted metrics are found within this many flushes.
+  static constexpr size_t SweepFlushes = 16;
+  static constexpr size_t MinSweepBatch = 64;
+
+  template <class Metric> class MetricIds {
+  public:
+    struct Entry {
+      Stats::RefcountPtr<Metric> metric_;
+      uint32_t id_;
+      uint64_t value_;
+    };
+
+    // @return the entry of the metric and whether it was added.
+    std::pair<Entry*, bool> findOrAdd(const Metric& metric, uint32_t& next_id) {
+      auto it = index_.try_emplace(&metric, entries_.size());
+      if (it.second) {
+        entries_.push_back(
+            {Stats::RefcountPtr<Metric>(const_cast<Metric*>(&metric)), next_id++, 0});
+      }
+      return {&entries_[it.first->second], it.second};
+    }
+
+    // Checks the next batch of entries for deleted metrics, releasing them and passing their ids to
+    // on_removed, so that no flush has to visit every metric.
+    template <class OnRemoved> void sweep(OnRemoved on_removed) {
+      size_t count =
+          std::min(entries_.size(), std::max(MinSweepBatch, entries_.size() / SweepFlushes));
+      for (; count > 0 && !entries_.empty(); --count) {
+        if (cursor_ >= entries_.size()) {
+          cursor_ = 0;
+        }
+        Entry& entry = entries_[cursor_];
+        if (entry.metric_->use_count() != 1) {
+          cursor_++;
+          continue;
+        }
+        on_removed(entry.id_);
+        index_.erase(entry.metric_.get());
+        if (cursor_ != entries_.size() - 1) {
+          entry = std::move(entries_.back());
+          index_[entry.metric_.get()] = cursor_;
+        }
+        entries_.pop_back();
+      }
+    }
+
+  private:
+    absl::flat_hash_map<const Metric*, uint32_t> index_;
+    std::vector<Entry> entries_;
+    size_t cursor_{0};
+  };
+
+  MetricIds<Stats::Counter> counters_;
+  MetricIds<Stats::Gauge> gauges_;
+  uint32_t next_id_{0};
+  // Per block buffers, reused across flushes.
+  std::string names_;
+  std::string counter_deltas_;
+  std::string gauge_deltas_;
+  std::string removed_;
+  std::string buffer_;
+};
+
 Context::Context() = default;
 Context::Context(Wasm* wasm) : ContextBase(wasm) {}
 Context::Context(Wasm* wasm, const PluginSharedPtr& plugin) : ContextBase(wasm, plugin) {
@@ -148,6 +280,37 @@ Context::Context(Wasm* wasm, uint32_t root_context_id, const PluginSharedPtr& pl
 Wasm* Context::wasm() const { return static_cast<Wasm*>(wasm_); }
 Plugin* Context::plugin() const { return static_cast<Plugin*>(plugin_.get()); }
 Context* Context::rootContext() const { return static_cast<Context*>(root_context()); }
+
+VmPluginStats* Context::vmPluginStats() {
+  if (!vm_plugin_stats_ && wasm() && plugin_) {
+    auto root = rootContext();
+    vm_plugin_stats_ = root && root != this
+                           ? root->vmPluginStats()
+                           : &getEnvoyWasmIntegration(*wasm()->wasm_vm()).pluginStats(plugin_->name_);
+  }
+  return vm_plugin_stats_;
+}
+
+VmCallTimer::VmCallTimer(Context& context, VmCallback callback)
+    : context_(context), stats_(context.vmPluginStats()), callback_(callback) {
+  context_.invalidateCallbackProperties();
+  if (stats_) {
+    start_ = context_.wasm()->dispatcher().timeSource().monotonicTime();
+  }
+}
+
+VmCallTimer::~VmCallTimer() {
+  context_.invalidateCallbackProperties();
+  if (!stats_) {
+    return;
+  }
+  auto wasm = context_.wasm();
+  auto& integration = getEnvoyWasmIntegration(*wasm->wasm_vm());
+  integration.recordCallback(*stats_, callback_,
+                             std::chrono::duration_cast<std::chrono::microseconds>(
+                                 wasm->dispatcher().timeSource().monotonicTime() - start_));
+  integration.recordMemorySize(wasm->wasm_vm()->getMemorySize());
+}
 Upstream::ClusterManager& Context::clusterManager() const { return wasm()->clusterManager(); }
 
 void Context::error(absl::string_view message) { ENVOY_LOG(trace, message); }
@@ -163,8 +326,14 @@ void Context::onCloseTCP() {
     return;
   }
   tcp_connection_closed_ = true;
-  onDone();
-  onLog();
+  {
+    VmCallTimer timer(*this, VmCallback::OnDone);
+    onDone();
+  }
+  {
+    VmCallTimer timer(*this, VmCallback::OnLog);
+    onLog();
+  }
   onDelete();
 }
 
@@ -306,6 +475,137 @@ void Context::onStatsUpdate(Envoy::Stats::MetricSnapshot& snapshot) {
   wasm()->on_stats_update_(this, id_, counter_block_size + gauge_block_size);
 }
 
+namespace {
+
+// Block types in the buffer passed to envoy_on_stats_update. See StatType in
+// ext/envoy_proxy_wasm_api.h.
+enum class StatBlockType : uint32_t {
+  Counter = 1,
+  Gauge = 2,
+  Name = 3,
+  CounterDelta = 4,
+  GaugeDelta = 5,
+  Removed = 6,
+};
+
+// Writes a block of the stats update buffer: [block size][type][count] followed by the entries.
+// Blocks are padded to 8 bytes so that 8 byte values are aligned whatever the block order.
+class StatBlockWriter {
+public:
+  StatBlockWriter(std::string& out, StatBlockType type) : out_(out) {
+    out_.clear();
+    appendUint32(0);
+    appendUint32(static_cast<uint32_t>(type));
+    appendUint32(0);
+  }
+
+  void appendUint32(uint32_t value) {
+    out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void appendUint64(uint64_t value) {
+    out_.resize(align<uint64_t>(out_.size()), '\0');
+    out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  void appendString(absl::string_view value) {
+    appendUint32(value.size());
+    out_.append(value.data(), value.size());
+  }
+  void endEntry() { count_++; }
+
+  // Returns the number of entries written.
+  uint32_t finish() {
+    out_.resize(align<uint64_t>(out_.size()), '\0');
+    writeUint32(&out_[0], out_.size());
+    writeUint32(&out_[2 * sizeof(uint32_t)], count_);
+    return count_;
+  }
+
+private:
+  std::string& out_;
+  uint32_t count_{0};
+};
+
+} // namespace
+
+void Context::onStatsDeltaUpdate(Envoy::Stats::MetricSnapshot& snapshot) {
+  proxy_wasm::DeferAfterCallActions actions(this);
+  if (wasm()->isFailed() || !wasm()->on_stats_update_) {
+    return;
+  }
+  // The first flush sends every used metric. Later flushes only look at counters which changed.
+  const bool first_flush = !stats_delta_state_;
+  if (first_flush) {
+    stats_delta_state_ = std::make_unique<StatsDeltaState>();
+  }
+  auto& state = *stats_delta_state_;
+
+  StatBlockWriter names(state.names_, StatBlockType::Name);
+  StatBlockWriter counter_deltas(state.counter_deltas_, StatBlockType::CounterDelta);
+  StatBlockWriter gauge_deltas(state.gauge_deltas_, StatBlockType::GaugeDelta);
+  StatBlockWriter removed(state.removed_, StatBlockType::Removed);
+
+  for (const auto& counter_snapshot : snapshot.counters()) {
+    const auto& counter = counter_snapshot.counter_.get();
+    if (!counter.used() || (counter_snapshot.delta_ == 0 && !first_flush)) {
+      continue;
+    }
+    auto found = state.counters_.findOrAdd(counter, state.next_id_);
+    auto* entry = found.first;
+    const bool added = found.second;
+    if (added) {
+      names.appendUint32(entry->id_);
+      names.appendString(counter.name());
+      names.endEntry();
+    }
+    counter_deltas.appendUint32(entry->id_);
+    counter_deltas.appendUint64(counter.value());
+    counter_deltas.appendUint64(counter_snapshot.delta_);
+    counter_deltas.endEntry();
+  }
+
+  for (const auto& gauge_ref : snapshot.gauges()) {
+    const auto& gauge = gauge_ref.get();
+    if (!gauge.used()) {
+      continue;
+    }
+    auto found = state.gauges_.findOrAdd(gauge, state.next_id_);
+    auto* entry = found.first;
+    const bool added = found.second;
+    if (added) {
+      names.appendUint32(entry->id_);
+      names.appendString(gauge.name());
+      names.endEntry();
+    }
+    const uint64_t value = gauge.value();
+    if (added || value != entry->value_) {
+      entry->value_ = value;
+      gauge_deltas.appendUint32(entry->id_);
+      gauge_deltas.appendUint64(value);
+      gauge_deltas.endEntry();
+    }
+  }
+
+  auto remove = [&removed](uint32_t id) {
+    removed.appendUint32(id);
+    removed.endEntry();
+  };
+  state.counters_.sweep(remove);
+  state.gauges_.sweep(remove);
+
+  const uint32_t changes =
+      names.finish() + counter_deltas.finish() + gauge_deltas.finish() + removed.finish();
+  if (changes == 0) {
+    return;
+  }
+  state.buffer_.clear();
+  for (const auto* block :
+       {&state.names_, &state.counter_deltas_, &state.gauge_deltas_, &state.removed_}) {
+    state.buffer_.append(*block);
+  }
+  buffer_.set(state.buffer_);
+  wasm()->on_stats_update_(this, id_, state.buffer_.size());
+}
+
 // Native serializer carrying over bit representation from CEL value to the extension.
 // This implementation assumes that the value type is static and known to the consumer.
 WasmResult serializeValue(Filters::Common::Expr::CelValue value, std::string* result) {
@@ -416,15 +716,77 @@ enum class PropertyToken { PROPERTY_TOKENS(_DECLARE) };
 static absl::flat_hash_map<std::string, PropertyToken> property_tokens = {PROPERTY_TOKENS(_PAIR)};
 #undef _PAIR
 
+namespace {
+
+absl::optional<PropertyToken> findPropertyToken(absl::string_view name) {
+  auto part_token = property_tokens.find(name);
+  if (part_token == property_tokens.end()) {
+    return absl::nullopt;
+  }
+  return part_token->second;
+}
+
+PropertyLifetime propertyLifetime(PropertyToken token) {
+  switch (token) {
+  case PropertyToken::NODE:
+  case PropertyToken::LISTENER_DIRECTION:
+  case PropertyToken::LISTENER_METADATA:
+  case PropertyToken::PLUGIN_NAME:
+  case PropertyToken::PLUGIN_ROOT_ID:
+  case PropertyToken::PLUGIN_VM_ID:
+    return PropertyLifetime::Context;
+  case PropertyToken::SOURCE:
+  case PropertyToken::DESTINATION:
+  case PropertyToken::CONNECTION:
+  case PropertyToken::CONNECTION_ID:
+    return PropertyLifetime::Stream;
+  case PropertyToken::REQUEST:
+  case PropertyToken::RESPONSE:
+    return PropertyLifetime::Callback;
+  default:
+    return PropertyLifetime::Call;
+  }
+}
+
+// Splits a '\0' separated property path into its parts.
+template <typename Parts> void splitPropertyPath(absl::string_view path, Parts* parts) {
+  size_t start = 0;
+  while (start < path.size()) {
+    size_t end = path.find('\0', start);
+    if (end == absl::string_view::npos) {
+      end = path.size();
+    }
+    parts->push_back(path.substr(start, end - start));
+    start = end + 1;
+  }
+}
+
+} // namespace
+
+PropertyPath::PropertyPath(absl::string_view path) : path_(path) {
+  splitPropertyPath(path_, &parts_);
+  if (!parts_.empty()) {
+    token_ = findPropertyToken(parts_[0]);
+    if (token_.has_value()) {
+      lifetime_ = propertyLifetime(token_.value());
+    }
+  }
+}
+
 absl::optional<google::api::expr::runtime::CelValue>
 Context::findValue(absl::string_view name, Protobuf::Arena* arena, bool last) const {
+  // Convert into a dense token to enable a jump table implementation.
+  return findValue(findPropertyToken(name), name, arena, last);
+}
+
+absl::optional<google::api::expr::runtime::CelValue>
+Context::findValue(absl::optional<PropertyToken> token, absl::string_view name,
+                   Protobuf::Arena* arena, bool last) const {
   using google::api::expr::runtime::CelValue;
 
   const StreamInfo::StreamInfo* info = getConstRequestStreamInfo();
 
-  // Convert into a dense token to enable a jump table implementation.
-  auto part_token = property_tokens.find(name);
-  if (part_token == property_tokens.end()) {
+  if (!token.has_value()) {
     if (info) {
       std::string key;
       absl::StrAppend(&key, WasmStateKeyPrefix, name);
@@ -442,7 +804,7 @@ Context::findValue(absl::string_view name, Protobuf::Arena* arena, bool last) co
     return {};
   }
 
-  switch (part_token->second) {
+  switch (token.value()) {
   case PropertyToken::METADATA:
     if (info) {
       return CelValue::CreateMessage(&info->dynamicMetadata(), arena);
@@ -548,29 +910,62 @@ Context::findValue(absl::string_view name, Protobuf::Arena* arena, bool last) co
 }
 
 WasmResult Context::getProperty(absl::string_view path, std::string* result) {
+  absl::InlinedVector<absl::string_view, 8> parts;
+  splitPropertyPath(path, &parts);
+  return evaluateProperty(parts.empty() ? absl::nullopt : findPropertyToken(parts[0]), parts,
+                          result);
+}
+
+WasmResult Context::getProperty(uint32_t path_id, absl::string_view* result) {
+  const PropertyPath* path = wasm()->propertyPath(path_id);
+  if (!path) {
+    return WasmResult::BadArgument;
+  }
+  if (property_cache_.size() <= path_id) {
+    property_cache_.resize(path_id + 1);
+  }
+  PropertyLifetime lifetime = path->lifetime_;
+  if (lifetime == PropertyLifetime::Stream && path->token_ == PropertyToken::CONNECTION &&
+      network_read_filter_callbacks_) {
+    // The TLS handshake of a TCP connection may complete after its context is created.
+    lifetime = PropertyLifetime::Callback;
+  }
+  uint64_t generation = 0;
+  switch (lifetime) {
+  case PropertyLifetime::Context:
+    generation = 1;
+    break;
+  case PropertyLifetime::Stream:
+    generation = stream_generation_;
+    break;
+  case PropertyLifetime::Callback:
+    generation = callback_generation_;
+    break;
+  case PropertyLifetime::Call:
+    break;
+  }
+  auto& entry = property_cache_[path_id];
+  if (generation == 0 || entry.generation_ != generation) {
+    entry.result_ = evaluateProperty(path->token_, path->parts_, &entry.value_);
+    entry.generation_ = generation;
+  }
+  *result = entry.value_;
+  return entry.result_;
+}
+
+WasmResult Context::evaluateProperty(absl::optional<PropertyToken> token,
+                                     absl::Span<const absl::string_view> parts,
+                                     std::string* result) {
   using google::api::expr::runtime::CelValue;
 
-  bool first = true;
   CelValue value;
   Protobuf::Arena arena;
 
-  size_t start = 0;
-  while (true) {
-    if (start >= path.size()) {
-      break;
-    }
-
-    size_t end = path.find('\0', start);
-    if (end == absl::string_view::npos) {
-      end = start + path.size();
-    }
-    auto part = path.substr(start, end - start);
-    start = end + 1;
-
-    if (first) {
+  for (size_t i = 0; i < parts.size(); i++) {
+    const absl::string_view part = parts[i];
+    if (i == 0) {
       // top-level identifier
-      first = false;
-      auto top_value = findValue(part, &arena, start >= path.size());
+      auto top_value = findValue(token, part, &arena, parts.size() == 1);
       if (!top_value.has_value()) {
         return WasmResult::NotFound;
       }
@@ -678,6 +1073,7 @@ WasmResult Context::addHeaderMapValue(WasmHeaderMapType type, absl::string_view
   if (!map) {
     return WasmResult::BadArgument;
   }
+  invalidateCallbackProperties();
   const Http::LowerCaseString lower_key{std::string(key)};
   map->addCopy(lower_key, std::string(value));
   return WasmResult::Ok;
@@ -726,6 +1122,7 @@ WasmResult Context::setHeaderMapPairs(WasmHeaderMapType type, const Pairs& pairs
   if (!map) {
     return WasmResult::BadArgument;
   }
+  invalidateCallbackProperties();
   std::vector<std::string> keys;
   map->iterate([&keys](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
     keys.push_back(std::string(header.key().getStringView()));
@@ -747,6 +1144,7 @@ WasmResult Context::removeHeaderMapValue(WasmHeaderMapType type, absl::string_vi
   if (!map) {
     return WasmResult::BadArgument;
   }
+  invalidateCallbackProperties();
   const Http::LowerCaseString lower_key{std::string(key)};
   map->remove(lower_key);
   return WasmResult::Ok;
@@ -758,6 +1156,7 @@ WasmResult Context::replaceHeaderMapValue(WasmHeaderMapType type, absl::string_v
   if (!map) {
     return WasmResult::BadArgument;
   }
+  invalidateCallbackProperties();
   const Http::LowerCaseString lower_key{std::string(key)};
   map->setCopy(lower_key, value);
   return WasmResult::Ok;
@@ -772,6 +1171,293 @@ WasmResult Context::getHeaderMapSize(WasmHeaderMapType type, uint32_t* result) {
   return WasmResult::Ok;
 }
 
+WasmResult Context::getHeaderMapValues(WasmHeaderMapType type, absl::string_view serialized_keys,
+                                       char* buffer, size_t buffer_size, size_t* result_size) {
+  return serializeHeaderMapValues(getConstMap(type), serialized_keys, buffer, buffer_size,
+                                  result_size);
+}
+
+WasmResult Context::setHeaderMapValues(WasmHeaderMapType type,
+                                       absl::string_view serialized_mutations) {
+  invalidateCallbackProperties();
+  return applyHeaderMapMutations(getMap(type), serialized_mutations);
+}
+
+// Batched header map serialization. All integers are uint32_t in host byte order and may be
+// unaligned as they are read directly from VM memory:
+//   keys:      [n][n x key size][n x (key, '\0')]
+//   values:    [n][n x value size][n x (value, '\0')], missing values have size
+//              kHeaderValueNotFound and no bytes.
+//   mutations: [n][n x (op, key size, value size)][n x (key, '\0', value, '\0')]
+namespace {
+
+constexpr uint32_t kHeaderValueNotFound = std::numeric_limits<uint32_t>::max();
+
+enum class HeaderMapMutationOp : uint32_t {
+  Replace = 0,
+  Add = 1,
+  Remove = 2,
+};
+
+using SerializedKeys = absl::InlinedVector<absl::string_view, 16>;
+
+bool parseSerializedKeys(absl::string_view serialized_keys, SerializedKeys* keys) {
+  if (serialized_keys.size() < sizeof(uint32_t)) {
+    return false;
+  }
+  const uint32_t n = readUint32(serialized_keys.data());
+  if (n > (serialized_keys.size() - sizeof(uint32_t)) / sizeof(uint32_t)) {
+    return false;
+  }
+  const char* key_sizes = serialized_keys.data() + sizeof(uint32_t);
+  const char* key = key_sizes + n * sizeof(uint32_t);
+  const char* end = serialized_keys.data() + serialized_keys.size();
+  keys->reserve(n);
+  for (uint32_t i = 0; i < n; i++) {
+    const uint32_t key_size = readUint32(key_sizes + i * sizeof(uint32_t));
+    if (static_cast<size_t>(end - key) < static_cast<size_t>(key_size) + 1) {
+      return false;
+    }
+    keys->emplace_back(key, key_size);
+    key += key_size + 1;
+  }
+  return true;
+}
+
+} // namespace
+
+WasmResult serializeHeaderMapValues(const Http::HeaderMap* map, absl::string_view serialized_keys,
+                                    char* buffer, size_t buffer_size, size_t* result_size) {
+  if (!map) {
+    return WasmResult::BadArgument;
+  }
+  SerializedKeys keys;
+  if (!parseSerializedKeys(serialized_keys, &keys)) {
+    return WasmResult::ParseFailure;
+  }
+  const uint32_t n = keys.size();
+  absl::InlinedVector<const Http::HeaderEntry*, 16> entries;
+  entries.reserve(n);
+  size_t size = (1 + n) * sizeof(uint32_t);
+  for (auto& key : keys) {
+    const Http::LowerCaseString lower_key{std::string(key)};
+    const Http::HeaderEntry* entry = map->get(lower_key);
+    if (entry) {
+      size += entry->value().size() + 1;
+    }
+    entries.push_back(entry);
+  }
+  *result_size = size;
+  if (size > buffer_size) {
+    return WasmResult::ResultMismatch;
+  }
+  writeUint32(buffer, n);
+  char* value_sizes = buffer + sizeof(uint32_t);
+  char* value = value_sizes + n * sizeof(uint32_t);
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t value_size = kHeaderValueNotFound;
+    if (entries[i]) {
+      const absl::string_view value_view = entries[i]->value().getStringView();
+      value_size = value_view.size();
+      memcpy(value, value_view.data(), value_view.size());
+      value += value_view.size();
+      *value++ = '\0';
+    }
+    writeUint32(value_sizes + i * sizeof(uint32_t), value_size);
+  }
+  return WasmResult::Ok;
+}
+
+WasmResult applyHeaderMapMutations(Http::HeaderMap* map, absl::string_view serialized_mutations) {
+  if (!map) {
+    return WasmResult::BadArgument;
+  }
+  if (serialized_mutations.size() < sizeof(uint32_t)) {
+    return WasmResult::ParseFailure;
+  }
+  const uint32_t n = readUint32(serialized_mutations.data());
+  if (n > (serialized_mutations.size() - sizeof(uint32_t)) / (3 * sizeof(uint32_t))) {
+    return WasmResult::ParseFailure;
+  }
+  struct Mutation {
+    HeaderMapMutationOp op;
+    absl::string_view key;
+    absl::string_view value;
+  };
+  absl::InlinedVector<Mutation, 16> mutations;
+  mutations.reserve(n);
+  const char* header = serialized_mutations.data() + sizeof(uint32_t);
+  const char* data = header + n * 3 * sizeof(uint32_t);
+  const char* end = serialized_mutations.data() + serialized_mutations.size();
+  for (uint32_t i = 0; i < n; i++, header += 3 * sizeof(uint32_t)) {
+    const uint32_t op = readUint32(header);
+    const uint32_t key_size = readUint32(header + sizeof(uint32_t));
+    const uint32_t value_size = readUint32(header + 2 * sizeof(uint32_t));
+    if (op > static_cast<uint32_t>(HeaderMapMutationOp::Remove)) {
+      return WasmResult::BadArgument;
+    }
+    if (static_cast<size_t>(end - data) <
+        static_cast<size_t>(key_size) + static_cast<size_t>(value_size) + 2) {
+      return WasmResult::ParseFailure;
+    }
+    mutations.push_back({static_cast<HeaderMapMutationOp>(op), absl::string_view(data, key_size),
+                         absl::string_view(data + key_size + 1, value_size)});
+    data += key_size + value_size + 2;
+  }
+  for (auto& mutation : mutations) {
+    const Http::LowerCaseString lower_key{std::string(mutation.key)};
+    switch (mutation.op) {
+    case HeaderMapMutationOp::Replace:
+      map->setCopy(lower_key, mutation.value);
+      break;
+    case HeaderMapMutationOp::Add:
+      map->addCopy(lower_key, std::string(mutation.value));
+      break;
+    case HeaderMapMutationOp::Remove:
+      map->remove(lower_key);
+      break;
+    }
+  }
+  return WasmResult::Ok;
+}
+
+// Shared Data
+
+WasmResult Context::getSharedData(absl::string_view key, std::pair<std::string, uint32_t>* data) {
+  return globalSharedData().get(wasm()->vm_id(), key, data);
+}
+
+WasmResult Context::setSharedData(absl::string_view key, absl::string_view value, uint32_t cas) {
+  return globalSharedData().set(wasm()->vm_id(), key, value, cas);
+}
+
+WasmResult Context::getSharedDataValues(absl::string_view serialized_keys, char* buffer,
+                                        size_t buffer_size, size_t* result_size) {
+  return serializeSharedDataValues(globalSharedData(), wasm()->vm_id(), serialized_keys, buffer,
+                                   buffer_size, result_size);
+}
+
+WasmResult Context::setSharedDataValues(absl::string_view serialized_updates) {
+  return applySharedDataUpdates(globalSharedData(), wasm()->vm_id(), serialized_updates);
+}
+
+WasmResult Context::watchSharedData(absl::string_view key, uint32_t* token) {
+  auto root_context_id = (isRootContext() ? this : rootContext())->id();
+  auto& watch_token =
+      wasm()->shared_data_watch_tokens_[std::make_pair(root_context_id, std::string(key))];
+  if (watch_token) {
+    *token = watch_token;
+    return WasmResult::Ok;
+  }
+  watch_token = wasm()->nextSharedDataWatchToken();
+  *token = watch_token;
+  auto weak_wasm = std::weak_ptr<Wasm>(wasm()->sharedThis());
+  auto handle = globalSharedData().watch(
+      wasm()->vm_id(), key, wasm()->dispatcher(),
+      [weak_wasm, root_context_id, token = *token]() {
+        auto wasm = weak_wasm.lock();
+        if (!wasm) {
+          return;
+        }
+        auto context = static_cast<Context*>(wasm->getContext(root_context_id));
+        if (context) {
+          context->onSharedDataChanged(token);
+        }
+      });
+  wasm()->shared_data_watches_.emplace(
+      *token, Wasm::SharedDataWatch{root_context_id, std::string(key), std::move(handle)});
+  return WasmResult::Ok;
+}
+
+WasmResult Context::unwatchSharedData(uint32_t token) {
+  auto root_context_id = (isRootContext() ? this : rootContext())->id();
+  auto it = wasm()->shared_data_watches_.find(token);
+  if (it == wasm()->shared_data_watches_.end() || it->second.root_context_id_ != root_context_id) {
+    return WasmResult::NotFound;
+  }
+  wasm()->shared_data_watch_tokens_.erase(std::make_pair(root_context_id, it->second.key_));
+  wasm()->shared_data_watches_.erase(it);
+  return WasmResult::Ok;
+}
+
+void Context::onSharedDataChanged(uint32_t token) {
+  proxy_wasm::DeferAfterCallActions actions(this);
+  if (wasm()->isFailed() || !wasm()->on_shared_data_changed_) {
+    return;
+  }
+  wasm()->on_shared_data_changed_(this, id_, token);
+}
+
+// Batched shared data serialization, as for header maps:
+//   keys:    [n][n x key size][n x (key, '\0')]
+//   values:  [n][n x (value size, cas)][n x (value, '\0')], missing values have size
+//            kHeaderValueNotFound, cas 0 and no bytes.
+//   updates: [n][n x (key size, value size, cas)][n x (key, '\0', value, '\0')]
+WasmResult serializeSharedDataValues(SharedData& shared_data, absl::string_view vm_id,
+                                     absl::string_view serialized_keys, char* buffer,
+                                     size_t buffer_size, size_t* result_size) {
+  SerializedKeys keys;
+  if (!parseSerializedKeys(serialized_keys, &keys)) {
+    return WasmResult::ParseFailure;
+  }
+  const uint32_t n = keys.size();
+  std::vector<std::pair<std::string, uint32_t>> values(n);
+  size_t size = (1 + 2 * n) * sizeof(uint32_t);
+  for (uint32_t i = 0; i < n; i++) {
+    if (shared_data.get(vm_id, keys[i], &values[i]) == WasmResult::Ok) {
+      size += values[i].first.size() + 1;
+    }
+  }
+  *result_size = size;
+  if (size > buffer_size) {
+    return WasmResult::ResultMismatch;
+  }
+  writeUint32(buffer, n);
+  char* header = buffer + sizeof(uint32_t);
+  char* value = header + 2 * n * sizeof(uint32_t);
+  for (auto& v : values) {
+    // A cas of 0 means the key has not been set.
+    writeUint32(header, v.second ? v.first.size() : kHeaderValueNotFound);
+    writeUint32(header + sizeof(uint32_t), v.second);
+    header += 2 * sizeof(uint32_t);
+    if (v.second) {
+      memcpy(value, v.first.data(), v.first.size());
+      value += v.first.size();
+      *value++ = '\0';
+    }
+  }
+  return WasmResult::Ok;
+}
+
+WasmResult applySharedDataUpdates(SharedData& shared_data, absl::string_view vm_id,
+                                  absl::string_view serialized_updates) {
+  if (serialized_updates.size() < sizeof(uint32_t)) {
+    return WasmResult::ParseFailure;
+  }
+  const uint32_t n = readUint32(serialized_updates.data());
+  if (n > (serialized_updates.size() - sizeof(uint32_t)) / (3 * sizeof(uint32_t))) {
+    return WasmResult::ParseFailure;
+  }
+  absl::InlinedVector<SharedData::Update, 16> updates;
+  updates.reserve(n);
+  const char* header = serialized_updates.data() + sizeof(uint32_t);
+  const char* data = header + n * 3 * sizeof(uint32_t);
+  const char* end = serialized_updates.data() + serialized_updates.size();
+  for (uint32_t i = 0; i < n; i++, header += 3 * sizeof(uint32_t)) {
+    const uint32_t key_size = readUint32(header);
+    const uint32_t value_size = readUint32(header + sizeof(uint32_t));
+    const uint32_t cas = readUint32(header + 2 * sizeof(uint32_t));
+    if (static_cast<size_t>(end - data) <
+        static_cast<size_t>(key_size) + static_cast<size_t>(value_size) + 2) {
+      return WasmResult::ParseFailure;
+    }
+    updates.push_back({absl::string_view(data, key_size),
+                       absl::string_view(data + key_size + 1, value_size), cas});
+    data += key_size + value_size + 2;
+  }
+  return shared_data.set(vm_id, updates);
+}
+
 // Buffer
 
 BufferInterface* Context::getBuffer(WasmBufferType type) {
@@ -1364,6 +2050,7 @@ Http::FilterDataStatus convertFilterDataStatus(proxy_wasm::FilterDataStatus stat
 
 Network::FilterStatus Context::onNewConnection() {
   onCreate();
+  VmCallTimer timer(*this, VmCallback::OnNewConnection);
   return convertNetworkFilterStatus(onNetworkNewConnection());
 };
 
@@ -1373,6 +2060,7 @@ Network::FilterStatus Context::onData(::Envoy::Buffer::Instance& data, bool end_
   }
   network_downstream_data_buffer_ = &data;
   end_of_stream_ = end_stream;
+  VmCallTimer timer(*this, VmCallback::OnDownstreamData);
   auto result = convertNetworkFilterStatus(onDownstreamData(data.length(), end_stream));
   if (result == Network::FilterStatus::Continue) {
     network_downstream_data_buffer_ = nullptr;
@@ -1386,6 +2074,7 @@ Network::FilterStatus Context::onWrite(::Envoy::Buffer::Instance& data, bool end
   }
   network_upstream_data_buffer_ = &data;
   end_of_stream_ = end_stream;
+  VmCallTimer timer(*this, VmCallback::OnUpstreamData);
   auto result = convertNetworkFilterStatus(onUpstreamData(data.length(), end_stream));
   if (result == Network::FilterStatus::Continue) {
     network_upstream_data_buffer_ = nullptr;
@@ -1436,19 +2125,24 @@ void Context::log(const Http::RequestHeaderMap* request_headers,
     onCreate();
   }
 
+  stream_generation_++;
   access_log_request_headers_ = request_headers;
   // ? request_trailers  ?
   access_log_response_headers_ = response_headers;
   access_log_response_trailers_ = response_trailers;
   access_log_stream_info_ = &stream_info;
 
-  onLog();
+  {
+    VmCallTimer timer(*this, VmCallback::OnLog);
+    onLog();
+  }
 
   access_log_request_headers_ = nullptr;
   // ? request_trailers  ?
   access_log_response_headers_ = nullptr;
   access_log_response_trailers_ = nullptr;
   access_log_stream_info_ = nullptr;
+  stream_generation_++;
 }
 
 void Context::onDestroy() {
@@ -1456,7 +2150,10 @@ void Context::onDestroy() {
     return;
   }
   destroyed_ = true;
-  onDone();
+  {
+    VmCallTimer timer(*this, VmCallback::OnDone);
+    onDone();
+  }
   onDelete();
 }
 
@@ -1546,6 +2243,7 @@ Http::FilterHeadersStatus Context::decodeHeaders(Http::RequestHeaderMap& headers
   http_request_started_ = true;
   request_headers_ = &headers;
   end_of_stream_ = end_stream;
+  VmCallTimer timer(*this, VmCallback::OnRequestHeaders);
   auto result = convertFilterHeadersStatus(onRequestHeaders(headerSize(&headers), end_stream));
   if (result == Http::FilterHeadersStatus::Continue) {
     request_headers_ = nullptr;
@@ -1561,6 +2259,7 @@ Http::FilterDataStatus Context::decodeData(::Envoy::Buffer::Instance& data, bool
   end_of_stream_ = end_stream;
   const auto buffer = getBuffer(WasmBufferType::HttpRequestBody);
   const auto buffer_size = (buffer == nullptr) ? 0 : buffer->size();
+  VmCallTimer timer(*this, VmCallback::OnRequestBody);
   auto result = convertFilterDataStatus(onRequestBody(buffer_size, end_stream));
   buffering_request_body_ = false;
   switch (result) {
@@ -1582,6 +2281,7 @@ Http::FilterTrailersStatus Context::decodeTrailers(Http::RequestTrailerMap& trai
     return Http::FilterTrailersStatus::Continue;
   }
   request_trailers_ = &trailers;
+  VmCallTimer timer(*this, VmCallback::OnRequestTrailers);
   auto result = convertFilterTrailersStatus(onRequestTrailers(headerSize(&trailers)));
   if (result == Http::FilterTrailersStatus::Continue) {
     request_trailers_ = nullptr;
@@ -1594,6 +2294,7 @@ Http::FilterMetadataStatus Context::decodeMetadata(Http::MetadataMap& request_me
     return Http::FilterMetadataStatus::Continue;
   }
   request_metadata_ = &request_metadata;
+  VmCallTimer timer(*this, VmCallback::OnRequestMetadata);
   auto result = convertFilterMetadataStatus(onRequestMetadata(headerSize(&request_metadata)));
   if (result == Http::FilterMetadataStatus::Continue) {
     request_metadata_ = nullptr;
@@ -1616,6 +2317,7 @@ Http::FilterHeadersStatus Context::encodeHeaders(Http::ResponseHeaderMap& header
   }
   response_headers_ = &headers;
   end_of_stream_ = end_stream;
+  VmCallTimer timer(*this, VmCallback::OnResponseHeaders);
   auto result = convertFilterHeadersStatus(onResponseHeaders(headerSize(&headers), end_stream));
   if (result == Http::FilterHeadersStatus::Continue) {
     response_headers_ = nullptr;
@@ -1631,6 +2333,7 @@ Http::FilterDataStatus Context::encodeData(::Envoy::Buffer::Instance& data, bool
   end_of_stream_ = end_stream;
   const auto buffer = getBuffer(WasmBufferType::HttpResponseBody);
   const auto buffer_size = (buffer == nullptr) ? 0 : buffer->size();
+  VmCallTimer timer(*this, VmCallback::OnResponseBody);
   auto result = convertFilterDataStatus(onResponseBody(buffer_size, end_stream));
   buffering_response_body_ = false;
   switch (result) {
@@ -1652,6 +2355,7 @@ Http::FilterTrailersStatus Context::encodeTrailers(Http::ResponseTrailerMap& tra
     return Http::FilterTrailersStatus::Continue;
   }
   response_trailers_ = &trailers;
+  VmCallTimer timer(*this, VmCallback::OnResponseTrailers);
   auto result = convertFilterTrailersStatus(onResponseTrailers(headerSize(&trailers)));
   if (result == Http::FilterTrailersStatus::Continue) {
     response_trailers_ = nullptr;
@@ -1664,6 +2368,7 @@ Http::FilterMetadataStatus Context::encodeMetadata(Http::MetadataMap& response_m
     return Http::FilterMetadataStatus::Continue;
   }
   response_metadata_ = &response_metadata;
+  VmCallTimer timer(*this, VmCallback::OnResponseMetadata);
   auto result = convertFilterMetadataStatus(onResponseMetadata(headerSize(&response_metadata)));
   if (result == Http::FilterMetadataStatus::Continue) {
     response_metadata_ = nullptr;
@@ -1688,8 +2393,11 @@ void Context::onHttpCallSuccess(uint32_t token, Envoy::Http::ResponseMessagePtr&
   }
   http_call_response_ = &response;
   uint32_t body_size = response->body() ? response->body()->length() : 0;
-  onHttpCallResponse(token, response->headers().size(), body_size,
-                     headerSize(response->trailers()));
+  {
+    VmCallTimer timer(*this, VmCallback::OnHttpCallResponse);
+    onHttpCallResponse(token, response->headers().size(), body_size,
+                       headerSize(response->trailers()));
+  }
   http_call_response_ = nullptr;
   http_request_.erase(token);
 }
@@ -1704,7 +2412,10 @@ void Context::onHttpCallFailure(uint32_t token, Http::AsyncClient::FailureReason
   // This is the only value currently.
   ASSERT(reason == Http::AsyncClient::FailureReason::Reset);
   status_message_ = "reset";
-  onHttpCallResponse(token, 0, 0, 0);
+  {
+    VmCallTimer timer(*this, VmCallback::OnHttpCallResponse);
+    onHttpCallResponse(token, 0, 0, 0);
+  }
   status_message_ = "";
   http_request_.erase(token);
 }
@@ -1714,6 +2425,7 @@ void Context::onGrpcReceiveWrapper(uint32_t token, ::Envoy::Buffer::InstancePtr
   if (wasm()->on_grpc_receive_) {
     grpc_receive_buffer_ = std::move(response);
     uint32_t response_size = grpc_receive_buffer_->length();
+    VmCallTimer timer(*this, VmCallback::OnGrpcReceive);
     ContextBase::onGrpcReceive(token, response_size);
     grpc_receive_buffer_.reset();
   }
@@ -1734,6 +2446,7 @@ void Context::onGrpcCloseWrapper(uint32_t token, const Grpc::Status::GrpcStatus&
   if (wasm()->on_grpc_close_) {
     status_code_ = static_cast<uint32_t>(status);
     status_message_ = message;
+    VmCallTimer timer(*this, VmCallback::OnGrpcClose);
     onGrpcClose(token, status_code_);
     status_message_ = "";
   }
@@ -6,6 +6,7 @@
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/time.h"
 #include "envoy/extensions/wasm/v3/wasm.pb.validate.h"
 #include "envoy/http/filter.h"
 #include "envoy/stats/sink.h"
@@ -15,8 +16,11 @@
 #include "common/common/logger.h"
 
 #include "extensions/common/wasm/wasm_state.h"
+#include "extensions/common/wasm/wasm_vm.h"
 #include "extensions/filters/common/expr/evaluator.h"
 
+#include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "eval/public/activation.h"
 #include "include/proxy-wasm/wasm.h"
 
@@ -43,7 +47,9 @@ using proxy_wasm::WasmStreamType;
 using VmConfig = envoy::extensions::wasm::v3::VmConfig;
 using GrpcService = envoy::config::core::v3::GrpcService;
 
+class SharedData;
 class Wasm;
+struct StatsDeltaState;
 
 using WasmHandleBaseSharedPtr = std::shared_ptr<WasmHandleBase>;
 
@@ -63,6 +69,15 @@ public:
                     uint64_t size_ptr) const override;
   WasmResult copyFrom(size_t start, size_t length, absl::string_view data) override;
 
+  // Scatter-gather access for plugins which copy the buffer into memory they have already
+  // allocated instead of having the whole buffer flattened into a new VM allocation.
+  // Serializes the sizes of the underlying slices as [n][n x slice size].
+  WasmResult getSliceSizes(char* buffer, size_t buffer_size, size_t* result_size) const;
+  // Copies up to length bytes starting at start into dest, returning the number of bytes copied.
+  size_t copyOut(size_t start, size_t length, char* dest) const;
+  // Views of the underlying slices, for scanning the buffer in place on the host.
+  absl::InlinedVector<absl::string_view, 16> slices() const;
+
   // proxy_wasm::BufferBase
   void clear() override {
     proxy_wasm::BufferBase::clear();
@@ -110,6 +125,34 @@ struct Plugin : public PluginBase {
 };
 using PluginSharedPtr = std::shared_ptr<Plugin>;
 
+enum class PropertyToken;
+
+// How long the value of a property stays the same, and so how long Context::getProperty(path_id)
+// reuses its serialized value.
+enum class PropertyLifetime {
+  // May change at any time, e.g. filter state. Evaluated on every call.
+  Call,
+  // Derived from the headers of the stream. Reused within one callback into the plugin until the
+  // plugin modifies headers.
+  Callback,
+  // Fixed for the stream, e.g. the addresses of the connection.
+  Stream,
+  // Fixed for the lifetime of the context, e.g. the node or the plugin name.
+  Context,
+};
+
+// A property path which has been split into its parts and had its top-level identifier resolved
+// once so that it can be evaluated repeatedly by id. See Wasm::registerPropertyPath().
+struct PropertyPath {
+  explicit PropertyPath(absl::string_view path);
+
+  const std::string path_;
+  absl::optional<PropertyToken> token_;
+  PropertyLifetime lifetime_{PropertyLifetime::Call};
+  std::vector<absl::string_view> parts_; // Views into path_.
+};
+using PropertyPathPtr = std::unique_ptr<PropertyPath>;
+
 // A context which will be the target of callbacks for a particular session
 // e.g. a handler of a stream.
 class Context : public proxy_wasm::ContextBase,
@@ -131,6 +174,8 @@ public:
   Plugin* plugin() const;
   Context* rootContext() const;
   Upstream::ClusterManager& clusterManager() const;
+  // Stats of the plugin in this VM, shared with the root context. nullptr for the VM context.
+  VmPluginStats* vmPluginStats();
 
   // proxy_wasm::ContextBase
   void error(absl::string_view message) override;
@@ -212,6 +257,12 @@ public:
 
   // State accessors
   WasmResult getProperty(absl::string_view path, std::string* result) override;
+  // Evaluates a path registered with Wasm::registerPropertyPath(). The serialized value is reused
+  // for as long as the lifetime of the path allows.
+  WasmResult getProperty(uint32_t path_id, absl::string_view* result);
+  // Called when a callback into the plugin starts or ends and when headers are modified, after
+  // which values derived from headers are evaluated again.
+  void invalidateCallbackProperties() { callback_generation_++; }
   WasmResult setProperty(absl::string_view path, absl::string_view value) override;
   WasmResult declareProperty(absl::string_view path,
                              std::unique_ptr<const WasmStatePrototype> state_prototype);
@@ -242,6 +293,26 @@ public:
 
   WasmResult getHeaderMapSize(WasmHeaderMapType type, uint32_t* size) override;
 
+  // Batched Header/Trailer/Metadata Maps. See ext/envoy_proxy_wasm_api.h for the serialization.
+  WasmResult getHeaderMapValues(WasmHeaderMapType type, absl::string_view serialized_keys,
+                                char* buffer, size_t buffer_size, size_t* result_size);
+  WasmResult setHeaderMapValues(WasmHeaderMapType type, absl::string_view serialized_mutations);
+
+  // Shared Data
+  WasmResult getSharedData(absl::string_view key,
+                           std::pair<std::string, uint32_t /* cas */>* data) override;
+  WasmResult setSharedData(absl::string_view key, absl::string_view value, uint32_t cas) override;
+
+  // Batched Shared Data. See ext/envoy_proxy_wasm_api.h for the serialization.
+  WasmResult getSharedDataValues(absl::string_view serialized_keys, char* buffer,
+                                 size_t buffer_size, size_t* result_size);
+  WasmResult setSharedDataValues(absl::string_view serialized_updates);
+  // Calls onSharedDataChanged(token) on the root context each time the key is set. Watching the
+  // same key again from the same root context returns the same token.
+  WasmResult watchSharedData(absl::string_view key, uint32_t* token);
+  // Removes a watch of the root context. No onSharedDataChanged(token) is called afterwards.
+  WasmResult unwatchSharedData(uint32_t token);
+
   // Buffer
   BufferInterface* getBuffer(WasmBufferType type) override;
   // TODO: use stream_type.
@@ -275,7 +346,12 @@ public:
   void onResolveDns(uint32_t token, Envoy::Network::DnsResolver::ResolutionStatus status,
                     std::list<Envoy::Network::DnsResponse>&& response);
 
+  void onSharedDataChanged(uint32_t token);
+
   void onStatsUpdate(Envoy::Stats::MetricSnapshot& snapshot);
+  // As onStatsUpdate() but only metrics which changed since the previous call are sent, and each
+  // metric name is sent once along with the id used for the metric from then on.
+  void onStatsDeltaUpdate(Envoy::Stats::MetricSnapshot& snapshot);
 
   // CEL evaluation
   std::vector<const google::api::expr::runtime::CelFunction*>
@@ -285,6 +361,9 @@ public:
   absl::optional<google::api::expr::runtime::CelValue>
   findValue(absl::string_view name, Protobuf::Arena* arena, bool last) const;
   absl::optional<google::api::expr::runtime::CelValue>
+  findValue(absl::optional<PropertyToken> token, absl::string_view name, Protobuf::Arena* arena,
+            bool last) const;
+  absl::optional<google::api::expr::runtime::CelValue>
   FindValue(absl::string_view name, Protobuf::Arena* arena) const override {
     return findValue(name, arena, false);
   }
@@ -402,6 +481,9 @@ protected:
   Http::HeaderMap* getMap(WasmHeaderMapType type);
   const Http::HeaderMap* getConstMap(WasmHeaderMapType type);
 
+  WasmResult evaluateProperty(absl::optional<PropertyToken> token,
+                              absl::Span<const absl::string_view> parts, std::string* result);
+
   const LocalInfo::LocalInfo* root_local_info_{nullptr}; // set only for root_context.
 
   uint32_t next_http_call_token_ = 1;
@@ -467,6 +549,22 @@ protected:
   // Opaque state.
   absl::flat_hash_map<std::string, std::unique_ptr<StorageObject>> data_storage_;
 
+  // Stats sent to a delta stat sink. Root contexts only.
+  std::unique_ptr<StatsDeltaState> stats_delta_state_;
+
+  // Serialized property values by registered path id.
+  struct PropertyCacheEntry {
+    // The stream or callback generation the value was evaluated in, or 0 if it was not evaluated.
+    uint64_t generation_{0};
+    WasmResult result_{WasmResult::NotFound};
+    std::string value_;
+  };
+  std::vector<PropertyCacheEntry> property_cache_;
+  // Advanced when the stream whose properties are seen changes, e.g. for each access log entry of
+  // a root context, and for each callback.
+  uint64_t stream_generation_{1};
+  uint64_t callback_generation_{1};
+
   // TCP State.
   bool upstream_closed_ = false;
   bool downstream_closed_ = false;
@@ -474,11 +572,43 @@ protected:
 
   // Filter state prototype declaration.
   absl::flat_hash_map<std::string, std::unique_ptr<const WasmStatePrototype>> state_prototypes_;
+
+  VmPluginStats* vm_plugin_stats_{};
 };
 using ContextSharedPtr = std::shared_ptr<Context>;
 
+// Records the time spent in a callback into the plugin, and the size of the linear memory of the
+// VM afterwards, in the stats of the plugin.
+class VmCallTimer {
+public:
+  VmCallTimer(Context& context, VmCallback callback);
+  ~VmCallTimer();
+
+private:
+  Context& context_;
+  VmPluginStats* const stats_;
+  const VmCallback callback_;
+  MonotonicTime start_;
+};
+
 WasmResult serializeValue(Filters::Common::Expr::CelValue value, std::string* result);
 
+// Looks up each of the serialized keys in the map and serializes the values into buffer. The size
+// of the result is always returned in result_size, and ResultMismatch is returned if it does not
+// fit in buffer_size.
+WasmResult serializeHeaderMapValues(const Http::HeaderMap* map, absl::string_view serialized_keys,
+                                    char* buffer, size_t buffer_size, size_t* result_size);
+// Applies the serialized mutations to the map in order. Nothing is applied unless all of the
+// mutations parse.
+WasmResult applyHeaderMapMutations(Http::HeaderMap* map, absl::string_view serialized_mutations);
+// As serializeHeaderMapValues() for the shared data of vm_id, with the cas of each value.
+WasmResult serializeSharedDataValues(SharedData& shared_data, absl::string_view vm_id,
+                                     absl::string_view serialized_keys, char* buffer,
+                                     size_t buffer_size, size_t* result_size);
+// Applies the serialized updates to the shared data of vm_id atomically. See SharedData::set().
+WasmResult applySharedDataUpdates(SharedData& shared_data, absl::string_view vm_id,
+                                  absl::string_view serialized_updates);
+
 } // namespace Wasm
 } // namespace Common
 } // namespace Extensions
@@ -17,6 +17,33 @@ namespace Wasm {
 
 proxy_wasm::Word resolve_dns(void* raw_context, proxy_wasm::Word dns_address,
                              proxy_wasm::Word dns_address_size, proxy_wasm::Word token_ptr);
+proxy_wasm::Word get_header_map_values(void* raw_context, proxy_wasm::Word type,
+                                       proxy_wasm::Word keys_ptr, proxy_wasm::Word keys_size,
+                                       proxy_wasm::Word buffer_ptr, proxy_wasm::Word buffer_size,
+                                       proxy_wasm::Word result_size_ptr);
+proxy_wasm::Word set_header_map_values(void* raw_context, proxy_wasm::Word type,
+                                       proxy_wasm::Word mutations_ptr,
+                                       proxy_wasm::Word mutations_size);
+proxy_wasm::Word get_buffer_slices(void* raw_context, proxy_wasm::Word type,
+                                   proxy_wasm::Word buffer_ptr, proxy_wasm::Word buffer_size,
+                                   proxy_wasm::Word result_size_ptr);
+proxy_wasm::Word copy_buffer_bytes(void* raw_context, proxy_wasm::Word type,
+                                   proxy_wasm::Word start, proxy_wasm::Word length,
+                                   proxy_wasm::Word dest_ptr, proxy_wasm::Word copied_ptr);
+proxy_wasm::Word register_property_path(void* raw_context, proxy_wasm::Word path_ptr,
+                                        proxy_wasm::Word path_size, proxy_wasm::Word path_id_ptr);
+proxy_wasm::Word get_property_by_id(void* raw_context, proxy_wasm::Word path_id,
+                                    proxy_wasm::Word buffer_ptr, proxy_wasm::Word buffer_size,
+                                    proxy_wasm::Word result_size_ptr);
+proxy_wasm::Word get_shared_data_values(void* raw_context, proxy_wasm::Word keys_ptr,
+                                        proxy_wasm::Word keys_size, proxy_wasm::Word buffer_ptr,
+                                        proxy_wasm::Word buffer_size,
+                                        proxy_wasm::Word result_size_ptr);
+proxy_wasm::Word set_shared_data_values(void* raw_context, proxy_wasm::Word updates_ptr,
+                                        proxy_wasm::Word updates_size);
+proxy_wasm::Word watch_shared_data(void* raw_context, proxy_wasm::Word key_ptr,
+                                   proxy_wasm::Word key_size, proxy_wasm::Word token_ptr);
+proxy_wasm::Word unwatch_shared_data(void* raw_context, proxy_wasm::Word token);
 
 } // namespace Wasm
 } // namespace Common
@@ -41,6 +68,84 @@ inline WasmResult envoy_resolve_dns(const char* dns_address, size_t dns_address_
           .u64_);
 }
 
+inline WasmResult envoy_get_header_map_values(WasmHeaderMapType type, const char* keys,
+                                              size_t keys_size, char* buffer, size_t buffer_size,
+                                              size_t* result_size) {
+  return static_cast<WasmResult>(::Envoy::Extensions::Common::Wasm::get_header_map_values(
+                                     proxy_wasm::current_context_, WS(type), WR(keys),
+                                     WS(keys_size), WR(buffer), WS(buffer_size), WR(result_size))
+                                     .u64_);
+}
+
+inline WasmResult envoy_set_header_map_values(WasmHeaderMapType type, const char* mutations,
+                                              size_t mutations_size) {
+  return static_cast<WasmResult>(
+      ::Envoy::Extensions::Common::Wasm::set_header_map_values(
+          proxy_wasm::current_context_, WS(type), WR(mutations), WS(mutations_size))
+          .u64_);
+}
+
+inline WasmResult envoy_get_buffer_slices(WasmBufferType type, char* buffer, size_t buffer_size,
+                                          size_t* result_size) {
+  return static_cast<WasmResult>(
+      ::Envoy::Extensions::Common::Wasm::get_buffer_slices(proxy_wasm::current_context_, WS(type),
+                                                           WR(buffer), WS(buffer_size),
+                                                           WR(result_size))
+          .u64_);
+}
+
+inline WasmResult envoy_copy_buffer_bytes(WasmBufferType type, size_t start, size_t length,
+                                          char* dest, size_t* copied) {
+  return static_cast<WasmResult>(
+      ::Envoy::Extensions::Common::Wasm::copy_buffer_bytes(proxy_wasm::current_context_, WS(type),
+                                                           WS(start), WS(length), WR(dest),
+                                                           WR(copied))
+          .u64_);
+}
+
+inline WasmResult envoy_register_property_path(const char* path, size_t path_size,
+                                               uint32_t* path_id) {
+  return static_cast<WasmResult>(::Envoy::Extensions::Common::Wasm::register_property_path(
+                                     proxy_wasm::current_context_, WR(path), WS(path_size),
+                                     WR(path_id))
+                                     .u64_);
+}
+
+inline WasmResult envoy_get_property_by_id(uint32_t path_id, char* buffer, size_t buffer_size,
+                                           size_t* result_size) {
+  return static_cast<WasmResult>(::Envoy::Extensions::Common::Wasm::get_property_by_id(
+                                     proxy_wasm::current_context_, WS(path_id), WR(buffer),
+                                     WS(buffer_size), WR(result_size))
+                                     .u64_);
+}
+
+inline WasmResult envoy_get_shared_data_values(const char* keys, size_t keys_size, char* buffer,
+                                               size_t buffer_size, size_t* result_size) {
+  return static_cast<WasmResult>(::Envoy::Extensions::Common::Wasm::get_shared_data_values(
+                                     proxy_wasm::current_context_, WR(keys), WS(keys_size),
+                                     WR(buffer), WS(buffer_size), WR(result_size))
+                                     .u64_);
+}
+
+inline WasmResult envoy_set_shared_data_values(const char* updates, size_t updates_size) {
+  return static_cast<WasmResult>(::Envoy::Extensions::Common::Wasm::set_shared_data_values(
+                                     proxy_wasm::current_context_, WR(updates), WS(updates_size))
+                                     .u64_);
+}
+
+inline WasmResult envoy_watch_shared_data(const char* key, size_t key_size, uint32_t* token) {
+  return static_cast<WasmResult>(::Envoy::Extensions::Common::Wasm::watch_shared_data(
+                                     proxy_wasm::current_context_, WR(key), WS(key_size),
+                                     WR(token))
+                                     .u64_);
+}
+
+inline WasmResult envoy_unwatch_shared_data(uint32_t token) {
+  return static_cast<WasmResult>(::Envoy::Extensions::Common::Wasm::unwatch_shared_data(
+                                     proxy_wasm::current_context_, WS(token))
+                                     .u64_);
+}
+
 #undef WS
 #undef WR
 
@@ -38,3 +38,8 @@ extern "C" PROXY_WASM_KEEPALIVE void envoy_on_stats_update(uint32_t context_id,
                                                            uint32_t data_size) {
   getEnvoyRootContext(context_id)->onStatsUpdate(data_size);
 }
+
+extern "C" PROXY_WASM_KEEPALIVE void envoy_on_shared_data_changed(uint32_t context_id,
+                                                                  uint32_t token) {
+  getEnvoyRootContext(context_id)->onSharedDataChanged(token);
+}
@@ -6,6 +6,25 @@
 
 extern "C" WasmResult envoy_resolve_dns(const char* dns_address, size_t dns_address_size,
                                         uint32_t* token);
+extern "C" WasmResult envoy_get_header_map_values(WasmHeaderMapType type, const char* keys,
+                                                  size_t keys_size, char* buffer,
+                                                  size_t buffer_size, size_t* result_size);
+extern "C" WasmResult envoy_set_header_map_values(WasmHeaderMapType type, const char* mutations,
+                                                  size_t mutations_size);
+extern "C" WasmResult envoy_get_buffer_slices(WasmBufferType type, char* buffer,
+                                              size_t buffer_size, size_t* result_size);
+extern "C" WasmResult envoy_copy_buffer_bytes(WasmBufferType type, size_t start, size_t length,
+                                              char* dest, size_t* copied);
+extern "C" WasmResult envoy_register_property_path(const char* path, size_t path_size,
+                                                   uint32_t* path_id);
+extern "C" WasmResult envoy_get_property_by_id(uint32_t path_id, char* buffer, size_t buffer_size,
+                                               size_t* result_size);
+extern "C" WasmResult envoy_get_shared_data_values(const char* keys, size_t keys_size,
+                                                   char* buffer, size_t buffer_size,
+                                                   size_t* result_size);
+extern "C" WasmResult envoy_set_shared_data_values(const char* updates, size_t updates_size);
+extern "C" WasmResult envoy_watch_shared_data(const char* key, size_t key_size, uint32_t* token);
+extern "C" WasmResult envoy_unwatch_shared_data(uint32_t token);
 
 class EnvoyContextBase {
 public:
@@ -19,6 +38,8 @@ public:
 
   virtual void onResolveDns(uint32_t /* token */, uint32_t /* result_size */) {}
   virtual void onStatsUpdate(uint32_t /* result_size */) {}
+  // Called each time a key watched with watchSharedData() is set, by any VM with the same vm_id.
+  virtual void onSharedDataChanged(uint32_t /* token */) {}
 };
 
 class EnvoyContext : public Context, public EnvoyContextBase {
@@ -51,6 +72,34 @@ struct StatResult {
 enum class StatType : uint32_t {
   Counter = 1,
   Gauge = 2,
+  // Block types used by stat sinks configured with delta_export.
+  Name = 3,
+  CounterDelta = 4,
+  GaugeDelta = 5,
+  Removed = 6,
+};
+
+struct StatNameResult {
+  uint32_t id;
+  std::string_view name;
+};
+
+struct CounterDeltaResult {
+  uint32_t id;
+  uint64_t value;
+  uint64_t delta;
+};
+
+struct GaugeDeltaResult {
+  uint32_t id;
+  uint64_t value;
+};
+
+struct StatDeltaResult {
+  std::vector<StatNameResult> names;
+  std::vector<CounterDeltaResult> counters;
+  std::vector<GaugeDeltaResult> gauges;
+  std::vector<uint32_t> removed;
 };
 
 inline std::vector<DnsResult> parseDnsResults(std::string_view data) {
@@ -128,4 +177,431 @@ inline StatResult parseStatResults(std::string_view data) {
   return results;
 }
 
+// Parses the update sent to a stat sink configured with delta_export. Names are sent once, before
+// the first update for the metric, and the plugin is expected to keep the mapping from id to name
+// until the id is removed. Each block is [size][type][count] followed by the entries and padded to
+// 8 bytes:
+//   Name:         [id][length][name]
+//   CounterDelta: [id] padding [value][delta]
+//   GaugeDelta:   [id] padding [value]
+//   Removed:      [id]
+inline StatDeltaResult parseStatDeltaResults(std::string_view data) {
+  StatDeltaResult results;
+  uint32_t data_len = 0;
+  while (data_len + 3 * sizeof(uint32_t) <= data.length()) {
+    const uint32_t* n = reinterpret_cast<const uint32_t*>(data.data() + data_len);
+    uint32_t block_size = *n++;
+    uint32_t block_type = *n++;
+    uint32_t num_stats = *n++;
+    if (block_type < static_cast<uint32_t>(StatType::Name) ||
+        block_type > static_cast<uint32_t>(StatType::Removed)) {
+      num_stats = 0;
+    }
+    uint32_t stat_index = data_len + 3 * sizeof(uint32_t);
+    for (uint32_t i = 0; i < num_stats; i++) {
+      uint32_t id = *reinterpret_cast<const uint32_t*>(data.data() + stat_index);
+      stat_index += sizeof(uint32_t);
+      switch (static_cast<StatType>(block_type)) {
+      case StatType::Name: {
+        uint32_t name_len = *reinterpret_cast<const uint32_t*>(data.data() + stat_index);
+        stat_index += sizeof(uint32_t);
+        results.names.push_back({id, {data.data() + stat_index, name_len}});
+        stat_index += name_len;
+        break;
+      }
+      case StatType::CounterDelta: {
+        stat_index = align<uint64_t>(stat_index);
+        const uint64_t* stat_vals = reinterpret_cast<const uint64_t*>(data.data() + stat_index);
+        results.counters.push_back({id, stat_vals[0], stat_vals[1]});
+        stat_index += 2 * sizeof(uint64_t);
+        break;
+      }
+      case StatType::GaugeDelta: {
+        stat_index = align<uint64_t>(stat_index);
+        const uint64_t* stat_vals = reinterpret_cast<const uint64_t*>(data.data() + stat_index);
+        results.gauges.push_back({id, stat_vals[0]});
+        stat_index += sizeof(uint64_t);
+        break;
+      }
+      case StatType::Removed:
+      default:
+        results.removed.push_back(id);
+        break;
+      }
+    }
+    if (block_size == 0) {
+      break;
+    }
+    data_len += block_size;
+  }
+  return results;
+}
+
 extern "C" WasmResult envoy_resolve_dns(const char* address, size_t address_size, uint32_t* token);
+
+// Batched header map access: a single call to read or modify a set of headers. All integers are
+// uint32_t:
+//   keys:      [n][n x key size][n x (key, '\0')]
+//   values:    [n][n x value size][n x (value, '\0')], missing values have size
+//              HeaderValueNotFound and no bytes.
+//   mutations: [n][n x (op, key size, value size)][n x (key, '\0', value, '\0')]
+constexpr uint32_t HeaderValueNotFound = 0xFFFFFFFF;
+
+struct HeaderValue {
+  bool found;
+  std::string_view value;
+};
+
+enum class HeaderMapMutationOp : uint32_t {
+  Replace = 0,
+  Add = 1,
+  Remove = 2,
+};
+
+struct HeaderMapMutation {
+  HeaderMapMutationOp op;
+  std::string_view key;
+  std::string_view value;
+};
+
+inline std::string serializeHeaderKeys(const std::vector<std::string_view>& keys) {
+  size_t size = (1 + keys.size()) * sizeof(uint32_t);
+  for (auto& k : keys) {
+    size += k.size() + 1;
+  }
+  std::string result(size, '\0');
+  uint32_t* p = reinterpret_cast<uint32_t*>(&result[0]);
+  *p++ = keys.size();
+  for (auto& k : keys) {
+    *p++ = k.size();
+  }
+  char* pk = reinterpret_cast<char*>(p);
+  for (auto& k : keys) {
+    memcpy(pk, k.data(), k.size());
+    pk += k.size() + 1;
+  }
+  return result;
+}
+
+inline std::vector<HeaderValue> parseHeaderValues(std::string_view data) {
+  if (data.size() < 4) {
+    return {};
+  }
+  const uint32_t* pn = reinterpret_cast<const uint32_t*>(data.data());
+  uint32_t n = *pn++;
+  std::vector<HeaderValue> results;
+  results.resize(n);
+  const char* pv = data.data() + (1 + n) * sizeof(uint32_t); // skip n + n sizes
+  for (uint32_t i = 0; i < n; i++) {
+    auto& e = results[i];
+    uint32_t vlen = *pn++;
+    if (vlen == HeaderValueNotFound) {
+      e.found = false;
+      continue;
+    }
+    e.found = true;
+    e.value = {pv, vlen};
+    pv += vlen + 1;
+  }
+  return results;
+}
+
+inline std::string serializeHeaderMapMutations(const std::vector<HeaderMapMutation>& mutations) {
+  size_t size = (1 + 3 * mutations.size()) * sizeof(uint32_t);
+  for (auto& m : mutations) {
+    size += m.key.size() + m.value.size() + 2;
+  }
+  std::string result(size, '\0');
+  uint32_t* p = reinterpret_cast<uint32_t*>(&result[0]);
+  *p++ = mutations.size();
+  for (auto& m : mutations) {
+    *p++ = static_cast<uint32_t>(m.op);
+    *p++ = m.key.size();
+    *p++ = m.value.size();
+  }
+  char* pm = reinterpret_cast<char*>(p);
+  for (auto& m : mutations) {
+    memcpy(pm, m.key.data(), m.key.size());
+    pm += m.key.size() + 1;
+    memcpy(pm, m.value.data(), m.value.size());
+    pm += m.value.size() + 1;
+  }
+  return result;
+}
+
+// Fetches the values of keys in one call. The values are views into buffer, which is reused
+// across calls and only grown if the serialized values do not fit.
+inline WasmResult getHeaderMapValues(WasmHeaderMapType type,
+                                     const std::vector<std::string_view>& keys,
+                                     std::string* buffer, std::vector<HeaderValue>* values) {
+  auto serialized_keys = serializeHeaderKeys(keys);
+  size_t result_size = 0;
+  auto result = envoy_get_header_map_values(type, serialized_keys.data(), serialized_keys.size(),
+                                            &(*buffer)[0], buffer->size(), &result_size);
+  if (result == WasmResult::ResultMismatch) {
+    buffer->resize(result_size);
+    result = envoy_get_header_map_values(type, serialized_keys.data(), serialized_keys.size(),
+                                         &(*buffer)[0], buffer->size(), &result_size);
+  }
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  *values = parseHeaderValues(std::string_view(buffer->data(), result_size));
+  return WasmResult::Ok;
+}
+
+inline WasmResult setHeaderMapValues(WasmHeaderMapType type,
+                                     const std::vector<HeaderMapMutation>& mutations) {
+  auto serialized_mutations = serializeHeaderMapMutations(mutations);
+  return envoy_set_header_map_values(type, serialized_mutations.data(),
+                                     serialized_mutations.size());
+}
+
+// Scatter-gather buffer access. The slice layout of a buffer is returned as
+// [n][n x slice size] (uint32_t) and windows of the buffer are copied into memory owned by the
+// plugin, so a large body need never be flattened into a single allocation in the VM.
+inline WasmResult getBufferSliceSizes(WasmBufferType type, std::vector<uint32_t>* sizes) {
+  uint32_t inline_buffer[17];
+  size_t result_size = 0;
+  auto result = envoy_get_buffer_slices(type, reinterpret_cast<char*>(inline_buffer),
+                                        sizeof(inline_buffer), &result_size);
+  if (result == WasmResult::Ok) {
+    sizes->assign(inline_buffer + 1, inline_buffer + 1 + inline_buffer[0]);
+    return result;
+  }
+  if (result != WasmResult::ResultMismatch) {
+    return result;
+  }
+  std::vector<uint32_t> buffer(result_size / sizeof(uint32_t));
+  result = envoy_get_buffer_slices(type, reinterpret_cast<char*>(buffer.data()), result_size,
+                                   &result_size);
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  sizes->assign(buffer.begin() + 1, buffer.begin() + 1 + buffer[0]);
+  return result;
+}
+
+// Streams [start, start + length) of the buffer through f in chunks of at most chunk_size bytes,
+// reusing a single chunk allocation. Stops early if f returns false.
+template <typename F>
+inline WasmResult forEachBufferChunk(WasmBufferType type, size_t start, size_t length,
+                                     size_t chunk_size, F f) {
+  std::unique_ptr<char[]> chunk(new char[chunk_size]);
+  while (length > 0) {
+    size_t copied = 0;
+    auto result = envoy_copy_buffer_bytes(type, start, std::min(length, chunk_size), chunk.get(),
+                                          &copied);
+    if (result != WasmResult::Ok) {
+      return result;
+    }
+    if (copied == 0 || !f(std::string_view(chunk.get(), copied))) {
+      break;
+    }
+    start += copied;
+    length -= copied;
+  }
+  return WasmResult::Ok;
+}
+
+// Registered property paths. The path is given in the same '\0' separated form as
+// proxy_get_property and is compiled once by the host into an id which can then be evaluated
+// cheaply, e.g. on every request.
+inline WasmResult registerPropertyPath(const std::vector<std::string_view>& parts,
+                                       uint32_t* path_id) {
+  std::string path;
+  for (auto& part : parts) {
+    path.append(part.data(), part.size());
+    path.push_back('\0');
+  }
+  return envoy_register_property_path(path.data(), path.size(), path_id);
+}
+
+// Fetches the serialized value of a registered property path into buffer, which is reused across
+// calls and only grown if the value does not fit.
+inline WasmResult getPropertyById(uint32_t path_id, std::string* buffer, size_t* value_size) {
+  auto result = envoy_get_property_by_id(path_id, &(*buffer)[0], buffer->size(), value_size);
+  if (result == WasmResult::ResultMismatch) {
+    buffer->resize(*value_size);
+    result = envoy_get_property_by_id(path_id, &(*buffer)[0], buffer->size(), value_size);
+  }
+  return result;
+}
+
+// Batched shared data access. Keys are serialized as for getHeaderMapValues() and:
+//   values:  [n][n x (value size, cas)][n x (value, '\0')], missing values have size
+//            HeaderValueNotFound and cas 0.
+//   updates: [n][n x (key size, value size, cas)][n x (key, '\0', value, '\0')]
+// The updates are applied atomically: none are applied unless the cas of every update matches (a
+// cas of 0 always matches).
+struct SharedDataValue {
+  bool found;
+  std::string_view value;
+  uint32_t cas;
+};
+
+struct SharedDataUpdate {
+  std::string_view key;
+  std::string_view value;
+  uint32_t cas;
+};
+
+inline std::vector<SharedDataValue> parseSharedDataValues(std::string_view data) {
+  if (data.size() < 4) {
+    return {};
+  }
+  const uint32_t* ph = reinterpret_cast<const uint32_t*>(data.data());
+  uint32_t n = *ph++;
+  std::vector<SharedDataValue> results;
+  results.resize(n);
+  const char* pv = data.data() + (1 + 2 * n) * sizeof(uint32_t); // skip n + n (size, cas)
+  for (uint32_t i = 0; i < n; i++) {
+    auto& e = results[i];
+    uint32_t vlen = *ph++;
+    e.cas = *ph++;
+    if (vlen == HeaderValueNotFound) {
+      e.found = false;
+      continue;
+    }
+    e.found = true;
+    e.value = {pv, vlen};
+    pv += vlen + 1;
+  }
+  return results;
+}
+
+inline std::string serializeSharedDataUpdates(const std::vector<SharedDataUpdate>& updates) {
+  size_t size = (1 + 3 * updates.size()) * sizeof(uint32_t);
+  for (auto& u : updates) {
+    size += u.key.size() + u.value.size() + 2;
+  }
+  std::string result(size, '\0');
+  uint32_t* p = reinterpret_cast<uint32_t*>(&result[0]);
+  *p++ = updates.size();
+  for (auto& u : updates) {
+    *p++ = u.key.size();
+    *p++ = u.value.size();
+    *p++ = u.cas;
+  }
+  char* pu = reinterpret_cast<char*>(p);
+  for (auto& u : updates) {
+    memcpy(pu, u.key.data(), u.key.size());
+    pu += u.key.size() + 1;
+    memcpy(pu, u.value.data(), u.value.size());
+    pu += u.value.size() + 1;
+  }
+  return result;
+}
+
+// Fetches the values of keys in one call. The values are views into buffer, which is reused
+// across calls and only grown if the serialized values do not fit.
+inline WasmResult getSharedDataValues(const std::vector<std::string_view>& keys,
+                                      std::string* buffer, std::vector<SharedDataValue>* values) {
+  auto serialized_keys = serializeHeaderKeys(keys);
+  size_t result_size = 0;
+  auto result = envoy_get_shared_data_values(serialized_keys.data(), serialized_keys.size(),
+                                             &(*buffer)[0], buffer->size(), &result_size);
+  if (result == WasmResult::ResultMismatch) {
+    buffer->resize(result_size);
+    result = envoy_get_shared_data_values(serialized_keys.data(), serialized_keys.size(),
+                                          &(*buffer)[0], buffer->size(), &result_size);
+  }
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  *values = parseSharedDataValues(std::string_view(buffer->data(), result_size));
+  return WasmResult::Ok;
+}
+
+inline WasmResult setSharedDataValues(const std::vector<SharedDataUpdate>& updates) {
+  auto serialized_updates = serializeSharedDataUpdates(updates);
+  return envoy_set_shared_data_values(serialized_updates.data(), serialized_updates.size());
+}
+
+// Watches key for changes: EnvoyRootContext::onSharedDataChanged(token) is called on this root
+// context each time the key is set, rather than having to poll for changes on a timer. Watching
+// the same key again returns the same token.
+inline WasmResult watchSharedData(std::string_view key, uint32_t* token) {
+  return envoy_watch_shared_data(key.data(), key.size(), token);
+}
+
+inline WasmResult unwatchSharedData(uint32_t token) { return envoy_unwatch_shared_data(token); }
+
+// Pattern sets: literals and regexes compiled once on the host and matched natively against a
+// whole buffer (e.g. the request body) without the buffer being copied into the VM. Only the
+// matches are returned. See the pattern_set_* foreign functions for the serialization.
+struct PatternSetPattern {
+  bool regex;
+  std::string_view pattern;
+};
+
+struct PatternSetMatch {
+  uint32_t pattern; // Index of the pattern in the set.
+  uint32_t offset;
+  uint32_t length;
+};
+
+inline WasmResult createPatternSet(const std::vector<PatternSetPattern>& patterns,
+                                   bool case_insensitive, uint32_t* token) {
+  size_t size = (2 + 2 * patterns.size()) * sizeof(uint32_t);
+  for (auto& p : patterns) {
+    size += p.pattern.size();
+  }
+  std::string arguments(size, '\0');
+  uint32_t* p = reinterpret_cast<uint32_t*>(&arguments[0]);
+  *p++ = case_insensitive ? 1 : 0;
+  *p++ = patterns.size();
+  for (auto& pattern : patterns) {
+    *p++ = pattern.regex ? 1 : 0;
+    *p++ = pattern.pattern.size();
+  }
+  char* pp = reinterpret_cast<char*>(p);
+  for (auto& pattern : patterns) {
+    memcpy(pp, pattern.pattern.data(), pattern.pattern.size());
+    pp += pattern.pattern.size();
+  }
+  std::string_view function = "pattern_set_create";
+  char* out = nullptr;
+  size_t out_size = 0;
+  auto result = proxy_call_foreign_function(function.data(), function.size(), arguments.data(),
+                                            arguments.size(), &out, &out_size);
+  if (result == WasmResult::Ok && out_size == sizeof(uint32_t)) {
+    memcpy(token, out, sizeof(uint32_t));
+  }
+  ::free(out);
+  return result;
+}
+
+inline WasmResult matchPatternSet(uint32_t token, WasmBufferType type, uint32_t max_matches,
+                                  std::vector<PatternSetMatch>* matches) {
+  const uint32_t arguments[3] = {token, static_cast<uint32_t>(type), max_matches};
+  std::string_view function = "pattern_set_match";
+  char* out = nullptr;
+  size_t out_size = 0;
+  auto result = proxy_call_foreign_function(function.data(), function.size(),
+                                            reinterpret_cast<const char*>(arguments),
+                                            sizeof(arguments), &out, &out_size);
+  matches->clear();
+  if (result == WasmResult::Ok && out_size >= sizeof(uint32_t)) {
+    const uint32_t* p = reinterpret_cast<const uint32_t*>(out);
+    const uint32_t n = *p++;
+    matches->reserve(n);
+    for (uint32_t i = 0; i < n; i++, p += 3) {
+      matches->push_back({p[0], p[1], p[2]});
+    }
+  }
+  ::free(out);
+  return result;
+}
+
+inline WasmResult deletePatternSet(uint32_t token) {
+  std::string_view function = "pattern_set_delete";
+  char* out = nullptr;
+  size_t out_size = 0;
+  auto result =
+      proxy_call_foreign_function(function.data(), function.size(),
+                                  reinterpret_cast<const char*>(&token), sizeof(token), &out,
+                                  &out_size);
+  ::free(out);
+  return result;
+}
@@ -1,3 +1,12 @@
 mergeInto(LibraryManager.library, {
   envoy_resolve_dns: function() {},
+  envoy_get_header_map_values: function() {},
+  envoy_set_header_map_values: function() {},
+  envoy_get_buffer_slices: function() {},
+  envoy_copy_buffer_bytes: function() {},
+  envoy_register_property_path: function() {},
+  envoy_get_property_by_id: function() {},
+  envoy_get_shared_data_values: function() {},
+  envoy_set_shared_data_values: function() {},
+  envoy_watch_shared_data: function() {},
 });
@@ -2,6 +2,7 @@
 
 #include "source/extensions/common/wasm/ext/declare_property.pb.h"
 
+#include "extensions/common/wasm/pattern_matcher.h"
 #include "extensions/common/wasm/wasm.h"
 
 #if defined(WASM_USE_CEL_PARSER)
@@ -215,6 +216,172 @@ RegisterForeignFunction
                                             createFromClass<DeleteExpressionFactory>());
 #endif
 
+// Pattern sets are compiled once per root context and then used to scan buffers natively, without
+// copying them into the VM. Arguments and results are serialized as little endian uint32s:
+//   pattern_set_create: [flags][n][n x (type, size)][patterns] -> [token]
+//     flags: bit 0 case insensitive. type: 0 literal, 1 regex.
+//   pattern_set_match: [token][buffer type][max matches] -> [n][n x (pattern, offset, length)]
+//   pattern_set_delete: [token]
+class PatternSetFactory : public Logger::Loggable<Logger::Id::wasm> {
+protected:
+  class PatternSetContext : public StorageObject {
+  public:
+    uint32_t createToken() {
+      uint32_t token = next_token_++;
+      while (matchers_.contains(token)) {
+        token = next_token_++;
+      }
+      return token;
+    }
+    const MultiPatternMatcher* getMatcher(uint32_t token) {
+      auto it = matchers_.find(token);
+      return it == matchers_.end() ? nullptr : it->second.get();
+    }
+    void setMatcher(uint32_t token, MultiPatternMatcherPtr matcher) {
+      matchers_[token] = std::move(matcher);
+    }
+    void deleteMatcher(uint32_t token) { matchers_.erase(token); }
+
+  private:
+    uint32_t next_token_ = 0;
+    absl::flat_hash_map<uint32_t, MultiPatternMatcherPtr> matchers_;
+  };
+
+  static PatternSetContext& getOrCreateContext(ContextBase* context_base) {
+    auto context = static_cast<Context*>(context_base);
+    std::string data_name = "pattern_set";
+    auto pattern_context = context->getForeignData<PatternSetContext>(data_name);
+    if (!pattern_context) {
+      auto new_context = std::make_unique<PatternSetContext>();
+      pattern_context = new_context.get();
+      context->setForeignData(data_name, std::move(new_context));
+    }
+    return *pattern_context;
+  }
+
+  static uint32_t readUint32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+};
+
+class CreatePatternSetFactory : public PatternSetFactory {
+public:
+  WasmForeignFunction create(std::shared_ptr<CreatePatternSetFactory> self) const {
+    WasmForeignFunction f =
+        [self](WasmBase&, absl::string_view arguments,
+               const std::function<void*(size_t size)>& alloc_result) -> WasmResult {
+      if (arguments.size() < 2 * sizeof(uint32_t)) {
+        return WasmResult::BadArgument;
+      }
+      const bool case_insensitive = readUint32(arguments.data()) & 1;
+      const uint32_t n = readUint32(arguments.data() + sizeof(uint32_t));
+      const char* p = arguments.data() + 2 * sizeof(uint32_t);
+      const char* end = arguments.data() + arguments.size();
+      if (n > static_cast<size_t>(end - p) / (2 * sizeof(uint32_t))) {
+        return WasmResult::BadArgument;
+      }
+      const char* pattern_data = p + n * 2 * sizeof(uint32_t);
+      std::vector<MultiPatternMatcher::Pattern> patterns;
+      patterns.reserve(n);
+      for (uint32_t i = 0; i < n; i++, p += 2 * sizeof(uint32_t)) {
+        const uint32_t type = readUint32(p);
+        const uint32_t size = readUint32(p + sizeof(uint32_t));
+        if (type > 1 || size > static_cast<size_t>(end - pattern_data)) {
+          return WasmResult::BadArgument;
+        }
+        patterns.push_back({type == 1, std::string(pattern_data, size)});
+        pattern_data += size;
+      }
+      std::string error;
+      auto matcher = MultiPatternMatcher::create(patterns, case_insensitive, &error);
+      if (!matcher) {
+        ENVOY_LOG(info, "pattern_set_create error: {}", error);
+        return WasmResult::BadArgument;
+      }
+      auto& pattern_context = getOrCreateContext(proxy_wasm::current_context_->root_context());
+      auto token = pattern_context.createToken();
+      pattern_context.setMatcher(token, std::move(matcher));
+      auto result = reinterpret_cast<uint32_t*>(alloc_result(sizeof(uint32_t)));
+      *result = token;
+      return WasmResult::Ok;
+    };
+    return f;
+  }
+};
+RegisterForeignFunction
+    registerCreatePatternSetForeignFunction("pattern_set_create",
+                                            createFromClass<CreatePatternSetFactory>());
+
+class MatchPatternSetFactory : public PatternSetFactory {
+public:
+  WasmForeignFunction create(std::shared_ptr<MatchPatternSetFactory> self) const {
+    WasmForeignFunction f =
+        [self](WasmBase&, absl::string_view arguments,
+               const std::function<void*(size_t size)>& alloc_result) -> WasmResult {
+      if (arguments.size() != 3 * sizeof(uint32_t)) {
+        return WasmResult::BadArgument;
+      }
+      const uint32_t token = readUint32(arguments.data());
+      const uint32_t type = readUint32(arguments.data() + sizeof(uint32_t));
+      const uint32_t max_matches = readUint32(arguments.data() + 2 * sizeof(uint32_t));
+      if (type > static_cast<uint32_t>(WasmBufferType::MAX)) {
+        return WasmResult::BadArgument;
+      }
+      auto& pattern_context = getOrCreateContext(proxy_wasm::current_context_->root_context());
+      auto matcher = pattern_context.getMatcher(token);
+      if (!matcher) {
+        return WasmResult::NotFound;
+      }
+      auto context = static_cast<Context*>(proxy_wasm::current_context_);
+      auto buffer = static_cast<Buffer*>(context->getBuffer(static_cast<WasmBufferType>(type)));
+      if (!buffer) {
+        return WasmResult::NotFound;
+      }
+      // The buffer is scanned where it lies: only the matches are copied into the VM.
+      std::vector<MultiPatternMatcher::Match> matches;
+      const auto slices = buffer->slices();
+      matcher->match(slices, max_matches, &matches);
+      const size_t size = (1 + 3 * matches.size()) * sizeof(uint32_t);
+      auto result = static_cast<char*>(alloc_result(size));
+      const uint32_t n = matches.size();
+      memcpy(result, &n, sizeof(n));
+      char* p = result + sizeof(uint32_t);
+      for (const auto& m : matches) {
+        const uint32_t values[3] = {m.pattern, static_cast<uint32_t>(m.offset),
+                                    static_cast<uint32_t>(m.length)};
+        memcpy(p, values, sizeof(values));
+        p += sizeof(values);
+      }
+      return WasmResult::Ok;
+    };
+    return f;
+  }
+};
+RegisterForeignFunction
+    registerMatchPatternSetForeignFunction("pattern_set_match",
+                                           createFromClass<MatchPatternSetFactory>());
+
+class DeletePatternSetFactory : public PatternSetFactory {
+public:
+  WasmForeignFunction create(std::shared_ptr<DeletePatternSetFactory> self) const {
+    WasmForeignFunction f = [self](WasmBase&, absl::string_view arguments,
+                                   const std::function<void*(size_t size)>&) -> WasmResult {
+      if (arguments.size() != sizeof(uint32_t)) {
+        return WasmResult::BadArgument;
+      }
+      auto& pattern_context = getOrCreateContext(proxy_wasm::current_context_->root_context());
+      pattern_context.deleteMatcher(readUint32(arguments.data()));
+      return WasmResult::Ok;
+    };
+    return f;
+  }
+};
+RegisterForeignFunction
+    registerDeletePatternSetForeignFunction("pattern_set_delete",
+                                            createFromClass<DeletePatternSetFactory>());
+
 // TODO(kyessenov) The factories should be separated into individual compilation units.
 // TODO(kyessenov) Leverage the host argument marshaller instead of the protobuf argument list.
 class DeclarePropertyFactory {
@@ -0,0 +1,198 @@
+#include "extensions/common/wasm/pattern_matcher.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+
+std::unique_ptr<MultiPatternMatcher>
+MultiPatternMatcher::create(const std::vector<Pattern>& patterns, bool case_insensitive,
+                            std::string* error) {
+  auto matcher = std::unique_ptr<MultiPatternMatcher>(new MultiPatternMatcher());
+  matcher->literal_lengths_.resize(patterns.size());
+
+  // Assign the byte classes first so that the transition table has its final width.
+  for (const auto& p : patterns) {
+    if (p.regex) {
+      continue;
+    }
+    if (p.pattern.empty()) {
+      *error = "empty literal pattern";
+      return nullptr;
+    }
+    for (char c : p.pattern) {
+      const uint8_t b = case_insensitive ? absl::ascii_tolower(c) : c;
+      if (!matcher->byte_classes_[b]) {
+        matcher->byte_classes_[b] = matcher->num_classes_++;
+      }
+    }
+  }
+  if (case_insensitive) {
+    for (char c = 'A'; c <= 'Z'; c++) {
+      matcher->byte_classes_[static_cast<uint8_t>(c)] =
+          matcher->byte_classes_[static_cast<uint8_t>(absl::ascii_tolower(c))];
+    }
+  }
+  matcher->transitions_.assign(matcher->num_classes_, -1);
+  matcher->outputs_.emplace_back();
+  matcher->output_links_.push_back(-1);
+  matcher->first_outputs_.push_back(-1);
+
+  re2::RE2::Options options;
+  options.set_case_sensitive(!case_insensitive);
+  options.set_log_errors(false);
+  for (uint32_t i = 0; i < patterns.size(); i++) {
+    const auto& p = patterns[i];
+    if (!p.regex) {
+      if (!matcher->addLiteral(i, p.pattern)) {
+        *error = "literal patterns exceed the memory budget";
+        return nullptr;
+      }
+      continue;
+    }
+    if (!matcher->regex_set_) {
+      matcher->regex_set_ = std::make_unique<re2::RE2::Set>(options, re2::RE2::UNANCHORED);
+    }
+    std::string regex_error;
+    if (matcher->regex_set_->Add(re2::StringPiece(p.pattern.data(), p.pattern.size()),
+                                 &regex_error) < 0) {
+      *error = absl::StrCat("invalid regex pattern ", i, ": ", regex_error);
+      return nullptr;
+    }
+    matcher->regexes_.emplace_back(i, std::make_unique<re2::RE2>(p.pattern, options));
+  }
+  if (matcher->regex_set_ && !matcher->regex_set_->Compile()) {
+    *error = "regex patterns exceed the memory budget";
+    return nullptr;
+  }
+  matcher->compileLiterals();
+  return matcher;
+}
+
+bool MultiPatternMatcher::addLiteral(uint32_t pattern, absl::string_view literal) {
+  uint32_t state = 0;
+  for (char c : literal) {
+    const uint32_t byte_class = byte_classes_[static_cast<uint8_t>(c)];
+    int32_t next = transition(state, byte_class);
+    if (next < 0) {
+      if ((transitions_.size() + num_classes_) * sizeof(int32_t) > MaxAutomatonBytes) {
+        return false;
+      }
+      next = outputs_.size();
+      transition(state, byte_class) = next;
+      transitions_.resize(transitions_.size() + num_classes_, -1);
+      outputs_.emplace_back();
+      output_links_.push_back(-1);
+      first_outputs_.push_back(-1);
+    }
+    state = next;
+  }
+  outputs_[state].push_back(pattern);
+  first_outputs_[state] = state;
+  literal_lengths_[pattern] = literal.size();
+  has_literals_ = true;
+  return true;
+}
+
+// Completes the trie into a DFA by breadth first traversal: a missing transition follows the
+// failure link, i.e. the longest proper suffix of the state which is also in the trie.
+void MultiPatternMatcher::compileLiterals() {
+  std::vector<uint32_t> failure(outputs_.size(), 0);
+  std::deque<uint32_t> queue;
+  for (uint32_t c = 0; c < num_classes_; c++) {
+    int32_t& next = transition(0, c);
+    if (next < 0) {
+      next = 0;
+    } else {
+      queue.push_back(next);
+    }
+  }
+  while (!queue.empty()) {
+    const uint32_t state = queue.front();
+    queue.pop_front();
+    for (uint32_t c = 0; c < num_classes_; c++) {
+      const int32_t next = transition(state, c);
+      const int32_t fallback = transition(failure[state], c);
+      if (next < 0) {
+        transition(state, c) = fallback;
+        continue;
+      }
+      failure[next] = fallback;
+      output_links_[next] = first_outputs_[fallback];
+      if (outputs_[next].empty()) {
+        first_outputs_[next] = output_links_[next];
+      }
+      queue.push_back(next);
+    }
+  }
+}
+
+void MultiPatternMatcher::match(absl::Span<const absl::string_view> slices,
+                                uint32_t max_matches, std::vector<Match>* matches) const {
+  uint32_t count = 0;
+  if (count == max_matches) {
+    return;
+  }
+  if (has_literals_) {
+    uint32_t state = 0;
+    uint64_t position = 0;
+    for (const auto& slice : slices) {
+      for (char c : slice) {
+        state = transitions_[state * num_classes_ + byte_classes_[static_cast<uint8_t>(c)]];
+        position++;
+        for (int32_t s = first_outputs_[state]; s >= 0; s = output_links_[s]) {
+          for (uint32_t pattern : outputs_[s]) {
+            matches->push_back({pattern, position - literal_lengths_[pattern],
+                                literal_lengths_[pattern]});
+            if (++count == max_matches) {
+              return;
+            }
+          }
+        }
+      }
+    }
+  }
+  if (!regex_set_) {
+    return;
+  }
+  // RE2 needs contiguous data, so multi-slice data is copied (natively) for the regexes.
+  std::string contiguous;
+  absl::string_view data;
+  if (slices.size() == 1) {
+    data = slices[0];
+  } else {
+    for (const auto& slice : slices) {
+      contiguous.append(slice.data(), slice.size());
+    }
+    data = contiguous;
+  }
+  const re2::StringPiece input(data.data(), data.size());
+  std::vector<int> ids;
+  if (!regex_set_->Match(input, &ids)) {
+    return;
+  }
+  std::sort(ids.begin(), ids.end());
+  for (int id : ids) {
+    const auto& regex = regexes_[id];
+    re2::StringPiece found;
+    if (!regex.second->Match(input, 0, input.size(), re2::RE2::UNANCHORED, &found, 1)) {
+      continue;
+    }
+    matches->push_back({regex.first, static_cast<uint64_t>(found.data() - input.data()),
+                        static_cast<uint64_t>(found.size())});
+    if (++count == max_matches) {
+      return;
+    }
+  }
+}
+
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
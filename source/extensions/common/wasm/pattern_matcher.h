@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+
+/**
+ * A set of literal and regex patterns compiled once so that data can be scanned for all of them in
+ * a single native pass, e.g. for plugins looking for signatures in request bodies. Literals are
+ * compiled into an Aho-Corasick automaton which is run over the data slice by slice, so matches
+ * spanning slices are found without the data being made contiguous. Regexes are compiled into an
+ * RE2::Set, which requires contiguous data.
+ */
+class MultiPatternMatcher {
+public:
+  struct Pattern {
+    bool regex;
+    std::string pattern;
+  };
+
+  struct Match {
+    uint32_t pattern; // Index of the pattern in the set.
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  // Bound on the transition table of the literals' automaton, which takes 4 bytes per state (up to
+  // one per literal byte) and byte class (up to one per distinct literal byte).
+  static constexpr uint64_t MaxAutomatonBytes = 16 * 1024 * 1024;
+
+  /**
+   * @return the compiled matcher or nullptr with the reason in error if a pattern is invalid or
+   * the patterns exceed the memory budget.
+   */
+  static std::unique_ptr<MultiPatternMatcher> create(const std::vector<Pattern>& patterns,
+                                                     bool case_insensitive, std::string* error);
+
+  /**
+   * Scans the slices as a single stream and appends up to max_matches matches: every occurrence
+   * of each literal in order of the end of the occurrence, then the leftmost match of each regex
+   * which matches.
+   */
+  void match(absl::Span<const absl::string_view> slices, uint32_t max_matches,
+             std::vector<Match>* matches) const;
+
+  bool hasRegexes() const { return !regexes_.empty(); }
+
+private:
+  MultiPatternMatcher() = default;
+
+  bool addLiteral(uint32_t pattern, absl::string_view literal);
+  void compileLiterals();
+  int32_t& transition(uint32_t state, uint32_t byte_class) {
+    return transitions_[state * num_classes_ + byte_class];
+  }
+
+  // Bytes which do not occur in any literal share class 0.
+  std::array<uint16_t, 256> byte_classes_{};
+  uint32_t num_classes_{1};
+
+  // The automaton: a complete DFA over byte classes with state 0 as the root.
+  std::vector<int32_t> transitions_;
+  // Literals ending at each state and the nearest state strictly reachable by failure links which
+  // has literals ending at it (or -1). first_outputs_ is the state itself if it has literals and
+  // its output link otherwise, so that a single load per byte tells whether anything matched.
+  std::vector<std::vector<uint32_t>> outputs_;
+  std::vector<int32_t> output_links_;
+  std::vector<int32_t> first_outputs_;
+  std::vector<uint32_t> literal_lengths_; // Indexed by pattern.
+  bool has_literals_{false};
+
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  std::vector<std::pair<uint32_t, std::unique_ptr<re2::RE2>>> regexes_; // (pattern, regex)
+};
+
+using MultiPatternMatcherPtr = std::unique_ptr<MultiPatternMatcher>;
+
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
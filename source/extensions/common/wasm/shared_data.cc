@@ -0,0 +1,174 @@
+#include "extensions/common/wasm/shared_data.h"
+
+#include <algorithm>
+
+#include "common/common/macros.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/hash/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+
+using proxy_wasm::WasmResult;
+
+uint32_t SharedData::stripeIndex(absl::string_view vm_id, absl::string_view key) {
+  return absl::Hash<std::pair<absl::string_view, absl::string_view>>()({vm_id, key}) % NumStripes;
+}
+
+void SharedData::assign(Entry& entry, absl::string_view value,
+                        PendingNotifications& notifications) {
+  entry.value_.assign(value.data(), value.size());
+  if (++entry.cas_ == 0) {
+    entry.cas_ = 1;
+  }
+  for (const WatchSharedPtr& watch : entry.watches_) {
+    if (!watch->pending_.exchange(true, std::memory_order_acq_rel)) {
+      notifications.push_back(watch);
+    }
+  }
+}
+
+// Posting is done outside of the stripe locks to keep them short. Posted notifications only hold a
+// weak reference to their watch, so that they neither keep it alive nor run once it is removed.
+void SharedData::notify(PendingNotifications& notifications) {
+  for (WatchSharedPtr& watch : notifications) {
+    Thread::LockGuard lock(watch->mutex_);
+    if (watch->removed_) {
+      continue;
+    }
+    watch->dispatcher_.post([weak_watch = std::weak_ptr<Watch>(watch)]() {
+      auto watch = weak_watch.lock();
+      if (!watch) {
+        return;
+      }
+      // Cleared first, so that sets made by or during cb are notified again.
+      watch->pending_.store(false, std::memory_order_release);
+      watch->cb_();
+    });
+  }
+}
+
+WasmResult SharedData::get(absl::string_view vm_id, absl::string_view key,
+                           std::pair<std::string, uint32_t>* data) {
+  Stripe& stripe = stripes_[stripeIndex(vm_id, key)];
+  Thread::LockGuard lock(stripe.mutex_);
+  auto vm = stripe.vms_.find(vm_id);
+  if (vm == stripe.vms_.end()) {
+    return WasmResult::NotFound;
+  }
+  auto it = vm->second.find(key);
+  if (it == vm->second.end() || it->second.cas_ == 0) {
+    return WasmResult::NotFound;
+  }
+  data->first = it->second.value_;
+  data->second = it->second.cas_;
+  return WasmResult::Ok;
+}
+
+WasmResult SharedData::set(absl::string_view vm_id, absl::string_view key,
+                           absl::string_view value, uint32_t cas) {
+  PendingNotifications notifications;
+  {
+    Stripe& stripe = stripes_[stripeIndex(vm_id, key)];
+    Thread::LockGuard lock(stripe.mutex_);
+    auto& entry = stripe.vms_[vm_id][key];
+    if (cas && entry.cas_ && cas != entry.cas_) {
+      return WasmResult::CasMismatch;
+    }
+    assign(entry, value, notifications);
+  }
+  notify(notifications);
+  return WasmResult::Ok;
+}
+
+WasmResult SharedData::set(absl::string_view vm_id, absl::Span<const Update> updates) {
+  // Lock every stripe involved in increasing index order so that concurrent batches can not
+  // deadlock.
+  absl::InlinedVector<uint32_t, 16> indices;
+  indices.reserve(updates.size());
+  for (auto& u : updates) {
+    indices.push_back(stripeIndex(vm_id, u.key));
+  }
+  absl::InlinedVector<uint32_t, 16> locked(indices.begin(), indices.end());
+  std::sort(locked.begin(), locked.end());
+  locked.erase(std::unique(locked.begin(), locked.end()), locked.end());
+  for (uint32_t i : locked) {
+    stripes_[i].mutex_.lock();
+  }
+  WasmResult result = WasmResult::Ok;
+  for (size_t i = 0; i < updates.size(); i++) {
+    if (!updates[i].cas) {
+      continue;
+    }
+    auto& vms = stripes_[indices[i]].vms_;
+    auto vm = vms.find(vm_id);
+    if (vm == vms.end()) {
+      continue;
+    }
+    auto it = vm->second.find(updates[i].key);
+    if (it != vm->second.end() && it->second.cas_ && it->second.cas_ != updates[i].cas) {
+      result = WasmResult::CasMismatch;
+      break;
+    }
+  }
+  PendingNotifications notifications;
+  if (result == WasmResult::Ok) {
+    for (size_t i = 0; i < updates.size(); i++) {
+      assign(stripes_[indices[i]].vms_[vm_id][updates[i].key], updates[i].value, notifications);
+    }
+  }
+  for (uint32_t i : locked) {
+    stripes_[i].mutex_.unlock();
+  }
+  notify(notifications);
+  return result;
+}
+
+SharedData::WatchHandlePtr SharedData::watch(absl::string_view vm_id, absl::string_view key,
+                                             Event::Dispatcher& dispatcher,
+                                             std::function<void()> cb) {
+  auto watch = std::make_shared<Watch>(dispatcher, std::move(cb));
+  {
+    Stripe& stripe = stripes_[stripeIndex(vm_id, key)];
+    Thread::LockGuard lock(stripe.mutex_);
+    stripe.vms_[vm_id][key].watches_.push_back(watch);
+  }
+  return std::make_unique<WatchHandle>(*this, vm_id, key, std::move(watch));
+}
+
+void SharedData::unwatch(absl::string_view vm_id, absl::string_view key,
+                         const WatchSharedPtr& watch) {
+  {
+    Thread::LockGuard lock(watch->mutex_);
+    watch->removed_ = true;
+  }
+  Stripe& stripe = stripes_[stripeIndex(vm_id, key)];
+  Thread::LockGuard lock(stripe.mutex_);
+  auto vm = stripe.vms_.find(vm_id);
+  if (vm == stripe.vms_.end()) {
+    return;
+  }
+  auto it = vm->second.find(key);
+  if (it == vm->second.end()) {
+    return;
+  }
+  auto& watches = it->second.watches_;
+  watches.erase(std::remove(watches.begin(), watches.end(), watch), watches.end());
+  // Keys which were only watched go away with their last watch.
+  if (it->second.cas_ == 0 && watches.empty()) {
+    vm->second.erase(it);
+    if (vm->second.empty()) {
+      stripe.vms_.erase(vm);
+    }
+  }
+}
+
+SharedData& globalSharedData() { MUTABLE_CONSTRUCT_ON_FIRST_USE(SharedData); }
+
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "include/proxy-wasm/wasm.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace Wasm {
+
+/**
+ * Process-wide key/value store backing proxy_get_shared_data and proxy_set_shared_data, scoped by
+ * vm_id. Keys are spread over independently locked stripes so that workers only contend when they
+ * touch keys in the same stripe. Every value has a version (cas) which is bumped by each set and
+ * can be used for optimistic concurrency control.
+ */
+class SharedData {
+public:
+  static constexpr uint32_t NumStripes = 64;
+
+  class WatchHandle;
+  using WatchHandlePtr = std::unique_ptr<WatchHandle>;
+
+  struct Update {
+    absl::string_view key;
+    absl::string_view value;
+    uint32_t cas; // 0 to set unconditionally.
+  };
+
+  /**
+   * @return NotFound if the key has never been set.
+   */
+  proxy_wasm::WasmResult get(absl::string_view vm_id, absl::string_view key,
+                             std::pair<std::string, uint32_t>* data);
+
+  /**
+   * @return CasMismatch if cas is non-zero and the key has been set since the version cas was
+   * read.
+   */
+  proxy_wasm::WasmResult set(absl::string_view vm_id, absl::string_view key,
+                             absl::string_view value, uint32_t cas);
+
+  /**
+   * Applies all of the updates atomically: nothing is changed unless the cas of every update
+   * matches. Updates later in the span win over earlier ones for the same key.
+   */
+  proxy_wasm::WasmResult set(absl::string_view vm_id, absl::Span<const Update> updates)
+      ABSL_NO_THREAD_SAFETY_ANALYSIS;
+
+  /**
+   * Posts cb to dispatcher when the key is set. Sets made before a posted cb has run are coalesced
+   * into it. The watch is removed when the returned handle is destroyed: nothing is posted to
+   * dispatcher afterwards, and a cb posted before does not run, so the handle must not outlive
+   * dispatcher.
+   */
+  WatchHandlePtr watch(absl::string_view vm_id, absl::string_view key,
+                       Event::Dispatcher& dispatcher, std::function<void()> cb);
+
+private:
+  struct Watch {
+    Watch(Event::Dispatcher& dispatcher, std::function<void()> cb)
+        : dispatcher_(dispatcher), cb_(std::move(cb)) {}
+
+    Event::Dispatcher& dispatcher_;
+    const std::function<void()> cb_;
+    // Set while a notification has been posted and has not run yet. Sets made meanwhile are
+    // covered by that notification, so a watcher has at most one notification queued.
+    std::atomic<bool> pending_{false};
+    // Notifications are posted under this lock, and never once the watch is removed.
+    Thread::MutexBasicLockable mutex_;
+    bool removed_ ABSL_GUARDED_BY(mutex_){false};
+  };
+  using WatchSharedPtr = std::shared_ptr<Watch>;
+
+  struct Entry {
+    std::string value_;
+    uint32_t cas_{0}; // 0 until the key is first set.
+    std::vector<WatchSharedPtr> watches_;
+  };
+
+  struct Stripe {
+    Thread::MutexBasicLockable mutex_;
+    absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, Entry>>
+        vms_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  using PendingNotifications = std::vector<WatchSharedPtr>;
+
+  static uint32_t stripeIndex(absl::string_view vm_id, absl::string_view key);
+  void unwatch(absl::string_view vm_id, absl::string_view key, const WatchSharedPtr& watch);
+  static void assign(Entry& entry, absl::string_view value, PendingNotifications& notifications);
+  static void notify(PendingNotifications& notifications);
+
+  std::array<Stripe, NumStripes> stripes_;
+};
+
+/**
+ * Removes its watch when destroyed.
+ */
+class SharedData::WatchHandle {
+public:
+  WatchHandle(SharedData& shared_data, absl::string_view vm_id, absl::string_view key,
+              WatchSharedPtr watch)
+      : shared_data_(shared_data), vm_id_(vm_id), key_(key), watch_(std::move(watch)) {}
+  ~WatchHandle() { shared_data_.unwatch(vm_id_, key_, watch_); }
+
+private:
+  SharedData& shared_data_;
+  const std::string vm_id_;
+  const std::string key_;
+  const WatchSharedPtr watch_;
+};
+
+SharedData& globalSharedData();
+
+} // namespace Wasm
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
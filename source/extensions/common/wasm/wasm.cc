@@ -2,14 +2,22 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <deque>
 
 #include "envoy/event/deferred_deletable.h"
 
+#include "common/common/hex.h"
 #include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/init/target_impl.h"
 
 #include "extensions/common/wasm/wasm_extension.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "openssl/sha.h"
 
 #define WASM_CONTEXT(_c)                                                                           \
   static_cast<Context*>(proxy_wasm::exports::ContextOrEffectiveContext(                            \
@@ -66,6 +74,348 @@ inline Wasm* getWasm(WasmHandleSharedPtr& base_wasm_handle) {
   return static_cast<Wasm*>(base_wasm_handle->wasm().get());
 }
 
+class BackgroundCompiler;
+
+// Wraps a VM whose code was compiled on the background compiler thread, so that the load() of that
+// code by WasmBase::initialize() on the main thread reuses the compilation instead of compiling the
+// code again. The module is run by a clone of the compiled VM created on the main thread, as some
+// runtimes (e.g. V8) tie the store of a VM to the thread which created it: the compiled VM is only
+// the source of the clones made for the worker threads, and is handed back to the compiler thread
+// to be destroyed there. Everything else, in particular linking and instantiating the module, is
+// forwarded to the VM running the module on the calling thread.
+class PrecompiledWasmVm : public proxy_wasm::WasmVm {
+public:
+  PrecompiledWasmVm(WasmVmPtr compiled_vm, std::shared_ptr<const std::string> code,
+                    bool allow_precompiled, std::shared_ptr<BackgroundCompiler> compiler);
+  ~PrecompiledWasmVm() override;
+
+  // proxy_wasm::WasmVm
+  absl::string_view runtime() override { return running_vm_->runtime(); }
+  proxy_wasm::Cloneable cloneable() override { return compiled_vm_->cloneable(); }
+  std::unique_ptr<proxy_wasm::WasmVm> clone() override { return compiled_vm_->clone(); }
+  bool load(const std::string& code, bool allow_precompiled) override {
+    if (code_ != nullptr && code == *code_ && allow_precompiled == allow_precompiled_) {
+      code_.reset();
+      return true;
+    }
+    return running_vm_->load(code, allow_precompiled);
+  }
+  proxy_wasm::AbiVersion getAbiVersion() override { return running_vm_->getAbiVersion(); }
+  bool link(absl::string_view debug_name) override { return running_vm_->link(debug_name); }
+  uint64_t getMemorySize() override { return running_vm_->getMemorySize(); }
+  std::optional<absl::string_view> getMemory(uint64_t pointer, uint64_t size) override {
+    return running_vm_->getMemory(pointer, size);
+  }
+  bool setMemory(uint64_t pointer, uint64_t size, const void* data) override {
+    return running_vm_->setMemory(pointer, size, data);
+  }
+  bool getWord(uint64_t pointer, Word* data) override {
+    return running_vm_->getWord(pointer, data);
+  }
+  bool setWord(uint64_t pointer, Word data) override { return running_vm_->setWord(pointer, data); }
+  // Clones do not keep the code, which the compiled VM does.
+  absl::string_view getCustomSection(absl::string_view name) override {
+    return compiled_vm_->getCustomSection(name);
+  }
+  absl::string_view getPrecompiledSectionName() override {
+    return running_vm_->getPrecompiledSectionName();
+  }
+#define _FORWARD_GET_FUNCTION(_T)                                                                  \
+  void getFunction(absl::string_view function_name, _T* f) override {                             \
+    running_vm_->getFunction(function_name, f);                                                    \
+  }
+  FOR_ALL_WASM_VM_EXPORTS(_FORWARD_GET_FUNCTION)
+#undef _FORWARD_GET_FUNCTION
+#define _FORWARD_REGISTER_CALLBACK(_T)                                                             \
+  void registerCallback(absl::string_view module_name, absl::string_view function_name,           \
+                        _T function,                                                               \
+                        typename proxy_wasm::ConvertFunctionTypeWordToUint32<_T>::type f)          \
+      override {                                                                                   \
+    running_vm_->registerCallback(module_name, function_name, function, f);                        \
+  }
+  FOR_ALL_WASM_VM_IMPORTS(_FORWARD_REGISTER_CALLBACK)
+#undef _FORWARD_REGISTER_CALLBACK
+
+private:
+  class ForwardingVmIntegration : public proxy_wasm::WasmVmIntegration {
+  public:
+    explicit ForwardingVmIntegration(proxy_wasm::WasmVm& wasm_vm) : wasm_vm_(wasm_vm) {}
+
+    // proxy_wasm::WasmVmIntegration
+    proxy_wasm::WasmVmIntegration* clone() override { return wasm_vm_.integration()->clone(); }
+    bool getNullVmFunction(absl::string_view function_name, bool returns_word,
+                           int number_of_arguments, proxy_wasm::NullPlugin* plugin,
+                           void* ptr_to_function_return) override {
+      return wasm_vm_.integration()->getNullVmFunction(function_name, returns_word,
+                                                       number_of_arguments, plugin,
+                                                       ptr_to_function_return);
+    }
+    void error(absl::string_view message) override { wasm_vm_.integration()->error(message); }
+
+  private:
+    proxy_wasm::WasmVm& wasm_vm_;
+  };
+
+  WasmVmPtr compiled_vm_;
+  WasmVmPtr running_vm_;
+  // The code compiled in the background, until it is loaded.
+  std::shared_ptr<const std::string> code_;
+  const bool allow_precompiled_;
+  const std::shared_ptr<BackgroundCompiler> compiler_;
+};
+
+std::mutex background_compile_hook_mutex;
+std::function<void()>* background_compile_hook_for_testing = nullptr;
+
+// Thread on which the VMs of new base Wasms are created and their code compiled when
+// VmConfig.compile_in_background is set, and on which these VMs are eventually destroyed. It is
+// shared by all the pending compilations and the VMs compiled on it, and joined once none is left.
+class BackgroundCompiler {
+public:
+  explicit BackgroundCompiler(Thread::ThreadFactory& thread_factory)
+      : thread_(thread_factory.createThread([this]() -> void { run(); },
+                                            Thread::Options{"WasmCompile"})) {}
+  ~BackgroundCompiler() {
+    {
+      Thread::LockGuard lock(mutex_);
+      shutdown_ = true;
+      wakeup_.notifyOne();
+    }
+    // Waits for the queued jobs, which are either cancelled compilations or VMs to destroy.
+    thread_->join();
+  }
+
+  void post(std::function<void()> job) {
+    Thread::LockGuard lock(mutex_);
+    jobs_.push_back(std::move(job));
+    wakeup_.notifyOne();
+  }
+
+  // Destroys a VM created on this thread.
+  void destroy(WasmVmPtr wasm_vm) {
+    auto shared_vm = std::make_shared<WasmVmPtr>(std::move(wasm_vm));
+    post([shared_vm]() { shared_vm->reset(); });
+  }
+
+private:
+  void run() {
+    while (true) {
+      std::function<void()> job;
+      {
+        Thread::LockGuard lock(mutex_);
+        while (jobs_.empty() && !shutdown_) {
+          wakeup_.wait(mutex_);
+        }
+        if (jobs_.empty()) {
+          return;
+        }
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+      }
+      job();
+    }
+  }
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar wakeup_;
+  std::deque<std::function<void()>> jobs_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){false};
+  // Must be last so that the members above are initialized before the thread starts.
+  Thread::ThreadPtr thread_;
+};
+
+std::weak_ptr<BackgroundCompiler>* background_compiler = nullptr;
+
+std::shared_ptr<BackgroundCompiler> getBackgroundCompiler(Api::Api& api) {
+  if (!background_compiler) {
+    background_compiler = new std::weak_ptr<BackgroundCompiler>();
+  }
+  auto compiler = background_compiler->lock();
+  if (!compiler) {
+    compiler = std::make_shared<BackgroundCompiler>(api.threadFactory());
+    *background_compiler = compiler;
+  }
+  return compiler;
+}
+
+PrecompiledWasmVm::PrecompiledWasmVm(WasmVmPtr compiled_vm, std::shared_ptr<const std::string> code,
+                                     bool allow_precompiled,
+                                     std::shared_ptr<BackgroundCompiler> compiler)
+    : compiled_vm_(std::move(compiled_vm)), running_vm_(compiled_vm_->clone()),
+      code_(std::move(code)), allow_precompiled_(allow_precompiled),
+      compiler_(std::move(compiler)) {
+  // The running VM reports its errors and failures through this one, which WasmBase knows.
+  integration() = std::move(running_vm_->integration());
+  running_vm_->integration() = std::make_unique<ForwardingVmIntegration>(*this);
+  running_vm_->setFailCallback([this](FailState fail_state) {
+    failed_ = fail_state;
+    if (fail_callback_) {
+      fail_callback_(fail_state);
+    }
+  });
+}
+
+PrecompiledWasmVm::~PrecompiledWasmVm() {
+  running_vm_.reset();
+  compiler_->destroy(std::move(compiled_vm_));
+}
+
+// A compilation on the background compiler thread, shared with the CreateWasmHandle of its owner.
+struct BackgroundCompile {
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar handed_off_cond_;
+  bool cancelled_ ABSL_GUARDED_BY(mutex_){false};
+  // The VM compiled on the compiler thread, if any, while it is handed to the main thread. The
+  // compiler thread waits until the main thread has taken it, or has given up on it, in which case
+  // the VM is destroyed on the compiler thread.
+  WasmVmPtr compiled_vm_ ABSL_GUARDED_BY(mutex_);
+  bool handed_off_ ABSL_GUARDED_BY(mutex_){false};
+  // The members below are only accessed on the main thread, where they are released either when
+  // the compilation completes or when it is cancelled.
+  std::function<void(WasmVmPtr compiled_vm, std::shared_ptr<BackgroundCompiler> compiler)>
+      on_compiled_;
+  std::shared_ptr<BackgroundCompiler> compiler_;
+};
+using BackgroundCompileSharedPtr = std::shared_ptr<BackgroundCompile>;
+
+// Posted by the compiler thread to hand the compiled VM over to the main thread. If it is dropped
+// without having run, e.g. with the dispatcher, the compiler thread keeps the VM and destroys it.
+class BackgroundCompileHandoff {
+public:
+  explicit BackgroundCompileHandoff(BackgroundCompileSharedPtr compile)
+      : compile_(std::move(compile)) {}
+  ~BackgroundCompileHandoff() { handOff(); }
+
+  void run() {
+    WasmVmPtr compiled_vm = handOff();
+    auto on_compiled = std::move(compile_->on_compiled_);
+    compile_->on_compiled_ = nullptr;
+    auto compiler = std::move(compile_->compiler_);
+    compile_->compiler_.reset();
+    if (on_compiled) {
+      on_compiled(std::move(compiled_vm), std::move(compiler));
+    }
+  }
+
+private:
+  // Takes the compiled VM, unless the compilation was cancelled meanwhile.
+  WasmVmPtr handOff() {
+    Thread::LockGuard lock(compile_->mutex_);
+    if (compile_->handed_off_) {
+      return nullptr;
+    }
+    compile_->handed_off_ = true;
+    compile_->handed_off_cond_.notifyOne();
+    return compile_->cancelled_ ? nullptr : std::move(compile_->compiled_vm_);
+  }
+
+  const BackgroundCompileSharedPtr compile_;
+};
+
+class BackgroundCompileHandle : public CreateWasmHandle {
+public:
+  explicit BackgroundCompileHandle(BackgroundCompileSharedPtr compile)
+      : compile_(std::move(compile)) {}
+  ~BackgroundCompileHandle() override {
+    {
+      Thread::LockGuard lock(compile_->mutex_);
+      compile_->cancelled_ = true;
+      compile_->handed_off_cond_.notifyOne();
+    }
+    // The callback may reference the owner, which is going away.
+    compile_->on_compiled_ = nullptr;
+    compile_->compiler_.reset();
+  }
+
+private:
+  const BackgroundCompileSharedPtr compile_;
+};
+
+// Holds the initialization of the listener (or server) until a VM compiled in the background is
+// ready or has failed.
+class BackgroundInitTarget {
+public:
+  explicit BackgroundInitTarget(absl::string_view name)
+      : target_(absl::StrCat("Wasm ", name), [this]() {
+          if (done_) {
+            target_.ready();
+          }
+        }) {}
+
+  const Init::Target& target() const { return target_; }
+  void ready() {
+    done_ = true;
+    target_.ready();
+  }
+
+private:
+  bool done_{false};
+  Init::TargetImpl target_;
+};
+
+// Remotely fetched code may also be persisted in VmConfig.code_cache_directory, named by its
+// sha256, so that it survives restarts. Returns an empty path if the on-disk cache is not
+// configured.
+std::string codeCacheFilePath(const VmConfig& vm_config) {
+  const auto& sha256 = vm_config.code().remote().sha256();
+  if (vm_config.code_cache_directory().empty() || sha256.empty() ||
+      !std::all_of(sha256.begin(), sha256.end(), absl::ascii_isxdigit)) {
+    return "";
+  }
+  return absl::StrCat(vm_config.code_cache_directory(), "/", absl::AsciiStrToLower(sha256),
+                      ".wasm");
+}
+
+// Returns the cached code or an empty string if it is missing or does not match the sha256.
+std::string readCodeCacheFile(const VmConfig& vm_config, Api::Api& api) {
+  const std::string path = codeCacheFilePath(vm_config);
+  if (path.empty() || !api.fileSystem().fileExists(path)) {
+    return "";
+  }
+  std::string code;
+  try {
+    code = api.fileSystem().fileReadToEnd(path);
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Unable to read cached Wasm code from {}: {}", path, e.what());
+    return "";
+  }
+  uint8_t digest[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const uint8_t*>(code.data()), code.size(), digest);
+  if (!absl::EqualsIgnoreCase(Hex::encode(digest, SHA256_DIGEST_LENGTH),
+                              vm_config.code().remote().sha256())) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Ignoring cached Wasm code in {} with mismatched sha256", path);
+    return "";
+  }
+  return code;
+}
+
+void writeCodeCacheFile(const VmConfig& vm_config, absl::string_view code, Api::Api& api,
+                        Random::RandomGenerator& random) {
+  const std::string path = codeCacheFilePath(vm_config);
+  if (path.empty() || api.fileSystem().fileExists(path)) {
+    return;
+  }
+  // Write to a unique temporary file and rename it into place so that concurrent writers (e.g. both
+  // processes during a hot restart) never expose a partially written module.
+  const std::string temp_path = absl::StrCat(path, ".", random.uuid(), ".tmp");
+  Filesystem::FilePtr file = api.fileSystem().createFile(temp_path);
+  const Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                                  1 << Filesystem::File::Operation::Create};
+  bool written = false;
+  if (file->open(flags).rc_) {
+    const Api::IoCallSizeResult result = file->write(code);
+    written = result.ok() && static_cast<size_t>(result.rc_) == code.size();
+    written = file->close().rc_ && written;
+  }
+  if (!written || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), warn,
+                        "Unable to write Wasm code to the code cache file {}", path);
+    std::remove(temp_path.c_str());
+  }
+}
+
 } // namespace
 
 std::string anyToBytes(const ProtobufWkt::Any& any) {
@@ -101,9 +451,11 @@ void Wasm::initializeLifecycle(Server::ServerLifecycleNotifier& lifecycle_notifi
 
 Wasm::Wasm(absl::string_view runtime, absl::string_view vm_id, absl::string_view vm_configuration,
            absl::string_view vm_key, const Stats::ScopeSharedPtr& scope,
-           Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher)
-    : WasmBase(createWasmVm(runtime, scope), vm_id, vm_configuration, vm_key), scope_(scope),
-      cluster_manager_(cluster_manager), dispatcher_(dispatcher),
+           Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher,
+           WasmVmPtr wasm_vm)
+    : WasmBase(wasm_vm != nullptr ? std::move(wasm_vm) : createWasmVm(runtime, scope), vm_id,
+               vm_configuration, vm_key),
+      scope_(scope), cluster_manager_(cluster_manager), dispatcher_(dispatcher),
       time_source_(dispatcher.timeSource()),
       wasm_stats_(WasmStats{
           ALL_WASM_STATS(POOL_COUNTER_PREFIX(*scope_, absl::StrCat("wasm.", runtime, ".")),
@@ -157,6 +509,7 @@ void Wasm::tickHandler(uint32_t root_context_id) {
   }
   auto context = getContext(root_context_id);
   if (context) {
+    VmCallTimer timer(*static_cast<Context*>(context), VmCallback::OnTick);
     context->onTick(0);
   }
   if (timer->second && period->second.count() > 0) {
@@ -173,6 +526,21 @@ Wasm::~Wasm() {
   }
 }
 
+WasmResult Wasm::registerPropertyPath(absl::string_view path, uint32_t* path_id) {
+  auto it = property_path_ids_.find(path);
+  if (it != property_path_ids_.end()) {
+    *path_id = it->second;
+    return WasmResult::Ok;
+  }
+  if (property_paths_.size() >= MaxPropertyPaths) {
+    return WasmResult::BadArgument;
+  }
+  *path_id = property_paths_.size();
+  property_paths_.push_back(std::make_unique<PropertyPath>(path));
+  property_path_ids_.emplace(std::string(path), *path_id);
+  return WasmResult::Ok;
+}
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 Word resolve_dns(void* raw_context, Word dns_address_ptr, Word dns_address_size, Word token_ptr) {
   auto context = WASM_CONTEXT(raw_context);
@@ -204,6 +572,198 @@ Word resolve_dns(void* raw_context, Word dns_address_ptr, Word dns_address_size,
   return WasmResult::Ok;
 }
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word get_header_map_values(void* raw_context, Word type, Word keys_ptr, Word keys_size,
+                           Word buffer_ptr, Word buffer_size, Word result_size_ptr) {
+  if (type.u64_ > static_cast<uint64_t>(WasmHeaderMapType::MAX)) {
+    return WasmResult::BadArgument;
+  }
+  auto context = WASM_CONTEXT(raw_context);
+  auto keys = context->wasmVm()->getMemory(keys_ptr, keys_size);
+  if (!keys) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  // The buffer is preallocated by the caller, so the values are serialized directly into VM
+  // memory rather than allocated in the VM and copied.
+  auto buffer = context->wasmVm()->getMemory(buffer_ptr, buffer_size);
+  if (!buffer) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  size_t result_size = 0;
+  auto result = context->getHeaderMapValues(static_cast<WasmHeaderMapType>(type.u64_),
+                                            keys.value(), const_cast<char*>(buffer.value().data()),
+                                            buffer_size.u64_, &result_size);
+  if (result == WasmResult::Ok || result == WasmResult::ResultMismatch) {
+    if (!context->wasmVm()->setWord(result_size_ptr, Word(result_size))) {
+      return WasmResult::InvalidMemoryAccess;
+    }
+  }
+  return result;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word set_header_map_values(void* raw_context, Word type, Word mutations_ptr,
+                           Word mutations_size) {
+  if (type.u64_ > static_cast<uint64_t>(WasmHeaderMapType::MAX)) {
+    return WasmResult::BadArgument;
+  }
+  auto context = WASM_CONTEXT(raw_context);
+  auto mutations = context->wasmVm()->getMemory(mutations_ptr, mutations_size);
+  if (!mutations) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return context->setHeaderMapValues(static_cast<WasmHeaderMapType>(type.u64_),
+                                     mutations.value());
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word get_buffer_slices(void* raw_context, Word type, Word buffer_ptr, Word buffer_size,
+                       Word result_size_ptr) {
+  if (type.u64_ > static_cast<uint64_t>(WasmBufferType::MAX)) {
+    return WasmResult::BadArgument;
+  }
+  auto context = WASM_CONTEXT(raw_context);
+  auto buffer = static_cast<Buffer*>(context->getBuffer(static_cast<WasmBufferType>(type.u64_)));
+  if (!buffer) {
+    return WasmResult::NotFound;
+  }
+  auto result_buffer = context->wasmVm()->getMemory(buffer_ptr, buffer_size);
+  if (!result_buffer) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  size_t result_size = 0;
+  auto result = buffer->getSliceSizes(const_cast<char*>(result_buffer.value().data()),
+                                      buffer_size.u64_, &result_size);
+  if (result == WasmResult::Ok || result == WasmResult::ResultMismatch) {
+    if (!context->wasmVm()->setWord(result_size_ptr, Word(result_size))) {
+      return WasmResult::InvalidMemoryAccess;
+    }
+  }
+  return result;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word copy_buffer_bytes(void* raw_context, Word type, Word start, Word length, Word dest_ptr,
+                       Word copied_ptr) {
+  if (type.u64_ > static_cast<uint64_t>(WasmBufferType::MAX)) {
+    return WasmResult::BadArgument;
+  }
+  auto context = WASM_CONTEXT(raw_context);
+  auto buffer = static_cast<Buffer*>(context->getBuffer(static_cast<WasmBufferType>(type.u64_)));
+  if (!buffer) {
+    return WasmResult::NotFound;
+  }
+  // Copy straight into memory provided by the caller, which may be reused across calls to scan
+  // a large body a chunk at a time.
+  auto dest = context->wasmVm()->getMemory(dest_ptr, length);
+  if (!dest) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  const size_t copied =
+      buffer->copyOut(start.u64_, length.u64_, const_cast<char*>(dest.value().data()));
+  if (!context->wasmVm()->setWord(copied_ptr, Word(copied))) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return WasmResult::Ok;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word register_property_path(void* raw_context, Word path_ptr, Word path_size, Word path_id_ptr) {
+  auto context = WASM_CONTEXT(raw_context);
+  auto path = context->wasmVm()->getMemory(path_ptr, path_size);
+  if (!path) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  uint32_t path_id;
+  const WasmResult result = context->wasm()->registerPropertyPath(path.value(), &path_id);
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  if (!context->wasm()->setDatatype(path_id_ptr, path_id)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return WasmResult::Ok;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word get_property_by_id(void* raw_context, Word path_id, Word buffer_ptr, Word buffer_size,
+                        Word result_size_ptr) {
+  auto context = WASM_CONTEXT(raw_context);
+  absl::string_view value;
+  auto result = context->getProperty(static_cast<uint32_t>(path_id.u64_), &value);
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  if (!context->wasmVm()->setWord(result_size_ptr, Word(value.size()))) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  if (value.size() > buffer_size.u64_) {
+    return WasmResult::ResultMismatch;
+  }
+  if (!context->wasmVm()->setMemory(buffer_ptr, value.size(), value.data())) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return WasmResult::Ok;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word get_shared_data_values(void* raw_context, Word keys_ptr, Word keys_size, Word buffer_ptr,
+                            Word buffer_size, Word result_size_ptr) {
+  auto context = WASM_CONTEXT(raw_context);
+  auto keys = context->wasmVm()->getMemory(keys_ptr, keys_size);
+  if (!keys) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  auto buffer = context->wasmVm()->getMemory(buffer_ptr, buffer_size);
+  if (!buffer) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  size_t result_size = 0;
+  auto result = context->getSharedDataValues(
+      keys.value(), const_cast<char*>(buffer.value().data()), buffer_size.u64_, &result_size);
+  if (result == WasmResult::Ok || result == WasmResult::ResultMismatch) {
+    if (!context->wasmVm()->setWord(result_size_ptr, Word(result_size))) {
+      return WasmResult::InvalidMemoryAccess;
+    }
+  }
+  return result;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word set_shared_data_values(void* raw_context, Word updates_ptr, Word updates_size) {
+  auto context = WASM_CONTEXT(raw_context);
+  auto updates = context->wasmVm()->getMemory(updates_ptr, updates_size);
+  if (!updates) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return context->setSharedDataValues(updates.value());
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word watch_shared_data(void* raw_context, Word key_ptr, Word key_size, Word token_ptr) {
+  auto context = WASM_CONTEXT(raw_context);
+  auto key = context->wasmVm()->getMemory(key_ptr, key_size);
+  // Verify token_ptr before registering the watch.
+  if (!key || !context->wasmVm()->getMemory(token_ptr, sizeof(uint32_t))) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  uint32_t token = 0;
+  auto result = context->watchSharedData(key.value(), &token);
+  if (result != WasmResult::Ok) {
+    return result;
+  }
+  if (!context->wasm()->setDatatype(token_ptr, token)) {
+    return WasmResult::InvalidMemoryAccess;
+  }
+  return WasmResult::Ok;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+Word unwatch_shared_data(void* raw_context, Word token) {
+  auto context = WASM_CONTEXT(raw_context);
+  return context->unwatchSharedData(static_cast<uint32_t>(token.u64_));
+}
+
 void Wasm::registerCallbacks() {
   WasmBase::registerCallbacks();
 #define _REGISTER(_fn)                                                                             \
@@ -211,6 +771,16 @@ void Wasm::registerCallbacks() {
       "env", "envoy_" #_fn, &_fn,                                                                  \
       &proxy_wasm::ConvertFunctionWordToUint32<decltype(_fn), _fn>::convertFunctionWordToUint32)
   _REGISTER(resolve_dns);
+  _REGISTER(get_header_map_values);
+  _REGISTER(set_header_map_values);
+  _REGISTER(get_buffer_slices);
+  _REGISTER(copy_buffer_bytes);
+  _REGISTER(register_property_path);
+  _REGISTER(get_property_by_id);
+  _REGISTER(get_shared_data_values);
+  _REGISTER(set_shared_data_values);
+  _REGISTER(watch_shared_data);
+  _REGISTER(unwatch_shared_data);
 #undef _REGISTER
 }
 
@@ -219,6 +789,7 @@ void Wasm::getFunctions() {
 #define _GET(_fn) wasm_vm_->getFunction("envoy_" #_fn, &_fn##_);
   _GET(on_resolve_dns)
   _GET(on_stats_update)
+  _GET(on_shared_data_changed)
 #undef _GET
 }
 
@@ -256,6 +827,12 @@ void Wasm::onStatsUpdate(absl::string_view root_id, Envoy::Stats::MetricSnapshot
   context->onStatsUpdate(snapshot);
 }
 
+void Wasm::onStatsDeltaUpdate(absl::string_view root_id,
+                              Envoy::Stats::MetricSnapshot& snapshot) {
+  auto context = getRootContext(root_id);
+  context->onStatsDeltaUpdate(snapshot);
+}
+
 void clearCodeCacheForTesting() {
   std::lock_guard<std::mutex> guard(code_cache_mutex);
   if (code_cache) {
@@ -306,6 +883,84 @@ WasmEvent toWasmEvent(const std::shared_ptr<WasmHandleBase>& wasm) {
   NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
 }
 
+// Compiles the code of a new base VM on the background compiler thread. The base VM is then created
+// from it back on the main thread by proxy_wasm::createWasm(), which links and instantiates the
+// module and starts and configures a canary clone of it, as the host calls made by
+// proxy_on_vm_start and proxy_on_configure (timers, HTTP and gRPC calls etc.) need the main thread.
+// Base VMs are still shared by vm_key: if one was created meanwhile, the compiled VM is dropped.
+// Code which cannot be compiled in the background, as it fails to load or as the runtime cannot
+// clone the VM, is loaded on the main thread instead.
+static CreateWasmHandlePtr createWasmInBackground(
+    const std::string& vm_key, std::string code, bool allow_precompiled,
+    absl::string_view runtime, const Stats::ScopeSharedPtr& scope, const PluginSharedPtr& plugin,
+    std::function<WasmHandleBaseSharedPtr(absl::string_view vm_key, WasmVmPtr wasm_vm)> factory,
+    proxy_wasm::WasmHandleCloneFactory clone_factory, Event::Dispatcher& dispatcher, Api::Api& api,
+    std::function<void(WasmHandleSharedPtr, WasmEvent)> done) {
+  auto shared_code = std::make_shared<const std::string>(std::move(code));
+  auto compile = std::make_shared<BackgroundCompile>();
+  compile->compiler_ = getBackgroundCompiler(api);
+  compile->on_compiled_ = [vm_key, shared_code, allow_precompiled, plugin,
+                           factory = std::move(factory), clone_factory = std::move(clone_factory),
+                           done = std::move(done)](WasmVmPtr compiled_vm,
+                                                   std::shared_ptr<BackgroundCompiler> compiler) {
+    // The VM is only passed to the factory of this call, if proxy_wasm::createWasm() creates a base
+    // Wasm at all; otherwise it is destroyed along with the factory.
+    auto precompiled_vm = std::make_shared<WasmVmPtr>();
+    if (compiled_vm != nullptr) {
+      *precompiled_vm = std::make_unique<PrecompiledWasmVm>(std::move(compiled_vm), shared_code,
+                                                            allow_precompiled, std::move(compiler));
+    }
+    proxy_wasm::WasmHandleFactory precompiled_factory =
+        [factory, precompiled_vm](absl::string_view vm_key) -> WasmHandleBaseSharedPtr {
+      return factory(vm_key, std::move(*precompiled_vm));
+    };
+    auto wasm = proxy_wasm::createWasm(vm_key, *shared_code, plugin, precompiled_factory,
+                                       clone_factory, allow_precompiled);
+    done(std::static_pointer_cast<WasmHandle>(wasm), toWasmEvent(wasm));
+  };
+  compile->compiler_->post([compile, shared_code, allow_precompiled, runtime = std::string(runtime),
+                            scope, &dispatcher]() {
+    std::function<void()> hook;
+    {
+      std::lock_guard<std::mutex> guard(background_compile_hook_mutex);
+      if (background_compile_hook_for_testing) {
+        hook = *background_compile_hook_for_testing;
+      }
+    }
+    if (hook) {
+      hook();
+    }
+    {
+      Thread::LockGuard lock(compile->mutex_);
+      if (compile->cancelled_) {
+        return;
+      }
+    }
+    // The VM is created, used and destroyed on this thread unless it is handed to the main thread.
+    WasmVmPtr wasm_vm = createWasmVm(runtime, scope);
+    if (wasm_vm != nullptr &&
+        (wasm_vm->cloneable() == proxy_wasm::Cloneable::NotCloneable ||
+         !wasm_vm->load(*shared_code, allow_precompiled))) {
+      wasm_vm.reset();
+    }
+    // Released after the lock, which it takes when destroyed.
+    auto handoff = std::make_shared<BackgroundCompileHandoff>(compile);
+    Thread::LockGuard lock(compile->mutex_);
+    // Once cancelled, the owner may be gone along with the main dispatcher.
+    if (compile->cancelled_) {
+      return;
+    }
+    compile->compiled_vm_ = std::move(wasm_vm);
+    dispatcher.post([handoff]() { handoff->run(); });
+    while (!compile->handed_off_ && !compile->cancelled_) {
+      compile->handed_off_cond_.wait(compile->mutex_);
+    }
+    // Only set if the compilation was cancelled before the main thread took the VM.
+    wasm_vm = std::move(compile->compiled_vm_);
+  });
+  return std::make_unique<BackgroundCompileHandle>(compile);
+}
+
 static bool createWasmInternal(const VmConfig& vm_config, const PluginSharedPtr& plugin,
                                const Stats::ScopeSharedPtr& scope,
                                Upstream::ClusterManager& cluster_manager,
@@ -313,15 +968,23 @@ static bool createWasmInternal(const VmConfig& vm_config, const PluginSharedPtr&
                                Random::RandomGenerator& random, Api::Api& api,
                                Server::ServerLifecycleNotifier& lifecycle_notifier,
                                Config::DataSource::RemoteAsyncDataProviderPtr& remote_data_provider,
-                               CreateWasmCallback&& cb,
+                               CreateWasmHandlePtr& create_wasm_handle, CreateWasmCallback&& cb,
                                CreateContextFn create_root_context_for_testing = nullptr) {
   auto wasm_extension = getWasmExtension();
+  if (vm_config.compile_in_background()) {
+    auto init_target = std::make_shared<BackgroundInitTarget>(plugin->name_);
+    init_manager.add(init_target->target());
+    cb = [cb = std::move(cb), init_target](WasmHandleSharedPtr wasm) {
+      cb(wasm);
+      init_target->ready();
+    };
+  }
   std::string source, code;
   bool fetch = false;
   if (vm_config.code().has_remote()) {
     auto now = dispatcher.timeSource().monotonicTime() + cache_time_offset_for_testing;
     source = vm_config.code().remote().http_uri().uri();
-    std::lock_guard<std::mutex> guard(code_cache_mutex);
+    std::unique_lock<std::mutex> guard(code_cache_mutex);
     if (!code_cache) {
       code_cache = new std::remove_reference<decltype(*code_cache)>::type;
     }
@@ -362,12 +1025,28 @@ static bool createWasmInternal(const VmConfig& vm_config, const PluginSharedPtr&
         wasm_extension->onEvent(WasmExtension::WasmEvent::RemoteLoadCacheHit, plugin);
       }
     } else {
-      fetch = true; // Not in cache, fetch.
       auto& e = (*code_cache)[vm_config.code().remote().sha256()];
-      e.in_progress = true;
       e.use_time = e.fetch_time = now;
-      wasm_extension->onRemoteCacheEntriesChanged(code_cache->size());
+      e.in_progress = true;
       wasm_extension->onEvent(WasmExtension::WasmEvent::RemoteLoadCacheMiss, plugin);
+      wasm_extension->onRemoteCacheEntriesChanged(code_cache->size());
+      fetch = true; // Not in cache, fetch.
+      if (!vm_config.code_cache_directory().empty()) {
+        // Read and verify the cached file without holding the lock. Meanwhile other loads of the
+        // same code find the entry in progress.
+        guard.unlock();
+        code = readCodeCacheFile(vm_config, api);
+        guard.lock();
+        wasm_extension->onEvent(code.empty() ? WasmExtension::WasmEvent::RemoteLoadDiskCacheMiss
+                                             : WasmExtension::WasmEvent::RemoteLoadDiskCacheHit,
+                                plugin);
+        if (!code.empty()) {
+          fetch = false;
+          auto& loaded = (*code_cache)[vm_config.code().remote().sha256()];
+          loaded.in_progress = false;
+          loaded.code = code;
+        }
+      }
     }
   } else if (vm_config.code().has_local()) {
     code = Config::DataSource::read(vm_config.code().local(), true, api);
@@ -375,8 +1054,8 @@ static bool createWasmInternal(const VmConfig& vm_config, const PluginSharedPtr&
                  .value_or(code.empty() ? EMPTY_STRING : INLINE_STRING);
   }
 
-  auto complete_cb = [cb, vm_config, plugin, scope, &cluster_manager, &dispatcher,
-                      &lifecycle_notifier, create_root_context_for_testing,
+  auto complete_cb = [cb, vm_config, plugin, scope, &cluster_manager, &dispatcher, &api,
+                      &lifecycle_notifier, &create_wasm_handle, create_root_context_for_testing,
                       wasm_extension](std::string code) -> bool {
     if (code.empty()) {
       cb(nullptr);
@@ -389,29 +1068,55 @@ static bool createWasmInternal(const VmConfig& vm_config, const PluginSharedPtr&
         [&vm_config, scope, &cluster_manager, &dispatcher, &lifecycle_notifier,
          wasm_factory](absl::string_view vm_key) -> WasmHandleBaseSharedPtr {
       return wasm_factory(vm_config, scope, cluster_manager, dispatcher, lifecycle_notifier,
-                          vm_key);
+                          vm_key, nullptr);
     };
-    auto wasm = proxy_wasm::createWasm(
-        vm_key, code, plugin, proxy_wasm_factory,
-        getCloneFactory(wasm_extension, dispatcher, create_root_context_for_testing),
-        vm_config.allow_precompiled());
-    Stats::ScopeSharedPtr create_wasm_stats_scope =
-        wasm_extension->lockAndCreateStats(scope, plugin);
-    wasm_extension->onEvent(toWasmEvent(wasm), plugin);
-    if (!wasm || wasm->wasm()->isFailed()) {
-      ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), trace,
-                          "Unable to create Wasm");
-      cb(nullptr);
-      return false;
+    const MonotonicTime start_time = dispatcher.timeSource().monotonicTime();
+    auto created_cb = [cb, plugin, scope, &dispatcher, wasm_extension,
+                       start_time](WasmHandleSharedPtr wasm, WasmEvent event) -> bool {
+      Stats::ScopeSharedPtr create_wasm_stats_scope =
+          wasm_extension->lockAndCreateStats(scope, plugin);
+      wasm_extension->onCreateWasmDuration(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              dispatcher.timeSource().monotonicTime() - start_time),
+          plugin);
+      wasm_extension->onEvent(event, plugin);
+      if (!wasm || wasm->wasm()->isFailed()) {
+        ENVOY_LOG_TO_LOGGER(Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm), trace,
+                            "Unable to create Wasm");
+        cb(nullptr);
+        return false;
+      }
+      cb(wasm);
+      return true;
+    };
+    auto clone_factory =
+        getCloneFactory(wasm_extension, dispatcher, create_root_context_for_testing);
+    if (vm_config.compile_in_background()) {
+      // The factory outlives this callback, so it needs its own copy of the VmConfig.
+      auto shared_vm_config = std::make_shared<const VmConfig>(vm_config);
+      auto factory = [shared_vm_config, scope, &cluster_manager, &dispatcher, &lifecycle_notifier,
+                      wasm_factory](absl::string_view vm_key,
+                                    WasmVmPtr wasm_vm) -> WasmHandleBaseSharedPtr {
+        return wasm_factory(*shared_vm_config, scope, cluster_manager, dispatcher,
+                            lifecycle_notifier, vm_key, std::move(wasm_vm));
+      };
+      create_wasm_handle = createWasmInBackground(
+          vm_key, std::move(code), vm_config.allow_precompiled(), vm_config.runtime(), scope,
+          plugin, std::move(factory), std::move(clone_factory), dispatcher, api, created_cb);
+      return true;
     }
-    cb(std::static_pointer_cast<WasmHandle>(wasm));
-    return true;
+    auto wasm = proxy_wasm::createWasm(vm_key, code, plugin, proxy_wasm_factory, clone_factory,
+                                       vm_config.allow_precompiled());
+    return created_cb(std::static_pointer_cast<WasmHandle>(wasm), toWasmEvent(wasm));
   };
 
   if (fetch) {
     auto holder = std::make_shared<std::unique_ptr<Event::DeferredDeletable>>();
     auto fetch_callback = [vm_config, complete_cb, source, &dispatcher, scope, holder, plugin,
-                           wasm_extension](const std::string& code) {
+                           wasm_extension, &api, &random](const std::string& code) {
+      if (!code.empty()) {
+        writeCodeCacheFile(vm_config, code, api, random);
+      }
       {
         std::lock_guard<std::mutex> guard(code_cache_mutex);
         auto& e = (*code_cache)[vm_config.code().remote().sha256()];
@@ -470,10 +1175,18 @@ bool createWasm(const VmConfig& vm_config, const PluginSharedPtr& plugin,
                 Random::RandomGenerator& random, Api::Api& api,
                 Envoy::Server::ServerLifecycleNotifier& lifecycle_notifier,
                 Config::DataSource::RemoteAsyncDataProviderPtr& remote_data_provider,
-                CreateWasmCallback&& cb, CreateContextFn create_root_context_for_testing) {
+                CreateWasmHandlePtr& create_wasm_handle, CreateWasmCallback&& cb,
+                CreateContextFn create_root_context_for_testing) {
   return createWasmInternal(vm_config, plugin, scope, cluster_manager, init_manager, dispatcher,
-                            random, api, lifecycle_notifier, remote_data_provider, std::move(cb),
-                            create_root_context_for_testing);
+                            random, api, lifecycle_notifier, remote_data_provider,
+                            create_wasm_handle, std::move(cb), create_root_context_for_testing);
+}
+
+void setBackgroundCompileHookForTesting(std::function<void()> hook) {
+  std::lock_guard<std::mutex> guard(background_compile_hook_mutex);
+  delete background_compile_hook_for_testing;
+  background_compile_hook_for_testing =
+      hook ? new std::function<void()>(std::move(hook)) : nullptr;
 }
 
 WasmHandleSharedPtr getOrCreateThreadLocalWasm(const WasmHandleSharedPtr& base_wasm,
@@ -21,6 +21,7 @@
 #include "common/version/version.h"
 
 #include "extensions/common/wasm/context.h"
+#include "extensions/common/wasm/shared_data.h"
 #include "extensions/common/wasm/wasm_extension.h"
 #include "extensions/common/wasm/wasm_vm.h"
 #include "extensions/common/wasm/well_known_names.h"
@@ -48,7 +49,8 @@ class Wasm : public WasmBase, Logger::Loggable<Logger::Id::wasm> {
 public:
   Wasm(absl::string_view runtime, absl::string_view vm_id, absl::string_view vm_configuration,
        absl::string_view vm_key, const Stats::ScopeSharedPtr& scope,
-       Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher);
+       Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher,
+       WasmVmPtr wasm_vm = nullptr);
   Wasm(std::shared_ptr<WasmHandle> other, Event::Dispatcher& dispatcher);
   ~Wasm() override;
 
@@ -78,6 +80,7 @@ public:
            const StreamInfo::StreamInfo& stream_info);
 
   void onStatsUpdate(absl::string_view root_id, Envoy::Stats::MetricSnapshot& snapshot);
+  void onStatsDeltaUpdate(absl::string_view root_id, Envoy::Stats::MetricSnapshot& snapshot);
   virtual std::string buildVersion() { return BUILD_VERSION_NUMBER; }
 
   void initializeLifecycle(Server::ServerLifecycleNotifier& lifecycle_notifier);
@@ -87,6 +90,21 @@ public:
     } while (!dns_token_);
     return dns_token_;
   }
+  uint32_t nextSharedDataWatchToken() {
+    do {
+      shared_data_watch_token_++;
+    } while (!shared_data_watch_token_ || shared_data_watches_.contains(shared_data_watch_token_));
+    return shared_data_watch_token_;
+  }
+
+  // Compiles a property path once for repeated evaluation with Context::getProperty(path_id).
+  // Registering the same path again returns the same id. At most MaxPropertyPaths distinct paths
+  // can be registered, after which BadArgument is returned.
+  static constexpr uint32_t MaxPropertyPaths = 1024;
+  WasmResult registerPropertyPath(absl::string_view path, uint32_t* path_id);
+  const PropertyPath* propertyPath(uint32_t path_id) const {
+    return path_id < property_paths_.size() ? property_paths_[path_id].get() : nullptr;
+  }
 
   void setCreateContextForTesting(CreateContextFn create_context,
                                   CreateContextFn create_root_context) {
@@ -102,6 +120,7 @@ protected:
   // Calls into the VM.
   proxy_wasm::WasmCallVoid<3> on_resolve_dns_;
   proxy_wasm::WasmCallVoid<2> on_stats_update_;
+  proxy_wasm::WasmCallVoid<2> on_shared_data_changed_;
 
   Stats::ScopeSharedPtr scope_;
   Upstream::ClusterManager& cluster_manager_;
@@ -122,6 +141,20 @@ protected:
   CreateContextFn create_root_context_for_testing_;
   Network::DnsResolverSharedPtr dns_resolver_;
   uint32_t dns_token_ = 1;
+  uint32_t shared_data_watch_token_ = 1;
+  // Shared data watches by token, removed from the shared data with this.
+  struct SharedDataWatch {
+    uint32_t root_context_id_;
+    std::string key_;
+    SharedData::WatchHandlePtr handle_;
+  };
+  absl::flat_hash_map<uint32_t, SharedDataWatch> shared_data_watches_;
+  // The token of the watch of each key by each root context, which watches a key at most once.
+  absl::flat_hash_map<std::pair<uint32_t, std::string>, uint32_t> shared_data_watch_tokens_;
+
+  // Registered property paths, indexed by id.
+  std::vector<PropertyPathPtr> property_paths_;
+  absl::flat_hash_map<std::string, uint32_t> property_path_ids_;
 };
 using WasmSharedPtr = std::shared_ptr<Wasm>;
 
@@ -138,6 +171,15 @@ private:
 
 using CreateWasmCallback = std::function<void(WasmHandleSharedPtr)>;
 
+// Returned by createWasm() through its create_wasm_handle argument while the VM is being compiled
+// in the background (VmConfig.compile_in_background). Destroying it cancels the creation of the VM,
+// so that the callback is never called once its owner is gone.
+class CreateWasmHandle {
+public:
+  virtual ~CreateWasmHandle() = default;
+};
+using CreateWasmHandlePtr = std::unique_ptr<CreateWasmHandle>;
+
 // Returns false if createWasm failed synchronously. This is necessary because xDS *MUST* report
 // all failures synchronously as it has no facility to report configuration update failures
 // asynchronously. Callers should throw an exception if they are part of a synchronous xDS update
@@ -148,7 +190,7 @@ bool createWasm(const VmConfig& vm_config, const PluginSharedPtr& plugin,
                 Random::RandomGenerator& random, Api::Api& api,
                 Envoy::Server::ServerLifecycleNotifier& lifecycle_notifier,
                 Config::DataSource::RemoteAsyncDataProviderPtr& remote_data_provider,
-                CreateWasmCallback&& callback,
+                CreateWasmHandlePtr& create_wasm_handle, CreateWasmCallback&& callback,
                 CreateContextFn create_root_context_for_testing = nullptr);
 
 WasmHandleSharedPtr
@@ -159,6 +201,8 @@ getOrCreateThreadLocalWasm(const WasmHandleSharedPtr& base_wasm, const PluginSha
 void clearCodeCacheForTesting();
 std::string anyToBytes(const ProtobufWkt::Any& any);
 void setTimeOffsetForCodeCacheForTesting(MonotonicTime::duration d);
+// Runs the hook on the background compiler thread before each compilation. Clears it if empty.
+void setBackgroundCompileHookForTesting(std::function<void()> hook);
 EnvoyWasm::WasmEvent toWasmEvent(const std::shared_ptr<WasmHandleBase>& wasm);
 
 } // namespace Wasm
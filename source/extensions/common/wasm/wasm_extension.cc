@@ -50,10 +50,10 @@ WasmHandleExtensionFactory EnvoyWasm::wasmFactory() {
   return [](const VmConfig vm_config, const Stats::ScopeSharedPtr& scope,
             Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher,
             Server::ServerLifecycleNotifier& lifecycle_notifier,
-            absl::string_view vm_key) -> WasmHandleBaseSharedPtr {
+            absl::string_view vm_key, WasmVmPtr wasm_vm) -> WasmHandleBaseSharedPtr {
     auto wasm = std::make_shared<Wasm>(vm_config.runtime(), vm_config.vm_id(),
                                        anyToBytes(vm_config.configuration()), vm_key, scope,
-                                       cluster_manager, dispatcher);
+                                       cluster_manager, dispatcher, std::move(wasm_vm));
     wasm->initializeLifecycle(lifecycle_notifier);
     return std::static_pointer_cast<WasmHandleBase>(std::make_shared<WasmHandle>(std::move(wasm)));
   };
@@ -79,6 +79,12 @@ void EnvoyWasm::onEvent(WasmEvent event, const PluginSharedPtr&) {
   case WasmEvent::RemoteLoadCacheMiss:
     create_wasm_stats_->remote_load_cache_misses_.inc();
     break;
+  case WasmEvent::RemoteLoadDiskCacheHit:
+    create_wasm_stats_->remote_load_disk_cache_hits_.inc();
+    break;
+  case WasmEvent::RemoteLoadDiskCacheMiss:
+    create_wasm_stats_->remote_load_disk_cache_misses_.inc();
+    break;
   case WasmEvent::RemoteLoadCacheFetchSuccess:
     create_wasm_stats_->remote_load_fetch_successes_.inc();
     break;
@@ -94,10 +100,15 @@ void EnvoyWasm::onRemoteCacheEntriesChanged(int entries) {
   create_wasm_stats_->remote_load_cache_entries_.set(entries);
 }
 
+void EnvoyWasm::onCreateWasmDuration(std::chrono::milliseconds duration, const PluginSharedPtr&) {
+  create_wasm_stats_->create_wasm_time_ms_.recordValue(duration.count());
+}
+
 void EnvoyWasm::createStats(const Stats::ScopeSharedPtr& scope, const PluginSharedPtr&) {
   if (!create_wasm_stats_) {
     create_wasm_stats_.reset(new CreateWasmStats{CREATE_WASM_STATS( // NOLINT
-        POOL_COUNTER_PREFIX(*scope, "wasm."), POOL_GAUGE_PREFIX(*scope, "wasm."))});
+        POOL_COUNTER_PREFIX(*scope, "wasm."), POOL_GAUGE_PREFIX(*scope, "wasm."),
+        POOL_HISTOGRAM_PREFIX(*scope, "wasm."))});
   }
 }
 
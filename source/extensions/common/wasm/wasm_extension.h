@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "envoy/server/lifecycle_notifier.h"
@@ -17,13 +18,16 @@ namespace Extensions {
 namespace Common {
 namespace Wasm {
 
-#define CREATE_WASM_STATS(COUNTER, GAUGE)                                                          \
+#define CREATE_WASM_STATS(COUNTER, GAUGE, HISTOGRAM)                                               \
   COUNTER(remote_load_cache_hits)                                                                  \
   COUNTER(remote_load_cache_negative_hits)                                                         \
   COUNTER(remote_load_cache_misses)                                                                \
+  COUNTER(remote_load_disk_cache_hits)                                                             \
+  COUNTER(remote_load_disk_cache_misses)                                                           \
   COUNTER(remote_load_fetch_successes)                                                             \
   COUNTER(remote_load_fetch_failures)                                                              \
-  GAUGE(remote_load_cache_entries, NeverImport)
+  GAUGE(remote_load_cache_entries, NeverImport)                                                    \
+  HISTOGRAM(create_wasm_time_ms, Milliseconds)
 
 class WasmHandle;
 class EnvoyWasmVmIntegration;
@@ -31,17 +35,20 @@ class EnvoyWasmVmIntegration;
 using WasmHandleSharedPtr = std::shared_ptr<WasmHandle>;
 using CreateContextFn =
     std::function<ContextBase*(Wasm* wasm, const std::shared_ptr<Plugin>& plugin)>;
+// Creates a base Wasm running on the given VM, or on a new VM of the configured runtime if it is
+// null.
 using WasmHandleExtensionFactory = std::function<WasmHandleBaseSharedPtr(
     const VmConfig& vm_config, const Stats::ScopeSharedPtr& scope,
     Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher,
-    Server::ServerLifecycleNotifier& lifecycle_notifier, absl::string_view vm_key)>;
+    Server::ServerLifecycleNotifier& lifecycle_notifier, absl::string_view vm_key,
+    WasmVmPtr wasm_vm)>;
 using WasmHandleExtensionCloneFactory = std::function<WasmHandleBaseSharedPtr(
     const WasmHandleSharedPtr& base_wasm, Event::Dispatcher& dispatcher,
     CreateContextFn create_root_context_for_testing)>;
 using ScopeWeakPtr = std::weak_ptr<Stats::Scope>;
 
 struct CreateWasmStats {
-  CREATE_WASM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  CREATE_WASM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 // Extension point for Wasm clients in embedded Envoy.
@@ -61,6 +68,8 @@ public:
     RemoteLoadCacheHit,
     RemoteLoadCacheNegativeHit,
     RemoteLoadCacheMiss,
+    RemoteLoadDiskCacheHit,
+    RemoteLoadDiskCacheMiss,
     RemoteLoadCacheFetchSuccess,
     RemoteLoadCacheFetchFailure,
     UnableToCreateVM,
@@ -73,6 +82,9 @@ public:
   };
   virtual void onEvent(WasmEvent event, const PluginSharedPtr& plugin) = 0;
   virtual void onRemoteCacheEntriesChanged(int remote_cache_entries) = 0;
+  // Called with the wall time taken to create (load, compile and start) or reuse the base VM.
+  virtual void onCreateWasmDuration(std::chrono::milliseconds duration,
+                                    const PluginSharedPtr& plugin) = 0;
   virtual void createStats(const Stats::ScopeSharedPtr& scope, const PluginSharedPtr& plugin)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_) = 0;
   virtual void resetStats() EXCLUSIVE_LOCKS_REQUIRED(mutex_) = 0; // Delete stats pointers
@@ -104,6 +116,8 @@ public:
   WasmHandleExtensionCloneFactory wasmCloneFactory() override;
   void onEvent(WasmEvent event, const PluginSharedPtr& plugin) override;
   void onRemoteCacheEntriesChanged(int remote_cache_entries) override;
+  void onCreateWasmDuration(std::chrono::milliseconds duration,
+                            const PluginSharedPtr& plugin) override;
   void createStats(const Stats::ScopeSharedPtr& scope, const PluginSharedPtr& plugin) override;
   void resetStats() override;
 
@@ -21,8 +21,62 @@ namespace Extensions {
 namespace Common {
 namespace Wasm {
 
+namespace {
+
+constexpr std::array<absl::string_view, NumVmCallbacks> VmCallbackNames = {
+    "on_new_connection",   "on_downstream_data",    "on_upstream_data",
+    "on_request_headers",  "on_request_body",       "on_request_trailers",
+    "on_request_metadata", "on_response_headers",   "on_response_body",
+    "on_response_trailers", "on_response_metadata", "on_log",
+    "on_done",             "on_tick",               "on_http_call_response",
+    "on_grpc_receive",     "on_grpc_close",
+};
+
+} // namespace
+
 void EnvoyWasmVmIntegration::error(absl::string_view message) { ENVOY_LOG(trace, message); }
 
+VmPluginStats& EnvoyWasmVmIntegration::pluginStats(absl::string_view plugin_name) {
+  auto it = plugin_stats_.find(plugin_name);
+  if (it != plugin_stats_.end()) {
+    return *it->second;
+  }
+  const std::string prefix = absl::StrCat(runtime_prefix_, "plugin.", plugin_name, ".");
+  auto stats = std::make_unique<VmPluginStats>(VmPluginStats{
+      ALL_VM_PLUGIN_STATS(POOL_COUNTER_PREFIX(*scope_, prefix), POOL_GAUGE_PREFIX(*scope_, prefix))
+          prefix,
+      {}});
+  stats->memory_bytes_.add(memory_size_);
+  return *plugin_stats_.emplace(std::string(plugin_name), std::move(stats)).first->second;
+}
+
+void EnvoyWasmVmIntegration::recordCallback(VmPluginStats& stats, VmCallback callback,
+                                            std::chrono::microseconds time) {
+  auto& histogram = stats.callback_us_[static_cast<size_t>(callback)];
+  if (!histogram) {
+    histogram = &scope_->histogramFromString(
+        absl::StrCat(stats.prefix_, VmCallbackNames[static_cast<size_t>(callback)], "_us"),
+        Stats::Histogram::Unit::Microseconds);
+  }
+  histogram->recordValue(time.count());
+}
+
+void EnvoyWasmVmIntegration::recordMemorySize(uint64_t size) {
+  // The Null VM runs in the host and has no linear memory.
+  if (size == memory_size_ || short_runtime_ == "null") {
+    return;
+  }
+  for (auto& p : plugin_stats_) {
+    if (size > memory_size_) {
+      p.second->memory_bytes_.add(size - memory_size_);
+      p.second->memory_grown_.inc();
+    } else {
+      p.second->memory_bytes_.sub(memory_size_ - size);
+    }
+  }
+  memory_size_ = size;
+}
+
 bool EnvoyWasmVmIntegration::getNullVmFunction(absl::string_view function_name, bool returns_word,
                                                int number_of_arguments,
                                                proxy_wasm::NullPlugin* plugin,
@@ -53,6 +107,18 @@ bool EnvoyWasmVmIntegration::getNullVmFunction(absl::string_view function_name,
       }
     };
     return true;
+  } else if (function_name == "envoy_on_shared_data_changed" && returns_word == false &&
+             number_of_arguments == 2) {
+    *reinterpret_cast<proxy_wasm::WasmCallVoid<2>*>(ptr_to_function_return) =
+        [plugin](ContextBase* context, Word context_id, Word token) {
+          proxy_wasm::SaveRestoreContext saved_context(context);
+          auto context_base = plugin->getContextBase(context_id);
+          if (auto root = context_base->asRoot()) {
+            static_cast<proxy_wasm::null_plugin::EnvoyRootContext*>(root)->onSharedDataChanged(
+                token);
+          }
+        };
+    return true;
   }
   return false;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <memory>
 
 #include "envoy/common/exception.h"
@@ -9,6 +11,7 @@
 
 #include "common/common/logger.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "include/proxy-wasm/wasm_vm.h"
 #include "include/proxy-wasm/word.h"
@@ -30,6 +33,42 @@ struct VmStats {
   ALL_VM_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
 };
 
+// Callbacks into a plugin whose duration is recorded in its VmPluginStats.
+enum class VmCallback {
+  OnNewConnection,
+  OnDownstreamData,
+  OnUpstreamData,
+  OnRequestHeaders,
+  OnRequestBody,
+  OnRequestTrailers,
+  OnRequestMetadata,
+  OnResponseHeaders,
+  OnResponseBody,
+  OnResponseTrailers,
+  OnResponseMetadata,
+  OnLog,
+  OnDone,
+  OnTick,
+  OnHttpCallResponse,
+  OnGrpcReceive,
+  OnGrpcClose,
+};
+constexpr size_t NumVmCallbacks = static_cast<size_t>(VmCallback::OnGrpcClose) + 1;
+
+/**
+ * Per-plugin stats: the linear memory of the VMs running the plugin, summed across workers.
+ */
+#define ALL_VM_PLUGIN_STATS(COUNTER, GAUGE)                                                        \
+  COUNTER(memory_grown)                                                                            \
+  GAUGE(memory_bytes, Accumulate)
+
+struct VmPluginStats {
+  ALL_VM_PLUGIN_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+  const std::string prefix_;
+  // <callback>_us histograms of the time spent in each callback, created on first use.
+  std::array<Stats::Histogram*, NumVmCallbacks> callback_us_;
+};
+
 // Wasm VM data providing stats.
 class EnvoyWasmVmIntegration : public proxy_wasm::WasmVmIntegration,
                                Logger::Loggable<Logger::Id::wasm> {
@@ -45,6 +84,9 @@ public:
     ENVOY_LOG(debug, "WasmVm created {} now active", runtime_, stats_.active_.value());
   }
   ~EnvoyWasmVmIntegration() override {
+    for (auto& p : plugin_stats_) {
+      p.second->memory_bytes_.sub(memory_size_);
+    }
     stats_.active_.dec();
     ENVOY_LOG(debug, "~WasmVm {} {} remaining active", runtime_, stats_.active_.value());
   }
@@ -60,12 +102,20 @@ public:
 
   const std::string& runtime() const { return runtime_; }
 
+  // Stats of the named plugin running in this VM, created on first use.
+  VmPluginStats& pluginStats(absl::string_view plugin_name);
+  void recordCallback(VmPluginStats& stats, VmCallback callback, std::chrono::microseconds time);
+  // Accounts for the current size of the linear memory of the VM in the stats of its plugins.
+  void recordMemorySize(uint64_t size);
+
 protected:
   const Stats::ScopeSharedPtr scope_;
   const std::string runtime_;
   const std::string short_runtime_;
   const std::string runtime_prefix_;
   VmStats stats_;
+  absl::flat_hash_map<std::string, std::unique_ptr<VmPluginStats>> plugin_stats_;
+  uint64_t memory_size_{0}; // As last recorded in plugin_stats_.
 }; // namespace Wasm
 
 inline EnvoyWasmVmIntegration& getEnvoyWasmIntegration(proxy_wasm::WasmVm& wasm_vm) {
@@ -208,6 +208,11 @@ EXTENSIONS = {
     "envoy.upstreams.http.http":                        "//source/extensions/upstreams/http/http:config",
     "envoy.upstreams.http.tcp":                         "//source/extensions/upstreams/http/tcp:config",
 
+    #
+    # Socket interfaces
+    #
+    "envoy.network.socket_interface.io_uring":          "//source/extensions/network/socket_interface/io_uring:config",
+
     #
     # Watchdog actions
     #
@@ -15,9 +15,9 @@ namespace HttpFilters {
 namespace Wasm {
 
 Http::FilterFactoryCb WasmFilterConfig::createFilterFactoryFromProtoTyped(
-    const envoy::extensions::filters::http::wasm::v3::Wasm& proto_config, const std::string&,
-    Server::Configuration::FactoryContext& context) {
-  auto filter_config = std::make_shared<FilterConfig>(proto_config, context);
+    const envoy::extensions::filters::http::wasm::v3::Wasm& proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  auto filter_config = std::make_shared<FilterConfig>(proto_config, stats_prefix, context);
   return [filter_config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     auto filter = filter_config->createFilter();
     if (!filter) { // Fail open
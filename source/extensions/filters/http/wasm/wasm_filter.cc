@@ -14,9 +14,60 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Wasm {
 
+ContextPool::ContextPool(const Common::Wasm::WasmHandleSharedPtr& wasm_handle,
+                         const Common::Wasm::PluginSharedPtr& plugin, uint32_t size,
+                         Event::Dispatcher& dispatcher, WasmFilterStats& stats)
+    : wasm_handle_(wasm_handle), plugin_(plugin), size_(size), dispatcher_(dispatcher),
+      stats_(stats) {
+  contexts_.reserve(size_);
+  refill();
+}
+
+ContextPool::~ContextPool() {
+  // The contexts were created in the VM, so give them the usual end of stream callbacks.
+  for (auto& context : contexts_) {
+    context->onDestroy();
+  }
+}
+
+std::shared_ptr<Context> ContextPool::take() {
+  if (contexts_.empty()) {
+    stats_.context_pool_misses_.inc();
+    return nullptr;
+  }
+  stats_.context_pool_hits_.inc();
+  auto context = std::move(contexts_.back());
+  contexts_.pop_back();
+  if (!refill_pending_) {
+    refill_pending_ = true;
+    dispatcher_.post([weak = std::weak_ptr<ContextPool>(shared_from_this())]() {
+      if (auto pool = weak.lock()) {
+        pool->refill();
+      }
+    });
+  }
+  return context;
+}
+
+void ContextPool::refill() {
+  refill_pending_ = false;
+  auto wasm = wasm_handle_->wasm().get();
+  if (wasm->isFailed()) {
+    return;
+  }
+  const uint32_t root_context_id = wasm->getRootContext(plugin_->root_id_)->id();
+  while (contexts_.size() < size_) {
+    auto context = std::make_shared<Context>(wasm, root_context_id, plugin_);
+    context->onCreate();
+    contexts_.push_back(std::move(context));
+  }
+}
+
 FilterConfig::FilterConfig(const envoy::extensions::filters::http::wasm::v3::Wasm& config,
+                           const std::string& stats_prefix,
                            Server::Configuration::FactoryContext& context)
-    : tls_slot_(context.threadLocal().allocateSlot()) {
+    : stats_{ALL_WASM_FILTER_STATS(POOL_COUNTER_PREFIX(context.scope(), stats_prefix + "wasm."))},
+      tls_slot_(context.threadLocal().allocateSlot()) {
   plugin_ = std::make_shared<Common::Wasm::Plugin>(
       config.config().name(), config.config().root_id(), config.config().vm_config().vm_id(),
       config.config().vm_config().runtime(),
@@ -24,7 +75,8 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::wasm::v3::Was
       context.direction(), context.localInfo(), &context.listenerMetadata());
 
   auto plugin = plugin_;
-  auto callback = [plugin, this](const Common::Wasm::WasmHandleSharedPtr& base_wasm) {
+  auto callback = [plugin, this, context_pool_size = config.context_pool_size()](
+                      const Common::Wasm::WasmHandleSharedPtr& base_wasm) {
     // NB: the Slot set() call doesn't complete inline, so all arguments must outlive this call.
     tls_slot_->set(
         [base_wasm,
@@ -35,12 +87,33 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::http::wasm::v3::Was
           return std::static_pointer_cast<ThreadLocal::ThreadLocalObject>(
               Common::Wasm::getOrCreateThreadLocalWasm(base_wasm, plugin, dispatcher));
         });
+    if (context_pool_slot_) {
+      // The thread local Wasm is cached per worker, so this returns the same VM as above.
+      context_pool_slot_->set([base_wasm, plugin, context_pool_size, &stats = stats_](
+                                  Event::Dispatcher& dispatcher)
+                                  -> std::shared_ptr<ThreadLocal::ThreadLocalObject> {
+        if (!base_wasm) {
+          return nullptr;
+        }
+        auto wasm_handle = Common::Wasm::getOrCreateThreadLocalWasm(base_wasm, plugin, dispatcher);
+        if (!wasm_handle || wasm_handle->wasm()->isFailed()) {
+          return nullptr;
+        }
+        return std::make_shared<ContextPool>(wasm_handle, plugin, context_pool_size, dispatcher,
+                                             stats);
+      });
+    }
   };
 
+  if (config.context_pool_size() > 0) {
+    context_pool_slot_ = context.threadLocal().allocateSlot();
+  }
+
   if (!Common::Wasm::createWasm(
           config.config().vm_config(), plugin_, context.scope().createScope(""),
           context.clusterManager(), context.initManager(), context.dispatcher(), context.random(),
-          context.api(), context.lifecycleNotifier(), remote_data_provider_, std::move(callback))) {
+          context.api(), context.lifecycleNotifier(), remote_data_provider_, create_wasm_handle_,
+          std::move(callback))) {
     throw Common::Wasm::WasmException(
         fmt::format("Unable to create Wasm HTTP filter {}", plugin->name_));
   }
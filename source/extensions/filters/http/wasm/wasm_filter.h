@@ -1,10 +1,12 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "envoy/extensions/filters/http/wasm/v3/wasm.pb.validate.h"
 #include "envoy/http/filter.h"
 #include "envoy/server/filter_config.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "extensions/common/wasm/wasm.h"
@@ -19,10 +21,50 @@ using Envoy::Extensions::Common::Wasm::Context;
 using Envoy::Extensions::Common::Wasm::Wasm;
 using Envoy::Extensions::Common::Wasm::WasmHandle;
 
+/**
+ * All Wasm filter stats. @see stats_macros.h
+ */
+#define ALL_WASM_FILTER_STATS(COUNTER)                                                             \
+  COUNTER(context_pool_hits)                                                                       \
+  COUNTER(context_pool_misses)
+
+/**
+ * Struct definition for all Wasm filter stats. @see stats_macros.h
+ */
+struct WasmFilterStats {
+  ALL_WASM_FILTER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+// Per-worker pool of stream contexts which have already been created in the VM.
+class ContextPool : public ThreadLocal::ThreadLocalObject,
+                    public std::enable_shared_from_this<ContextPool> {
+public:
+  ContextPool(const Common::Wasm::WasmHandleSharedPtr& wasm_handle,
+              const Common::Wasm::PluginSharedPtr& plugin, uint32_t size,
+              Event::Dispatcher& dispatcher, WasmFilterStats& stats);
+  ~ContextPool() override;
+
+  // Returns a pre-created context or nullptr if the pool is empty. A refill of the pool is
+  // scheduled on the dispatcher so that the replacement is not created on the request path.
+  std::shared_ptr<Context> take();
+  void refill();
+
+  size_t sizeForTesting() const { return contexts_.size(); }
+
+private:
+  const Common::Wasm::WasmHandleSharedPtr wasm_handle_;
+  const Common::Wasm::PluginSharedPtr plugin_;
+  const uint32_t size_;
+  Event::Dispatcher& dispatcher_;
+  WasmFilterStats& stats_;
+  std::vector<std::shared_ptr<Context>> contexts_;
+  bool refill_pending_{false};
+};
+
 class FilterConfig : Logger::Loggable<Logger::Id::wasm> {
 public:
   FilterConfig(const envoy::extensions::filters::http::wasm::v3::Wasm& proto_config,
-               Server::Configuration::FactoryContext& context);
+               const std::string& stats_prefix, Server::Configuration::FactoryContext& context);
 
   std::shared_ptr<Context> createFilter() {
     Wasm* wasm = nullptr;
@@ -32,6 +74,12 @@ public:
     if (plugin_->fail_open_ && (!wasm || wasm->isFailed())) {
       return nullptr;
     }
+    if (wasm && !wasm->isFailed() && context_pool_slot_ && context_pool_slot_->get()) {
+      auto context = context_pool_slot_->getTyped<ContextPool>().take();
+      if (context) {
+        return context;
+      }
+    }
     if (wasm && !root_context_id_) {
       root_context_id_ = wasm->getRootContext(plugin_->root_id_)->id();
     }
@@ -41,8 +89,12 @@ public:
 private:
   uint32_t root_context_id_{0};
   Envoy::Extensions::Common::Wasm::PluginSharedPtr plugin_;
+  WasmFilterStats stats_;
   ThreadLocal::SlotPtr tls_slot_;
+  ThreadLocal::SlotPtr context_pool_slot_;
   Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider_;
+  // Destroyed first, so that a VM compiled in the background is not set on the slots above.
+  Envoy::Extensions::Common::Wasm::CreateWasmHandlePtr create_wasm_handle_;
 };
 
 typedef std::shared_ptr<FilterConfig> FilterConfigSharedPtr;
@@ -35,7 +35,8 @@ FilterConfig::FilterConfig(const envoy::extensions::filters::network::wasm::v3::
   if (!Common::Wasm::createWasm(
           config.config().vm_config(), plugin_, context.scope().createScope(""),
           context.clusterManager(), context.initManager(), context.dispatcher(), context.random(),
-          context.api(), context.lifecycleNotifier(), remote_data_provider_, std::move(callback))) {
+          context.api(), context.lifecycleNotifier(), remote_data_provider_, create_wasm_handle_,
+          std::move(callback))) {
     throw Common::Wasm::WasmException(
         fmt::format("Unable to create Wasm network filter {}", plugin->name_));
   }
@@ -46,6 +46,8 @@ private:
   Envoy::Extensions::Common::Wasm::PluginSharedPtr plugin_;
   ThreadLocal::SlotPtr tls_slot_;
   Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider_;
+  // Destroyed first, so that a VM compiled in the background is not set on the slot above.
+  Envoy::Extensions::Common::Wasm::CreateWasmHandlePtr create_wasm_handle_;
 };
 
 typedef std::shared_ptr<FilterConfig> FilterConfigSharedPtr;
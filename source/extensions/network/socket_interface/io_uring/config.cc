@@ -0,0 +1,128 @@
+#include "extensions/network/socket_interface/io_uring/config.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/config/core/v3/address.pb.h"
+#include "envoy/network/resolver.h"
+#include "envoy/registry/registry.h"
+
+#include "common/common/fmt.h"
+#include "common/network/address_impl.h"
+#include "common/network/utility.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+namespace {
+
+// The read buffers are allocated up front for each worker, so their total is bounded.
+constexpr uint64_t MaxProvidedBufferBytes = 64 * 1024 * 1024;
+
+} // namespace
+
+Network::IoHandlePtr IoUringSocketInterface::makeSocket(int socket_fd, bool socket_v6only,
+                                                        Network::Socket::Type socket_type) const {
+  // Datagram sockets use the default implementation.
+  if (socket_type == Network::Socket::Type::Datagram) {
+    return Network::SocketInterfaceImpl::makeSocket(socket_fd, socket_v6only, socket_type);
+  }
+  return std::make_unique<IoUringSocketHandle>(*this, socket_fd, socket_v6only, false);
+}
+
+IoUringWorker* IoUringSocketInterface::currentWorker() const {
+  if (worker_slot_ == nullptr || !worker_slot_->currentThreadRegistered()) {
+    return nullptr;
+  }
+  ThreadLocal::ThreadLocalObjectSharedPtr worker = worker_slot_->get();
+  return worker != nullptr ? static_cast<IoUringWorker*>(worker.get()) : nullptr;
+}
+
+Server::BootstrapExtensionPtr IoUringSocketInterface::createBootstrapExtension(
+    const Protobuf::Message& config, Server::Configuration::ServerFactoryContext& context) {
+  return std::make_unique<IoUringSocketInterfaceExtension>(
+      *this,
+      MessageUtil::downcastAndValidate<const envoy::extensions::network::socket_interface::
+                                           io_uring::v3alpha::IoUringSocketInterface&>(
+          config, context.messageValidationContext().staticValidationVisitor()),
+      context);
+}
+
+ProtobufTypes::MessagePtr IoUringSocketInterface::createEmptyConfigProto() {
+  return std::make_unique<
+      envoy::extensions::network::socket_interface::io_uring::v3alpha::IoUringSocketInterface>();
+}
+
+IoUringSocketInterfaceExtension::IoUringSocketInterfaceExtension(
+    IoUringSocketInterface& sock_interface,
+    const envoy::extensions::network::socket_interface::io_uring::v3alpha::IoUringSocketInterface&
+        config,
+    Server::Configuration::ServerFactoryContext& context)
+    : Network::SocketInterfaceExtension(sock_interface), sock_interface_(sock_interface),
+      slot_(context.threadLocal().allocateSlot()) {
+  const IoUringWorkerConfig worker_config{
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, io_uring_size, 1024),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, read_buffer_size, 16384),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, read_buffers, 256)};
+  const uint64_t provided_bytes =
+      static_cast<uint64_t>(worker_config.read_buffer_size_) * worker_config.read_buffers_;
+  if (provided_bytes > MaxProvidedBufferBytes) {
+    throw EnvoyException(fmt::format(
+        "io_uring socket interface: read_buffer_size * read_buffers is {} bytes, more than the {} "
+        "bytes allowed per worker",
+        provided_bytes, MaxProvidedBufferBytes));
+  }
+  // Bootstrap extensions are created before the server registers its threads, so the workers are
+  // created when it starts. Sockets created before then use the default implementation.
+  startup_handle_ = context.lifecycleNotifier().registerCallback(
+      Server::ServerLifecycleNotifier::Stage::Startup, [this, worker_config]() {
+        slot_->set([worker_config](Event::Dispatcher& dispatcher) {
+          return IoUringWorker::create(dispatcher, worker_config);
+        });
+      });
+  sock_interface_.setWorkerSlot(slot_.get());
+}
+
+IoUringSocketInterfaceExtension::~IoUringSocketInterfaceExtension() {
+  sock_interface_.setWorkerSlot(nullptr);
+}
+
+REGISTER_FACTORY(IoUringSocketInterface, Server::Configuration::BootstrapExtensionFactory);
+
+/**
+ * Resolves IP addresses whose sockets are created by the io_uring socket interface, to select it
+ * for individual listeners and clusters.
+ */
+class IoUringResolver : public Network::Address::Resolver {
+public:
+  Network::Address::InstanceConstSharedPtr
+  resolve(const envoy::config::core::v3::SocketAddress& socket_address) override {
+    if (socket_address.port_specifier_case() ==
+        envoy::config::core::v3::SocketAddress::PortSpecifierCase::kNamedPort) {
+      throw EnvoyException(fmt::format("io_uring resolver can't handle port specifier type {}",
+                                       socket_address.port_specifier_case()));
+    }
+    const Network::SocketInterface* sock_interface =
+        Network::socketInterface("envoy.network.socket_interface.io_uring");
+    const Network::Address::InstanceConstSharedPtr address =
+        Network::Utility::parseInternetAddress(
+            socket_address.address(), socket_address.port_value(), !socket_address.ipv4_compat());
+    if (address->ip()->version() == Network::Address::IpVersion::v4) {
+      return std::make_shared<Network::Address::Ipv4Instance>(
+          reinterpret_cast<const sockaddr_in*>(address->sockAddr()), sock_interface);
+    }
+    return std::make_shared<Network::Address::Ipv6Instance>(
+        *reinterpret_cast<const sockaddr_in6*>(address->sockAddr()),
+        address->ip()->ipv6()->v6only(), sock_interface);
+  }
+
+  std::string name() const override { return "envoy.network.resolvers.io_uring"; }
+};
+
+REGISTER_FACTORY(IoUringResolver, Network::Address::Resolver);
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
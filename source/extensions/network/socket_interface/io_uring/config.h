@@ -0,0 +1,67 @@
+#pragma once
+
+#include "envoy/extensions/network/socket_interface/io_uring/v3alpha/io_uring_socket_interface.pb.h"
+#include "envoy/server/lifecycle_notifier.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/network/socket_interface_impl.h"
+
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_handle.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+/**
+ * Config registration for the io_uring socket interface. @see SocketInterfaceBase.
+ */
+class IoUringSocketInterface : public Network::SocketInterfaceImpl, public IoUringWorkerProvider {
+public:
+  // Server::Configuration::BootstrapExtensionFactory
+  Server::BootstrapExtensionPtr
+  createBootstrapExtension(const Protobuf::Message& config,
+                           Server::Configuration::ServerFactoryContext& context) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override;
+  std::string name() const override { return "envoy.network.socket_interface.io_uring"; }
+
+  // IoUringWorkerProvider
+  IoUringWorker* currentWorker() const override;
+
+  void setWorkerSlot(ThreadLocal::Slot* slot) { worker_slot_ = slot; }
+
+protected:
+  // Network::SocketInterfaceImpl
+  Network::IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
+                                  Network::Socket::Type socket_type) const override;
+
+private:
+  // Owned by the bootstrap extension, nullptr if it has not been configured.
+  ThreadLocal::Slot* worker_slot_{nullptr};
+};
+
+/**
+ * Holds the per thread io_uring workers, which are created once the server has registered its
+ * threads.
+ */
+class IoUringSocketInterfaceExtension : public Network::SocketInterfaceExtension {
+public:
+  IoUringSocketInterfaceExtension(
+      IoUringSocketInterface& sock_interface,
+      const envoy::extensions::network::socket_interface::io_uring::v3alpha::IoUringSocketInterface&
+          config,
+      Server::Configuration::ServerFactoryContext& context);
+  ~IoUringSocketInterfaceExtension() override;
+
+private:
+  IoUringSocketInterface& sock_interface_;
+  ThreadLocal::SlotPtr slot_;
+  Server::ServerLifecycleNotifier::HandlePtr startup_handle_;
+};
+
+DECLARE_FACTORY(IoUringSocketInterface);
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,163 @@
+#include "extensions/network/socket_interface/io_uring/io_uring_impl.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+namespace {
+
+int setup(uint32_t entries, io_uring_params* params) {
+  return syscall(__NR_io_uring_setup, entries, params);
+}
+
+int enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+int registerRing(int fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+  return syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+template <class T> T* offset(void* base, uint32_t off) {
+  return reinterpret_cast<T*>(static_cast<char*>(base) + off);
+}
+
+} // namespace
+
+std::unique_ptr<IoUringImpl> IoUringImpl::create(uint32_t entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  auto ring = std::unique_ptr<IoUringImpl>(new IoUringImpl());
+  ring->ring_fd_ = setup(entries, &params);
+  if (ring->ring_fd_ < 0) {
+    return nullptr;
+  }
+  // Reads and writes on non-blocking sockets must be retried by the kernel once the socket is
+  // ready rather than completing with EAGAIN (5.7), and completions must not be dropped when the
+  // completion queue is full (5.5).
+  if (!(params.features & IORING_FEAT_FAST_POLL) || !(params.features & IORING_FEAT_NODROP)) {
+    errno = ENOTSUP;
+    return nullptr;
+  }
+
+  ring->sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    ring->sq_ring_size_ = ring->cq_ring_size_ =
+        std::max(ring->sq_ring_size_, ring->cq_ring_size_);
+  }
+  ring->sq_ring_ = mmap(nullptr, ring->sq_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->ring_fd_, IORING_OFF_SQ_RING);
+  if (ring->sq_ring_ == MAP_FAILED) {
+    ring->sq_ring_ = nullptr;
+    return nullptr;
+  }
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    ring->cq_ring_ = ring->sq_ring_;
+  } else {
+    ring->cq_ring_ = mmap(nullptr, ring->cq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring->ring_fd_, IORING_OFF_CQ_RING);
+    if (ring->cq_ring_ == MAP_FAILED) {
+      ring->cq_ring_ = nullptr;
+      return nullptr;
+    }
+  }
+  ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring->ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return nullptr;
+  }
+  ring->sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  ring->sq_head_ = offset<uint32_t>(ring->sq_ring_, params.sq_off.head);
+  ring->sq_tail_ = offset<uint32_t>(ring->sq_ring_, params.sq_off.tail);
+  ring->sq_flags_ = offset<uint32_t>(ring->sq_ring_, params.sq_off.flags);
+  ring->sq_array_ = offset<uint32_t>(ring->sq_ring_, params.sq_off.array);
+  ring->sq_mask_ = *offset<uint32_t>(ring->sq_ring_, params.sq_off.ring_mask);
+  ring->sq_entries_ = *offset<uint32_t>(ring->sq_ring_, params.sq_off.ring_entries);
+  ring->cq_head_ = offset<uint32_t>(ring->cq_ring_, params.cq_off.head);
+  ring->cq_tail_ = offset<uint32_t>(ring->cq_ring_, params.cq_off.tail);
+  ring->cqes_ = offset<io_uring_cqe>(ring->cq_ring_, params.cq_off.cqes);
+  ring->cq_mask_ = *offset<uint32_t>(ring->cq_ring_, params.cq_off.ring_mask);
+  ring->sqe_tail_ = ring->submitted_tail_ = *ring->sq_tail_;
+
+  // Kernels which can probe (5.6) report the operations they support. Older ones are rejected by
+  // the checks of the operations the socket interface requires.
+  const uint32_t num_ops = 256;
+  std::vector<char> probe_storage(sizeof(io_uring_probe) + num_ops * sizeof(io_uring_probe_op));
+  auto* probe = reinterpret_cast<io_uring_probe*>(probe_storage.data());
+  if (registerRing(ring->ring_fd_, IORING_REGISTER_PROBE, probe, num_ops) == 0) {
+    ring->supported_ops_.resize(probe->last_op + 1);
+    for (uint32_t i = 0; i < probe->ops_len && i < num_ops; i++) {
+      if (probe->ops[i].flags & IO_URING_OP_SUPPORTED) {
+        ring->supported_ops_[probe->ops[i].op] = true;
+      }
+    }
+  }
+  return ring;
+}
+
+IoUringImpl::~IoUringImpl() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+}
+
+io_uring_sqe* IoUringImpl::getSqe() {
+  if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    return nullptr;
+  }
+  const uint32_t index = sqe_tail_ & sq_mask_;
+  sq_array_[index] = index;
+  sqe_tail_++;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+int IoUringImpl::submit() {
+  const uint32_t to_submit = sqe_tail_ - submitted_tail_;
+  if (to_submit == 0) {
+    return 0;
+  }
+  __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+  const int rc = enter(ring_fd_, to_submit, 0, 0);
+  if (rc < 0) {
+    return -errno;
+  }
+  // Entries the kernel did not consume stay in the ring and are submitted by the next call.
+  submitted_tail_ += rc;
+  return rc;
+}
+
+int IoUringImpl::registerEventFd(int fd) {
+  return registerRing(ring_fd_, IORING_REGISTER_EVENTFD, &fd, 1) == 0 ? 0 : -errno;
+}
+
+int IoUringImpl::flushOverflow() {
+  return enter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS) < 0 ? -errno : 0;
+}
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/non_copyable.h"
+
+// Definitions which are missing from the headers of kernels older than the running one.
+#ifndef IORING_SQ_CQ_OVERFLOW
+#define IORING_SQ_CQ_OVERFLOW (1U << 1)
+#endif
+#ifndef IORING_CQE_F_MORE
+#define IORING_CQE_F_MORE (1U << 1)
+#endif
+#ifndef IORING_ACCEPT_MULTISHOT
+#define IORING_ACCEPT_MULTISHOT (1U << 0)
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+/**
+ * A Linux io_uring instance driven directly through the io_uring_setup, io_uring_enter and
+ * io_uring_register system calls, so that only the kernel headers are required. Not thread safe:
+ * each instance is owned by a single worker.
+ */
+class IoUringImpl : NonCopyable {
+public:
+  ~IoUringImpl();
+
+  /**
+   * @param entries supplies the number of submission queue entries, rounded up to a power of two
+   *        by the kernel.
+   * @return the ring or nullptr with errno set if io_uring is unavailable or lacks the features
+   *         the socket interface relies on.
+   */
+  static std::unique_ptr<IoUringImpl> create(uint32_t entries);
+
+  /**
+   * @return a zeroed submission queue entry which is submitted by the next submit(), or nullptr if
+   *         the submission queue is full.
+   */
+  io_uring_sqe* getSqe();
+
+  /**
+   * Submits every entry obtained by getSqe() since the last call.
+   * @return the number of entries submitted or -errno.
+   */
+  int submit();
+
+  /**
+   * @return the number of entries obtained by getSqe() which have not been submitted yet.
+   */
+  uint32_t pendingSubmissions() const { return sqe_tail_ - submitted_tail_; }
+
+  /**
+   * Calls cb with each available completion, including completions the kernel held back because
+   * the completion queue was full.
+   */
+  template <class Callback> void forEachCompletion(Callback cb) {
+    for (;;) {
+      uint32_t head = *cq_head_;
+      const uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      for (; head != tail; head++) {
+        // Copied out so that the slot can be reused by the kernel while cb runs.
+        const io_uring_cqe cqe = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        cb(cqe);
+      }
+      if (!(__atomic_load_n(sq_flags_, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW) ||
+          flushOverflow() < 0) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * Registers fd as an eventfd which is signalled each time completions are posted.
+   * @return 0 or -errno.
+   */
+  int registerEventFd(int fd);
+
+  /**
+   * @return whether the kernel supports the operation.
+   */
+  bool isOpSupported(uint8_t op) const { return op < supported_ops_.size() && supported_ops_[op]; }
+
+private:
+  IoUringImpl() = default;
+
+  int flushOverflow();
+
+  int ring_fd_{-1};
+  void* sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void* cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  io_uring_sqe* sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  // Pointers into the rings shared with the kernel.
+  uint32_t* sq_head_{nullptr};
+  uint32_t* sq_tail_{nullptr};
+  uint32_t* sq_flags_{nullptr};
+  uint32_t* sq_array_{nullptr};
+  uint32_t sq_mask_{0};
+  uint32_t sq_entries_{0};
+  uint32_t* cq_head_{nullptr};
+  uint32_t* cq_tail_{nullptr};
+  io_uring_cqe* cqes_{nullptr};
+  uint32_t cq_mask_{0};
+
+  // Entries are handed out at sqe_tail_ and published to the kernel up to it by submit().
+  uint32_t sqe_tail_{0};
+  uint32_t submitted_tail_{0};
+
+  std::vector<bool> supported_ops_;
+};
+
+using IoUringImplPtr = std::unique_ptr<IoUringImpl>;
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
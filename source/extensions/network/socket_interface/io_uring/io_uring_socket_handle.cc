@@ -0,0 +1,137 @@
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_handle.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+IoUringSocketHandle::IoUringSocketHandle(const IoUringWorkerProvider& workers, os_fd_t fd,
+                                         bool socket_v6only, bool connected)
+    : Network::IoSocketHandleImpl(fd, socket_v6only), workers_(workers), connected_(connected) {}
+
+IoUringSocketHandle::~IoUringSocketHandle() {
+  if (socket_ != nullptr) {
+    IoUringSocketHandle::close();
+  }
+}
+
+IoUringSocket* IoUringSocketHandle::socket() {
+  if (socket_ == nullptr && !listening_ && SOCKET_VALID(fd_)) {
+    worker_ = workers_.currentWorker();
+    if (worker_ != nullptr) {
+      socket_ = std::make_unique<IoUringSocket>(*worker_, fd_, connected_);
+    }
+  }
+  return socket_.get();
+}
+
+Api::IoCallUint64Result IoUringSocketHandle::close() {
+  if (socket_ == nullptr) {
+    return Network::IoSocketHandleImpl::close();
+  }
+  // The worker closes the file descriptor once the socket's requests have completed.
+  worker_->closeSocket(std::move(socket_));
+  SET_SOCKET_INVALID(fd_);
+  return Api::ioCallUint64ResultNoError();
+}
+
+Api::IoCallUint64Result IoUringSocketHandle::readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                                   uint64_t num_slice) {
+  if (socket_ == nullptr) {
+    return Network::IoSocketHandleImpl::readv(max_length, slices, num_slice);
+  }
+  return socket_->read(max_length, slices, num_slice, false);
+}
+
+Api::IoCallUint64Result IoUringSocketHandle::writev(const Buffer::RawSlice* slices,
+                                                    uint64_t num_slice) {
+  if (socket_ == nullptr) {
+    return Network::IoSocketHandleImpl::writev(slices, num_slice);
+  }
+  return socket_->write(slices, num_slice);
+}
+
+Api::IoCallUint64Result IoUringSocketHandle::recv(void* buffer, size_t length, int flags) {
+  if (socket_ == nullptr) {
+    return Network::IoSocketHandleImpl::recv(buffer, length, flags);
+  }
+  Buffer::RawSlice slice{buffer, length};
+  return socket_->read(length, &slice, 1, flags & MSG_PEEK);
+}
+
+Api::SysCallIntResult IoUringSocketHandle::listen(int backlog) {
+  const Api::SysCallIntResult result = Network::IoSocketHandleImpl::listen(backlog);
+  if (result.rc_ == 0) {
+    listening_ = true;
+  }
+  return result;
+}
+
+Network::IoHandlePtr IoUringSocketHandle::accept(struct sockaddr* addr, socklen_t* addrlen) {
+  IoUringWorker* worker = listening_ ? workers_.currentWorker() : nullptr;
+  IoUringAcceptor* acceptor = worker != nullptr ? worker->acceptor(fd_) : nullptr;
+  if (acceptor == nullptr) {
+    auto result = Api::OsSysCallsSingleton::get().accept(fd_, addr, addrlen);
+    if (SOCKET_INVALID(result.rc_)) {
+      return nullptr;
+    }
+    return std::make_unique<IoUringSocketHandle>(workers_, result.rc_, socket_v6only_, true);
+  }
+  const os_fd_t fd = acceptor->accept();
+  if (SOCKET_INVALID(fd)) {
+    return nullptr;
+  }
+  // Accepts are submitted without an address buffer, so the peer address is looked up here.
+  if (addr != nullptr && addrlen != nullptr &&
+      Api::OsSysCallsSingleton::get().getpeername(fd, addr, addrlen).rc_ != 0) {
+    *addrlen = 0;
+  }
+  return std::make_unique<IoUringSocketHandle>(workers_, fd, socket_v6only_, true);
+}
+
+Api::SysCallIntResult IoUringSocketHandle::connect(Network::Address::InstanceConstSharedPtr address) {
+  IoUringSocket* socket = this->socket();
+  if (socket == nullptr) {
+    return Network::IoSocketHandleImpl::connect(address);
+  }
+  return socket->connect(*address);
+}
+
+Event::FileEventPtr IoUringSocketHandle::createFileEvent(Event::Dispatcher& dispatcher,
+                                                         Event::FileReadyCb cb,
+                                                         Event::FileTriggerType trigger,
+                                                         uint32_t events) {
+  if (listening_) {
+    IoUringWorker* worker = workers_.currentWorker();
+    if (worker != nullptr && worker->acceptor(fd_) == nullptr) {
+      return worker->createAcceptorFileEvent(fd_, cb, events);
+    }
+  } else if (socket() != nullptr) {
+    ASSERT(&worker_->dispatcher() == &dispatcher);
+    return socket_->createFileEvent(dispatcher, cb, events);
+  }
+  return Network::IoSocketHandleImpl::createFileEvent(dispatcher, cb, trigger, events);
+}
+
+Api::SysCallIntResult IoUringSocketHandle::shutdown(int how) {
+  if (socket_ == nullptr) {
+    return Network::IoSocketHandleImpl::shutdown(how);
+  }
+  return socket_->shutdown(how);
+}
+
+absl::optional<uint64_t> IoUringSocketHandle::bytesAvailable() {
+  if (socket_ == nullptr) {
+    return Network::IoSocketHandleImpl::bytesAvailable();
+  }
+  // Data still in the socket is only read once the completed reads have been consumed.
+  return socket_->bufferedBytes();
+}
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common/network/io_socket_handle_impl.h"
+
+#include "extensions/network/socket_interface/io_uring/io_uring_worker.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+/**
+ * Supplies the io_uring worker of the calling thread, if it has one.
+ */
+class IoUringWorkerProvider {
+public:
+  virtual ~IoUringWorkerProvider() = default;
+
+  /**
+   * @return the calling thread's worker or nullptr if io_uring is not used on the thread.
+   */
+  virtual IoUringWorker* currentWorker() const PURE;
+};
+
+/**
+ * IoHandle for stream sockets whose I/O goes through the io_uring of the thread which creates their
+ * first file event. Sockets without a file event, e.g. listen sockets before workers use them, and
+ * sockets on threads without a worker make system calls as IoSocketHandleImpl does.
+ */
+class IoUringSocketHandle : public Network::IoSocketHandleImpl {
+public:
+  IoUringSocketHandle(const IoUringWorkerProvider& workers, os_fd_t fd, bool socket_v6only,
+                      bool connected);
+  ~IoUringSocketHandle() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  Api::SysCallIntResult listen(int backlog) override;
+  Network::IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  Api::SysCallIntResult connect(Network::Address::InstanceConstSharedPtr address) override;
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override;
+  Api::SysCallIntResult shutdown(int how) override;
+  absl::optional<uint64_t> bytesAvailable() override;
+
+private:
+  // Moves the socket's I/O to the calling thread's worker, if it has one.
+  IoUringSocket* socket();
+
+  const IoUringWorkerProvider& workers_;
+  IoUringWorker* worker_{nullptr};
+  IoUringSocketPtr socket_;
+  bool connected_;
+  bool listening_{false};
+};
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
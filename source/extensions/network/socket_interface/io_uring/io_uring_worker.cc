@@ -0,0 +1,687 @@
+#include "extensions/network/socket_interface/io_uring/io_uring_worker.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+#include "common/common/utility.h"
+#include "common/network/io_socket_error_impl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+namespace {
+
+// Cancelled connections and writes are given between one and two periods to complete.
+constexpr std::chrono::milliseconds LingerPeriod{10000};
+
+Api::IoCallUint64Result ioResult(uint64_t rc) {
+  return Api::IoCallUint64Result(
+      rc, Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+}
+
+Api::IoCallUint64Result ioError(int error) {
+  if (error == SOCKET_ERROR_AGAIN) {
+    return Api::IoCallUint64Result(
+        0, Api::IoErrorPtr(Network::IoSocketError::getIoSocketEagainInstance(),
+                           Network::IoSocketError::deleteIoError));
+  }
+  return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(error),
+                                                    Network::IoSocketError::deleteIoError));
+}
+
+} // namespace
+
+IoUringFileEvent::IoUringFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                   uint32_t events, ReadinessSource& source)
+    : cb_(cb), source_(&source),
+      schedulable_(dispatcher.createSchedulableCallback([this]() { onScheduled(); })) {
+  setEnabled(events);
+}
+
+IoUringFileEvent::~IoUringFileEvent() {
+  if (source_ != nullptr) {
+    source_->onFileEventDestroyed();
+  }
+}
+
+void IoUringFileEvent::activate(uint32_t events) {
+  injected_ |= events;
+  schedulable_->scheduleCallbackNextIteration();
+}
+
+void IoUringFileEvent::setEnabled(uint32_t events) {
+  enabled_ = events;
+  ready_ = source_ != nullptr ? source_->readiness() : 0;
+  if (ready_ & enabled_) {
+    schedulable_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void IoUringFileEvent::notify(uint32_t events) {
+  ready_ |= events;
+  if (ready_ & enabled_) {
+    schedulable_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void IoUringFileEvent::onScheduled() {
+  const uint32_t events = (ready_ & enabled_) | injected_;
+  ready_ = 0;
+  injected_ = 0;
+  if (events != 0) {
+    cb_(events);
+  }
+}
+
+IoUringSocket::IoUringSocket(IoUringWorker& parent, os_fd_t fd, bool connected)
+    : parent_(parent), fd_(fd), connected_(connected) {}
+
+IoUringSocket::~IoUringSocket() {
+  if (file_event_ != nullptr) {
+    file_event_->detachSource();
+  }
+  for (auto& buffer : read_buffers_) {
+    releaseReadBuffer(buffer);
+  }
+  Api::OsSysCallsSingleton::get().close(fd_);
+}
+
+Event::FileEventPtr IoUringSocket::createFileEvent(Event::Dispatcher& dispatcher,
+                                                   Event::FileReadyCb cb, uint32_t events) {
+  // Only the most recent event is notified, e.g. the connection's once listener filters are done.
+  if (file_event_ != nullptr) {
+    file_event_->detachSource();
+  }
+  auto file_event = std::make_unique<IoUringFileEvent>(dispatcher, cb, events, *this);
+  file_event_ = file_event.get();
+  submitRead();
+  return file_event;
+}
+
+uint64_t IoUringSocket::bufferedBytes() const {
+  uint64_t bytes = 0;
+  for (const ReadBuffer& buffer : read_buffers_) {
+    bytes += buffer.length_ - buffer.offset_;
+  }
+  return bytes;
+}
+
+uint32_t IoUringSocket::readiness() const {
+  uint32_t events = 0;
+  if (!read_buffers_.empty() || end_of_stream_ || read_error_ != 0) {
+    events |= Event::FileReadyType::Read;
+  }
+  if (end_of_stream_) {
+    events |= Event::FileReadyType::Closed;
+  }
+  if (connected_ && !connect_in_flight_ &&
+      (write_error_ != 0 || write_buffer_.length() < WriteBufferLimit)) {
+    events |= Event::FileReadyType::Write;
+  }
+  return events;
+}
+
+void IoUringSocket::notify(uint32_t events) {
+  if (file_event_ != nullptr) {
+    file_event_->notify(events);
+  }
+}
+
+Api::IoCallUint64Result IoUringSocket::read(uint64_t max_length, Buffer::RawSlice* slices,
+                                            uint64_t num_slice, bool peek) {
+  uint64_t copied = 0;
+  uint64_t slice = 0;
+  uint64_t slice_offset = 0;
+  for (size_t i = 0; i < read_buffers_.size() && slice < num_slice && copied < max_length; i++) {
+    ReadBuffer& buffer = read_buffers_[i];
+    uint32_t offset = buffer.offset_;
+    while (offset < buffer.length_ && slice < num_slice && copied < max_length) {
+      const uint64_t length = std::min({static_cast<uint64_t>(buffer.length_ - offset),
+                                        slices[slice].len_ - slice_offset, max_length - copied});
+      memcpy(static_cast<char*>(slices[slice].mem_) + slice_offset, buffer.data_ + offset, length);
+      offset += length;
+      slice_offset += length;
+      copied += length;
+      if (slice_offset == slices[slice].len_) {
+        slice++;
+        slice_offset = 0;
+      }
+    }
+    if (!peek) {
+      buffer.offset_ = offset;
+    }
+  }
+  if (!peek) {
+    while (!read_buffers_.empty() && read_buffers_.front().offset_ == read_buffers_.front().length_) {
+      releaseReadBuffer(read_buffers_.front());
+      read_buffers_.pop_front();
+    }
+    submitRead();
+  }
+  if (copied > 0 || max_length == 0) {
+    return ioResult(copied);
+  }
+  if (read_error_ != 0) {
+    return ioError(read_error_);
+  }
+  if (end_of_stream_) {
+    return ioResult(0);
+  }
+  return ioError(SOCKET_ERROR_AGAIN);
+}
+
+Api::IoCallUint64Result IoUringSocket::write(const Buffer::RawSlice* slices, uint64_t num_slice) {
+  if (write_error_ != 0) {
+    return ioError(write_error_);
+  }
+  if (shutdown_pending_) {
+    return ioError(EPIPE);
+  }
+  if (!connected_ || connect_in_flight_) {
+    return ioError(SOCKET_ERROR_AGAIN);
+  }
+  const uint64_t room = WriteBufferLimit - std::min(write_buffer_.length(), WriteBufferLimit);
+  uint64_t accepted = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    const uint64_t length = std::min(static_cast<uint64_t>(slices[i].len_), room - accepted);
+    write_buffer_.add(slices[i].mem_, length);
+    accepted += length;
+    if (length < slices[i].len_) {
+      // Write readiness is reported again once the buffered data has been flushed below the limit.
+      write_blocked_ = true;
+      break;
+    }
+  }
+  submitWrite();
+  if (accepted == 0 && write_blocked_) {
+    return ioError(SOCKET_ERROR_AGAIN);
+  }
+  return ioResult(accepted);
+}
+
+Api::SysCallIntResult IoUringSocket::connect(const Network::Address::Instance& address) {
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().connect(fd_, address.sockAddr(), address.sockAddrLen());
+  if (result.rc_ == 0) {
+    connected_ = true;
+    submitRead();
+    notify(Event::FileReadyType::Write);
+  } else if (result.errno_ == SOCKET_ERROR_IN_PROGRESS) {
+    // The socket becomes writable once the connection is established or has failed, which the
+    // connection finds out through SO_ERROR as usual.
+    connected_ = true;
+    connect_in_flight_ = true;
+    io_uring_sqe* sqe = parent_.getSqe(connect_request_);
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd_;
+    sqe->poll_events = POLLOUT;
+  }
+  return result;
+}
+
+Api::SysCallIntResult IoUringSocket::shutdown(int how) {
+  if (how != SHUT_RD && (write_in_flight_ || write_buffer_.length() > 0)) {
+    // Sending FIN has to wait for the data which has already been accepted by write().
+    shutdown_pending_ = true;
+    if (how == SHUT_RDWR) {
+      return Api::OsSysCallsSingleton::get().shutdown(fd_, SHUT_RD);
+    }
+    return {0, 0};
+  }
+  return Api::OsSysCallsSingleton::get().shutdown(fd_, how);
+}
+
+void IoUringSocket::close() {
+  closed_ = true;
+  if (file_event_ != nullptr) {
+    file_event_->detachSource();
+    file_event_ = nullptr;
+  }
+  for (auto& buffer : read_buffers_) {
+    releaseReadBuffer(buffer);
+  }
+  read_buffers_.clear();
+  if (read_in_flight_) {
+    parent_.cancel(read_request_);
+  }
+  if (connect_in_flight_) {
+    parent_.cancel(connect_request_);
+  }
+}
+
+bool IoUringSocket::finished() const {
+  return closed_ && !read_in_flight_ && !write_in_flight_ && !connect_in_flight_;
+}
+
+void IoUringSocket::onLinger() {
+  // Writes which have not completed within a period of the socket being closed are cancelled.
+  if (lingering_ && write_in_flight_) {
+    parent_.cancel(write_request_);
+  }
+  lingering_ = true;
+}
+
+void IoUringSocket::submitRead(bool heap_buffer) {
+  if (read_in_flight_ || !connected_ || connect_in_flight_ || closed_ || end_of_stream_ ||
+      read_error_ != 0 || read_buffers_.size() >= MaxReadBuffers) {
+    return;
+  }
+  io_uring_sqe* sqe = parent_.getSqe(read_request_);
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd_;
+  sqe->len = parent_.readBufferSize();
+  if (parent_.hasProvidedBuffers() && !heap_buffer) {
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = IoUringWorker::ReadBufferGroup;
+  } else {
+    heap_read_buffer_.reset(new char[parent_.readBufferSize()]);
+    sqe->addr = reinterpret_cast<uint64_t>(heap_read_buffer_.get());
+  }
+  read_in_flight_ = true;
+}
+
+void IoUringSocket::submitWrite() {
+  if (write_in_flight_ || write_buffer_.length() == 0) {
+    return;
+  }
+  write_iovecs_.clear();
+  for (const auto& slice : write_buffer_.getRawSlices(IOV_MAX)) {
+    write_iovecs_.push_back({slice.mem_, slice.len_});
+  }
+  io_uring_sqe* sqe = parent_.getSqe(write_request_);
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(write_iovecs_.data());
+  sqe->len = write_iovecs_.size();
+  write_in_flight_ = true;
+}
+
+void IoUringSocket::releaseReadBuffer(ReadBuffer& buffer) {
+  if (buffer.buffer_id_ >= 0) {
+    parent_.releaseProvidedBuffer(buffer.buffer_id_);
+    buffer.buffer_id_ = -1;
+  }
+}
+
+void IoUringSocket::onCompletion(RequestType type, int32_t result, uint32_t flags) {
+  switch (type) {
+  case RequestType::Read:
+    onRead(result, flags);
+    break;
+  case RequestType::Write:
+    onWrite(result);
+    break;
+  case RequestType::Connect:
+    connect_in_flight_ = false;
+    if (!closed_) {
+      submitRead();
+      notify(Event::FileReadyType::Write);
+    }
+    break;
+  case RequestType::Accept:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+void IoUringSocket::onRead(int32_t result, uint32_t flags) {
+  read_in_flight_ = false;
+  ReadBuffer buffer{nullptr, 0, 0, -1, std::move(heap_read_buffer_)};
+  if (flags & IORING_CQE_F_BUFFER) {
+    buffer.buffer_id_ = flags >> IORING_CQE_BUFFER_SHIFT;
+    buffer.data_ = parent_.providedBuffer(buffer.buffer_id_);
+  } else {
+    buffer.data_ = buffer.heap_.get();
+  }
+  if (closed_ || result <= 0) {
+    releaseReadBuffer(buffer);
+  }
+  if (closed_) {
+    return;
+  }
+  if (result > 0) {
+    buffer.length_ = result;
+    read_buffers_.push_back(std::move(buffer));
+  } else if (result == 0) {
+    end_of_stream_ = true;
+  } else if (result == -ENOBUFS) {
+    // Every provided buffer is in use, so this read brings its own.
+    submitRead(true);
+    return;
+  } else if (result == -EAGAIN || result == -EINTR) {
+    submitRead();
+    return;
+  } else {
+    read_error_ = -result;
+  }
+  notify(Event::FileReadyType::Read | (end_of_stream_ ? Event::FileReadyType::Closed : 0));
+  submitRead();
+}
+
+void IoUringSocket::onWrite(int32_t result) {
+  write_in_flight_ = false;
+  if (result >= 0) {
+    write_buffer_.drain(result);
+  } else if (result != -EAGAIN && result != -EINTR) {
+    ENVOY_LOG(trace, "io_uring write on fd {} failed: {}", fd_, errorDetails(-result));
+    write_error_ = -result;
+    write_buffer_.drain(write_buffer_.length());
+  }
+  if (write_buffer_.length() == 0 && shutdown_pending_ && !closed_) {
+    shutdown_pending_ = false;
+    Api::OsSysCallsSingleton::get().shutdown(fd_, SHUT_WR);
+  }
+  submitWrite();
+  if (!closed_ &&
+      (write_error_ != 0 || (write_blocked_ && write_buffer_.length() < WriteBufferLimit))) {
+    write_blocked_ = false;
+    notify(Event::FileReadyType::Write);
+  }
+}
+
+IoUringAcceptor::IoUringAcceptor(IoUringWorker& parent, os_fd_t listen_fd)
+    : parent_(parent), listen_fd_(listen_fd) {}
+
+IoUringAcceptor::~IoUringAcceptor() {
+  if (file_event_ != nullptr) {
+    file_event_->detachSource();
+  }
+  for (os_fd_t fd : accepted_) {
+    Api::OsSysCallsSingleton::get().close(fd);
+  }
+}
+
+Event::FileEventPtr IoUringAcceptor::createFileEvent(Event::Dispatcher& dispatcher,
+                                                     Event::FileReadyCb cb, uint32_t events) {
+  auto file_event = std::make_unique<IoUringFileEvent>(dispatcher, cb, events, *this);
+  file_event_ = file_event.get();
+  submitAccept();
+  return file_event;
+}
+
+uint32_t IoUringAcceptor::readiness() const {
+  return accepted_.empty() ? 0 : Event::FileReadyType::Read;
+}
+
+void IoUringAcceptor::onFileEventDestroyed() {
+  file_event_ = nullptr;
+  // The listener is gone, which may destroy this.
+  parent_.closeAcceptor(*this);
+}
+
+os_fd_t IoUringAcceptor::accept() {
+  if (accepted_.empty()) {
+    return INVALID_SOCKET;
+  }
+  const os_fd_t fd = accepted_.front();
+  accepted_.pop_front();
+  submitAccept();
+  return fd;
+}
+
+void IoUringAcceptor::close() {
+  closed_ = true;
+  if (file_event_ != nullptr) {
+    file_event_->detachSource();
+    file_event_ = nullptr;
+  }
+  for (os_fd_t fd : accepted_) {
+    Api::OsSysCallsSingleton::get().close(fd);
+  }
+  accepted_.clear();
+  if (accept_in_flight_) {
+    parent_.cancel(accept_request_);
+  }
+}
+
+void IoUringAcceptor::submitAccept() {
+  if (accept_in_flight_ || closed_ || accepted_.size() >= MaxPendingAccepts) {
+    return;
+  }
+  io_uring_sqe* sqe = parent_.getSqe(accept_request_);
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = listen_fd_;
+  sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+  if (parent_.multishotAccept()) {
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  }
+  accept_in_flight_ = true;
+}
+
+void IoUringAcceptor::onCompletion(RequestType type, int32_t result, uint32_t flags) {
+  ASSERT(type == RequestType::Accept);
+  // A multishot accept stays armed for as long as its completions are flagged with more.
+  if (!(flags & IORING_CQE_F_MORE)) {
+    accept_in_flight_ = false;
+  }
+  if (result >= 0) {
+    if (closed_) {
+      Api::OsSysCallsSingleton::get().close(result);
+      return;
+    }
+    accepted_.push_back(result);
+    if (file_event_ != nullptr) {
+      file_event_->notify(Event::FileReadyType::Read);
+    }
+    if (accept_in_flight_ && accepted_.size() >= MaxPendingAccepts) {
+      parent_.cancel(accept_request_);
+    }
+  } else if (result == -EINVAL && parent_.multishotAccept()) {
+    ENVOY_LOG(debug, "multishot accept is not supported, falling back to single accepts");
+    parent_.disableMultishotAccept();
+  } else if (result != -ECANCELED) {
+    ENVOY_LOG(debug, "io_uring accept on fd {} failed: {}", listen_fd_, errorDetails(-result));
+  }
+  submitAccept();
+}
+
+std::shared_ptr<IoUringWorker> IoUringWorker::create(Event::Dispatcher& dispatcher,
+                                                     const IoUringWorkerConfig& config) {
+  IoUringImplPtr ring = IoUringImpl::create(config.io_uring_size_);
+  if (ring == nullptr) {
+    ENVOY_LOG(warn, "io_uring is not available on {}: {}", dispatcher.name(),
+              errorDetails(errno));
+    return nullptr;
+  }
+  for (uint8_t op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_WRITEV, IORING_OP_POLL_ADD,
+                     IORING_OP_ASYNC_CANCEL}) {
+    if (!ring->isOpSupported(op)) {
+      ENVOY_LOG(warn, "io_uring on {} does not support operation {}", dispatcher.name(), op);
+      return nullptr;
+    }
+  }
+  auto worker =
+      std::shared_ptr<IoUringWorker>(new IoUringWorker(dispatcher, std::move(ring), config));
+  if (!worker->initialize()) {
+    return nullptr;
+  }
+  return worker;
+}
+
+IoUringWorker::IoUringWorker(Event::Dispatcher& dispatcher, IoUringImplPtr ring,
+                             const IoUringWorkerConfig& config)
+    : dispatcher_(dispatcher), ring_(std::move(ring)), read_buffer_size_(config.read_buffer_size_),
+      num_read_buffers_(config.read_buffers_),
+      submit_cb_(dispatcher.createSchedulableCallback([this]() { submit(); })),
+      multishot_accept_(true),
+      linger_timer_(dispatcher.createTimer([this]() { onLingerTimer(); })) {}
+
+IoUringWorker::~IoUringWorker() {
+  // Workers are destroyed with their thread after its connections. Requests which are still in
+  // flight are cancelled by the kernel when the ring is closed.
+  acceptors_.clear();
+  closing_.clear();
+  event_fd_event_.reset();
+  ring_.reset();
+  if (SOCKET_VALID(event_fd_)) {
+    Api::OsSysCallsSingleton::get().close(event_fd_);
+  }
+}
+
+bool IoUringWorker::initialize() {
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (!SOCKET_VALID(event_fd_)) {
+    ENVOY_LOG(warn, "failed to create the io_uring eventfd: {}", errorDetails(errno));
+    return false;
+  }
+  const int rc = ring_->registerEventFd(event_fd_);
+  if (rc < 0) {
+    ENVOY_LOG(warn, "failed to register the io_uring eventfd: {}", errorDetails(-rc));
+    return false;
+  }
+  event_fd_event_ = dispatcher_.createFileEvent(
+      event_fd_, [this](uint32_t) { onCompletions(); }, Event::FileTriggerType::Edge,
+      Event::FileReadyType::Read);
+
+  if (num_read_buffers_ > 0 && !ring_->isOpSupported(IORING_OP_PROVIDE_BUFFERS)) {
+    num_read_buffers_ = 0;
+  }
+  if (num_read_buffers_ > 0) {
+    read_buffer_memory_.reset(new char[static_cast<size_t>(num_read_buffers_) * read_buffer_size_]);
+    provideBuffers(0, num_read_buffers_);
+  }
+  return true;
+}
+
+io_uring_sqe* IoUringWorker::nextSqe() {
+  io_uring_sqe* sqe = ring_->getSqe();
+  if (sqe == nullptr) {
+    ring_->submit();
+    sqe = ring_->getSqe();
+    RELEASE_ASSERT(sqe != nullptr, "io_uring submission queue is full");
+  }
+  if (!submit_cb_->enabled()) {
+    submit_cb_->scheduleCallbackCurrentIteration();
+  }
+  return sqe;
+}
+
+io_uring_sqe* IoUringWorker::getSqe(const Request& request) {
+  io_uring_sqe* sqe = nextSqe();
+  sqe->user_data = reinterpret_cast<uint64_t>(&request);
+  return sqe;
+}
+
+void IoUringWorker::cancel(const Request& request) {
+  io_uring_sqe* sqe = nextSqe();
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = reinterpret_cast<uint64_t>(&request);
+}
+
+void IoUringWorker::provideBuffers(uint16_t first_id, uint32_t count) {
+  io_uring_sqe* sqe = nextSqe();
+  sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+  sqe->fd = count;
+  sqe->addr = reinterpret_cast<uint64_t>(providedBuffer(first_id));
+  sqe->len = read_buffer_size_;
+  sqe->off = first_id;
+  sqe->buf_group = ReadBufferGroup;
+}
+
+void IoUringWorker::submit() {
+  if (!released_buffers_.empty()) {
+    // Buffers released in the same iteration are often adjacent, so they are given back to the
+    // kernel in runs.
+    std::vector<uint16_t> released;
+    released.swap(released_buffers_);
+    std::sort(released.begin(), released.end());
+    for (size_t i = 0; i < released.size();) {
+      size_t end = i + 1;
+      while (end < released.size() && released[end] == released[end - 1] + 1) {
+        end++;
+      }
+      provideBuffers(released[i], end - i);
+      i = end;
+    }
+  }
+  const int rc = ring_->submit();
+  if (rc < 0 && rc != -EAGAIN && rc != -EBUSY) {
+    ENVOY_LOG(error, "io_uring submission failed: {}", errorDetails(-rc));
+  }
+  if (ring_->pendingSubmissions() > 0) {
+    submit_cb_->scheduleCallbackNextIteration();
+  }
+}
+
+void IoUringWorker::onCompletions() {
+  uint64_t count;
+  // The eventfd is drained before the completions are, so that completions posted meanwhile
+  // signal it again.
+  const ssize_t rc = ::read(event_fd_, &count, sizeof(count));
+  UNREFERENCED_PARAMETER(rc);
+  ring_->forEachCompletion([this](const io_uring_cqe& cqe) {
+    // Cancellations and provided buffers are submitted without a request.
+    if (cqe.user_data == 0) {
+      return;
+    }
+    const Request& request = *reinterpret_cast<const Request*>(cqe.user_data);
+    CompletionHandler& handler = request.handler_;
+    handler.onCompletion(request.type_, cqe.res, cqe.flags);
+    if (handler.finished()) {
+      closing_.erase(&handler);
+    }
+  });
+}
+
+void IoUringWorker::closeSocket(IoUringSocketPtr socket) {
+  socket->close();
+  if (!socket->finished()) {
+    addClosing(std::move(socket));
+  }
+}
+
+Event::FileEventPtr IoUringWorker::createAcceptorFileEvent(os_fd_t listen_fd,
+                                                           Event::FileReadyCb cb,
+                                                           uint32_t events) {
+  auto& acceptor = acceptors_[listen_fd];
+  ASSERT(acceptor == nullptr);
+  acceptor = std::make_unique<IoUringAcceptor>(*this, listen_fd);
+  return acceptor->createFileEvent(dispatcher_, cb, events);
+}
+
+IoUringAcceptor* IoUringWorker::acceptor(os_fd_t listen_fd) {
+  auto it = acceptors_.find(listen_fd);
+  return it != acceptors_.end() ? it->second.get() : nullptr;
+}
+
+void IoUringWorker::closeAcceptor(IoUringAcceptor& acceptor) {
+  auto it = acceptors_.find(acceptor.listenFd());
+  ASSERT(it != acceptors_.end() && it->second.get() == &acceptor);
+  std::unique_ptr<IoUringAcceptor> closed = std::move(it->second);
+  acceptors_.erase(it);
+  closed->close();
+  if (!closed->finished()) {
+    addClosing(std::move(closed));
+  }
+}
+
+void IoUringWorker::addClosing(CompletionHandlerPtr handler) {
+  CompletionHandler* key = handler.get();
+  closing_.emplace(key, std::move(handler));
+  if (!linger_timer_->enabled()) {
+    linger_timer_->enableTimer(LingerPeriod);
+  }
+}
+
+void IoUringWorker::onLingerTimer() {
+  for (auto& entry : closing_) {
+    entry.second->onLinger();
+  }
+  if (!closing_.empty()) {
+    linger_timer_->enableTimer(LingerPeriod);
+  }
+}
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
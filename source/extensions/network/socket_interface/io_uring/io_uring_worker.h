@@ -0,0 +1,351 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "envoy/api/io_error.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/event/timer.h"
+#include "envoy/network/address.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+#include "extensions/network/socket_interface/io_uring/io_uring_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+
+class IoUringWorker;
+
+enum class RequestType : uint8_t { Accept, Connect, Read, Write };
+
+/**
+ * Receives the completions of the requests it submits to a worker's ring.
+ */
+class CompletionHandler {
+public:
+  virtual ~CompletionHandler() = default;
+
+  virtual void onCompletion(RequestType type, int32_t result, uint32_t flags) PURE;
+
+  /**
+   * @return whether the handler has been closed and has no requests in flight, i.e. whether it
+   *         can be destroyed.
+   */
+  virtual bool finished() const PURE;
+
+  /**
+   * Called periodically while a closed handler waits for its requests to complete, to cancel
+   * requests which may never complete.
+   */
+  virtual void onLinger() PURE;
+};
+
+using CompletionHandlerPtr = std::unique_ptr<CompletionHandler>;
+
+// The user data of a submission. Each handler embeds one per type of request it can have in
+// flight, so submitting does not allocate.
+struct Request {
+  CompletionHandler& handler_;
+  const RequestType type_;
+};
+
+class IoUringFileEvent;
+
+/**
+ * The state a file event reports readiness for.
+ */
+class ReadinessSource {
+public:
+  virtual ~ReadinessSource() = default;
+
+  /**
+   * @return the FileReadyType events which are currently ready.
+   */
+  virtual uint32_t readiness() const PURE;
+
+  virtual void onFileEventDestroyed() PURE;
+};
+
+/**
+ * Emulates an edge triggered file event on top of completions: sources notify() the event when
+ * completions make them ready, and the events which are enabled are delivered from a callback
+ * scheduled in the current event loop iteration. Enabling events re-reports current readiness, as
+ * re-registering a file descriptor with epoll does.
+ */
+class IoUringFileEvent : public Event::FileEvent {
+public:
+  IoUringFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb, uint32_t events,
+                   ReadinessSource& source);
+  ~IoUringFileEvent() override;
+
+  // Event::FileEvent
+  void activate(uint32_t events) override;
+  void setEnabled(uint32_t events) override;
+
+  void notify(uint32_t events);
+  void detachSource() { source_ = nullptr; }
+
+private:
+  void onScheduled();
+
+  Event::FileReadyCb cb_;
+  ReadinessSource* source_;
+  Event::SchedulableCallbackPtr schedulable_;
+  uint32_t enabled_{0};
+  uint32_t ready_{0};
+  uint32_t injected_{0};
+};
+
+/**
+ * A read which completed and whose data has not been fully consumed yet.
+ */
+struct ReadBuffer {
+  char* data_;
+  uint32_t length_;
+  uint32_t offset_{0};
+  int32_t buffer_id_; // The provided buffer holding the data, -1 if heap_ does.
+  std::unique_ptr<char[]> heap_;
+};
+
+/**
+ * The state of a connected (or connecting) stream socket. Reads are kept in flight while the
+ * socket is connected and fewer than MaxReadBuffers completed reads are waiting to be consumed,
+ * writes are copied and flushed with one write in flight at a time, and readiness is reported
+ * from that state.
+ */
+class IoUringSocket : public CompletionHandler,
+                      public ReadinessSource,
+                      protected Logger::Loggable<Logger::Id::io> {
+public:
+  static constexpr uint32_t MaxReadBuffers = 4;
+
+  IoUringSocket(IoUringWorker& parent, os_fd_t fd, bool connected);
+  ~IoUringSocket() override;
+
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      uint32_t events);
+
+  /**
+   * Copies completed reads into slices, leaving them in place if peek is set.
+   * @return the number of bytes copied, 0 at the end of the stream, EAGAIN if no data has
+   *         arrived yet, or the error the socket failed with.
+   */
+  Api::IoCallUint64Result read(uint64_t max_length, Buffer::RawSlice* slices, uint64_t num_slice,
+                               bool peek);
+  Api::IoCallUint64Result write(const Buffer::RawSlice* slices, uint64_t num_slice);
+  Api::SysCallIntResult connect(const Network::Address::Instance& address);
+  Api::SysCallIntResult shutdown(int how);
+
+  /**
+   * @return the bytes of completed reads which have not been consumed yet.
+   */
+  uint64_t bufferedBytes() const;
+
+  /**
+   * Cancels reads and stops reporting readiness. The file descriptor is closed once pending
+   * writes have been flushed and every request has completed.
+   */
+  void close();
+
+  // CompletionHandler
+  void onCompletion(RequestType type, int32_t result, uint32_t flags) override;
+  bool finished() const override;
+  void onLinger() override;
+
+  // ReadinessSource
+  uint32_t readiness() const override;
+  void onFileEventDestroyed() override { file_event_ = nullptr; }
+
+private:
+  // Bounds the data copied by write() which has not been written to the socket yet.
+  static constexpr uint64_t WriteBufferLimit = 256 * 1024;
+
+  void submitRead(bool heap_buffer = false);
+  void submitWrite();
+  void onRead(int32_t result, uint32_t flags);
+  void onWrite(int32_t result);
+  void releaseReadBuffer(ReadBuffer& buffer);
+  void notify(uint32_t events);
+
+  IoUringWorker& parent_;
+  os_fd_t fd_;
+  IoUringFileEvent* file_event_{nullptr};
+
+  Request read_request_{*this, RequestType::Read};
+  Request write_request_{*this, RequestType::Write};
+  Request connect_request_{*this, RequestType::Connect};
+
+  std::deque<ReadBuffer> read_buffers_;
+  // The buffer of the read in flight, when it does not use a provided buffer.
+  std::unique_ptr<char[]> heap_read_buffer_;
+  Buffer::OwnedImpl write_buffer_;
+  std::vector<iovec> write_iovecs_;
+
+  bool connected_;
+  bool read_in_flight_{false};
+  bool write_in_flight_{false};
+  bool connect_in_flight_{false};
+  bool write_blocked_{false};
+  bool end_of_stream_{false};
+  bool shutdown_pending_{false};
+  bool closed_{false};
+  bool lingering_{false};
+  int read_error_{0};
+  int write_error_{0};
+};
+
+using IoUringSocketPtr = std::unique_ptr<IoUringSocket>;
+
+/**
+ * Accepts connections on a listen socket for one worker. Multishot accepts (Linux 5.19) keep a
+ * single request armed for every connection; older kernels resubmit an accept per connection.
+ */
+class IoUringAcceptor : public CompletionHandler,
+                        public ReadinessSource,
+                        protected Logger::Loggable<Logger::Id::io> {
+public:
+  // Accepts are paused while this many accepted connections wait for the listener.
+  static constexpr uint32_t MaxPendingAccepts = 256;
+
+  IoUringAcceptor(IoUringWorker& parent, os_fd_t listen_fd);
+  ~IoUringAcceptor() override;
+
+  os_fd_t listenFd() const { return listen_fd_; }
+
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      uint32_t events);
+
+  /**
+   * @return an accepted file descriptor or INVALID_SOCKET if none is pending.
+   */
+  os_fd_t accept();
+
+  /**
+   * Cancels accepts and closes connections which have not been handed to the listener.
+   */
+  void close();
+
+  // CompletionHandler
+  void onCompletion(RequestType type, int32_t result, uint32_t flags) override;
+  bool finished() const override { return closed_ && !accept_in_flight_; }
+  void onLinger() override {}
+
+  // ReadinessSource
+  uint32_t readiness() const override;
+  void onFileEventDestroyed() override;
+
+private:
+  void submitAccept();
+
+  IoUringWorker& parent_;
+  const os_fd_t listen_fd_;
+  IoUringFileEvent* file_event_{nullptr};
+  Request accept_request_{*this, RequestType::Accept};
+  std::deque<os_fd_t> accepted_;
+  bool accept_in_flight_{false};
+  bool closed_{false};
+};
+
+struct IoUringWorkerConfig {
+  uint32_t io_uring_size_;
+  uint32_t read_buffer_size_;
+  uint32_t read_buffers_;
+};
+
+/**
+ * The per thread io_uring. Submissions made while handling events are batched and submitted at
+ * the end of the event loop iteration, and completions are reaped when the ring's eventfd is
+ * signalled.
+ */
+class IoUringWorker : public ThreadLocal::ThreadLocalObject,
+                      protected Logger::Loggable<Logger::Id::io> {
+public:
+  // Buffer group of the provided read buffers.
+  static constexpr uint16_t ReadBufferGroup = 0;
+
+  /**
+   * @return the worker or nullptr if io_uring can not be used on this host.
+   */
+  static std::shared_ptr<IoUringWorker> create(Event::Dispatcher& dispatcher,
+                                               const IoUringWorkerConfig& config);
+  ~IoUringWorker() override;
+
+  Event::Dispatcher& dispatcher() { return dispatcher_; }
+  uint32_t readBufferSize() const { return read_buffer_size_; }
+
+  /**
+   * @return a submission queue entry for request, submitted at the end of the current event loop
+   *         iteration.
+   */
+  io_uring_sqe* getSqe(const Request& request);
+  void cancel(const Request& request);
+
+  bool hasProvidedBuffers() const { return num_read_buffers_ > 0; }
+  char* providedBuffer(uint16_t buffer_id) {
+    return read_buffer_memory_.get() + static_cast<size_t>(buffer_id) * read_buffer_size_;
+  }
+  void releaseProvidedBuffer(uint16_t buffer_id) { released_buffers_.push_back(buffer_id); }
+
+  /**
+   * Finishes closing a socket whose handle has been closed, keeping it alive while it has
+   * requests in flight.
+   */
+  void closeSocket(IoUringSocketPtr socket);
+
+  Event::FileEventPtr createAcceptorFileEvent(os_fd_t listen_fd, Event::FileReadyCb cb,
+                                              uint32_t events);
+  /**
+   * @return the acceptor of the listen socket on this worker, nullptr if it has none.
+   */
+  IoUringAcceptor* acceptor(os_fd_t listen_fd);
+  void closeAcceptor(IoUringAcceptor& acceptor);
+
+  bool multishotAccept() const { return multishot_accept_; }
+  void disableMultishotAccept() { multishot_accept_ = false; }
+
+private:
+  IoUringWorker(Event::Dispatcher& dispatcher, IoUringImplPtr ring,
+                const IoUringWorkerConfig& config);
+
+  bool initialize();
+  io_uring_sqe* nextSqe();
+  void submit();
+  void onCompletions();
+  void provideBuffers(uint16_t first_id, uint32_t count);
+  void addClosing(CompletionHandlerPtr handler);
+  void onLingerTimer();
+
+  Event::Dispatcher& dispatcher_;
+  IoUringImplPtr ring_;
+  const uint32_t read_buffer_size_;
+  uint32_t num_read_buffers_;
+  std::unique_ptr<char[]> read_buffer_memory_;
+  std::vector<uint16_t> released_buffers_;
+  os_fd_t event_fd_{INVALID_SOCKET};
+  Event::FileEventPtr event_fd_event_;
+  Event::SchedulableCallbackPtr submit_cb_;
+  bool multishot_accept_;
+
+  absl::flat_hash_map<os_fd_t, std::unique_ptr<IoUringAcceptor>> acceptors_;
+  // Closed sockets and acceptors waiting for their requests to complete.
+  absl::flat_hash_map<CompletionHandler*, CompletionHandlerPtr> closing_;
+  Event::TimerPtr linger_timer_;
+};
+
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
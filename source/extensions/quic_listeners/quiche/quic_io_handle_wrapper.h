@@ -105,6 +105,7 @@ public:
     return io_handle_.createFileEvent(dispatcher, cb, trigger, events);
   }
   Api::SysCallIntResult shutdown(int how) override { return io_handle_.shutdown(how); }
+  absl::optional<uint64_t> bytesAvailable() override { return io_handle_.bytesAvailable(); }
 
 private:
   Network::IoHandle& io_handle_;
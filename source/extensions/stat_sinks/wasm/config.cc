@@ -22,7 +22,8 @@ WasmSinkFactory::createStatsSink(const Protobuf::Message& proto_config,
       MessageUtil::downcastAndValidate<const envoy::extensions::stat_sinks::wasm::v3::Wasm&>(
           proto_config, context.messageValidationContext().staticValidationVisitor());
 
-  auto wasm_sink = std::make_unique<WasmStatSink>(config.config().root_id(), nullptr);
+  auto wasm_sink = std::make_unique<WasmStatSink>(config.config().root_id(), nullptr,
+                                                  config.delta_export());
 
   auto plugin = std::make_shared<Common::Wasm::Plugin>(
       config.config().name(), config.config().root_id(), config.config().vm_config().vm_id(),
@@ -30,7 +31,9 @@ WasmSinkFactory::createStatsSink(const Protobuf::Message& proto_config,
       Common::Wasm::anyToBytes(config.config().configuration()), config.config().fail_open(),
       envoy::config::core::v3::TrafficDirection::UNSPECIFIED, context.localInfo(), nullptr);
 
-  auto callback = [&wasm_sink, &context, plugin](Common::Wasm::WasmHandleSharedPtr base_wasm) {
+  // The sink owns the creation of its base Wasm, which may complete after this returns.
+  auto callback = [sink = wasm_sink.get(), &context,
+                   plugin](Common::Wasm::WasmHandleSharedPtr base_wasm) {
     if (!base_wasm) {
       if (plugin->fail_open_) {
         ENVOY_LOG(error, "Unable to create Wasm Stat Sink {}", plugin->name_);
@@ -39,17 +42,20 @@ WasmSinkFactory::createStatsSink(const Protobuf::Message& proto_config,
       }
       return;
     }
-    wasm_sink->setSingleton(
+    sink->setSingleton(
         Common::Wasm::getOrCreateThreadLocalWasm(base_wasm, plugin, context.dispatcher()));
   };
 
+  Common::Wasm::CreateWasmHandlePtr create_wasm_handle;
   if (!Common::Wasm::createWasm(
           config.config().vm_config(), plugin, context.scope().createScope(""),
           context.clusterManager(), context.initManager(), context.dispatcher(), context.random(),
-          context.api(), context.lifecycleNotifier(), remote_data_provider_, std::move(callback))) {
+          context.api(), context.lifecycleNotifier(), remote_data_provider_, create_wasm_handle,
+          std::move(callback))) {
     throw Common::Wasm::WasmException(
         fmt::format("Unable to create Wasm Stat Sink {}", plugin->name_));
   }
+  wasm_sink->setCreateWasmHandle(std::move(create_wasm_handle));
 
   return wasm_sink;
 }
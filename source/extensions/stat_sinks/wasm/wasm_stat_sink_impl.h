@@ -13,11 +13,20 @@ using Envoy::Extensions::Common::Wasm::WasmHandle;
 
 class WasmStatSink : public Stats::Sink {
 public:
-  WasmStatSink(absl::string_view root_id, Common::Wasm::WasmHandleSharedPtr singleton)
-      : root_id_(root_id), singleton_(std::move(singleton)) {}
+  WasmStatSink(absl::string_view root_id, Common::Wasm::WasmHandleSharedPtr singleton,
+               bool delta_export = false)
+      : root_id_(root_id), singleton_(std::move(singleton)), delta_export_(delta_export) {}
 
   void flush(Stats::MetricSnapshot& snapshot) override {
-    singleton_->wasm()->onStatsUpdate(root_id_, snapshot);
+    if (!singleton_) {
+      // The VM is still being compiled in the background, or failed to load.
+      return;
+    }
+    if (delta_export_) {
+      singleton_->wasm()->onStatsDeltaUpdate(root_id_, snapshot);
+    } else {
+      singleton_->wasm()->onStatsUpdate(root_id_, snapshot);
+    }
   }
 
   void setSingleton(Common::Wasm::WasmHandleSharedPtr singleton) {
@@ -25,6 +34,10 @@ public:
     singleton_ = std::move(singleton);
   }
 
+  void setCreateWasmHandle(Common::Wasm::CreateWasmHandlePtr create_wasm_handle) {
+    create_wasm_handle_ = std::move(create_wasm_handle);
+  }
+
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override {
     (void)histogram;
     (void)value;
@@ -33,6 +46,8 @@ public:
 private:
   std::string root_id_;
   Common::Wasm::WasmHandleSharedPtr singleton_;
+  const bool delta_export_;
+  Common::Wasm::CreateWasmHandlePtr create_wasm_handle_;
 };
 
 } // namespace Wasm
@@ -27,6 +27,7 @@
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
+#include "openssl/err.h"
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
 #include "openssl/rand.h"
@@ -74,7 +75,8 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       ssl_ciphers_(stat_name_set_->add("ssl.ciphers")),
       ssl_versions_(stat_name_set_->add("ssl.versions")),
       ssl_curves_(stat_name_set_->add("ssl.curves")),
-      ssl_sigalgs_(stat_name_set_->add("ssl.sigalgs")), capabilities_(config.capabilities()) {
+      ssl_sigalgs_(stat_name_set_->add("ssl.sigalgs")), capabilities_(config.capabilities()),
+      kernel_tls_offload_(config.kernelTlsOffload()) {
   const auto tls_certificates = config.tlsCertificates();
   tls_contexts_.resize(std::max(static_cast<size_t>(1), tls_certificates.size()));
 
@@ -857,6 +859,11 @@ ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
       max_session_keys_(config.maxSessionKeys()) {
   // This should be guaranteed during configuration ingestion for client contexts.
   ASSERT(tls_contexts_.size() == 1);
+  // Renegotiation handshake messages would be consumed by the kernel, which only passes
+  // application data and alerts through.
+  if (allow_renegotiation_) {
+    kernel_tls_offload_ = false;
+  }
   if (!parsed_alpn_protocols_.empty()) {
     for (auto& ctx : tls_contexts_) {
       const int rc = SSL_CTX_set_alpn_protos(ctx.ssl_ctx_.get(), parsed_alpn_protocols_.data(),
@@ -1000,8 +1007,10 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()) {
+                                     TimeSource& time_source,
+                                     Envoy::Ssl::SessionCache* session_cache)
+    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()),
+      session_cache_(config.capabilities().handles_session_resumption ? nullptr : session_cache) {
   if (config.tlsCertificates().empty() && !config.capabilities().provides_certificates) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
@@ -1068,9 +1077,93 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
     int rc =
         SSL_CTX_set_session_id_context(ctx.ssl_ctx_.get(), session_id.data(), session_id.size());
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
+
+    // Sessions are stored in the shared cache so that they can be resumed by any context with the
+    // same session ID context, including the contexts of a hot restarted process. The internal
+    // cache is still looked up first, and holds the sessions which the shared cache rejects.
+    if (session_cache_ != nullptr) {
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+            ->storeSession(session);
+        // The session is not retained.
+        return 0;
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_length, int* copy) -> SSL_SESSION* {
+            // The returned reference is owned by the caller.
+            *copy = 0;
+            return static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)))
+                ->lookupSession(id, id_length);
+          });
+      SSL_CTX_sess_set_remove_cb(ctx.ssl_ctx_.get(), [](SSL_CTX* ssl_ctx, SSL_SESSION* session) {
+        static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(ssl_ctx))->removeSession(session);
+      });
+    }
   }
 }
 
+void ServerContextImpl::storeSession(SSL_SESSION* session) {
+  unsigned id_length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  uint8_t* data;
+  size_t length;
+  if (id_length == 0) {
+    return;
+  }
+  Envoy::Ssl::SessionCache::InsertResult result = Envoy::Ssl::SessionCache::InsertResult::Rejected;
+  if (SSL_SESSION_to_bytes(session, &data, &length)) {
+    bssl::UniquePtr<uint8_t> data_ptr(data);
+    const SystemTime expiry{
+        std::chrono::seconds(SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session))};
+    result =
+        session_cache_->insert({id, id_length}, {data, length}, expiry, time_source_.systemTime());
+  } else {
+    ERR_clear_error();
+  }
+  switch (result) {
+  case Envoy::Ssl::SessionCache::InsertResult::Inserted:
+    break;
+  case Envoy::Ssl::SessionCache::InsertResult::Evicted:
+    stats_.session_cache_eviction_.inc();
+    break;
+  case Envoy::Ssl::SessionCache::InsertResult::Rejected:
+    // E.g. sessions with a peer certificate chain, which are too large. They can still be resumed
+    // through this context, whose internal cache is the one BoringSSL looks up.
+    stats_.session_cache_insert_failure_.inc();
+    SSL_CTX_add_session(tls_contexts_[0].ssl_ctx_.get(), session);
+    break;
+  }
+}
+
+SSL_SESSION* ServerContextImpl::lookupSession(const uint8_t* id, int id_length) {
+  std::vector<uint8_t> data;
+  if (!session_cache_->lookup({id, static_cast<size_t>(id_length)}, time_source_.systemTime(),
+                              data)) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  // The session ID context of the session is checked by BoringSSL, so sessions of other contexts
+  // are not resumed.
+  SSL_SESSION* session =
+      SSL_SESSION_from_bytes(data.data(), data.size(), tls_contexts_[0].ssl_ctx_.get());
+  if (session == nullptr) {
+    ERR_clear_error();
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  return session;
+}
+
+void ServerContextImpl::removeSession(SSL_SESSION* session) {
+  unsigned id_length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  session_cache_->remove({id, id_length});
+}
+
 ServerContextImpl::SessionContextID
 ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string>& server_names) {
   uint8_t hash_buffer[EVP_MAX_MD_SIZE];
@@ -1257,12 +1350,16 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
         }
 
         // If our current encryption was not the decryption key, renew
+        if (!is_enc_key) {
+          stats_.session_ticket_renewed_.inc();
+        }
         return is_enc_key ? 1  // success; do not renew
                           : 2; // success: renew key
       }
       is_enc_key = false;
     }
 
+    stats_.session_ticket_unknown_key_.inc();
     return 0; // decryption failed
   }
 }
@@ -39,12 +39,14 @@ public:
   Ssl::PrivateKeyMethodManager& privateKeyMethodManager() override {
     return private_key_method_manager_;
   };
+  void setSessionCache(Ssl::SessionCache* cache) override { session_cache_ = cache; }
 
 private:
   void removeEmptyContexts();
   TimeSource& time_source_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
+  Ssl::SessionCache* session_cache_{};
 };
 
 } // namespace Tls
@@ -0,0 +1,236 @@
+#include "extensions/transport_sockets/tls/ktls.h"
+
+#include <algorithm>
+#include <cstring>
+#include <typeinfo>
+
+#include "envoy/common/platform.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/macros.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#include "openssl/err.h"
+#include "openssl/mem.h"
+
+#ifdef __linux__
+#include <linux/tls.h>
+
+// Definitions which are missing from the headers of kernels older than the running one.
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#ifdef __linux__
+namespace {
+
+constexpr uint8_t AlertRecord = 21;
+constexpr uint8_t ApplicationDataRecord = 23;
+constexpr uint8_t AlertLevelWarning = 1;
+constexpr uint8_t CloseNotifyAlert = 0;
+// The implicit part of the AES-GCM nonce in TLS 1.2 (RFC 5288).
+constexpr size_t SaltLength = 4;
+constexpr size_t MaxKeyLength = 32;
+
+void writeSequence(uint64_t sequence, uint8_t* out) {
+  for (int i = 7; i >= 0; i--) {
+    out[i] = sequence & 0xff;
+    sequence >>= 8;
+  }
+}
+
+template <class CryptoInfo>
+bool setCryptoInfo(Network::IoHandle& io_handle, int direction, uint16_t cipher_type,
+                   const uint8_t* key, const uint8_t* salt, uint64_t sequence) {
+  CryptoInfo info{};
+  static_assert(sizeof(info.salt) == SaltLength, "unexpected salt length");
+  static_assert(sizeof(info.iv) == sizeof(uint64_t), "unexpected explicit nonce length");
+  static_assert(sizeof(info.rec_seq) == sizeof(uint64_t), "unexpected sequence number length");
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, salt, sizeof(info.salt));
+  // BoringSSL uses the record sequence number as the explicit part of the nonce.
+  writeSequence(sequence, info.iv);
+  writeSequence(sequence, info.rec_seq);
+  const bool ok = io_handle.setOption(SOL_TLS, direction, &info, sizeof(info)).rc_ == 0;
+  OPENSSL_cleanse(&info, sizeof(info));
+  return ok;
+}
+
+bool setKeys(Network::IoHandle& io_handle, int direction, size_t key_length, const uint8_t* key,
+             const uint8_t* salt, uint64_t sequence) {
+  if (key_length == 16) {
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_128>(
+        io_handle, direction, TLS_CIPHER_AES_GCM_128, key, salt, sequence);
+  }
+#ifdef TLS_CIPHER_AES_GCM_256
+  return setCryptoInfo<tls12_crypto_info_aes_gcm_256>(io_handle, direction, TLS_CIPHER_AES_GCM_256,
+                                                      key, salt, sequence);
+#else
+  return false;
+#endif
+}
+
+} // namespace
+#endif
+
+KernelTls::Offload KernelTls::offload(SSL* ssl, Network::IoHandle& io_handle) {
+  Offload offload;
+#ifdef __linux__
+  // The kernel record layer is driven through the file descriptor, which only the default socket
+  // interface reads from directly. Records buffered by SSL would be lost.
+  if (typeid(io_handle) != typeid(Network::IoSocketHandleImpl) ||
+      SSL_version(ssl) != TLS1_2_VERSION || SSL_has_pending(ssl)) {
+    return offload;
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) {
+    return offload;
+  }
+  size_t key_length;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    key_length = 16;
+    break;
+  case NID_aes_256_gcm:
+    key_length = 32;
+    break;
+  default:
+    return offload;
+  }
+
+  // The key block of AEAD cipher suites has no MAC keys: client key, server key, client salt,
+  // server salt.
+  uint8_t key_block[2 * (MaxKeyLength + SaltLength)];
+  const size_t key_block_length = SSL_get_key_block_len(ssl);
+  if (key_block_length != 2 * (key_length + SaltLength) ||
+      !SSL_generate_key_block(ssl, key_block, key_block_length)) {
+    ERR_clear_error();
+    return offload;
+  }
+  const uint8_t* client_key = key_block;
+  const uint8_t* server_key = client_key + key_length;
+  const uint8_t* client_salt = server_key + key_length;
+  const uint8_t* server_salt = client_salt + SaltLength;
+  const bool server = SSL_is_server(ssl);
+
+  static const char ulp[] = "tls";
+  if (io_handle.setOption(IPPROTO_TCP, TCP_ULP, ulp, sizeof(ulp)).rc_ == 0) {
+    offload.tx_ = setKeys(io_handle, TLS_TX, key_length, server ? server_key : client_key,
+                          server ? server_salt : client_salt, SSL_get_write_sequence(ssl));
+    // Receive is only offloaded along with transmit, so that a connection either writes all of
+    // its records through SSL or none of them.
+    if (offload.tx_) {
+      offload.rx_ = setKeys(io_handle, TLS_RX, key_length, server ? client_key : server_key,
+                            server ? client_salt : server_salt, SSL_get_read_sequence(ssl));
+    }
+  }
+  OPENSSL_cleanse(key_block, sizeof(key_block));
+#else
+  UNREFERENCED_PARAMETER(ssl);
+  UNREFERENCED_PARAMETER(io_handle);
+#endif
+  return offload;
+}
+
+Api::SysCallSizeResult KernelTls::read(Network::IoHandle& io_handle, Buffer::Instance& buffer,
+                                       uint64_t max_length, RecordType& type) {
+#ifdef __linux__
+  constexpr uint64_t MaxSlices = 2;
+  Buffer::RawSlice slices[MaxSlices];
+  iovec iov[MaxSlices];
+  const uint64_t num_slices = buffer.reserve(max_length, slices, MaxSlices);
+  for (uint64_t i = 0; i < num_slices; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+  }
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr msg{};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = num_slices;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().recvmsg(io_handle.fdDoNotUse(), &msg, 0);
+
+  // Without a control message the kernel returned application data.
+  uint8_t record_type = ApplicationDataRecord;
+  const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (result.rc_ > 0 && cmsg != nullptr && cmsg->cmsg_level == SOL_TLS &&
+      cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+    record_type = *CMSG_DATA(cmsg);
+  }
+
+  uint64_t bytes_to_commit = 0;
+  type = RecordType::ApplicationData;
+  if (result.rc_ > 0 && record_type == ApplicationDataRecord) {
+    bytes_to_commit = result.rc_;
+  } else if (result.rc_ > 0 && record_type == AlertRecord) {
+    // The reserved slices may be short, so the two bytes of the alert are gathered.
+    uint8_t alert[2];
+    uint64_t copied = 0;
+    for (uint64_t i = 0; i < num_slices && copied < sizeof(alert); i++) {
+      const uint64_t length = std::min<uint64_t>(slices[i].len_, sizeof(alert) - copied);
+      memcpy(alert + copied, slices[i].mem_, length);
+      copied += length;
+    }
+    type = result.rc_ == sizeof(alert) && alert[1] == CloseNotifyAlert ? RecordType::CloseNotify
+                                                                       : RecordType::Alert;
+  } else if (result.rc_ > 0) {
+    type = RecordType::Other;
+  }
+  for (uint64_t i = 0; i < num_slices; i++) {
+    slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(bytes_to_commit));
+    bytes_to_commit -= slices[i].len_;
+  }
+  buffer.commit(slices, num_slices);
+  if (result.rc_ > 0 && type != RecordType::ApplicationData) {
+    return {0, 0};
+  }
+  return result;
+#else
+  UNREFERENCED_PARAMETER(io_handle);
+  UNREFERENCED_PARAMETER(buffer);
+  UNREFERENCED_PARAMETER(max_length);
+  type = RecordType::Other;
+  return {-1, SOCKET_ERROR_NOT_SUP};
+#endif
+}
+
+bool KernelTls::sendCloseNotify(Network::IoHandle& io_handle) {
+#ifdef __linux__
+  uint8_t alert[2] = {AlertLevelWarning, CloseNotifyAlert};
+  iovec iov{alert, sizeof(alert)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint8_t))]{};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = AlertRecord;
+  return Api::OsSysCallsSingleton::get().sendmsg(io_handle.fdDoNotUse(), &msg, 0).rc_ ==
+         sizeof(alert);
+#else
+  UNREFERENCED_PARAMETER(io_handle);
+  return false;
+#endif
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
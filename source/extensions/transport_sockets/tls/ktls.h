@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/network/io_handle.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Offloads the record layer of established TLS connections to the Linux kernel TLS ULP (kTLS).
+ * Only TLS 1.2 with AES-GCM is offloaded: BoringSSL exposes the TLS 1.2 key block but not the
+ * TLS 1.3 traffic secrets, and TLS 1.3 post-handshake messages would have to be handled outside of
+ * the record layer. Everything else, and every platform other than Linux, stays in userspace.
+ */
+class KernelTls {
+public:
+  struct Offload {
+    bool tx_{};
+    bool rx_{};
+  };
+
+  /**
+   * Installs the keys of the connection's current epoch into the kernel. Only the transmit
+   * direction may end up offloaded, e.g. on kernels older than 4.17, in which case the connection
+   * keeps reading through SSL.
+   * @param ssl supplies a connection whose handshake has completed.
+   * @param io_handle supplies the socket of the connection.
+   * @return the directions which have been offloaded.
+   */
+  static Offload offload(SSL* ssl, Network::IoHandle& io_handle);
+
+  enum class RecordType { ApplicationData, CloseNotify, Alert, Other };
+
+  /**
+   * Reads decrypted records from a socket whose receive direction is offloaded. Application data
+   * is committed to buffer, any other record is consumed and reported through type only.
+   * @return the number of bytes committed (0 for other records or at the end of the stream), or -1
+   *         with errno set.
+   */
+  static Api::SysCallSizeResult read(Network::IoHandle& io_handle, Buffer::Instance& buffer,
+                                     uint64_t max_length, RecordType& type);
+
+  /**
+   * Sends a close_notify alert on a socket whose transmit direction is offloaded.
+   * @return whether the alert has been queued on the socket.
+   */
+  static bool sendCloseNotify(Network::IoHandle& io_handle);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "extensions/transport_sockets/tls/ssl_socket.h"
 
+#include "envoy/common/platform.h"
 #include "envoy/stats/scope.h"
 
 #include "common/common/assert.h"
@@ -9,6 +10,7 @@
 #include "common/runtime/runtime_features.h"
 
 #include "extensions/transport_sockets/tls/io_handle_bio.h"
+#include "extensions/transport_sockets/tls/ktls.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -116,6 +118,9 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
       return {action, 0, false};
     }
   }
+  if (ktls_rx_) {
+    return doKernelTlsRead(read_buffer);
+  }
 
   bool keep_reading = true;
   bool end_stream = false;
@@ -168,6 +173,46 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
+Network::IoResult SslSocket::doKernelTlsRead(Buffer::Instance& read_buffer) {
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t bytes_read = 0;
+  bool end_stream = false;
+  while (true) {
+    KernelTls::RecordType type;
+    const Api::SysCallSizeResult result =
+        KernelTls::read(callbacks_->ioHandle(), read_buffer, ktls_read_size_.value(), type);
+    ENVOY_CONN_LOG(trace, "kernel TLS read returns: {}", callbacks_->connection(), result.rc_);
+    if (result.rc_ < 0) {
+      if (result.errno_ != SOCKET_ERROR_AGAIN) {
+        ENVOY_CONN_LOG(debug, "kernel TLS read error: {}", callbacks_->connection(),
+                       result.errno_);
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    if (type == KernelTls::RecordType::CloseNotify) {
+      end_stream = true;
+      break;
+    }
+    // Like SSL_read(), treat alerts, unexpected handshake messages and a truncated stream as
+    // errors.
+    if (type != KernelTls::RecordType::ApplicationData || result.rc_ == 0) {
+      action = PostIoAction::Close;
+      break;
+    }
+    bytes_read += result.rc_;
+    ktls_read_size_.update(callbacks_->ioHandle(), result.rc_);
+    if (callbacks_->shouldDrainReadBuffer()) {
+      callbacks_->setReadBufferReady();
+      break;
+    }
+  }
+
+  ENVOY_CONN_LOG(trace, "kernel TLS read {} bytes", callbacks_->connection(), bytes_read);
+
+  return {action, bytes_read, end_stream};
+}
+
 void SslSocket::onPrivateKeyMethodComplete() {
   ASSERT(isThreadSafe());
   ASSERT(info_->state() == Ssl::SocketState::HandshakeInProgress);
@@ -184,6 +229,18 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->kernelTlsOffload()) {
+    const KernelTls::Offload offload = KernelTls::offload(ssl, callbacks_->ioHandle());
+    ktls_tx_ = offload.tx_;
+    ktls_rx_ = offload.rx_;
+    ENVOY_CONN_LOG(debug, "kernel TLS offload: tx={} rx={}", callbacks_->connection(), ktls_tx_,
+                   ktls_rx_);
+    if (ktls_tx_) {
+      ctx_->stats().kernel_tls_offload_.inc();
+    } else {
+      ctx_->stats().kernel_tls_offload_unsupported_.inc();
+    }
+  }
   callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 }
 
@@ -227,6 +284,9 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       return {action, 0, false};
     }
   }
+  if (ktls_tx_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
 
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
@@ -276,6 +336,30 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    // The kernel splits the data into records, so it is written as is.
+    Api::IoCallUint64Result result = write_buffer.write(callbacks_->ioHandle());
+    ENVOY_CONN_LOG(trace, "kernel TLS write returns: {}", callbacks_->connection(), result.rc_);
+    if (result.ok()) {
+      total_bytes_written += result.rc_;
+    } else if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+      break;
+    } else {
+      ENVOY_CONN_LOG(debug, "kernel TLS write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(info_->state() == Ssl::SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -284,9 +368,15 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
-    int rc = SSL_shutdown(rawSsl());
-    ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
-    drainErrorQueue();
+    if (ktls_tx_) {
+      // SSL no longer owns the write sequence number, so the kernel sends the alert.
+      const bool sent = KernelTls::sendCloseNotify(callbacks_->ioHandle());
+      ENVOY_CONN_LOG(debug, "kernel TLS shutdown: sent={}", callbacks_->connection(), sent);
+    } else {
+      int rc = SSL_shutdown(rawSsl());
+      ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
+      drainErrorQueue();
+    }
     info_->setState(Ssl::SocketState::ShutdownSent);
   }
 }
@@ -14,6 +14,7 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
+#include "common/network/raw_buffer_socket.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
@@ -80,6 +81,8 @@ private:
     absl::optional<int> error_;
   };
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
+  Network::IoResult doKernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
 
   Network::PostIoAction doHandshake();
   void drainErrorQueue();
@@ -93,6 +96,11 @@ private:
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
+  // Whether the record layer of each direction has been offloaded to the kernel.
+  bool ktls_tx_{};
+  bool ktls_rx_{};
+  // The kernel returns plaintext, so offloaded reads are sized like those of a raw socket.
+  Network::AdaptiveReadSize ktls_read_size_;
 
   SslHandshakerImplSharedPtr info_;
 };
@@ -218,6 +218,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(runtime_handler_.handlerRuntimeModify), false, true},
           {"/reopen_logs", "reopen access logs",
            MAKE_ADMIN_HANDLER(logs_handler_.handlerReopenLogs), false, true},
+          {"/workers", "print the CPUs and NUMA nodes of the worker threads",
+           MAKE_ADMIN_HANDLER(server_info_handler_.handlerWorkers), false, false},
       },
       date_provider_(server.dispatcher().timeSource()),
       admin_filter_chain_(std::make_shared<AdminFilterChain>()),
@@ -1,12 +1,17 @@
 #include "server/admin/server_info_handler.h"
 
 #include "envoy/admin/v3/memory.pb.h"
+#include "envoy/admin/v3/workers.pb.h"
+#include "envoy/server/listener_manager.h"
+#include "envoy/server/worker.h"
 
 #include "common/memory/stats.h"
 #include "common/version/version.h"
 
 #include "server/admin/utils.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -56,6 +61,26 @@ Http::Code ServerInfoHandler::handlerMemory(absl::string_view,
   return Http::Code::OK;
 }
 
+Http::Code ServerInfoHandler::handlerWorkers(absl::string_view,
+                                             Http::ResponseHeaderMap& response_headers,
+                                             Buffer::Instance& response, AdminStream&) {
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+  envoy::admin::v3::Workers workers;
+  const std::vector<WorkerPlacement> placements = server_.listenerManager().workerPlacements();
+  for (uint32_t i = 0; i < placements.size(); i++) {
+    envoy::admin::v3::Workers::Worker& worker = *workers.add_workers();
+    worker.set_name(absl::StrCat("worker_", i));
+    for (const uint32_t cpu : placements[i].cpus_) {
+      worker.add_cpus(cpu);
+    }
+    if (placements[i].numa_node_.has_value()) {
+      worker.mutable_numa_node()->set_value(placements[i].numa_node_.value());
+    }
+  }
+  response.add(MessageUtil::getJsonStringFromMessage(workers, true, true)); // pretty-print
+  return Http::Code::OK;
+}
+
 Http::Code ServerInfoHandler::handlerReady(absl::string_view, Http::ResponseHeaderMap&,
                                            Buffer::Instance& response, AdminStream&) {
   const envoy::admin::v3::ServerInfo::State state =
@@ -1,5 +1,8 @@
 #include "server/connection_handler_impl.h"
 
+#include <algorithm>
+#include <ctime>
+
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 #include "envoy/network/exception.h"
@@ -24,11 +27,55 @@ void emitLogs(Network::ListenerConfig& config, StreamInfo::StreamInfo& stream_in
     access_log->log(nullptr, nullptr, nullptr, stream_info);
   }
 }
+
+// CPU time consumed by the calling thread, or zero where that is not available.
+std::chrono::nanoseconds threadCpuTime() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+  }
+#endif
+  return std::chrono::nanoseconds(0);
+}
 } // namespace
 
+constexpr std::chrono::milliseconds ConnectionHandlerImpl::LoadTracker::SampleInterval;
+
+void ConnectionHandlerImpl::LoadTracker::enable() {
+  if (timer_ != nullptr) {
+    return;
+  }
+  timer_ = dispatcher_.createTimer([this]() -> void { onSample(); });
+  last_sample_time_ = dispatcher_.timeSource().monotonicTime();
+  last_cpu_time_ = threadCpuTime();
+  timer_->enableTimer(SampleInterval);
+}
+
+void ConnectionHandlerImpl::LoadTracker::onSample() {
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  const std::chrono::nanoseconds cpu_time = threadCpuTime();
+  const uint64_t elapsed_ns = std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_sample_time_).count(), 1);
+  const uint64_t interval_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(SampleInterval).count();
+
+  // The timer firing late means events were queued behind other work for that long.
+  const uint64_t lag_ns = elapsed_ns > interval_ns ? elapsed_ns - interval_ns : 0;
+  const uint64_t busy_permille =
+      std::min<uint64_t>((cpu_time - last_cpu_time_).count() * 1000 / elapsed_ns, 1000);
+  const uint64_t lag_permille = std::min<uint64_t>(lag_ns * 1000 / interval_ns, 1000);
+  connection_cost_ =
+      ((busy_permille + lag_permille + IdleLoad) << 16) / (num_connections_.load() + 1);
+
+  last_sample_time_ = now;
+  last_cpu_time_ = cpu_time;
+  timer_->enableTimer(SampleInterval);
+}
+
 ConnectionHandlerImpl::ConnectionHandlerImpl(Event::Dispatcher& dispatcher)
     : dispatcher_(dispatcher), per_handler_stat_prefix_(dispatcher.name() + "."),
-      disable_listeners_(false) {}
+      load_tracker_(dispatcher, num_handler_connections_), disable_listeners_(false) {}
 
 void ConnectionHandlerImpl::incNumConnections() { ++num_handler_connections_; }
 
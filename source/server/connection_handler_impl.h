@@ -7,6 +7,7 @@
 
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/filter.h"
@@ -97,6 +98,42 @@ public:
   };
 
 private:
+  /**
+   * Samples the load of the handler's thread for load aware connection balancing. Sampling only
+   * starts once enable() is called on the handler's thread, while connectionCost() may be called
+   * from any thread.
+   */
+  class LoadTracker {
+  public:
+    LoadTracker(Event::Dispatcher& dispatcher, const std::atomic<uint64_t>& num_connections)
+        : dispatcher_(dispatcher), num_connections_(num_connections) {}
+
+    void enable();
+
+    /**
+     * @return the estimated cost of one connection on this thread as a fixed point fraction (16
+     *         fractional bits) of the thread's load in permille. The load is the share of the last
+     *         sampling interval the thread spent on CPU plus the event loop lag relative to the
+     *         interval, so it can exceed 1000 when the thread is overloaded.
+     */
+    uint64_t connectionCost() const { return connection_cost_; }
+
+    static constexpr std::chrono::milliseconds SampleInterval{100};
+    // Load in permille that is attributed even to an idle thread, so that idle threads compare
+    // by connection count.
+    static constexpr uint64_t IdleLoad = 10;
+
+  private:
+    void onSample();
+
+    Event::Dispatcher& dispatcher_;
+    const std::atomic<uint64_t>& num_connections_;
+    Event::TimerPtr timer_;
+    MonotonicTime last_sample_time_;
+    std::chrono::nanoseconds last_cpu_time_{};
+    std::atomic<uint64_t> connection_cost_{IdleLoad << 16};
+  };
+
   struct ActiveTcpConnection;
   using ActiveTcpConnectionPtr = std::unique_ptr<ActiveTcpConnection>;
   struct ActiveTcpSocket;
@@ -145,6 +182,10 @@ private:
       config_->openConnections().inc();
     }
     void post(Network::ConnectionSocketPtr&& socket) override;
+    uint64_t loadScore() const override {
+      return (num_listener_connections_ + 1) * parent_.load_tracker_.connectionCost();
+    }
+    void enableLoadTracking() override { parent_.load_tracker_.enable(); }
 
     /**
      * Remove and destroy an active connection.
@@ -343,6 +384,9 @@ private:
 
   Event::Dispatcher& dispatcher_;
   const std::string per_handler_stat_prefix_;
+  // Declared before listeners_ as other threads may read it until the listeners unregister from
+  // their balancers.
+  LoadTracker load_tracker_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerDetails>> listeners_;
   std::atomic<uint64_t> num_handler_connections_{};
   bool disable_listeners_;
@@ -1,6 +1,7 @@
 #include "server/hot_restart_impl.h"
 
 #include <sys/prctl.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/un.h>
 
@@ -17,6 +18,7 @@
 #include "common/api/os_sys_calls_impl_hot_restart.h"
 #include "common/common/fmt.h"
 #include "common/common/lock_guard.h"
+#include "common/common/logger.h"
 
 #include "absl/strings/string_view.h"
 
@@ -82,6 +84,72 @@ SharedMemory* attachSharedMemory(uint32_t base_id, uint32_t restart_epoch) {
   return shmem;
 }
 
+SessionCacheMemory* attachSessionCacheMemory(uint32_t base_id, uint32_t restart_epoch,
+                                             uint32_t max_sessions) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+
+  const std::string shmem_name = fmt::format("/envoy_tls_session_cache_{}", base_id);
+  const uint32_t sets_per_shard = SessionCacheMemory::setsPerShard(max_sessions);
+  const uint64_t size = SessionCacheMemory::size(sets_per_shard);
+
+  if (restart_epoch > 0) {
+    // Only the header is mapped until the layout of the segment is known to match. The size of
+    // the segment is checked first, as accessing a mapping beyond the end of a segment which was
+    // truncated (e.g. by a process which crashed while creating it) raises SIGBUS.
+    const Api::SysCallIntResult result =
+        hot_restart_os_sys_calls.shmOpen(shmem_name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+    if (result.rc_ != -1) {
+      struct stat stat_buf;
+      const Api::SysCallIntResult stat_result = os_sys_calls.fstat(result.rc_, &stat_buf);
+      if (stat_result.rc_ != -1 && static_cast<uint64_t>(stat_buf.st_size) == size) {
+        const Api::SysCallPtrResult header_result = os_sys_calls.mmap(
+            nullptr, sizeof(SessionCacheMemory), PROT_READ, MAP_SHARED, result.rc_, 0);
+        bool matches = false;
+        if (header_result.rc_ != MAP_FAILED) {
+          const auto* header = reinterpret_cast<const SessionCacheMemory*>(header_result.rc_);
+          matches = header->size_ == size && header->version_ == HOT_RESTART_VERSION;
+          os_sys_calls.munmap(header_result.rc_, sizeof(SessionCacheMemory));
+        }
+        if (matches) {
+          const Api::SysCallPtrResult mmap_result =
+              os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, result.rc_, 0);
+          os_sys_calls.close(result.rc_);
+          RELEASE_ASSERT(mmap_result.rc_ != MAP_FAILED, "");
+          return reinterpret_cast<SessionCacheMemory*>(mmap_result.rc_);
+        }
+      }
+      os_sys_calls.close(result.rc_);
+    }
+  }
+
+  // A parent process whose segment is replaced keeps it mapped until it terminates.
+  hot_restart_os_sys_calls.shmUnlink(shmem_name.c_str());
+  const Api::SysCallIntResult result = hot_restart_os_sys_calls.shmOpen(
+      shmem_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (result.rc_ == -1) {
+    ENVOY_LOG_MISC(error, "cannot open shared memory region {}, TLS sessions are not shared: {}",
+                   shmem_name, errorDetails(result.errno_));
+    return nullptr;
+  }
+  const Api::SysCallIntResult truncate_result = os_sys_calls.ftruncate(result.rc_, size);
+  const Api::SysCallPtrResult mmap_result =
+      truncate_result.rc_ == -1
+          ? Api::SysCallPtrResult{MAP_FAILED, truncate_result.errno_}
+          : os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, result.rc_, 0);
+  os_sys_calls.close(result.rc_);
+  if (mmap_result.rc_ == MAP_FAILED) {
+    ENVOY_LOG_MISC(error, "cannot map shared memory region {}, TLS sessions are not shared: {}",
+                   shmem_name, errorDetails(mmap_result.errno_));
+    hot_restart_os_sys_calls.shmUnlink(shmem_name.c_str());
+    return nullptr;
+  }
+  // The new segment is zero filled.
+  auto* memory = reinterpret_cast<SessionCacheMemory*>(mmap_result.rc_);
+  SharedMemorySessionCache::initialize(*memory, sets_per_shard, HOT_RESTART_VERSION);
+  return memory;
+}
+
 void initializeMutex(pthread_mutex_t& mutex) {
   pthread_mutexattr_t attribute;
   pthread_mutexattr_init(&attribute);
@@ -97,7 +165,7 @@ void initializeMutex(pthread_mutex_t& mutex) {
 // the socket names to entirely prevent collisions between consecutive base ids.
 HotRestartImpl::HotRestartImpl(uint32_t base_id, uint32_t restart_epoch,
                                const std::string& socket_path, mode_t socket_mode)
-    : base_id_(base_id), scaled_base_id_(base_id * 10),
+    : base_id_(base_id), scaled_base_id_(base_id * 10), restart_epoch_(restart_epoch),
       as_child_(HotRestartingChild(scaled_base_id_, restart_epoch, socket_path, socket_mode)),
       as_parent_(HotRestartingParent(scaled_base_id_, restart_epoch, socket_path, socket_mode)),
       shmem_(attachSharedMemory(scaled_base_id_, restart_epoch)), log_lock_(shmem_->log_lock_),
@@ -108,6 +176,17 @@ HotRestartImpl::HotRestartImpl(uint32_t base_id, uint32_t restart_epoch,
   RELEASE_ASSERT(rc != -1, "");
 }
 
+Ssl::SessionCache* HotRestartImpl::sslSessionCache(uint32_t max_sessions) {
+  if (session_cache_ == nullptr) {
+    SessionCacheMemory* memory =
+        attachSessionCacheMemory(scaled_base_id_, restart_epoch_, max_sessions);
+    if (memory != nullptr) {
+      session_cache_ = std::make_unique<SharedMemorySessionCache>(*memory);
+    }
+  }
+  return session_cache_.get();
+}
+
 void HotRestartImpl::drainParentListeners() {
   as_child_.drainParentListeners();
   // At this point we are initialized and a new Envoy can startup if needed.
@@ -16,6 +16,7 @@
 
 #include "server/hot_restarting_child.h"
 #include "server/hot_restarting_parent.h"
+#include "server/shared_memory_session_cache.h"
 
 namespace Envoy {
 namespace Server {
@@ -46,6 +47,18 @@ static const uint64_t SHMEM_FLAGS_INITIALIZING = 0x1;
  */
 SharedMemory* attachSharedMemory(uint32_t base_id, uint32_t restart_epoch);
 
+/**
+ * Attach to the TLS session cache segment of the parent process if it has the layout required for
+ * max_sessions, or otherwise create a new one in its place.
+ *
+ * @param base_id uint32_t that is the base id flag used to start this Envoy.
+ * @param restart_epoch uint32_t the restart epoch flag used to start this Envoy.
+ * @param max_sessions uint32_t the number of sessions the cache holds at least.
+ * @return the segment, or nullptr if it could not be created.
+ */
+SessionCacheMemory* attachSessionCacheMemory(uint32_t base_id, uint32_t restart_epoch,
+                                             uint32_t max_sessions);
+
 /**
  * Initialize a pthread mutex for process shared locking.
  */
@@ -113,6 +126,7 @@ public:
   std::string version() override;
   Thread::BasicLockable& logLock() override { return log_lock_; }
   Thread::BasicLockable& accessLogLock() override { return access_log_lock_; }
+  Ssl::SessionCache* sslSessionCache(uint32_t max_sessions) override;
 
   /**
    * envoy --hot_restart_version doesn't initialize Envoy, but computes the version string
@@ -123,6 +137,7 @@ public:
 private:
   uint32_t base_id_;
   uint32_t scaled_base_id_;
+  const uint32_t restart_epoch_;
   HotRestartingChild as_child_;
   HotRestartingParent as_parent_;
   // This pointer is shared memory, and is expected to exist until process end.
@@ -130,6 +145,7 @@ private:
   SharedMemory* shmem_;
   ProcessSharedMutex log_lock_;
   ProcessSharedMutex access_log_lock_;
+  std::unique_ptr<SharedMemorySessionCache> session_cache_;
 };
 
 } // namespace Server
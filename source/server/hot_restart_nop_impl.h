@@ -27,6 +27,7 @@ public:
   std::string version() override { return "disabled"; }
   Thread::BasicLockable& logLock() override { return log_lock_; }
   Thread::BasicLockable& accessLogLock() override { return access_log_lock_; }
+  Ssl::SessionCache* sslSessionCache(uint32_t) override { return nullptr; }
 
 private:
   Thread::MutexBasicLockable log_lock_;
@@ -14,6 +14,7 @@
 #include "common/access_log/access_log_impl.h"
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
+#include "common/common/utility.h"
 #include "common/config/utility.h"
 #include "common/network/connection_balancer_impl.h"
 #include "common/network/resolver_impl.h"
@@ -61,9 +62,21 @@ ListenSocketFactoryImpl::ListenSocketFactoryImpl(ListenerComponentFactory& facto
                                                  Network::Socket::Type socket_type,
                                                  const Network::Socket::OptionsSharedPtr& options,
                                                  bool bind_to_port,
-                                                 const std::string& listener_name, bool reuse_port)
+                                                 const std::string& listener_name, bool reuse_port,
+                                                 bool reuse_port_cpu_steering,
+                                                 bool shares_group_with_parent)
     : factory_(factory), local_address_(address), socket_type_(socket_type), options_(options),
-      bind_to_port_(bind_to_port), listener_name_(listener_name), reuse_port_(reuse_port) {
+      bind_to_port_(bind_to_port), listener_name_(listener_name), reuse_port_(reuse_port),
+      reuse_port_cpu_steering_(reuse_port && reuse_port_cpu_steering && bind_to_port &&
+                               local_address_->type() == Network::Address::Type::Ip) {
+  if (reuse_port_cpu_steering_) {
+    steered_group_ = std::make_shared<SteeredGroup>();
+    if (shares_group_with_parent) {
+      // The position of the parent's sockets in the group is not known.
+      absl::MutexLock lock(&steered_group_->lock_);
+      steered_group_->steering_.disable();
+    }
+  }
 
   bool create_socket = false;
   if (local_address_->type() == Network::Address::Type::Ip) {
@@ -127,6 +140,9 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket() {
   if (!reuse_port_) {
     return socket_;
   }
+  if (reuse_port_cpu_steering_) {
+    return getSteeredListenSocket();
+  }
 
   Network::SocketSharedPtr socket;
   absl::call_once(steal_once_, [this, &socket]() {
@@ -149,6 +165,49 @@ Network::SocketSharedPtr ListenSocketFactoryImpl::getListenSocket() {
   return createListenSocketAndApplyOptions();
 }
 
+Network::SocketSharedPtr ListenSocketFactoryImpl::getSteeredListenSocket() {
+  // Sockets join the SO_REUSEPORT group when UDP sockets are bound and when TCP sockets start
+  // listening. Both happen here under the lock, so that the group order matches the order in which
+  // the sockets are added to the steering program. listen() is called again with the configured
+  // backlog once the worker creates its listener.
+  absl::MutexLock lock(&steered_group_->lock_);
+  Network::SocketSharedPtr socket = std::move(socket_);
+  if (socket == nullptr) {
+    socket = createListenSocketAndApplyOptions();
+  }
+  if (socket == nullptr) {
+    return socket;
+  }
+  if (socket_type_ == Network::Socket::Type::Stream) {
+    const Api::SysCallIntResult result = socket->ioHandle().listen(ENVOY_TCP_BACKLOG_SIZE);
+    if (result.rc_ != 0) {
+      throw Network::CreateListenerException(
+          fmt::format("cannot listen() on {}: {}", local_address_->asString(),
+                      errorDetails(result.errno_)));
+    }
+  }
+  // getListenSocket() is called on the worker that will use the socket.
+  steered_group_->steering_.addSocket(*socket, Network::ReusePortCpuSteering::currentThreadCpu());
+
+  // The socket leaves the group once the last listener using it is gone, e.g. after a listener
+  // update has replaced the listener sharing this factory. The kernel then reorders the group, so
+  // the socket is closed and removed under the lock before the program is rebuilt.
+  Network::Socket* raw_socket = socket.get();
+  return Network::SocketSharedPtr(
+      raw_socket, [group = steered_group_, socket = std::move(socket)](Network::Socket*) mutable {
+        absl::MutexLock lock(&group->lock_);
+        socket->close();
+        group->steering_.removeSocket(*socket);
+      });
+}
+
+void ListenSocketFactoryImpl::stopSteering() {
+  if (steered_group_ != nullptr) {
+    absl::MutexLock lock(&steered_group_->lock_);
+    steered_group_->steering_.disable();
+  }
+}
+
 ListenerFactoryContextBaseImpl::ListenerFactoryContextBaseImpl(
     Envoy::Server::Instance& server, ProtobufMessage::ValidationVisitor& validation_visitor,
     const envoy::config::listener::v3::Listener& config, DrainManagerPtr drain_manager)
@@ -492,9 +551,17 @@ void ListenerImpl::buildSocketOptions() {
   if (connection_balancer_ == nullptr) {
     // Not in place listener update.
     if (config_.has_connection_balance_config()) {
-      // Currently exact balance is the only supported type and there are no options.
-      ASSERT(config_.connection_balance_config().has_exact_balance());
-      connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+      switch (config_.connection_balance_config().balance_type_case()) {
+      case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kExactBalance:
+        connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+        break;
+      case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kLoadAwareBalance:
+        connection_balancer_ = std::make_shared<Network::LoadAwareConnectionBalancerImpl>(
+            listenerScope(), parent_.server_.random());
+        break;
+      default:
+        NOT_REACHED_GCOVR_EXCL_LINE;
+      }
     } else {
       connection_balancer_ = std::make_shared<Network::NopConnectionBalancerImpl>();
     }
@@ -17,10 +17,12 @@
 #include "common/common/logger.h"
 #include "common/init/manager_impl.h"
 #include "common/init/target_impl.h"
+#include "common/network/reuse_port_steering.h"
 
 #include "server/filter_chain_manager_impl.h"
 
 #include "absl/base/call_once.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Server {
@@ -43,7 +45,8 @@ public:
                           Network::Address::InstanceConstSharedPtr address,
                           Network::Socket::Type socket_type,
                           const Network::Socket::OptionsSharedPtr& options, bool bind_to_port,
-                          const std::string& listener_name, bool reuse_port);
+                          const std::string& listener_name, bool reuse_port,
+                          bool reuse_port_cpu_steering, bool shares_group_with_parent);
 
   // Network::ListenSocketFactory
   Network::Socket::Type socketType() const override { return socket_type_; }
@@ -66,10 +69,19 @@ public:
     return absl::nullopt;
   }
 
+  /**
+   * Stop steering the connections of the SO_REUSEPORT group, because this process stops listening
+   * for good, e.g. when handing over to a hot restart child. Otherwise closing the sockets would
+   * re-attach a program that does not know about the sockets of the child.
+   */
+  void stopSteering();
+
 protected:
   Network::SocketSharedPtr createListenSocketAndApplyOptions();
 
 private:
+  Network::SocketSharedPtr getSteeredListenSocket();
+
   ListenerComponentFactory& factory_;
   // Initially, its port number might be 0. Once a socket is created, its port
   // will be set to the binding port.
@@ -79,8 +91,18 @@ private:
   bool bind_to_port_;
   const std::string& listener_name_;
   const bool reuse_port_;
+  const bool reuse_port_cpu_steering_;
   Network::SocketSharedPtr socket_;
   absl::once_flag steal_once_;
+
+  // The SO_REUSEPORT group when steering. It is shared with the sockets handed out, which remove
+  // themselves from the group when the last worker releases them.
+  struct SteeredGroup {
+    // Serializes sockets joining and leaving the group, so that the group order is known.
+    absl::Mutex lock_;
+    Network::ReusePortCpuSteering steering_ ABSL_GUARDED_BY(lock_);
+  };
+  std::shared_ptr<SteeredGroup> steered_group_;
 };
 
 // TODO(mattklein123): Consider getting rid of pre-worker start and post-worker start code by
@@ -261,7 +261,7 @@ ListenerManagerImpl::ListenerManagerImpl(Instance& server,
       enable_dispatcher_stats_(enable_dispatcher_stats) {
   for (uint32_t i = 0; i < server.options().concurrency(); i++) {
     workers_.emplace_back(
-        worker_factory.createWorker(server.overloadManager(), absl::StrCat("worker_", i)));
+        worker_factory.createWorker(i, server.overloadManager(), absl::StrCat("worker_", i)));
   }
 }
 
@@ -841,6 +841,15 @@ uint64_t ListenerManagerImpl::numConnections() const {
   return num_connections;
 }
 
+std::vector<WorkerPlacement> ListenerManagerImpl::workerPlacements() const {
+  std::vector<WorkerPlacement> placements;
+  placements.reserve(workers_.size());
+  for (const auto& worker : workers_) {
+    placements.push_back(worker->placement());
+  }
+  return placements;
+}
+
 bool ListenerManagerImpl::removeListener(const std::string& name) {
   return removeListenerInternal(name, true);
 }
@@ -930,6 +939,15 @@ void ListenerManagerImpl::stopListener(Network::ListenerConfig& listener,
 
 void ListenerManagerImpl::stopListeners(StopListenersType stop_listeners_type) {
   stop_listeners_type_ = stop_listeners_type;
+  if (stop_listeners_type == StopListenersType::All) {
+    for (const auto& listener : active_listeners_) {
+      auto* socket_factory =
+          dynamic_cast<ListenSocketFactoryImpl*>(listener->getSocketFactory().get());
+      if (socket_factory != nullptr) {
+        socket_factory->stopSteering();
+      }
+    }
+  }
   for (Network::ListenerConfig& listener : listeners()) {
     if (stop_listeners_type != StopListenersType::InboundOnly ||
         listener.direction() == envoy::config::core::v3::INBOUND) {
@@ -1036,7 +1054,10 @@ Network::ListenSocketFactorySharedPtr ListenerManagerImpl::createListenSocketFac
   Network::Socket::Type socket_type = Network::Utility::protobufAddressSocketType(proto_address);
   return std::make_shared<ListenSocketFactoryImpl>(
       factory_, listener.address(), socket_type, listener.listenSocketOptions(),
-      listener.bindToPort(), listener.name(), reuse_port);
+      listener.bindToPort(), listener.name(), reuse_port,
+      listener.config().reuse_port_cpu_steering(),
+      // A hot restart parent keeps listening on its sockets until our workers have started.
+      server_.options().restartEpoch() > 0 && !workers_started_);
 }
 
 ApiListenerOptRef ListenerManagerImpl::apiListener() {
@@ -192,6 +192,7 @@ public:
   std::vector<std::reference_wrapper<Network::ListenerConfig>>
   listeners(ListenerState state = ListenerState::ACTIVE) override;
   uint64_t numConnections() const override;
+  std::vector<WorkerPlacement> workerPlacements() const override;
   bool removeListener(const std::string& listener_name) override;
   void startWorkers(GuardDog& guard_dog) override;
   void stopListeners(StopListenersType stop_listeners_type) override;
@@ -14,6 +14,7 @@
 #include "common/version/version.h"
 
 #include "server/options_impl_platform.h"
+#include "server/worker_placement.h"
 
 #include "absl/strings/str_replace.h"
 #include "absl/strings/str_split.h"
@@ -151,6 +152,12 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::ValueArg<std::string> worker_cpu_affinity(
+      "", "worker-cpu-affinity", "List of CPUs to pin worker threads to, e.g. 0-3,8-11", false, "",
+      "string", cmd);
+  TCLAP::SwitchArg numa_local_workers("", "numa-local-workers",
+                                      "Allocate worker memory on the worker's NUMA node", cmd,
+                                      false);
 
   TCLAP::ValueArg<bool> use_fake_symbol_table("", "use-fake-symbol-table",
                                               "Use fake symbol table implementation", false, false,
@@ -188,6 +195,13 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   mutex_tracing_enabled_ = enable_mutex_tracing.getValue();
   fake_symbol_table_enabled_ = use_fake_symbol_table.getValue();
   cpuset_threads_ = cpuset_threads.getValue();
+  numa_local_workers_ = numa_local_workers.getValue();
+  const auto cpus = WorkerPlacementUtility::parseCpuList(worker_cpu_affinity.getValue());
+  if (!cpus.has_value()) {
+    throw MalformedArgvException(
+        fmt::format("error: invalid CPU list '{}'", worker_cpu_affinity.getValue()));
+  }
+  worker_cpu_affinity_ = cpus.value();
 
   if (log_level.isSet()) {
     log_level_ = parseAndValidateLogLevel(log_level.getValue());
@@ -407,6 +421,10 @@ Server::CommandLineOptionsPtr OptionsImpl::toCommandLineOptions() const {
   command_line_options->set_disable_hot_restart(hotRestartDisabled());
   command_line_options->set_enable_mutex_tracing(mutexTracingEnabled());
   command_line_options->set_cpuset_threads(cpusetThreadsEnabled());
+  for (const uint32_t cpu : workerCpuAffinity()) {
+    command_line_options->add_worker_cpu_affinity(cpu);
+  }
+  command_line_options->set_numa_local_workers(numaLocalWorkersEnabled());
   command_line_options->set_restart_epoch(restartEpoch());
   for (const auto& e : disabledExtensions()) {
     command_line_options->add_disabled_extensions(e);
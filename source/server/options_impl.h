@@ -90,6 +90,12 @@ public:
     signal_handling_enabled_ = signal_handling_enabled;
   }
   void setCpusetThreads(bool cpuset_threads_enabled) { cpuset_threads_ = cpuset_threads_enabled; }
+  void setWorkerCpuAffinity(const std::vector<uint32_t>& worker_cpu_affinity) {
+    worker_cpu_affinity_ = worker_cpu_affinity;
+  }
+  void setNumaLocalWorkers(bool numa_local_workers_enabled) {
+    numa_local_workers_ = numa_local_workers_enabled;
+  }
   void setAllowUnkownFields(bool allow_unknown_static_fields) {
     allow_unknown_static_fields_ = allow_unknown_static_fields;
   }
@@ -154,6 +160,8 @@ public:
   Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  const std::vector<uint32_t>& workerCpuAffinity() const override { return worker_cpu_affinity_; }
+  bool numaLocalWorkersEnabled() const override { return numa_local_workers_; }
   const std::vector<std::string>& disabledExtensions() const override {
     return disabled_extensions_;
   }
@@ -205,6 +213,8 @@ private:
   bool signal_handling_enabled_;
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
+  std::vector<uint32_t> worker_cpu_affinity_;
+  bool numa_local_workers_{false};
   bool fake_symbol_table_enabled_;
   std::vector<std::string> disabled_extensions_;
   uint32_t count_;
@@ -74,7 +74,7 @@ InstanceImpl::InstanceImpl(
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(new ConnectionHandlerImpl(*dispatcher_)),
       random_generator_(std::move(random_generator)), listener_component_factory_(*this),
-      worker_factory_(thread_local_, *api_, hooks),
+      worker_factory_(thread_local_, *api_, hooks, options),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
                           store),
       terminated_(false),
@@ -212,6 +212,12 @@ void InstanceImpl::updateServerStats() {
   server_stats_->memory_heap_size_.set(Memory::Stats::totalCurrentlyReserved());
   server_stats_->memory_physical_size_.set(Memory::Stats::totalPhysicalBytes());
   server_stats_->parent_connections_.set(parent_stats.parent_connections_);
+  updateSlicePoolLimit();
+  const Buffer::SlicePool::Stats slice_pool_stats = Buffer::SlicePool::stats();
+  server_stats_->slice_pool_hits_.add(slice_pool_stats.hits_ - slice_pool_stats_.hits_);
+  server_stats_->slice_pool_misses_.add(slice_pool_stats.misses_ - slice_pool_stats_.misses_);
+  server_stats_->slice_pool_cached_bytes_.set(slice_pool_stats.cached_bytes_);
+  slice_pool_stats_ = slice_pool_stats;
   server_stats_->total_connections_.set(listener_manager_->numConnections() +
                                         parent_stats.parent_connections_);
   server_stats_->days_until_first_cert_expiring_.set(
@@ -222,6 +228,12 @@ void InstanceImpl::updateServerStats() {
       stats_store_.symbolTable().getRecentLookups([](absl::string_view, uint64_t) {}));
 }
 
+// Called on every stats flush, so that runtime updates of the limit take effect.
+void InstanceImpl::updateSlicePoolLimit() {
+  Buffer::SlicePool::setMaxCachedBytes(runtime().snapshot().getInteger(
+      "buffer.slice_pool.max_cached_bytes", Buffer::SlicePool::DefaultMaxCachedBytes));
+}
+
 void InstanceImpl::flushStatsInternal() {
   updateServerStats();
   InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_);
@@ -470,9 +482,20 @@ void InstanceImpl::initialize(const Options& options,
   runtime_singleton_ = std::make_unique<Runtime::ScopedLoaderSingleton>(
       component_factory.createRuntime(*this, initial_config));
   hooks.onRuntimeCreated();
+  updateSlicePoolLimit();
 
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_ = createContextManager("ssl_context_manager", time_source_);
+  // If configured, server contexts share the sessions cached in shared memory across listeners and
+  // hot restarts.
+  if (bootstrap_.has_tls_session_cache()) {
+    Ssl::SessionCache* session_cache =
+        restarter_.sslSessionCache(bootstrap_.tls_session_cache().max_sessions());
+    if (session_cache == nullptr) {
+      ENVOY_LOG(warn, "the shared TLS session cache is unavailable, it requires hot restart");
+    }
+    ssl_context_manager_->setSessionCache(session_cache);
+  }
 
   const bool use_tcp_for_dns_lookups = bootstrap_.use_tcp_for_dns_lookups();
   dns_resolver_ = dispatcher_->createDnsResolver({}, use_tcp_for_dns_lookups);
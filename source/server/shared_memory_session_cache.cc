@@ -0,0 +1,133 @@
+#include "server/shared_memory_session_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "common/common/hash.h"
+#include "common/common/lock_guard.h"
+
+#include "server/hot_restart_impl.h"
+
+namespace Envoy {
+namespace Server {
+
+namespace {
+
+uint64_t toSeconds(SystemTime time) {
+  return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+void SharedMemorySessionCache::initialize(SessionCacheMemory& memory, uint32_t sets_per_shard,
+                                          uint64_t version) {
+  memory.size_ = SessionCacheMemory::size(sets_per_shard);
+  memory.version_ = version;
+  memory.sets_per_shard_ = sets_per_shard;
+  for (SessionCacheMemory::Shard& shard : memory.shards_) {
+    initializeMutex(shard.lock_);
+  }
+}
+
+SharedMemorySessionCache::Set SharedMemorySessionCache::set(absl::Span<const uint8_t> id) {
+  // Clients pick the ids they look up, so they are hashed rather than used directly.
+  const uint64_t hash =
+      HashUtil::xxHash64(absl::string_view(reinterpret_cast<const char*>(id.data()), id.size()));
+  const uint64_t shard_index = hash % SessionCacheMemory::Shards;
+  const uint64_t set_index = (hash / SessionCacheMemory::Shards) % memory_.sets_per_shard_;
+  return {memory_.shards_[shard_index],
+          &memory_.entries()[(shard_index * memory_.sets_per_shard_ + set_index) *
+                             SessionCacheMemory::Ways]};
+}
+
+SessionCacheMemory::Entry* SharedMemorySessionCache::find(const Set& set,
+                                                          absl::Span<const uint8_t> id) {
+  for (uint32_t i = 0; i < SessionCacheMemory::Ways; i++) {
+    SessionCacheMemory::Entry& entry = set.entries_[i];
+    if (entry.expiry_ != 0 && entry.id_length_ == id.size() &&
+        memcmp(entry.id_, id.data(), id.size()) == 0) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+Ssl::SessionCache::InsertResult SharedMemorySessionCache::insert(absl::Span<const uint8_t> id,
+                                                                 absl::Span<const uint8_t> session,
+                                                                 SystemTime expiry,
+                                                                 SystemTime now) {
+  const uint64_t expiry_seconds = toSeconds(expiry);
+  const uint64_t now_seconds = toSeconds(now);
+  if (id.empty() || id.size() > SessionCacheMemory::MaxIdLength ||
+      session.size() > SessionCacheMemory::MaxSessionLength || expiry_seconds <= now_seconds) {
+    return InsertResult::Rejected;
+  }
+
+  const Set entries = set(id);
+  ProcessSharedMutex mutex(entries.shard_.lock_);
+  Thread::LockGuard lock(mutex);
+  SessionCacheMemory::Entry* victim = find(entries, id);
+  bool evicted = false;
+  if (victim == nullptr) {
+    // Prefer a free or expired entry, and otherwise evict the least recently used one.
+    for (uint32_t i = 0; i < SessionCacheMemory::Ways; i++) {
+      SessionCacheMemory::Entry& entry = entries.entries_[i];
+      if (entry.expiry_ <= now_seconds) {
+        victim = &entry;
+        break;
+      }
+      if (victim == nullptr || entry.last_used_ < victim->last_used_) {
+        victim = &entry;
+      }
+    }
+    evicted = victim->expiry_ > now_seconds;
+  }
+
+  victim->expiry_ = expiry_seconds;
+  victim->last_used_ = ++entries.shard_.clock_;
+  victim->id_length_ = id.size();
+  memcpy(victim->id_, id.data(), id.size());
+  victim->session_length_ = session.size();
+  memcpy(victim->session_, session.data(), session.size());
+  return evicted ? InsertResult::Evicted : InsertResult::Inserted;
+}
+
+bool SharedMemorySessionCache::lookup(absl::Span<const uint8_t> id, SystemTime now,
+                                      std::vector<uint8_t>& session) {
+  if (id.empty() || id.size() > SessionCacheMemory::MaxIdLength) {
+    return false;
+  }
+
+  const Set entries = set(id);
+  ProcessSharedMutex mutex(entries.shard_.lock_);
+  Thread::LockGuard lock(mutex);
+  SessionCacheMemory::Entry* entry = find(entries, id);
+  if (entry == nullptr) {
+    return false;
+  }
+  if (entry->expiry_ <= toSeconds(now)) {
+    entry->expiry_ = 0;
+    return false;
+  }
+  entry->last_used_ = ++entries.shard_.clock_;
+  session.assign(entry->session_, entry->session_ + entry->session_length_);
+  return true;
+}
+
+void SharedMemorySessionCache::remove(absl::Span<const uint8_t> id) {
+  if (id.empty() || id.size() > SessionCacheMemory::MaxIdLength) {
+    return;
+  }
+
+  const Set entries = set(id);
+  ProcessSharedMutex mutex(entries.shard_.lock_);
+  Thread::LockGuard lock(mutex);
+  SessionCacheMemory::Entry* entry = find(entries, id);
+  if (entry != nullptr) {
+    entry->expiry_ = 0;
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <pthread.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/ssl/session_cache.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * The layout of the TLS session cache shared memory segment. The cache is split into shards, each
+ * with its own process shared lock, and each shard is a set associative table whose sets evict
+ * their least recently used entry. The header is followed by the entries of all the shards. Entries
+ * hold serialized sessions, so they stay valid across processes.
+ */
+struct SessionCacheMemory {
+  static constexpr uint32_t Shards = 16;
+  static constexpr uint32_t Ways = 8;
+  static constexpr uint32_t MaxIdLength = 32; // SSL_MAX_SSL_SESSION_ID_LENGTH
+  // Large enough for sessions without a peer certificate chain.
+  static constexpr uint32_t MaxSessionLength = 1024;
+
+  struct Entry {
+    uint64_t expiry_;    // Seconds since the epoch, 0 if the entry is free.
+    uint64_t last_used_; // Value of the shard's clock_ when the entry was last used.
+    uint8_t id_length_;
+    uint8_t id_[MaxIdLength];
+    uint16_t session_length_;
+    uint8_t session_[MaxSessionLength];
+  };
+
+  struct Shard {
+    pthread_mutex_t lock_;
+    uint64_t clock_;
+  };
+
+  /**
+   * @return the number of sets per shard holding at least max_sessions sessions.
+   */
+  static uint32_t setsPerShard(uint32_t max_sessions) {
+    return (max_sessions + Shards * Ways - 1) / (Shards * Ways);
+  }
+
+  /**
+   * @return the size of the segment of a cache with the given number of sets per shard.
+   */
+  static uint64_t size(uint32_t sets_per_shard) {
+    return sizeof(SessionCacheMemory) +
+           uint64_t(Shards) * sets_per_shard * Ways * sizeof(SessionCacheMemory::Entry);
+  }
+
+  Entry* entries() { return reinterpret_cast<Entry*>(this + 1); }
+
+  uint64_t size_;
+  uint64_t version_;
+  uint32_t sets_per_shard_;
+  Shard shards_[Shards];
+};
+
+/**
+ * Ssl::SessionCache backed by a shared memory segment, shared by every worker of every process
+ * attached to the segment. Sessions survive hot restarts.
+ */
+class SharedMemorySessionCache : public Ssl::SessionCache {
+public:
+  explicit SharedMemorySessionCache(SessionCacheMemory& memory) : memory_(memory) {}
+
+  /**
+   * Initializes a zeroed segment of SessionCacheMemory::size(sets_per_shard) bytes, when it is
+   * created.
+   */
+  static void initialize(SessionCacheMemory& memory, uint32_t sets_per_shard, uint64_t version);
+
+  // Ssl::SessionCache
+  InsertResult insert(absl::Span<const uint8_t> id, absl::Span<const uint8_t> session,
+                      SystemTime expiry, SystemTime now) override;
+  bool lookup(absl::Span<const uint8_t> id, SystemTime now,
+              std::vector<uint8_t>& session) override;
+  void remove(absl::Span<const uint8_t> id) override;
+
+private:
+  struct Set {
+    SessionCacheMemory::Shard& shard_;
+    SessionCacheMemory::Entry* entries_;
+  };
+
+  Set set(absl::Span<const uint8_t> id);
+  static SessionCacheMemory::Entry* find(const Set& set, absl::Span<const uint8_t> id);
+
+  SessionCacheMemory& memory_;
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -9,29 +9,47 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/buffer/buffer_impl.h"
+
 #include "server/connection_handler_impl.h"
 
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager,
+WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager,
                                           const std::string& worker_name) {
+  if (options_.numaLocalWorkersEnabled() && !numa_topology_.has_value()) {
+    numa_topology_ = NumaTopology::load(api_.fileSystem());
+    if (numa_topology_->nodes().empty()) {
+      ENVOY_LOG(warn, "NUMA topology is not available, workers will not be NUMA local");
+    }
+  }
+  WorkerPlacement placement = WorkerPlacementUtility::placementFor(
+      index, options_.workerCpuAffinity(), options_.numaLocalWorkersEnabled(),
+      numa_topology_.has_value() ? numa_topology_.value() : NumaTopology());
+
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher(worker_name));
   return WorkerPtr{
       new WorkerImpl(tls_, hooks_, std::move(dispatcher),
                      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(*dispatcher)},
-                     overload_manager, api_)};
+                     overload_manager, api_, std::move(placement))};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
-                       OverloadManager& overload_manager, Api::Api& api)
+                       OverloadManager& overload_manager, Api::Api& api,
+                       WorkerPlacement placement)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api) {
+      api_(api), placement_(std::move(placement)) {
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
       [this](OverloadActionState state) { stopAcceptingConnectionsCb(state); });
+  // Cached slice storage is freed, and no more is cached, while the heap is being shrunk.
+  overload_manager.registerForAction(
+      OverloadActionNames::get().ShrinkHeap, *dispatcher_, [](OverloadActionState state) {
+        Buffer::SlicePool::setThreadCacheEnabled(!state.isSaturated());
+      });
 }
 
 void WorkerImpl::addListener(absl::optional<uint64_t> overridden_listener,
@@ -60,6 +78,13 @@ uint64_t WorkerImpl::numConnections() const {
   return ret;
 }
 
+WorkerPlacement WorkerImpl::placement() const {
+  if (placement_applied_) {
+    return placement_;
+  }
+  return {};
+}
+
 void WorkerImpl::removeListener(Network::ListenerConfig& listener,
                                 std::function<void()> completion) {
   ASSERT(thread_);
@@ -122,6 +147,12 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener, std::function<v
 }
 
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
+  // The placement is applied before anything else runs on the thread so that the memory the
+  // worker allocates from here on, e.g. connection buffers and thread local caches, comes from
+  // its own NUMA node.
+  if (!placement_.cpus_.empty() || placement_.numa_node_.has_value()) {
+    placement_applied_ = WorkerPlacementUtility::applyToCurrentThread(placement_);
+  }
   ENVOY_LOG(debug, "worker entering dispatch loop");
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
   // as this is when TLS stat scopes start working.
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 
@@ -7,29 +8,35 @@
 #include "envoy/network/connection_handler.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/listener_manager.h"
+#include "envoy/server/options.h"
 #include "envoy/server/worker.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
 
 #include "server/listener_hooks.h"
+#include "server/worker_placement.h"
 
 namespace Envoy {
 namespace Server {
 
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks,
+                    const Options& options)
+      : tls_(tls), api_(api), hooks_(hooks), options_(options) {}
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager& overload_manager,
+  WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager,
                          const std::string& worker_name) override;
 
 private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  const Options& options_;
+  // Loaded when the first worker is created, and only if workers are NUMA local.
+  absl::optional<NumaTopology> numa_topology_;
 };
 
 /**
@@ -39,12 +46,13 @@ class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
              Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api);
+             Api::Api& api, WorkerPlacement placement = {});
 
   // Server::Worker
   void addListener(absl::optional<uint64_t> overridden_listener, Network::ListenerConfig& listener,
                    AddListenerCompletion completion) override;
   uint64_t numConnections() const override;
+  WorkerPlacement placement() const override;
 
   void removeListener(Network::ListenerConfig& listener, std::function<void()> completion) override;
   void removeFilterChains(uint64_t listener_tag,
@@ -64,6 +72,8 @@ private:
   Event::DispatcherPtr dispatcher_;
   Network::ConnectionHandlerPtr handler_;
   Api::Api& api_;
+  const WorkerPlacement placement_;
+  std::atomic<bool> placement_applied_{false};
   Thread::ThreadPtr thread_;
   WatchDogSharedPtr watch_dog_;
 };
@@ -0,0 +1,157 @@
+#include "server/worker_placement.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/fmt.h"
+#include "common/common/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sched.h>
+
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace Server {
+
+NumaTopology NumaTopology::load(Filesystem::Instance& file_system) {
+  static constexpr absl::string_view NodeRoot = "/sys/devices/system/node/";
+  std::vector<Node> nodes;
+  try {
+    const auto node_ids = WorkerPlacementUtility::parseCpuList(
+        StringUtil::trim(file_system.fileReadToEnd(absl::StrCat(NodeRoot, "online"))));
+    if (!node_ids.has_value()) {
+      return {};
+    }
+    for (const uint32_t node_id : node_ids.value()) {
+      auto cpus = WorkerPlacementUtility::parseCpuList(StringUtil::trim(file_system.fileReadToEnd(
+          fmt::format("{}node{}/cpulist", NodeRoot, node_id))));
+      if (!cpus.has_value()) {
+        return {};
+      }
+      nodes.push_back({node_id, std::move(cpus.value())});
+    }
+  } catch (const EnvoyException&) {
+    // No NUMA information, e.g. on platforms other than Linux.
+    return {};
+  }
+  return NumaTopology(std::move(nodes));
+}
+
+absl::optional<uint32_t> NumaTopology::nodeOfCpu(uint32_t cpu) const {
+  for (const Node& node : nodes_) {
+    if (std::find(node.cpus_.begin(), node.cpus_.end(), cpu) != node.cpus_.end()) {
+      return node.id_;
+    }
+  }
+  return absl::nullopt;
+}
+
+absl::optional<std::vector<uint32_t>>
+WorkerPlacementUtility::parseCpuList(absl::string_view cpu_list) {
+  // Far more CPUs than any machine has, to bound the size of the list.
+  static constexpr uint32_t MaxCpu = 1 << 16;
+  std::vector<uint32_t> cpus;
+  // An empty list is valid, e.g. the cpulist of a node without CPUs.
+  for (absl::string_view range : absl::StrSplit(cpu_list, ',', absl::SkipWhitespace())) {
+    const std::vector<absl::string_view> bounds = absl::StrSplit(range, absl::MaxSplits('-', 1));
+    uint32_t first;
+    uint32_t last;
+    if (!absl::SimpleAtoi(bounds[0], &first)) {
+      return absl::nullopt;
+    }
+    last = first;
+    if (bounds.size() == 2 && (!absl::SimpleAtoi(bounds[1], &last) || last < first)) {
+      return absl::nullopt;
+    }
+    if (last >= MaxCpu) {
+      return absl::nullopt;
+    }
+    for (uint32_t cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+WorkerPlacement WorkerPlacementUtility::placementFor(uint32_t index,
+                                                     const std::vector<uint32_t>& cpu_affinity,
+                                                     bool numa_local,
+                                                     const NumaTopology& topology) {
+  WorkerPlacement placement;
+  if (!cpu_affinity.empty()) {
+    const uint32_t cpu = cpu_affinity[index % cpu_affinity.size()];
+    placement.cpus_.push_back(cpu);
+    if (numa_local) {
+      placement.numa_node_ = topology.nodeOfCpu(cpu);
+    }
+  } else if (numa_local && !topology.nodes().empty()) {
+    const NumaTopology::Node& node = topology.nodes()[index % topology.nodes().size()];
+    placement.cpus_ = node.cpus_;
+    placement.numa_node_ = node.id_;
+  }
+  return placement;
+}
+
+#ifdef __linux__
+bool WorkerPlacementUtility::applyToCurrentThread(const WorkerPlacement& placement) {
+  auto& linux_os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+  if (!placement.cpus_.empty()) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (const uint32_t cpu : placement.cpus_) {
+      if (cpu >= CPU_SETSIZE) {
+        ENVOY_LOG(warn, "cannot pin worker thread to CPU {}: at most {} CPUs are supported", cpu,
+                  CPU_SETSIZE);
+        return false;
+      }
+      CPU_SET(cpu, &mask);
+    }
+    // A pid of zero is the calling thread.
+    const Api::SysCallIntResult result =
+        linux_os_syscalls.sched_setaffinity(0, sizeof(cpu_set_t), &mask);
+    if (result.rc_ != 0) {
+      ENVOY_LOG(warn, "cannot pin worker thread to CPUs {}: {}",
+                absl::StrJoin(placement.cpus_, ","), errorDetails(result.errno_));
+      return false;
+    }
+  }
+
+  if (placement.numa_node_.has_value()) {
+    // MPOL_PREFERRED rather than MPOL_BIND, so that allocations fall back to other nodes instead
+    // of failing when the local node is out of memory. The kernel ignores the last bit of the mask,
+    // so it is sized to hold one more node than needed.
+    constexpr uint32_t BitsPerWord = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> node_mask((placement.numa_node_.value() + 1) / BitsPerWord + 1);
+    node_mask[placement.numa_node_.value() / BitsPerWord] |=
+        1UL << (placement.numa_node_.value() % BitsPerWord);
+    const Api::SysCallIntResult result = linux_os_syscalls.set_mempolicy(
+        MPOL_PREFERRED, node_mask.data(), node_mask.size() * BitsPerWord);
+    if (result.rc_ != 0) {
+      ENVOY_LOG(warn, "cannot set the memory policy of worker thread to NUMA node {}: {}",
+                placement.numa_node_.value(), errorDetails(result.errno_));
+      return false;
+    }
+  }
+  return true;
+}
+#else
+bool WorkerPlacementUtility::applyToCurrentThread(const WorkerPlacement& placement) {
+  if (!placement.cpus_.empty() || placement.numa_node_.has_value()) {
+    ENVOY_LOG(warn, "worker thread placement is only supported on Linux");
+    return false;
+  }
+  return true;
+}
+#endif
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/server/worker.h"
+
+#include "common/common/logger.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * The NUMA nodes of the machine and the CPUs that belong to each of them.
+ */
+class NumaTopology {
+public:
+  struct Node {
+    uint32_t id_;
+    std::vector<uint32_t> cpus_;
+  };
+
+  NumaTopology() = default;
+  explicit NumaTopology(std::vector<Node> nodes) : nodes_(std::move(nodes)) {}
+
+  /**
+   * Read the topology from sysfs. The topology is empty if it can't be read, e.g. on platforms
+   * other than Linux.
+   */
+  static NumaTopology load(Filesystem::Instance& file_system);
+
+  const std::vector<Node>& nodes() const { return nodes_; }
+
+  /**
+   * @return the node the CPU belongs to, if it is known.
+   */
+  absl::optional<uint32_t> nodeOfCpu(uint32_t cpu) const;
+
+private:
+  std::vector<Node> nodes_;
+};
+
+/**
+ * Worker placement utilities.
+ */
+class WorkerPlacementUtility : Logger::Loggable<Logger::Id::main> {
+public:
+  /**
+   * Parse a CPU list in the format used by sysfs and taskset, e.g. "0-3,8,10-11".
+   * @return the CPUs in the order listed, or nullopt if the list is malformed.
+   */
+  static absl::optional<std::vector<uint32_t>> parseCpuList(absl::string_view cpu_list);
+
+  /**
+   * Compute the placement of a worker.
+   * @param index supplies the index of the worker.
+   * @param cpu_affinity supplies the CPUs workers are pinned to. Worker i is pinned to
+   *        cpu_affinity[i % cpu_affinity.size()]. If empty, workers are not pinned to single CPUs.
+   * @param numa_local supplies whether workers allocate memory on their local NUMA node. If set
+   *        without CPUs, workers are spread round robin across the nodes and restricted to the
+   *        CPUs of their node.
+   * @param topology supplies the NUMA topology, only used if numa_local is set.
+   */
+  static WorkerPlacement placementFor(uint32_t index, const std::vector<uint32_t>& cpu_affinity,
+                                      bool numa_local, const NumaTopology& topology);
+
+  /**
+   * Apply a placement to the calling thread. Memory the thread allocates from then on prefers the
+   * placement's NUMA node.
+   * @return whether the placement was applied. Failures are logged.
+   */
+  static bool applyToCurrentThread(const WorkerPlacement& placement);
+};
+
+} // namespace Server
+} // namespace Envoy
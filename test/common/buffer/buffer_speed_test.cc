@@ -244,6 +244,34 @@ static void bufferReserveCommitPartial(benchmark::State& state) {
 }
 BENCHMARK(bufferReserveCommitPartial)->Arg(1)->Arg(4096)->Arg(16384)->Arg(65536);
 
+// Test the read cycle of a connection: a read is reserved and committed, moved to another buffer and
+// drained, so that every iteration creates and frees a slice. The first argument enables (1) or
+// disables (0) the slice pool of the thread.
+static void bufferReadMoveDrain(benchmark::State& state) {
+  Buffer::SlicePool::setThreadCacheEnabled(state.range(0) != 0);
+  Buffer::OwnedImpl read_buffer;
+  Buffer::OwnedImpl destination;
+  uint64_t length = 0;
+  for (auto _ : state) {
+    constexpr uint64_t NumSlices = 2;
+    Buffer::RawSlice slices[NumSlices];
+    uint64_t slices_used = read_buffer.reserve(state.range(1), slices, NumSlices);
+    read_buffer.commit(slices, slices_used);
+    destination.move(read_buffer);
+    length += destination.length();
+    destination.drain(destination.length());
+  }
+  benchmark::DoNotOptimize(length);
+  Buffer::SlicePool::setThreadCacheEnabled(true);
+}
+BENCHMARK(bufferReadMoveDrain)
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({0, 16384})
+    ->Args({1, 16384})
+    ->Args({0, 65536})
+    ->Args({1, 65536});
+
 // Test the linearization of a buffer in the best case where the data is in one slice.
 static void bufferLinearizeSimple(benchmark::State& state) {
   const std::string data(state.range(0), 'a');
@@ -191,6 +191,66 @@ TEST_F(OwnedSliceTest, Drain) {
   EXPECT_EQ(original_size, slice->reservableSize());
 }
 
+class SlicePoolTest : public testing::Test {
+protected:
+  SlicePoolTest() { SlicePool::releaseThreadCache(); }
+  ~SlicePoolTest() override {
+    SlicePool::setMaxCachedBytes(SlicePool::DefaultMaxCachedBytes);
+    SlicePool::setThreadCacheEnabled(true);
+  }
+};
+
+TEST_F(SlicePoolTest, ReusesStorageOfSizeClass) {
+  const SlicePool::Stats before = SlicePool::stats();
+  SlicePtr slice = OwnedSlice::create(16384);
+  const Slice* storage = slice.get();
+  slice.reset();
+  EXPECT_EQ(20480, SlicePool::stats().cached_bytes_ - before.cached_bytes_);
+
+  // A slice needing the same storage size gets the storage.
+  slice = OwnedSlice::create(18000);
+  EXPECT_EQ(storage, slice.get());
+  EXPECT_EQ(20416, slice->reservableSize());
+  const SlicePool::Stats after = SlicePool::stats();
+  EXPECT_EQ(1, after.hits_ - before.hits_);
+  EXPECT_EQ(1, after.misses_ - before.misses_);
+  EXPECT_EQ(before.cached_bytes_, after.cached_bytes_);
+}
+
+TEST_F(SlicePoolTest, DoesNotCacheSizesOutsideClasses) {
+  const SlicePool::Stats before = SlicePool::stats();
+  OwnedSlice::create(8000).reset();
+  OwnedSlice::create(1024 * 1024).reset();
+  EXPECT_EQ(before.cached_bytes_, SlicePool::stats().cached_bytes_);
+
+  // Cached storage of a larger class is not used for a smaller slice.
+  OwnedSlice::create(16384).reset();
+  const SlicePool::Stats cached = SlicePool::stats();
+  SlicePtr slice = OwnedSlice::create(12000);
+  EXPECT_EQ(12224, slice->reservableSize());
+  EXPECT_EQ(cached.cached_bytes_, SlicePool::stats().cached_bytes_);
+  EXPECT_EQ(cached.hits_, SlicePool::stats().hits_);
+}
+
+TEST_F(SlicePoolTest, MaxCachedBytes) {
+  SlicePool::setMaxCachedBytes(4096);
+  const SlicePool::Stats before = SlicePool::stats();
+  SlicePtr first = OwnedSlice::create(100);
+  SlicePtr second = OwnedSlice::create(100);
+  first.reset();
+  second.reset();
+  EXPECT_EQ(4096, SlicePool::stats().cached_bytes_ - before.cached_bytes_);
+}
+
+TEST_F(SlicePoolTest, DisabledThreadCache) {
+  OwnedSlice::create(100).reset();
+  const SlicePool::Stats before = SlicePool::stats();
+  SlicePool::setThreadCacheEnabled(false);
+  EXPECT_EQ(before.cached_bytes_ - 4096, SlicePool::stats().cached_bytes_);
+  OwnedSlice::create(100).reset();
+  EXPECT_EQ(before.cached_bytes_ - 4096, SlicePool::stats().cached_bytes_);
+}
+
 TEST(UnownedSliceTest, CreateDelete) {
   constexpr char input[] = "hello world";
   bool release_callback_called = false;
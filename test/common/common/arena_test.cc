@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(ArenaTest, AllocateFromBlocks) {
+  Arena arena(64, 1024);
+  EXPECT_EQ(0, arena.bytesAllocated());
+  EXPECT_EQ(0, arena.bytesReserved());
+
+  char* first = static_cast<char*>(arena.allocate(16));
+  char* second = static_cast<char*>(arena.allocate(16));
+  EXPECT_EQ(first + 16, second);
+  EXPECT_EQ(32, arena.bytesAllocated());
+  EXPECT_EQ(64, arena.bytesReserved());
+
+  // Padding is added to honor the alignment.
+  arena.allocate(1, 1);
+  void* aligned = arena.allocate(8, 8);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(aligned) % 8);
+  EXPECT_EQ(48, arena.bytesAllocated());
+
+  // A request not fitting in the current block starts a block twice as large.
+  arena.allocate(32);
+  EXPECT_EQ(64 + 128, arena.bytesReserved());
+  EXPECT_EQ(80, arena.bytesAllocated());
+
+  // A request larger than the next block gets a block of its own size.
+  arena.allocate(512);
+  EXPECT_EQ(64 + 128 + 512, arena.bytesReserved());
+  EXPECT_EQ(0, arena.overflows());
+}
+
+TEST(ArenaTest, InitialBlock) {
+  alignas(std::max_align_t) char block[64];
+  Arena arena(64, 1024, block);
+  EXPECT_EQ(64, arena.bytesReserved());
+
+  // The supplied block is used first.
+  EXPECT_EQ(block, arena.allocate(16));
+  EXPECT_EQ(block + 16, arena.allocate(48));
+  EXPECT_EQ(64, arena.bytesReserved());
+
+  // Once it is full, blocks are allocated as usual, starting at twice its size.
+  char* next = static_cast<char*>(arena.allocate(16));
+  EXPECT_TRUE(next < block || next >= block + sizeof(block));
+  EXPECT_EQ(64 + 128, arena.bytesReserved());
+  EXPECT_EQ(80, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, Overflow) {
+  Arena arena(64, 128);
+  EXPECT_NE(nullptr, arena.allocate(64));
+  // The next block would be 128 bytes, exceeding the limit.
+  EXPECT_EQ(nullptr, arena.allocate(1));
+  EXPECT_EQ(1, arena.overflows());
+  EXPECT_EQ(nullptr, arena.allocate(256));
+  EXPECT_EQ(2, arena.overflows());
+  EXPECT_EQ(64, arena.bytesReserved());
+}
+
+class TestObject : public ArenaAllocated {
+public:
+  TestObject(int& destroyed) : destroyed_(destroyed) {}
+  ~TestObject() { destroyed_++; }
+
+  int& destroyed_;
+  uint64_t value_{42};
+};
+
+TEST(ArenaAllocatedTest, Placement) {
+  int destroyed = 0;
+  Arena arena(256, 256);
+
+  auto in_arena = std::unique_ptr<TestObject>(new (&arena) TestObject(destroyed));
+  EXPECT_GT(arena.bytesAllocated(), 0);
+  const uint64_t allocated = arena.bytesAllocated();
+  auto on_heap = std::unique_ptr<TestObject>(new (nullptr) TestObject(destroyed));
+  auto default_new = std::make_unique<TestObject>(destroyed);
+  EXPECT_EQ(allocated, arena.bytesAllocated());
+  EXPECT_EQ(42, in_arena->value_);
+  EXPECT_EQ(42, on_heap->value_);
+
+  // Once the arena is full, instances are placed on the heap.
+  std::vector<std::unique_ptr<TestObject>> objects;
+  while (arena.overflows() == 0) {
+    objects.emplace_back(new (&arena) TestObject(destroyed));
+  }
+
+  in_arena.reset();
+  on_heap.reset();
+  default_new.reset();
+  EXPECT_EQ(3, destroyed);
+  const size_t num_objects = objects.size();
+  objects.clear();
+  EXPECT_EQ(3 + num_objects, destroyed);
+}
+
+} // namespace
+} // namespace Envoy
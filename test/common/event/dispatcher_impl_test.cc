@@ -336,6 +336,8 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_,
+              gauge("test.dispatcher.post_queue_depth", Stats::Gauge::ImportMode::NeverImport));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
@@ -375,8 +377,8 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
-    // or else this would deadlock.
+    // This also ensures that callbacks posted while callbacks are called or destroyed
+    // are run, or else this would never finish.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
 
@@ -397,6 +399,43 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
   }
 }
 
+// Callbacks posted concurrently from several threads all run, in the order of each thread.
+TEST_F(DispatcherImplTest, PostFromManyThreads) {
+  constexpr uint32_t Threads = 4;
+  constexpr uint32_t CallbacksPerThread = 10000;
+  std::vector<uint32_t> last_seen(Threads);
+  uint32_t remaining = Threads * CallbacksPerThread;
+  bool in_order = true;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t thread = 0; thread < Threads; thread++) {
+    threads.push_back(api_->threadFactory().createThread([&, thread]() {
+      for (uint32_t i = 1; i <= CallbacksPerThread; i++) {
+        dispatcher_->post([&, thread, i]() {
+          in_order &= last_seen[thread] + 1 == i;
+          last_seen[thread] = i;
+          if (--remaining == 0) {
+            {
+              Thread::LockGuard lock(mu_);
+              work_finished_ = true;
+            }
+            cv_.notifyOne();
+          }
+        });
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  EXPECT_TRUE(in_order);
+}
+
 TEST_F(DispatcherImplTest, Timer) {
   timerTest([](Timer& timer) { timer.enableTimer(std::chrono::milliseconds(0)); });
   timerTest([](Timer& timer) { timer.enableTimer(std::chrono::milliseconds(50)); });
@@ -0,0 +1,113 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/event/post_queue.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+TEST(PostQueueTest, WakesUpOnlyWhenEmpty) {
+  PostQueue queue;
+  uint32_t ran = 0;
+  EXPECT_TRUE(queue.push([&ran]() { ran++; }));
+  EXPECT_FALSE(queue.push([&ran]() { ran++; }));
+  EXPECT_EQ(2, queue.size());
+
+  EXPECT_EQ(PostQueue::BatchResult::Empty, queue.runBatch());
+  EXPECT_EQ(2, ran);
+  EXPECT_EQ(0, queue.size());
+  EXPECT_TRUE(queue.push([&ran]() { ran++; }));
+  EXPECT_EQ(PostQueue::BatchResult::Empty, queue.runBatch());
+  EXPECT_EQ(3, ran);
+}
+
+// Callbacks pushed by a running batch are left for the next batch, and don't wake up the consumer.
+TEST(PostQueueTest, BatchExcludesCallbacksPushedByIt) {
+  PostQueue queue;
+  std::vector<uint32_t> order;
+  queue.push([&]() {
+    order.push_back(1);
+    EXPECT_FALSE(queue.push([&]() { order.push_back(3); }));
+  });
+  queue.push([&]() { order.push_back(2); });
+
+  EXPECT_EQ(PostQueue::BatchResult::Queued, queue.runBatch());
+  EXPECT_EQ((std::vector<uint32_t>{1, 2}), order);
+  EXPECT_EQ(PostQueue::BatchResult::Empty, queue.runBatch());
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 3}), order);
+}
+
+TEST(PostQueueTest, DestroysPendingCallbacks) {
+  auto resource = std::make_shared<int>(0);
+  {
+    PostQueue queue;
+    queue.push([resource]() {});
+    EXPECT_EQ(2, resource.use_count());
+  }
+  EXPECT_EQ(1, resource.use_count());
+}
+
+// Callbacks are released as soon as they have run, although their nodes are reused.
+TEST(PostQueueTest, ReleasesCallbacksAfterRunning) {
+  auto resource = std::make_shared<int>(0);
+  PostQueue queue;
+  queue.push([resource]() {});
+  queue.runBatch();
+  EXPECT_EQ(1, resource.use_count());
+}
+
+// A queue destroyed by a thread local destructor which runs after the node cache of its thread has
+// been destroyed frees its nodes directly.
+TEST(PostQueueTest, DestroyedAfterThreadNodeCache) {
+  auto resource = std::make_shared<int>(0);
+  std::thread thread([resource]() {
+    struct Holder {
+      std::unique_ptr<PostQueue> queue_;
+    };
+    // Constructed before the node cache, so destroyed after it.
+    static thread_local Holder holder;
+    holder.queue_ = std::make_unique<PostQueue>();
+    holder.queue_->push([resource]() {});
+  });
+  thread.join();
+  EXPECT_EQ(1, resource.use_count());
+}
+
+TEST(PostQueueTest, ConcurrentProducers) {
+  constexpr uint32_t Threads = 4;
+  constexpr uint32_t CallbacksPerThread = 100000;
+  PostQueue queue;
+  std::vector<uint32_t> last_seen(Threads);
+  uint32_t ran = 0;
+  bool in_order = true;
+
+  std::vector<std::thread> threads;
+  for (uint32_t thread = 0; thread < Threads; thread++) {
+    threads.emplace_back([&, thread]() {
+      for (uint32_t i = 1; i <= CallbacksPerThread; i++) {
+        queue.push([&, thread, i]() {
+          in_order &= last_seen[thread] + 1 == i;
+          last_seen[thread] = i;
+          ran++;
+        });
+      }
+    });
+  }
+  while (ran < Threads * CallbacksPerThread) {
+    queue.runBatch();
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(PostQueue::BatchResult::Empty, queue.runBatch());
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(0, queue.size());
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
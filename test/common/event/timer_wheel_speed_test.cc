@@ -0,0 +1,60 @@
+// Usage: bazel run //test/common/event:timer_wheel_speed_test
+
+// Compares the libevent timers of a dispatcher with its timer wheel under the churn of connection
+// and stream timeouts: many armed timers, mostly re-enabled or disabled long before they expire.
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "common/event/dispatcher_impl.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Event {
+
+class DispatcherScheduler : public Scheduler {
+public:
+  TimerPtr createTimer(const TimerCb& cb, Dispatcher& dispatcher) override {
+    return dispatcher.createTimer(cb);
+  }
+};
+
+static void timerChurn(benchmark::State& state, bool use_wheel) {
+  const uint64_t timer_count = state.range(0);
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  DispatcherScheduler scheduler;
+  TimerWheel wheel(scheduler, api->timeSource(), *dispatcher);
+  std::mt19937_64 random(1);
+
+  std::vector<TimerPtr> timers;
+  for (uint64_t i = 0; i < timer_count; i++) {
+    timers.push_back(use_wheel ? wheel.createTimer([]() {}, *dispatcher)
+                               : dispatcher->createTimer([]() {}));
+    timers.back()->enableTimer(std::chrono::milliseconds(1000 + random() % 60000));
+  }
+
+  for (auto _ : state) {
+    Timer& timer = *timers[random() % timer_count];
+    if (random() % 4 == 0) {
+      timer.disableTimer();
+    } else {
+      timer.enableTimer(std::chrono::milliseconds(1000 + random() % 60000));
+    }
+  }
+  timers.clear();
+}
+
+static void timerChurnLibevent(benchmark::State& state) { timerChurn(state, false); }
+BENCHMARK(timerChurnLibevent)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+static void timerChurnWheel(benchmark::State& state) { timerChurn(state, true); }
+BENCHMARK(timerChurnWheel)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,238 @@
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "common/api/api_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+// Drives the wheel with the timers of the dispatcher, which run on simulated time.
+class DispatcherScheduler : public Scheduler {
+public:
+  TimerPtr createTimer(const TimerCb& cb, Dispatcher& dispatcher) override {
+    return dispatcher.createTimer(cb);
+  }
+};
+
+class TimerWheelTest : public testing::Test {
+protected:
+  template <class Duration> void advance(Duration duration) {
+    time_system_.advanceTimeAndRun(duration, *dispatcher_, Dispatcher::RunType::NonBlock);
+  }
+
+  // Creates a timer recording the simulated time it fires at.
+  TimerPtr createTimer(std::vector<MonotonicTime>& fired) {
+    return wheel_.createTimer([this, &fired]() { fired.push_back(time_system_.monotonicTime()); },
+                              *dispatcher_);
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_{Api::createApiForTest(time_system_)};
+  DispatcherPtr dispatcher_{api_->allocateDispatcher("test_thread")};
+  DispatcherScheduler scheduler_;
+  TimerWheel wheel_{scheduler_, time_system_, *dispatcher_};
+};
+
+TEST_F(TimerWheelTest, EnableAndDisable) {
+  std::vector<MonotonicTime> fired;
+  TimerPtr timer = createTimer(fired);
+  EXPECT_FALSE(timer->enabled());
+
+  timer->enableTimer(std::chrono::milliseconds(10));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_EQ(1, wheel_.size());
+  advance(std::chrono::milliseconds(9));
+  EXPECT_TRUE(fired.empty());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_EQ(1, fired.size());
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0, wheel_.size());
+
+  timer->enableTimer(std::chrono::milliseconds(10));
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0, wheel_.size());
+  advance(std::chrono::milliseconds(20));
+  EXPECT_EQ(1, fired.size());
+
+  // Enabling an armed timer moves its expiry.
+  timer->enableTimer(std::chrono::milliseconds(10));
+  advance(std::chrono::milliseconds(5));
+  timer->enableTimer(std::chrono::milliseconds(10));
+  advance(std::chrono::milliseconds(9));
+  EXPECT_EQ(1, fired.size());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_EQ(2, fired.size());
+
+  // Destroying an armed timer takes it off the wheel.
+  timer->enableTimer(std::chrono::milliseconds(10));
+  timer.reset();
+  EXPECT_EQ(0, wheel_.size());
+  advance(std::chrono::milliseconds(20));
+  EXPECT_EQ(2, fired.size());
+}
+
+// Timers expiring beyond the innermost level are cascaded and still fire on time.
+TEST_F(TimerWheelTest, OuterLevels) {
+  const MonotonicTime start = time_system_.monotonicTime();
+  const std::vector<std::chrono::milliseconds> durations = {
+      std::chrono::milliseconds(300), std::chrono::seconds(20), std::chrono::hours(2),
+      std::chrono::hours(24 * 60)};
+  std::vector<std::vector<MonotonicTime>> fired(durations.size());
+  std::vector<TimerPtr> timers;
+  for (size_t i = 0; i < durations.size(); i++) {
+    timers.push_back(createTimer(fired[i]));
+    timers.back()->enableTimer(durations[i]);
+  }
+
+  std::chrono::milliseconds elapsed(0);
+  for (size_t i = 0; i < durations.size(); i++) {
+    advance(durations[i] - std::chrono::milliseconds(1) - elapsed);
+    EXPECT_TRUE(fired[i].empty()) << i;
+    advance(std::chrono::milliseconds(1));
+    elapsed = durations[i];
+    ASSERT_EQ(1, fired[i].size()) << i;
+    EXPECT_EQ(start + durations[i], fired[i][0]) << i;
+  }
+  EXPECT_EQ(0, wheel_.size());
+}
+
+// Zero duration and high resolution timers are handed to the underlying scheduler.
+TEST_F(TimerWheelTest, PreciseTimers) {
+  std::vector<MonotonicTime> fired;
+  TimerPtr timer = createTimer(fired);
+  timer->enableTimer(std::chrono::milliseconds(0));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_EQ(0, wheel_.size());
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, fired.size());
+  EXPECT_FALSE(timer->enabled());
+
+  const MonotonicTime start = time_system_.monotonicTime();
+  timer->enableHRTimer(std::chrono::microseconds(500));
+  EXPECT_EQ(0, wheel_.size());
+  advance(std::chrono::microseconds(499));
+  EXPECT_EQ(1, fired.size());
+  advance(std::chrono::microseconds(1));
+  ASSERT_EQ(2, fired.size());
+  EXPECT_EQ(start + std::chrono::microseconds(500), fired[1]);
+
+  // Switching back to the wheel disables the precise timer.
+  timer->enableHRTimer(std::chrono::microseconds(500));
+  timer->enableTimer(std::chrono::milliseconds(2));
+  advance(std::chrono::milliseconds(1));
+  EXPECT_EQ(2, fired.size());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_EQ(3, fired.size());
+}
+
+// Callbacks may disable, destroy and enable the timers expiring in the same tick.
+TEST_F(TimerWheelTest, CallbacksChangeTimersOfTheSameTick) {
+  uint32_t first_fired = 0;
+  uint32_t second_fired = 0;
+  TimerPtr second;
+  TimerPtr third;
+  TimerPtr first = wheel_.createTimer(
+      [&]() {
+        first_fired++;
+        second->disableTimer();
+        third.reset();
+        first->enableTimer(std::chrono::milliseconds(1));
+      },
+      *dispatcher_);
+  second = wheel_.createTimer([&]() { second_fired++; }, *dispatcher_);
+  third = wheel_.createTimer([]() { FAIL(); }, *dispatcher_);
+  first->enableTimer(std::chrono::milliseconds(5));
+  second->enableTimer(std::chrono::milliseconds(5));
+  third->enableTimer(std::chrono::milliseconds(5));
+
+  advance(std::chrono::milliseconds(5));
+  EXPECT_EQ(1, first_fired);
+  EXPECT_EQ(0, second_fired);
+  EXPECT_TRUE(first->enabled());
+  EXPECT_EQ(1, wheel_.size());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_EQ(2, first_fired);
+  first->disableTimer();
+}
+
+// Timers are armed, moved and disabled at random, and must fire at the first step of time which
+// reaches their deadline.
+TEST_F(TimerWheelTest, Random) {
+  constexpr uint32_t Timers = 1000;
+  std::mt19937_64 random(1);
+  std::vector<MonotonicTime> deadlines(Timers);
+  std::vector<TimerPtr> timers;
+  for (uint32_t i = 0; i < Timers; i++) {
+    timers.push_back(wheel_.createTimer(
+        [this, i, &deadlines]() { EXPECT_LE(deadlines[i], time_system_.monotonicTime()); },
+        *dispatcher_));
+  }
+
+  for (uint32_t step = 0; step < 2000; step++) {
+    for (uint32_t change = 0; change < 20; change++) {
+      const uint32_t i = random() % Timers;
+      if (random() % 4 == 0) {
+        timers[i]->disableTimer();
+        continue;
+      }
+      // Mostly short durations, with some spanning the outer levels.
+      const std::chrono::milliseconds duration(random() % 8 == 0 ? random() % 100000
+                                                                 : random() % 1000 + 1);
+      if (duration.count() == 0) {
+        continue;
+      }
+      timers[i]->enableTimer(duration);
+      deadlines[i] = time_system_.monotonicTime() + duration;
+    }
+
+    advance(std::chrono::milliseconds(random() % 200 + 1));
+    const MonotonicTime now = time_system_.monotonicTime();
+    for (uint32_t i = 0; i < Timers; i++) {
+      if (timers[i]->enabled()) {
+        EXPECT_GT(deadlines[i], now) << i;
+      }
+    }
+  }
+  uint64_t armed = 0;
+  for (const TimerPtr& timer : timers) {
+    armed += timer->enabled();
+  }
+  EXPECT_EQ(armed, wheel_.size());
+}
+
+TEST(TimerWheelDispatcherTest, EnabledByRuntime) {
+  TestScopedRuntime scoped_runtime;
+  Api::ApiPtr api = Api::createApiForTest();
+  {
+    DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+    EXPECT_EQ(nullptr, dynamic_cast<WheelTimerImpl*>(dispatcher->createTimer([]() {}).get()));
+  }
+
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.dispatcher_timer_wheel", "true"}});
+  DispatcherPtr dispatcher = api->allocateDispatcher("test_thread");
+  bool fired = false;
+  TimerPtr timer = dispatcher->createTimer([&fired, &dispatcher]() {
+    fired = true;
+    dispatcher->exit();
+  });
+  EXPECT_NE(nullptr, dynamic_cast<WheelTimerImpl*>(timer.get()));
+  timer->enableTimer(std::chrono::milliseconds(1));
+  dispatcher->run(Dispatcher::RunType::Block);
+  EXPECT_TRUE(fired);
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
@@ -1,4 +1,5 @@
 #include "common/http/header_map_impl.h"
+#include "common/memory/stats.h"
 
 #include "benchmark/benchmark.h"
 
@@ -141,7 +142,7 @@ static void headerMapImplIterate(benchmark::State& state) {
   }
   benchmark::DoNotOptimize(num_callbacks);
 }
-BENCHMARK(headerMapImplIterate)->Arg(0)->Arg(1)->Arg(10)->Arg(50);
+BENCHMARK(headerMapImplIterate)->Arg(0)->Arg(1)->Arg(10)->Arg(50)->Arg(200);
 
 /**
  * Measure the speed of removing a header by key name.
@@ -207,5 +208,81 @@ static void headerMapImplPopulate(benchmark::State& state) {
 }
 BENCHMARK(headerMapImplPopulate);
 
+/** Measure the speed of reverse iteration with a lightweight callback. */
+static void headerMapImplIterateReverse(benchmark::State& state) {
+  auto headers = Http::ResponseHeaderMapImpl::create();
+  size_t num_callbacks = 0;
+  addDummyHeaders(*headers, state.range(0));
+  auto counting_callback = [&num_callbacks](const HeaderEntry&) -> HeaderMap::Iterate {
+    num_callbacks++;
+    return HeaderMap::Iterate::Continue;
+  };
+  for (auto _ : state) { // NOLINT
+    headers->iterateReverse(counting_callback);
+  }
+  benchmark::DoNotOptimize(num_callbacks);
+}
+BENCHMARK(headerMapImplIterateReverse)->Arg(10)->Arg(50)->Arg(200);
+
+/**
+ * Measure the speed of creating a HeaderMapImpl with a large number of headers, as e.g. requests
+ * carrying many cookies or tracing headers. The memory_per_map counter is the heap memory held by
+ * one such map, which is only reported when built with tcmalloc.
+ */
+static void headerMapImplAddMany(benchmark::State& state) {
+  const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+  {
+    auto headers = Http::ResponseHeaderMapImpl::create();
+    addDummyHeaders(*headers, state.range(0));
+    state.counters["memory_per_map"] = Memory::Stats::totalCurrentlyAllocated() - start_mem;
+  }
+  for (auto _ : state) { // NOLINT
+    auto headers = Http::ResponseHeaderMapImpl::create();
+    addDummyHeaders(*headers, state.range(0));
+    benchmark::DoNotOptimize(headers->size());
+  }
+}
+BENCHMARK(headerMapImplAddMany)->Arg(0)->Arg(1)->Arg(10)->Arg(50)->Arg(200);
+
+/**
+ * Measure the speed of copying a HeaderMapImpl, as done e.g. when retrying or mirroring a request.
+ */
+static void headerMapImplCopy(benchmark::State& state) {
+  auto headers = Http::RequestHeaderMapImpl::create();
+  headers->setReferenceMethod("GET");
+  headers->setReferencePath("/");
+  headers->setReferenceHost("example.com");
+  addDummyHeaders(*headers, state.range(0));
+  for (auto _ : state) { // NOLINT
+    auto copy = createHeaderMap<RequestHeaderMapImpl>(*headers);
+    benchmark::DoNotOptimize(copy->size());
+  }
+}
+BENCHMARK(headerMapImplCopy)->Arg(10)->Arg(50)->Arg(200);
+
+/**
+ * Measure the speed of removing headers from the middle of a large HeaderMapImpl and adding them
+ * back, as filters rewriting headers do.
+ */
+static void headerMapImplRemoveAddChurn(benchmark::State& state) {
+  auto headers = Http::ResponseHeaderMapImpl::create();
+  addDummyHeaders(*headers, state.range(0));
+  const std::string prefix("dummy-key-");
+  std::vector<LowerCaseString> keys;
+  for (int64_t i = 0; i < state.range(0); i += 4) {
+    keys.emplace_back(prefix + std::to_string(i));
+  }
+  for (auto _ : state) { // NOLINT
+    for (const LowerCaseString& key : keys) {
+      headers->remove(key);
+    }
+    for (const LowerCaseString& key : keys) {
+      headers->addReference(key, "abcd");
+    }
+  }
+  benchmark::DoNotOptimize(headers->size());
+}
+BENCHMARK(headerMapImplRemoveAddChurn)->Arg(10)->Arg(50)->Arg(200);
+
 } // namespace Http
 } // namespace Envoy
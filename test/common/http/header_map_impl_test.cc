@@ -1177,6 +1177,58 @@ TEST(HeaderMapImplTest, TestRequestHeaderMapImplyCopy) {
   EXPECT_EQ("bar", baz.get(LowerCaseString("foo"))->value().getStringView());
 }
 
+// Validate ordering, inline header pointers and byte size across many removals and additions,
+// which reuse the storage of removed headers and compact the header order.
+TEST(HeaderMapImplTest, ManyHeadersRemoveAndAdd) {
+  TestRequestHeaderMapImpl headers;
+  headers.setContentType("text/plain");
+  const HeaderEntry* content_type = headers.ContentType();
+  for (size_t i = 0; i < 100; i++) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), absl::StrCat(i));
+  }
+  headers.setPath("/");
+
+  // Remove every header with an odd index, then add some back.
+  for (size_t i = 1; i < 100; i += 2) {
+    EXPECT_EQ(1UL, headers.remove(LowerCaseString(absl::StrCat("x-header-", i))));
+  }
+  for (size_t i = 1; i < 10; i += 2) {
+    headers.addCopy(LowerCaseString(absl::StrCat("x-header-", i)), absl::StrCat(i));
+  }
+  headers.setMethod("GET");
+  EXPECT_EQ(58UL, headers.size());
+  EXPECT_EQ(content_type, headers.ContentType());
+  EXPECT_EQ("text/plain", headers.getContentTypeValue());
+  headers.verifyByteSizeInternalForTest();
+
+  std::vector<std::string> expected{":path", ":method", "content-type"};
+  for (size_t i = 0; i < 100; i += 2) {
+    expected.push_back(absl::StrCat("x-header-", i));
+  }
+  for (size_t i = 1; i < 10; i += 2) {
+    expected.push_back(absl::StrCat("x-header-", i));
+  }
+  std::vector<std::string> keys;
+  headers.iterate([&keys](const HeaderEntry& header) -> HeaderMap::Iterate {
+    keys.emplace_back(header.key().getStringView());
+    return HeaderMap::Iterate::Continue;
+  });
+  EXPECT_EQ(expected, keys);
+
+  std::vector<std::string> reversed_keys;
+  headers.iterateReverse([&reversed_keys](const HeaderEntry& header) -> HeaderMap::Iterate {
+    reversed_keys.emplace_back(header.key().getStringView());
+    return HeaderMap::Iterate::Continue;
+  });
+  std::reverse(reversed_keys.begin(), reversed_keys.end());
+  EXPECT_EQ(expected, reversed_keys);
+
+  EXPECT_EQ(55UL, headers.removePrefix(LowerCaseString("x-header-")));
+  EXPECT_EQ(3UL, headers.size());
+  EXPECT_EQ(content_type, headers.ContentType());
+  headers.verifyByteSizeInternalForTest();
+}
+
 // Make sure 'host' -> ':authority' auto translation only occurs for request headers.
 TEST(HeaderMapImplTest, HostHeader) {
   TestRequestHeaderMapImpl request_headers{{"host", "foo"}};
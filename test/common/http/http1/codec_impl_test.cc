@@ -1152,6 +1152,34 @@ TEST_P(Http1ServerConnectionImplTest, HeaderInvalidCharsRejection) {
   EXPECT_EQ("http1.invalid_characters", response_encoder->getStream().responseDetails());
 }
 
+// Header values longer than the blocks scanned with SIMD instructions are accepted and rejected the
+// same as shorter ones.
+TEST_P(Http1ServerConnectionImplTest, LongHeaderValueInvalidCharsRejection) {
+  initialize();
+
+  const std::string value = absl::StrCat(std::string(20, 'a'), "\t", std::string(20, 'b'));
+  TestRequestHeaderMapImpl expected_headers{
+      {":authority", "h.com"}, {":path", "/"}, {":method", "GET"}, {"foo", value}};
+  sendAndValidateRequestAndSendResponse(
+      absl::StrCat("GET / HTTP/1.1\r\nHOST: h.com\r\nfoo: ", value, "\r\n\r\n"),
+      expected_headers);
+
+  MockRequestDecoder decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  Buffer::OwnedImpl buffer(absl::StrCat("GET / HTTP/1.1\r\nHOST: h.com\r\nfoo: ",
+                                        std::string(35, 'a'), std::string(1, 3), "\r\n"));
+  EXPECT_CALL(decoder, sendLocalReply(_, _, _, _, _, _));
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(isCodecProtocolError(status));
+  EXPECT_EQ(status.message(), "http/1.1 protocol error: header value contains invalid chars");
+  EXPECT_EQ("http1.invalid_characters", response_encoder->getStream().responseDetails());
+}
+
 // Ensures that request headers with names containing the underscore character are allowed
 // when the option is set to allow.
 TEST_P(Http1ServerConnectionImplTest, HeaderNameWithUnderscoreAllowed) {
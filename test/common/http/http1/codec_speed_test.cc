@@ -0,0 +1,109 @@
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/header_utility.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/http/http1/header_scanner.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+namespace {
+
+// A header value as long as a typical cookie or user agent.
+const std::string& headerValue() {
+  CONSTRUCT_ON_FIRST_USE(std::string,
+                         "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+                         "Chrome/85.0.4183.102 Safari/537.36");
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ValidateHeaderValueHeaderUtility(::benchmark::State& state) {
+  const std::string& value = headerValue();
+  for (auto _ : state) { // NOLINT
+    ::benchmark::DoNotOptimize(HeaderUtility::headerValueIsValid(value));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(BM_ValidateHeaderValueHeaderUtility);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ValidateHeaderValueScanner(::benchmark::State& state) {
+  const auto implementation = static_cast<HeaderScanner::Implementation>(state.range(0));
+  if (!HeaderScanner::supported(implementation)) {
+    state.SkipWithError("implementation not supported by the CPU");
+    return;
+  }
+  const std::string& value = headerValue();
+  for (auto _ : state) { // NOLINT
+    ::benchmark::DoNotOptimize(HeaderScanner::findInvalidValueChar(value, implementation));
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(BM_ValidateHeaderValueScanner)
+    ->Arg(static_cast<int>(HeaderScanner::Implementation::Scalar))
+    ->Arg(static_cast<int>(HeaderScanner::Implementation::Sse42))
+    ->Arg(static_cast<int>(HeaderScanner::Implementation::Avx2));
+
+// Measures the throughput of the server codec parsing requests with the given number of headers.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ServerCodecDispatch(::benchmark::State& state) {
+  const int64_t num_headers = state.range(0);
+  const Http1Settings settings;
+
+  std::string request = "GET /some/path?with=query HTTP/1.1\r\nhost: example.com\r\n";
+  for (int64_t i = 0; i < num_headers; i++) {
+    absl::StrAppend(&request, "x-header-", i, ": ", headerValue(), "\r\n");
+  }
+  absl::StrAppend(&request, "\r\n");
+
+  Stats::IsolatedStoreImpl store;
+  CodecStats::AtomicPtr stats;
+  NiceMock<Network::MockConnection> connection;
+  ON_CALL(connection, write(testing::_, testing::_))
+      .WillByDefault(Invoke([](Buffer::Instance& data, bool) { data.drain(data.length()); }));
+  NiceMock<MockServerConnectionCallbacks> callbacks;
+  NiceMock<MockRequestDecoder> decoder;
+  ResponseEncoder* response_encoder = nullptr;
+  ON_CALL(callbacks, newStream(testing::_, testing::_))
+      .WillByDefault(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  ServerConnectionImpl codec(connection, CodecStats::atomicGet(stats, store), callbacks, settings,
+                             Http::DEFAULT_MAX_REQUEST_HEADERS_KB, num_headers + 10,
+                             envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+  const TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+
+  for (auto _ : state) { // NOLINT
+    Buffer::OwnedImpl buffer(request);
+    const Http::Status status = codec.dispatch(buffer);
+    if (!status.ok()) {
+      state.SkipWithError("request was rejected");
+      return;
+    }
+    // Complete the response so that the connection accepts the next request.
+    response_encoder->encodeHeaders(response_headers, true);
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK(BM_ServerCodecDispatch)->Arg(10)->Arg(50);
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,71 @@
+#include <string>
+#include <vector>
+
+#include "common/http/header_utility.h"
+#include "common/http/http1/header_scanner.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+std::vector<HeaderScanner::Implementation> supportedImplementations() {
+  std::vector<HeaderScanner::Implementation> implementations;
+  for (const auto implementation :
+       {HeaderScanner::Implementation::Scalar, HeaderScanner::Implementation::Sse42,
+        HeaderScanner::Implementation::Avx2}) {
+    if (HeaderScanner::supported(implementation)) {
+      implementations.push_back(implementation);
+    }
+  }
+  return implementations;
+}
+
+TEST(HeaderScannerTest, ScalarIsAlwaysSupported) {
+  EXPECT_TRUE(HeaderScanner::supported(HeaderScanner::Implementation::Scalar));
+  EXPECT_TRUE(HeaderScanner::supported(HeaderScanner::bestImplementation()));
+}
+
+TEST(HeaderScannerTest, Empty) {
+  for (const auto implementation : supportedImplementations()) {
+    EXPECT_EQ(absl::string_view::npos, HeaderScanner::findInvalidValueChar("", implementation));
+  }
+  EXPECT_TRUE(HeaderScanner::valueIsValid(""));
+}
+
+// Every character is classified as by HeaderUtility::headerValueIsValid(), at every position of
+// values spanning several 16 and 32 byte blocks.
+TEST(HeaderScannerTest, SameAsHeaderUtility) {
+  for (const auto implementation : supportedImplementations()) {
+    for (size_t length : {1, 15, 16, 17, 31, 32, 33, 70}) {
+      for (size_t position = 0; position < length; position++) {
+        for (int c = 0; c < 256; c++) {
+          std::string value(length, 'a');
+          value[position] = static_cast<char>(c);
+          const bool valid = HeaderUtility::headerValueIsValid(value);
+          EXPECT_EQ(valid ? absl::string_view::npos : position,
+                    HeaderScanner::findInvalidValueChar(value, implementation))
+              << "implementation " << static_cast<int>(implementation) << " length " << length
+              << " position " << position << " character " << c;
+        }
+      }
+    }
+  }
+}
+
+TEST(HeaderScannerTest, FirstInvalidChar) {
+  const std::string value = absl::StrCat(std::string(40, 'a'), "\x7f", std::string(10, 'b'), "\n");
+  for (const auto implementation : supportedImplementations()) {
+    EXPECT_EQ(40, HeaderScanner::findInvalidValueChar(value, implementation));
+  }
+  EXPECT_FALSE(HeaderScanner::valueIsValid(value));
+  EXPECT_TRUE(HeaderScanner::valueIsValid("text/html; charset=\"utf-8\"\t\x80\xff"));
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
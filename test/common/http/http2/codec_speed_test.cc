@@ -0,0 +1,143 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http2/codec_impl.h"
+#include "common/http/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+namespace {
+
+// A client and a server codec connected to each other. The bytes written by one side are only
+// dispatched to the other side by transfer(), so that encoding and decoding can be timed
+// separately.
+class CodecPair {
+public:
+  CodecPair()
+      : http2_options_(::Envoy::Http2::Utility::initializeAndValidateOptions(
+            envoy::config::core::v3::Http2ProtocolOptions())) {
+    ON_CALL(client_connection_, write(testing::_, testing::_))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { to_server_.move(data); }));
+    ON_CALL(server_connection_, write(testing::_, testing::_))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { to_client_.move(data); }));
+    ON_CALL(server_callbacks_, newStream(testing::_, testing::_))
+        .WillByDefault(Invoke([this](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoder_ = &encoder;
+          return request_decoder_;
+        }));
+    client_ = std::make_unique<ClientConnectionImpl>(
+        client_connection_, client_callbacks_, CodecStats::atomicGet(client_stats_, store_),
+        http2_options_, Http::DEFAULT_MAX_REQUEST_HEADERS_KB, Http::DEFAULT_MAX_HEADERS_COUNT,
+        ProdNghttp2SessionFactory::get());
+    server_ = std::make_unique<ServerConnectionImpl>(
+        server_connection_, server_callbacks_, CodecStats::atomicGet(server_stats_, store_),
+        http2_options_, Http::DEFAULT_MAX_REQUEST_HEADERS_KB, Http::DEFAULT_MAX_HEADERS_COUNT,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+  }
+
+  // Dispatches the bytes written so far by each side to the other side.
+  bool transfer() {
+    while (to_server_.length() > 0 || to_client_.length() > 0) {
+      if (!server_->dispatch(to_server_).ok() || !client_->dispatch(to_client_).ok()) {
+        return false;
+      }
+    }
+    // Destroys the closed streams.
+    client_connection_.dispatcher_.clearDeferredDeleteList();
+    server_connection_.dispatcher_.clearDeferredDeleteList();
+    return true;
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  CodecStats::AtomicPtr client_stats_;
+  CodecStats::AtomicPtr server_stats_;
+  const envoy::config::core::v3::Http2ProtocolOptions http2_options_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<Network::MockConnection> server_connection_;
+  NiceMock<MockConnectionCallbacks> client_callbacks_;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks_;
+  NiceMock<MockResponseDecoder> response_decoder_;
+  NiceMock<MockRequestDecoder> request_decoder_;
+  Buffer::OwnedImpl to_server_;
+  Buffer::OwnedImpl to_client_;
+  std::unique_ptr<ClientConnectionImpl> client_;
+  std::unique_ptr<ServerConnectionImpl> server_;
+  ResponseEncoder* response_encoder_{};
+};
+
+} // namespace
+
+// Measures the cost of encoding a HEADERS frame for a response with the headers added by the
+// connection manager and router, plus the given number of custom headers. With a non-zero second
+// argument, the header names and values are references, which nghttp2 does not copy.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_EncodeResponseHeaders(::benchmark::State& state) {
+  const int64_t num_headers = state.range(0);
+  const bool by_reference = state.range(1) != 0;
+
+  std::vector<LowerCaseString> names;
+  for (int64_t i = 0; i < num_headers; i++) {
+    names.emplace_back(absl::StrCat("x-custom-header-", i));
+  }
+  const std::string value = "some-header-value-which-is-constant";
+  auto response_headers = ResponseHeaderMapImpl::create();
+  response_headers->setReferenceStatus("200");
+  response_headers->setReferenceServer("envoy");
+  response_headers->setReferenceContentType(Headers::get().ContentTypeValues.Json);
+  response_headers->setEnvoyUpstreamServiceTime(3);
+  for (const LowerCaseString& name : names) {
+    if (by_reference) {
+      response_headers->addReference(name, value);
+    } else {
+      response_headers->addCopy(name, value);
+    }
+  }
+  const TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"}, {":path", "/"}, {":scheme", "http"}, {":authority", "host"}};
+
+  CodecPair codecs;
+  for (auto _ : state) { // NOLINT
+    state.PauseTiming();
+    codecs.client_->newStream(codecs.response_decoder_).encodeHeaders(request_headers, true);
+    if (!codecs.transfer()) {
+      state.SkipWithError("request was rejected");
+      return;
+    }
+    state.ResumeTiming();
+
+    codecs.response_encoder_->encodeHeaders(*response_headers, true);
+
+    state.PauseTiming();
+    if (!codecs.transfer()) {
+      state.SkipWithError("response was rejected");
+      return;
+    }
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_EncodeResponseHeaders)
+    ->Args({0, 0})
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({50, 0})
+    ->Args({50, 1});
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#include "common/network/connection_balancer_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/common.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class MockBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  MOCK_METHOD(uint64_t, numConnections, (), (const));
+  MOCK_METHOD(void, incNumConnections, ());
+  MOCK_METHOD(void, post, (Network::ConnectionSocketPtr && socket));
+  MOCK_METHOD(uint64_t, loadScore, (), (const));
+  MOCK_METHOD(void, enableLoadTracking, ());
+};
+
+class LoadAwareConnectionBalancerImplTest : public testing::Test {
+public:
+  LoadAwareConnectionBalancerImplTest() : balancer_(stats_store_, random_) {
+    EXPECT_CALL(handler1_, enableLoadTracking());
+    EXPECT_CALL(handler2_, enableLoadTracking());
+    balancer_.registerHandler(handler1_);
+    balancer_.registerHandler(handler2_);
+  }
+
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  LoadAwareConnectionBalancerImpl balancer_;
+  NiceMock<MockBalancedConnectionHandler> handler1_;
+  NiceMock<MockBalancedConnectionHandler> handler2_;
+};
+
+// A connection moves to the random candidate only when it is less loaded.
+TEST_F(LoadAwareConnectionBalancerImplTest, PicksLessLoadedHandler) {
+  ON_CALL(handler1_, loadScore()).WillByDefault(Return(200));
+  ON_CALL(handler2_, loadScore()).WillByDefault(Return(100));
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_CALL(handler2_, incNumConnections());
+  EXPECT_EQ(&handler2_, &balancer_.pickTargetHandler(handler1_));
+  EXPECT_EQ(1UL, balancer_.stats().rebalanced_.value());
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(0));
+  EXPECT_CALL(handler2_, incNumConnections());
+  EXPECT_EQ(&handler2_, &balancer_.pickTargetHandler(handler2_));
+  EXPECT_EQ(1UL, balancer_.stats().rebalanced_.value());
+}
+
+// Equal scores keep the connection on the accepting handler.
+TEST_F(LoadAwareConnectionBalancerImplTest, StaysOnTie) {
+  ON_CALL(handler1_, loadScore()).WillByDefault(Return(100));
+  ON_CALL(handler2_, loadScore()).WillByDefault(Return(100));
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_CALL(handler1_, incNumConnections());
+  EXPECT_EQ(&handler1_, &balancer_.pickTargetHandler(handler1_));
+  EXPECT_EQ(0UL, balancer_.stats().rebalanced_.value());
+}
+
+// A single registered handler always keeps its connections.
+TEST_F(LoadAwareConnectionBalancerImplTest, SingleHandler) {
+  balancer_.unregisterHandler(handler2_);
+
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_CALL(handler1_, incNumConnections());
+  EXPECT_EQ(&handler1_, &balancer_.pickTargetHandler(handler1_));
+}
+
+// The imbalance gauges are refreshed periodically from all handler scores.
+TEST_F(LoadAwareConnectionBalancerImplTest, ImbalanceStats) {
+  ON_CALL(handler1_, loadScore()).WillByDefault(Return(400));
+  ON_CALL(handler2_, loadScore()).WillByDefault(Return(100));
+  ON_CALL(random_, random()).WillByDefault(Return(0));
+
+  for (uint32_t i = 0; i < 63; ++i) {
+    balancer_.pickTargetHandler(handler1_);
+  }
+  EXPECT_EQ(0UL, balancer_.stats().max_load_score_.value());
+
+  balancer_.pickTargetHandler(handler1_);
+  EXPECT_EQ(400UL, balancer_.stats().max_load_score_.value());
+  EXPECT_EQ(100UL, balancer_.stats().min_load_score_.value());
+  EXPECT_EQ(75UL, balancer_.stats().load_imbalance_percent_.value());
+  EXPECT_EQ(0UL, TestUtility::findCounter(stats_store_, "connection_balance.rebalanced")->value());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
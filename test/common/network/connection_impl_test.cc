@@ -13,11 +13,13 @@
 #include "common/network/connection_impl.h"
 #include "common/network/io_socket_handle_impl.h"
 #include "common/network/listen_socket_impl.h"
+#include "common/network/raw_buffer_socket.h"
 #include "common/network/utility.h"
 #include "common/runtime/runtime_impl.h"
 
 #include "test/mocks/buffer/mocks.h"
 #include "test/mocks/event/mocks.h"
+#include "test/mocks/network/io_handle.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/test_common/environment.h"
@@ -37,6 +39,7 @@ using testing::InSequence;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
 using testing::Return;
+using testing::ReturnRef;
 using testing::SaveArg;
 using testing::Sequence;
 using testing::StrictMock;
@@ -52,6 +55,58 @@ TEST(RawBufferSocket, TestBasics) {
   EXPECT_EQ("", raw_buffer_socket->protocol());
 }
 
+// Reads which fill the read size grow it, by the data the socket reports as available if it can,
+// and runs of reads using less than half of it shrink it, within bounds.
+TEST(RawBufferSocket, AdaptsReadSize) {
+  NiceMock<MockTransportSocketCallbacks> callbacks;
+  NiceMock<MockIoHandle> io_handle;
+  ON_CALL(callbacks, ioHandle()).WillByDefault(ReturnRef(io_handle));
+  RawBufferSocket socket;
+  socket.setTransportSocketCallbacks(callbacks);
+  Buffer::OwnedImpl buffer;
+
+  const auto read = [&](uint64_t bytes, absl::optional<uint64_t> available = absl::nullopt) {
+    EXPECT_CALL(io_handle, readv(_, _, _))
+        .WillOnce(Invoke([&, bytes](uint64_t max_length, Buffer::RawSlice*, uint64_t) {
+          EXPECT_EQ(socket.readSize(), max_length);
+          return Api::IoCallUint64Result(
+              bytes, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+        }))
+        .WillOnce(Invoke([](uint64_t, Buffer::RawSlice*, uint64_t) {
+          return Api::IoCallUint64Result(
+              0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                                 IoSocketError::deleteIoError));
+        }));
+    ON_CALL(io_handle, bytesAvailable()).WillByDefault(Return(available));
+    IoResult result = socket.doRead(buffer);
+    EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+    EXPECT_EQ(bytes, result.bytes_processed_);
+    buffer.drain(buffer.length());
+  };
+
+  EXPECT_EQ(RawBufferSocket::InitialReadSize, socket.readSize());
+  read(RawBufferSocket::InitialReadSize, 40000);
+  EXPECT_EQ(RawBufferSocket::MaxReadSize, socket.readSize());
+  read(RawBufferSocket::MaxReadSize, 1024 * 1024);
+  EXPECT_EQ(RawBufferSocket::MaxReadSize, socket.readSize());
+
+  for (uint32_t i = 1; i < AdaptiveReadSize::ShortReadsBeforeShrink; i++) {
+    read(100);
+  }
+  EXPECT_EQ(RawBufferSocket::MaxReadSize, socket.readSize());
+  read(100);
+  EXPECT_EQ(RawBufferSocket::MaxReadSize / 2, socket.readSize());
+
+  // Without a hint, the read size doubles.
+  read(RawBufferSocket::MaxReadSize / 2);
+  EXPECT_EQ(RawBufferSocket::MaxReadSize, socket.readSize());
+
+  for (uint32_t i = 0; i < 10 * AdaptiveReadSize::ShortReadsBeforeShrink; i++) {
+    read(1);
+  }
+  EXPECT_EQ(RawBufferSocket::MinReadSize, socket.readSize());
+}
+
 TEST(ConnectionImplUtility, updateBufferStats) {
   StrictMock<Stats::MockCounter> counter;
   StrictMock<Stats::MockGauge> gauge;
@@ -2318,9 +2373,8 @@ TEST_P(ReadBufferLimitTest, NoLimit) { readBufferLimitTest(0, 256 * 1024); }
 TEST_P(ReadBufferLimitTest, SomeLimit) {
   const uint32_t read_buffer_limit = 32 * 1024;
   // Envoy has soft limits, so as long as the first read is <= read_buffer_limit - 1 it will do a
-  // second read. The effective chunk size is then read_buffer_limit - 1 + MaxReadSize,
-  // which is currently 16384.
-  readBufferLimitTest(read_buffer_limit, read_buffer_limit - 1 + 16384);
+  // second read. The effective chunk size is then at most read_buffer_limit - 1 + MaxReadSize.
+  readBufferLimitTest(read_buffer_limit, read_buffer_limit - 1 + RawBufferSocket::MaxReadSize);
 }
 
 class TcpClientConnectionImplTest : public testing::TestWithParam<Address::IpVersion> {
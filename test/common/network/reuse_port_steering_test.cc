@@ -0,0 +1,122 @@
+#include "common/network/listen_socket_impl.h"
+#include "common/network/reuse_port_steering.h"
+#include "common/network/socket_option_factory.h"
+#include "common/network/utility.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/network_utility.h"
+
+#include "gtest/gtest.h"
+
+#ifdef __linux__
+#include <linux/filter.h>
+#endif
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+#ifdef __linux__
+// Pinned sockets get a comparison against their CPU, all other CPUs fall through to a modulo.
+TEST(ReusePortCpuSteeringTest, Program) {
+  ReusePortCpuSteering steering;
+  auto address = Utility::parseInternetAddress("127.0.0.1", 0);
+  TcpListenSocket socket(address, nullptr, false);
+  steering.addSocket(socket, 3);
+  steering.addSocket(socket, absl::nullopt);
+  steering.addSocket(socket, 5);
+
+  const std::vector<ReusePortCpuSteering::Instruction> program = steering.program();
+  ASSERT_EQ(7U, program.size());
+  EXPECT_EQ(BPF_LD | BPF_W | BPF_ABS, program[0].code);
+  EXPECT_EQ(static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU), program[0].k);
+  EXPECT_EQ(BPF_JMP | BPF_JEQ | BPF_K, program[1].code);
+  EXPECT_EQ(3U, program[1].k);
+  EXPECT_EQ(BPF_RET | BPF_K, program[2].code);
+  EXPECT_EQ(0U, program[2].k);
+  EXPECT_EQ(5U, program[3].k);
+  EXPECT_EQ(2U, program[4].k);
+  EXPECT_EQ(BPF_ALU | BPF_MOD | BPF_K, program[5].code);
+  EXPECT_EQ(3U, program[5].k);
+  EXPECT_EQ(BPF_RET | BPF_A, program[6].code);
+}
+
+// A listener update adds the sockets of the new listener to the group of the old one, whose sockets
+// are closed afterwards. The kernel moves the last socket into the position of a closed one.
+TEST(ReusePortCpuSteeringTest, ListenerUpdate) {
+  ReusePortCpuSteering steering;
+  auto address = Utility::parseInternetAddress("127.0.0.1", 0);
+  TcpListenSocket old0(address, nullptr, false);
+  TcpListenSocket old1(address, nullptr, false);
+  TcpListenSocket new0(address, nullptr, false);
+  TcpListenSocket new1(address, nullptr, false);
+  steering.addSocket(old0, 0);
+  steering.addSocket(old1, 1);
+  steering.addSocket(new0, 0);
+  steering.addSocket(new1, 1);
+
+  // Group: new1, old1, new0.
+  old0.close();
+  steering.removeSocket(old0);
+  std::vector<ReusePortCpuSteering::Instruction> program = steering.program();
+  ASSERT_EQ(9U, program.size());
+  EXPECT_EQ(1U, program[1].k);
+  EXPECT_EQ(0U, program[2].k);
+  EXPECT_EQ(1U, program[3].k);
+  EXPECT_EQ(1U, program[4].k);
+  EXPECT_EQ(0U, program[5].k);
+  EXPECT_EQ(2U, program[6].k);
+  EXPECT_EQ(3U, program[7].k);
+
+  // Group: new1, new0.
+  old1.close();
+  steering.removeSocket(old1);
+  program = steering.program();
+  ASSERT_EQ(7U, program.size());
+  EXPECT_EQ(1U, program[1].k);
+  EXPECT_EQ(0U, program[2].k);
+  EXPECT_EQ(0U, program[3].k);
+  EXPECT_EQ(1U, program[4].k);
+  EXPECT_EQ(2U, program[5].k);
+
+  // Sockets which are not in the group are ignored.
+  EXPECT_FALSE(steering.removeSocket(old1));
+  EXPECT_EQ(7U, steering.program().size());
+}
+
+// The program can be attached to every socket of a listening SO_REUSEPORT group, and is re-attached
+// to the remaining sockets when one is closed.
+TEST(ReusePortCpuSteeringTest, AttachToGroup) {
+  const auto version = TestEnvironment::getIpVersionsForTest()[0];
+  auto first = std::make_shared<TcpListenSocket>(Test::getCanonicalLoopbackAddress(version),
+                                                 SocketOptionFactory::buildReusePortOptions(),
+                                                 true);
+  auto second = std::make_shared<TcpListenSocket>(first->localAddress(),
+                                                  SocketOptionFactory::buildReusePortOptions(),
+                                                  true);
+  auto third = std::make_shared<TcpListenSocket>(first->localAddress(),
+                                                 SocketOptionFactory::buildReusePortOptions(),
+                                                 true);
+  ReusePortCpuSteering steering;
+  ASSERT_EQ(0, first->ioHandle().listen(ENVOY_TCP_BACKLOG_SIZE).rc_);
+  EXPECT_TRUE(steering.addSocket(*first, absl::nullopt));
+  ASSERT_EQ(0, second->ioHandle().listen(ENVOY_TCP_BACKLOG_SIZE).rc_);
+  EXPECT_TRUE(steering.addSocket(*second, ReusePortCpuSteering::currentThreadCpu()));
+  first->close();
+  EXPECT_TRUE(steering.removeSocket(*first));
+
+  // A disabled group only tracks its sockets.
+  steering.disable();
+  EXPECT_FALSE(steering.enabled());
+  ASSERT_EQ(0, third->ioHandle().listen(ENVOY_TCP_BACKLOG_SIZE).rc_);
+  EXPECT_FALSE(steering.addSocket(*third, absl::nullopt));
+  second->close();
+  EXPECT_FALSE(steering.removeSocket(*second));
+}
+#else
+TEST(ReusePortCpuSteeringTest, Unsupported) { EXPECT_FALSE(ReusePortCpuSteering::supported()); }
+#endif
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -7617,6 +7617,65 @@ virtual_hosts:
   checkEach(yaml, 1213, 1213, 1415);
 }
 
+// Indexed route matching must find the same route as evaluating every route in order.
+TEST_F(RouteMatcherTest, IndexedRouteMatching) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: all
+    domains: ["*"]
+    routes:
+      - match: { path: "/exact" }
+        route: { cluster: exact }
+      - match: { prefix: "/api/v1", headers: [{ name: x-version, exact_match: "2" }] }
+        route: { cluster: api_v1_header }
+      - match: { prefix: "/API", case_sensitive: false }
+        route: { cluster: api_insensitive }
+      - match: { safe_regex: { google_re2: {}, regex: "/users/[0-9]+" } }
+        route: { cluster: users_regex }
+      - match: { prefix: "/api/v1" }
+        route: { cluster: api_v1 }
+      - match: { path: "/EXACT", case_sensitive: false }
+        route: { cluster: exact_insensitive }
+      - match: { prefix: "/users", query_parameters: [{ name: debug }] }
+        route: { cluster: users_debug }
+      - match: { safe_regex: { google_re2: {}, regex: "/users/.*" } }
+        route: { cluster: users_any }
+      - match: { prefix: "/" }
+        route: { cluster: default }
+)EOF";
+
+  const std::vector<std::pair<std::string, std::string>> requests{
+      {"/exact", "exact"},
+      {"/exact?a=b", "exact"},
+      {"/Exact", "exact_insensitive"},
+      {"/exact/more", "default"},
+      {"/api/v1/foo", "api_insensitive"},
+      {"/users/123", "users_regex"},
+      {"/users/123?debug=1", "users_regex"},
+      {"/users/abc", "users_any"},
+      {"/users?debug=1", "users_debug"},
+      {"/other", "default"},
+  };
+
+  for (const bool indexed : {true, false}) {
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.indexed_route_matching", indexed ? "true" : "false"}});
+    TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+    for (const auto& request : requests) {
+      EXPECT_EQ(request.second,
+                config.route(genHeaders("www.lyft.com", request.first, "GET"), 0)
+                    ->routeEntry()
+                    ->clusterName())
+          << request.first << (indexed ? " indexed" : "");
+    }
+
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/api/v1/foo", "GET");
+    headers.addCopy("x-version", "2");
+    EXPECT_EQ("api_v1_header", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+}
+
 class RouteMatchOverrideTest : public testing::Test, public ConfigImplTestBase {};
 
 TEST_F(RouteMatchOverrideTest, VerifyAllMatchableRoutes) {
@@ -7741,6 +7800,45 @@ virtual_hosts:
   EXPECT_EQ(accepted_route, nullptr);
 }
 
+// Routes which can't match the path are skipped, but the evaluation status is relative to all the
+// routes of the virtual host.
+TEST_F(RouteMatchOverrideTest, SkipsRoutesNotMatchingPath) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/foo/bar" }
+        route:
+          cluster: foo_bar
+      - match: { prefix: "/baz" }
+        route:
+          cluster: baz
+      - match: { prefix: "/foo" }
+        route:
+          cluster: foo
+      - match: { path: "/qux" }
+        route:
+          cluster: qux
+)EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+  std::vector<std::string> clusters{"foo", "foo_bar"};
+
+  RouteConstSharedPtr accepted_route = config.route(
+      [&clusters](RouteConstSharedPtr route,
+                  RouteEvalStatus route_eval_status) -> RouteMatchStatus {
+        EXPECT_FALSE(clusters.empty());
+        EXPECT_EQ(clusters[clusters.size() - 1], route->routeEntry()->clusterName());
+        clusters.pop_back();
+        EXPECT_EQ(route_eval_status, RouteEvalStatus::HasMoreRoutes);
+        return RouteMatchStatus::Continue;
+      },
+      genHeaders("bat.com", "/foo/bar/baz", "GET"));
+  EXPECT_TRUE(clusters.empty());
+  EXPECT_EQ(accepted_route, nullptr);
+}
+
 TEST_F(RouteMatchOverrideTest, NullRouteOnNoRouteMatch) {
   const std::string yaml = R"EOF(
 virtual_hosts:
@@ -0,0 +1,108 @@
+#include "common/router/route_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+RouteIndex::Candidates candidates(const RouteIndex& index, absl::string_view path) {
+  RouteIndex::Candidates candidates;
+  index.candidates(path, candidates);
+  return candidates;
+}
+
+TEST(RouteIndexTest, Empty) {
+  RouteIndex index;
+  index.compile();
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre());
+}
+
+TEST(RouteIndexTest, Prefixes) {
+  RouteIndex index;
+  index.addPrefix(0, "/foo/bar", true);
+  index.addPrefix(1, "/baz", true);
+  index.addPrefix(2, "/foo", true);
+  index.addPrefix(3, "/foo", true);
+  index.addPrefix(4, "", true);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo/bar/baz"), ElementsAre(0, 2, 3, 4));
+  EXPECT_THAT(candidates(index, "/foo/bar"), ElementsAre(0, 2, 3, 4));
+  EXPECT_THAT(candidates(index, "/foo/ba"), ElementsAre(2, 3, 4));
+  EXPECT_THAT(candidates(index, "/fo"), ElementsAre(4));
+  EXPECT_THAT(candidates(index, "/baz"), ElementsAre(1, 4));
+  EXPECT_THAT(candidates(index, "/FOO"), ElementsAre(4));
+  EXPECT_THAT(candidates(index, ""), ElementsAre(4));
+}
+
+TEST(RouteIndexTest, Paths) {
+  RouteIndex index;
+  index.addPath(0, "/foo", true);
+  index.addPrefix(1, "/foo", true);
+  index.addPath(2, "/foo/bar", true);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1));
+  EXPECT_THAT(candidates(index, "/foo/"), ElementsAre(1));
+  EXPECT_THAT(candidates(index, "/foo/bar"), ElementsAre(1, 2));
+  EXPECT_THAT(candidates(index, "/fo"), ElementsAre());
+}
+
+TEST(RouteIndexTest, QueryAndFragmentIgnored) {
+  RouteIndex index;
+  index.addPath(0, "/foo", true);
+  index.addPrefix(1, "/foo?", true);
+  index.addRegex(2, "/fo+");
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo?bar=baz"), ElementsAre(0, 2));
+  EXPECT_THAT(candidates(index, "/foo#bar"), ElementsAre(0, 2));
+}
+
+TEST(RouteIndexTest, CaseInsensitive) {
+  RouteIndex index;
+  index.addPrefix(0, "/Foo", false);
+  index.addPath(1, "/FOO/bar", false);
+  index.addPrefix(2, "/foo", true);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo/BAR"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates(index, "/FOO/bar"), ElementsAre(0, 1));
+  EXPECT_THAT(candidates(index, "/fOo"), ElementsAre(0));
+}
+
+TEST(RouteIndexTest, Regexes) {
+  RouteIndex index;
+  index.addRegex(0, "/users/[0-9]+");
+  index.addPrefix(1, "/users", true);
+  index.addRegex(2, "/users/.*");
+  index.addRegex(3, "/[a-z]+");
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/users/123"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates(index, "/users/abc"), ElementsAre(1, 2));
+  // Regexes match the whole path.
+  EXPECT_THAT(candidates(index, "/users"), ElementsAre(1, 3));
+  EXPECT_THAT(candidates(index, "/users/123/x"), ElementsAre(1, 2));
+}
+
+TEST(RouteIndexTest, Unindexed) {
+  RouteIndex index;
+  index.addPrefix(0, "/foo", true);
+  index.addUnindexed(1);
+  index.addPath(2, "/bar", true);
+  index.addUnindexed(3);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1, 3));
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(candidates(index, ""), ElementsAre(1, 3));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
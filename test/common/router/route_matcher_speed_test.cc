@@ -0,0 +1,116 @@
+// Measures route lookup in virtual hosts with large synthetic route tables, with and without the
+// route index.
+
+#include "envoy/config/route/v3/route.pb.h"
+
+#include "common/http/header_map_impl.h"
+#include "common/router/config_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/server/instance.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+/**
+ * Generate a virtual host with the given number of routes. Most routes are prefix routes, one in
+ * eight is an exact path route, one in sixteen is a regex route and one in sixteen has a header
+ * condition.
+ */
+envoy::config::route::v3::RouteConfiguration genRouteConfig(uint32_t num_routes) {
+  envoy::config::route::v3::RouteConfiguration config;
+  auto* virtual_host = config.add_virtual_hosts();
+  virtual_host->set_name("benchmark");
+  virtual_host->add_domains("*");
+  for (uint32_t i = 0; i < num_routes; i++) {
+    auto* route = virtual_host->add_routes();
+    auto* match = route->mutable_match();
+    switch (i % 16) {
+    case 0:
+    case 8:
+      match->set_path(absl::StrCat("/service_", i, "/method"));
+      break;
+    case 4: {
+      auto* regex = match->mutable_safe_regex();
+      regex->mutable_google_re2();
+      regex->set_regex(absl::StrCat("/service_", i, "/[a-z]+/[0-9]+"));
+      break;
+    }
+    case 12: {
+      match->set_prefix(absl::StrCat("/service_", i, "/"));
+      auto* header = match->add_headers();
+      header->set_name("x-tenant");
+      header->set_exact_match(absl::StrCat("tenant_", i));
+      break;
+    }
+    default:
+      match->set_prefix(absl::StrCat("/service_", i, "/"));
+      break;
+    }
+    route->mutable_route()->set_cluster(absl::StrCat("cluster_", i));
+  }
+  virtual_host->add_routes()->mutable_match()->set_prefix("/");
+  virtual_host->mutable_routes(num_routes)->mutable_route()->set_cluster("default");
+  return config;
+}
+
+/**
+ * Look up a route in a virtual host of state.range(0) routes, with route indexing enabled if
+ * state.range(1) is set. The requested path matches the route at the given fraction of the table.
+ */
+void routeLookup(::benchmark::State& state, double position, absl::string_view suffix) {
+  const uint32_t num_routes = state.range(0);
+  const bool indexed = state.range(1) != 0;
+  if (benchmark::skipExpensiveBenchmarks() && num_routes > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.indexed_route_matching", indexed ? "true" : "false"}});
+  testing::NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ConfigImpl config(genRouteConfig(num_routes), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), false);
+  testing::NiceMock<StreamInfo::MockStreamInfo> stream_info;
+
+  // Requests to the middle of each group of 16 routes hit a plain prefix route.
+  const uint32_t target = static_cast<uint32_t>(position * (num_routes - 1)) / 16 * 16 + 6;
+  auto headers = Http::RequestHeaderMapImpl::create();
+  headers->setHost("www.example.com");
+  headers->setMethod("GET");
+  headers->setForwardedProto("https");
+  headers->setPath(absl::StrCat("/service_", target, suffix));
+
+  for (auto _ : state) { // NOLINT
+    ::benchmark::DoNotOptimize(config.route(*headers, stream_info, 0));
+  }
+}
+
+void routeLookupFirst(::benchmark::State& state) { routeLookup(state, 0, "/method/foo"); }
+void routeLookupMiddle(::benchmark::State& state) { routeLookup(state, 0.5, "/method/foo"); }
+void routeLookupLast(::benchmark::State& state) { routeLookup(state, 1, "/method/foo"); }
+void routeLookupDefault(::benchmark::State& state) { routeLookup(state, 1, "_unknown/method"); }
+
+void routeLookupArgs(::benchmark::internal::Benchmark* b) {
+  for (const int num_routes : {16, 128, 1024, 4096}) {
+    for (const int indexed : {0, 1}) {
+      b->Args({num_routes, indexed});
+    }
+  }
+}
+
+BENCHMARK(routeLookupFirst)->Apply(routeLookupArgs);
+BENCHMARK(routeLookupMiddle)->Apply(routeLookupArgs);
+BENCHMARK(routeLookupLast)->Apply(routeLookupArgs);
+BENCHMARK(routeLookupDefault)->Apply(routeLookupArgs);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
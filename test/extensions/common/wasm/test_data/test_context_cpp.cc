@@ -32,10 +32,45 @@ private:
   uint32_t dns_token_;
 };
 
+// Reads the headers of a typical request as an auth plugin would, used by wasm_speed_test.
+static const std::vector<std::string_view> header_lookup_keys = {
+    ":method",         ":path",     ":authority", "authorization", "cookie",       "x-request-id",
+    "x-forwarded-for", "x-api-key", "x-tenant",   "x-missing",     "content-type", "user-agent"};
+
+// One proxy_get_header_map_value call per header.
+class HeaderMapValueContext : public EnvoyContext {
+public:
+  explicit HeaderMapValueContext(uint32_t id, RootContext* root) : EnvoyContext(id, root) {}
+
+  FilterHeadersStatus onRequestHeaders(uint32_t, bool) override;
+
+private:
+  size_t size_ = 0;
+};
+
+// A single envoy_get_header_map_values call for all of the headers.
+class HeaderMapValuesContext : public EnvoyContext {
+public:
+  explicit HeaderMapValuesContext(uint32_t id, RootContext* root) : EnvoyContext(id, root) {}
+
+  FilterHeadersStatus onRequestHeaders(uint32_t, bool) override;
+
+private:
+  std::string buffer_;
+  std::vector<HeaderValue> values_;
+  size_t size_ = 0;
+};
+
 static RegisterContextFactory register_TestContext(CONTEXT_FACTORY(TestContext),
                                                    ROOT_FACTORY(TestRootContext));
 static RegisterContextFactory register_EmptyTestContext(CONTEXT_FACTORY(EnvoyContext),
                                                         ROOT_FACTORY(EnvoyRootContext), "empty");
+static RegisterContextFactory
+    register_HeaderMapValueContext(CONTEXT_FACTORY(HeaderMapValueContext),
+                                   ROOT_FACTORY(EnvoyRootContext), "header_map_value");
+static RegisterContextFactory
+    register_HeaderMapValuesContext(CONTEXT_FACTORY(HeaderMapValuesContext),
+                                    ROOT_FACTORY(EnvoyRootContext), "header_map_values");
 
 bool TestRootContext::onStart(size_t) {
   envoy_resolve_dns("example.com", sizeof("example.com") - 1, &dns_token_);
@@ -79,4 +114,23 @@ void TestRootContext::onQueueReady(uint32_t) {
   }
 }
 
+FilterHeadersStatus HeaderMapValueContext::onRequestHeaders(uint32_t, bool) {
+  for (auto key : header_lookup_keys) {
+    size_ += getRequestHeader(key)->size();
+  }
+  return FilterHeadersStatus::Continue;
+}
+
+FilterHeadersStatus HeaderMapValuesContext::onRequestHeaders(uint32_t, bool) {
+  if (getHeaderMapValues(WasmHeaderMapType::RequestHeaders, header_lookup_keys, &buffer_,
+                         &values_) != WasmResult::Ok) {
+    logError("getHeaderMapValues failed");
+    return FilterHeadersStatus::Continue;
+  }
+  for (auto& value : values_) {
+    size_ += value.value.size();
+  }
+  return FilterHeadersStatus::Continue;
+}
+
 END_WASM_PLUGIN
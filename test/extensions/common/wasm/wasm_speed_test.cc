@@ -1,8 +1,10 @@
 #include "common/common/thread.h"
 #include "common/common/thread_synchronizer.h"
+#include "common/http/header_map_impl.h"
 
 #include "extensions/common/wasm/wasm.h"
 
+#include "test/mocks/local_info/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/environment.h"
@@ -59,6 +61,101 @@ void bmWasmSpeedTest(benchmark::State& state) {
 
 BENCHMARK(bmWasmSpeedTest);
 
+namespace {
+
+// A typical request as seen by an auth plugin. The headers read from it are listed in
+// test_data/test_context_cpp.cc.
+Http::TestRequestHeaderMapImpl makeBenchmarkRequestHeaders() {
+  Http::TestRequestHeaderMapImpl headers{{":method", "GET"},
+                                         {":path", "/api/v1/resource?id=12345"},
+                                         {":authority", "www.example.com"},
+                                         {":scheme", "https"},
+                                         {"user-agent", "benchmark/1.0"},
+                                         {"accept", "application/json"},
+                                         {"accept-encoding", "gzip, deflate"},
+                                         {"authorization", "Bearer 0123456789abcdef"},
+                                         {"cookie", "session=abcdef0123456789"},
+                                         {"x-request-id", "c7a3b9f2-1d2e-4f5a-8b6c-7d8e9f0a1b2c"},
+                                         {"x-forwarded-for", "10.0.0.1"},
+                                         {"x-forwarded-proto", "https"},
+                                         {"x-api-key", "key"},
+                                         {"x-tenant", "tenant"},
+                                         {"content-type", "application/json"}};
+  return headers;
+}
+
+class BenchmarkContext : public Extensions::Common::Wasm::Context {
+public:
+  using Extensions::Common::Wasm::Context::Context;
+
+  void setRequestHeaders(Http::RequestHeaderMap* headers) { request_headers_ = headers; }
+};
+
+// Runs onRequestHeaders() of the test plugin stream context registered under root_id, so that
+// every header lookup made by the plugin crosses the VM boundary through the ABI.
+void bmWasmHeaderMapLookup(benchmark::State& state, const std::string& runtime,
+                           const std::string& root_id) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm).set_level(spdlog::level::off);
+  Stats::IsolatedStoreImpl stats_store;
+  Api::ApiPtr api = Api::createApiForTest(stats_store);
+  Upstream::MockClusterManager cluster_manager;
+  Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
+  auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+  testing::NiceMock<LocalInfo::MockLocalInfo> local_info;
+  std::string code;
+  if (runtime != "null") {
+    code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_context_cpp.wasm"));
+  } else {
+    // The name of the Null VM plugin.
+    code = "CommonWasmTestContextCpp";
+  }
+  auto plugin = std::make_shared<Extensions::Common::Wasm::Plugin>(
+      "", root_id, "", runtime, "", false, envoy::config::core::v3::TrafficDirection::UNSPECIFIED,
+      local_info, nullptr);
+  auto vm_key = proxy_wasm::makeVmKey("", "", code);
+  auto wasm = std::make_shared<Extensions::Common::Wasm::Wasm>(
+      absl::StrCat("envoy.wasm.runtime.", runtime), "", "", vm_key, scope, cluster_manager,
+      *dispatcher);
+  if (!wasm->initialize(code, false)) {
+    state.SkipWithError("failed to load the test plugin");
+    return;
+  }
+  auto root_context = wasm->start(plugin);
+  auto context = std::make_unique<BenchmarkContext>(wasm.get(), root_context->id(), plugin);
+  context->onCreate();
+  auto headers = makeBenchmarkRequestHeaders();
+  context->setRequestHeaders(&headers);
+  for (__attribute__((unused)) auto _ : state) {
+    context->onRequestHeaders(headers.size(), false);
+  }
+  context.reset();
+}
+
+} // namespace
+
+// Per-key access: one proxy_get_header_map_value call, with its lookup and copy into the VM, per
+// header.
+void bmWasmHeaderMapGetValue(benchmark::State& state, std::string runtime) {
+  bmWasmHeaderMapLookup(state, runtime, "header_map_value");
+}
+
+// Batched access: a single envoy_get_header_map_values call serializes all of the headers into a
+// buffer reused across calls.
+void bmWasmHeaderMapGetValues(benchmark::State& state, std::string runtime) {
+  bmWasmHeaderMapLookup(state, runtime, "header_map_values");
+}
+
+BENCHMARK_CAPTURE(bmWasmHeaderMapGetValue, null, std::string("null"));
+BENCHMARK_CAPTURE(bmWasmHeaderMapGetValues, null, std::string("null"));
+#if defined(ENVOY_WASM_V8)
+BENCHMARK_CAPTURE(bmWasmHeaderMapGetValue, v8, std::string("v8"));
+BENCHMARK_CAPTURE(bmWasmHeaderMapGetValues, v8, std::string("v8"));
+#endif
+
 } // namespace Envoy
 
 int main(int argc, char** argv) {
@@ -2,10 +2,15 @@
 
 #include "common/common/hex.h"
 #include "common/event/dispatcher_impl.h"
+#include "common/stats/allocator_impl.h"
 #include "common/stats/isolated_store_impl.h"
 
+#include "extensions/common/wasm/ext/envoy_null_plugin.h"
+#include "extensions/common/wasm/pattern_matcher.h"
+#include "extensions/common/wasm/shared_data.h"
 #include "extensions/common/wasm/wasm.h"
 
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/stats/mocks.h"
 #include "test/mocks/upstream/mocks.h"
@@ -78,6 +83,8 @@ public:
     return proxy_wasm::WasmResult::Ok;
   }
   MOCK_METHOD2(log_, void(spdlog::level::level_enum level, absl::string_view message));
+
+  void setRequestHeaders(Http::RequestHeaderMap* headers) { request_headers_ = headers; }
 };
 
 class WasmCommonTest : public testing::TestWithParam<std::string> {
@@ -672,6 +679,7 @@ TEST_P(WasmCommonTest, VmCache) {
   NiceMock<Server::MockServerLifecycleNotifier2> lifecycle_notifier;
   Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
   Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider;
+  CreateWasmHandlePtr create_wasm_handle;
   auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
   NiceMock<LocalInfo::MockLocalInfo> local_info;
   auto name = "";
@@ -709,7 +717,7 @@ TEST_P(WasmCommonTest, VmCache) {
   vm_config.mutable_code()->mutable_local()->set_inline_bytes(code);
   WasmHandleSharedPtr wasm_handle;
   createWasm(vm_config, plugin, scope, cluster_manager, init_manager, *dispatcher, random, *api,
-             lifecycle_notifier, remote_data_provider,
+             lifecycle_notifier, remote_data_provider, create_wasm_handle,
              [&wasm_handle](const WasmHandleSharedPtr& w) { wasm_handle = w; });
   EXPECT_NE(wasm_handle, nullptr);
   Event::PostCb post_cb = [] {};
@@ -717,7 +725,7 @@ TEST_P(WasmCommonTest, VmCache) {
 
   WasmHandleSharedPtr wasm_handle2;
   createWasm(vm_config, plugin, scope, cluster_manager, init_manager, *dispatcher, random, *api,
-             lifecycle_notifier, remote_data_provider,
+             lifecycle_notifier, remote_data_provider, create_wasm_handle,
              [&wasm_handle2](const WasmHandleSharedPtr& w) { wasm_handle2 = w; });
   EXPECT_NE(wasm_handle2, nullptr);
   EXPECT_EQ(wasm_handle, wasm_handle2);
@@ -768,6 +776,7 @@ TEST_P(WasmCommonTest, RemoteCode) {
   Init::ExpectableWatcherImpl init_watcher;
   Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
   Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider;
+  CreateWasmHandlePtr create_wasm_handle;
   auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
   NiceMock<LocalInfo::MockLocalInfo> local_info;
   auto name = "";
@@ -818,7 +827,7 @@ TEST_P(WasmCommonTest, RemoteCode) {
     init_target_handle = target.createHandle("test");
   }));
   createWasm(vm_config, plugin, scope, cluster_manager, init_manager, *dispatcher, random, *api,
-             lifecycle_notifier, remote_data_provider,
+             lifecycle_notifier, remote_data_provider, create_wasm_handle,
              [&wasm_handle](const WasmHandleSharedPtr& w) { wasm_handle = w; });
 
   EXPECT_CALL(init_watcher, ready());
@@ -865,6 +874,7 @@ TEST_P(WasmCommonTest, RemoteCodeMultipleRetry) {
   Init::ExpectableWatcherImpl init_watcher;
   Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
   Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider;
+  CreateWasmHandlePtr create_wasm_handle;
   auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
   NiceMock<LocalInfo::MockLocalInfo> local_info;
   auto name = "";
@@ -928,7 +938,7 @@ TEST_P(WasmCommonTest, RemoteCodeMultipleRetry) {
     init_target_handle = target.createHandle("test");
   }));
   createWasm(vm_config, plugin, scope, cluster_manager, init_manager, *dispatcher, random, *api,
-             lifecycle_notifier, remote_data_provider,
+             lifecycle_notifier, remote_data_provider, create_wasm_handle,
              [&wasm_handle](const WasmHandleSharedPtr& w) { wasm_handle = w; });
 
   EXPECT_CALL(init_watcher, ready());
@@ -964,6 +974,122 @@ TEST_P(WasmCommonTest, RemoteCodeMultipleRetry) {
   dispatcher->clearDeferredDeleteList();
 }
 
+TEST_P(WasmCommonTest, RemoteCodeDiskCache) {
+  if (GetParam() == "null") {
+    return;
+  }
+  Stats::IsolatedStoreImpl stats_store;
+  Api::ApiPtr api = Api::createApiForTest(stats_store);
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  NiceMock<Random::MockRandomGenerator> random;
+  NiceMock<Init::MockManager> init_manager;
+  NiceMock<Server::MockServerLifecycleNotifier> lifecycle_notifier;
+  Init::ExpectableWatcherImpl init_watcher;
+  Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
+  Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider;
+  CreateWasmHandlePtr create_wasm_handle;
+  auto scope = Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  auto plugin = std::make_shared<Extensions::Common::Wasm::Plugin>(
+      "", "", "", GetParam(), "done", false, envoy::config::core::v3::TrafficDirection::UNSPECIFIED,
+      local_info, nullptr);
+
+  std::string code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      absl::StrCat("{{ test_rundir }}/test/extensions/common/wasm/test_data/test_cpp.wasm")));
+
+  VmConfig vm_config;
+  vm_config.set_runtime(absl::StrCat("envoy.wasm.runtime.", GetParam()));
+  ProtobufWkt::BytesValue vm_configuration_bytes;
+  vm_configuration_bytes.set_value("vm_cache");
+  vm_config.mutable_configuration()->PackFrom(vm_configuration_bytes);
+  std::string sha256 = Extensions::Common::Wasm::sha256(code);
+  std::string sha256Hex =
+      Hex::encode(reinterpret_cast<const uint8_t*>(&*sha256.begin()), sha256.size());
+  vm_config.mutable_code()->mutable_remote()->set_sha256(sha256Hex);
+  vm_config.mutable_code()->mutable_remote()->mutable_http_uri()->set_uri(
+      "http://example.com/test.wasm");
+  vm_config.mutable_code()->mutable_remote()->mutable_http_uri()->set_cluster("example_com");
+  vm_config.mutable_code()->mutable_remote()->mutable_http_uri()->mutable_timeout()->set_seconds(5);
+  const std::string cache_directory = TestEnvironment::temporaryPath("wasm_code_cache");
+  TestEnvironment::removePath(cache_directory);
+  TestEnvironment::createPath(cache_directory);
+  vm_config.set_code_cache_directory(cache_directory);
+  const std::string cache_file = absl::StrCat(cache_directory, "/", sha256Hex, ".wasm");
+
+  // The first load fetches the code and fills the on-disk cache.
+  WasmHandleSharedPtr wasm_handle;
+  NiceMock<Http::MockAsyncClient> client;
+  NiceMock<Http::MockAsyncClientRequest> request(&client);
+  EXPECT_CALL(cluster_manager, httpAsyncClientForCluster("example_com"))
+      .WillOnce(ReturnRef(cluster_manager.async_client_));
+  EXPECT_CALL(cluster_manager.async_client_, send_(_, _, _))
+      .WillOnce(
+          Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            Http::ResponseMessagePtr response(
+                new Http::ResponseMessageImpl(Http::ResponseHeaderMapPtr{
+                    new Http::TestResponseHeaderMapImpl{{":status", "200"}}}));
+            response->body() = std::make_unique<::Envoy::Buffer::OwnedImpl>(code);
+            callbacks.onSuccess(request, std::move(response));
+            return nullptr;
+          }));
+  Init::TargetHandlePtr init_target_handle;
+  EXPECT_CALL(init_manager, add(_)).WillOnce(Invoke([&](const Init::Target& target) {
+    init_target_handle = target.createHandle("test");
+  }));
+  createWasm(vm_config, plugin, scope, cluster_manager, init_manager, *dispatcher, random, *api,
+             lifecycle_notifier, remote_data_provider, create_wasm_handle,
+             [&wasm_handle](const WasmHandleSharedPtr& w) { wasm_handle = w; });
+  EXPECT_CALL(init_watcher, ready());
+  init_target_handle->initialize(init_watcher);
+  EXPECT_NE(wasm_handle, nullptr);
+  EXPECT_TRUE(api->fileSystem().fileExists(cache_file));
+  EXPECT_EQ(1, stats_store.counter("wasm.wasm.remote_load_disk_cache_misses").value());
+  wasm_handle.reset();
+  remote_data_provider.reset();
+
+  // Simulate a restart: the in-memory cache is gone but the code is loaded from disk
+  // synchronously without a fetch.
+  clearCodeCacheForTesting();
+  EXPECT_CALL(cluster_manager, httpAsyncClientForCluster(_)).Times(0);
+  EXPECT_TRUE(createWasm(vm_config, plugin, scope, cluster_manager, init_manager, *dispatcher,
+                         random, *api, lifecycle_notifier, remote_data_provider, create_wasm_handle,
+                         [&wasm_handle](const WasmHandleSharedPtr& w) { wasm_handle = w; }));
+  EXPECT_NE(wasm_handle, nullptr);
+  EXPECT_EQ(remote_data_provider, nullptr);
+  EXPECT_EQ(1, stats_store.counter("wasm.wasm.remote_load_disk_cache_hits").value());
+  wasm_handle.reset();
+
+  // A corrupted cache file is ignored.
+  clearCodeCacheForTesting();
+  TestEnvironment::writeStringToFileForTest(cache_file, "corrupted", true);
+  vm_config.set_nack_on_code_cache_miss(true);
+  EXPECT_CALL(cluster_manager, httpAsyncClientForCluster("example_com"))
+      .WillOnce(ReturnRef(cluster_manager.async_client_));
+  EXPECT_CALL(cluster_manager.async_client_, send_(_, _, _))
+      .WillOnce(
+          Invoke([&](Http::RequestMessagePtr&, Http::AsyncClient::Callbacks& callbacks,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            Http::ResponseMessagePtr response(
+                new Http::ResponseMessageImpl(Http::ResponseHeaderMapPtr{
+                    new Http::TestResponseHeaderMapImpl{{":status", "503"}}}));
+            callbacks.onSuccess(request, std::move(response));
+            return nullptr;
+          }));
+  EXPECT_FALSE(createWasm(vm_config, plugin, scope, cluster_manager, init_manager, *dispatcher,
+                          random, *api, lifecycle_notifier, remote_data_provider,
+                          create_wasm_handle,
+                          [&wasm_handle](const WasmHandleSharedPtr& w) { wasm_handle = w; }));
+  EXPECT_EQ(wasm_handle, nullptr);
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  // The corrupted file counts as a second disk cache miss and the code is fetched again.
+  EXPECT_EQ(2, stats_store.counter("wasm.wasm.remote_load_disk_cache_misses").value());
+  EXPECT_EQ(1, stats_store.counter("wasm.wasm.remote_load_disk_cache_hits").value());
+  EXPECT_EQ(1, stats_store.counter("wasm.wasm.remote_load_fetch_failures").value());
+  EXPECT_EQ("corrupted", TestEnvironment::readFileToStringForTest(cache_file));
+  dispatcher->clearDeferredDeleteList();
+}
+
 class WasmCommonContextTest
     : public Common::Wasm::WasmTestBase<testing::TestWithParam<std::string>> {
 public:
@@ -1058,6 +1184,595 @@ TEST_P(WasmCommonContextTest, EmptyContext) {
   root_context_->validateConfiguration("", plugin_);
 }
 
+TEST_P(WasmCommonContextTest, PropertyPath) {
+  std::string code;
+  if (GetParam() != "null") {
+    code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(absl::StrCat(
+        "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_context_cpp.wasm")));
+  } else {
+    // The name of the Null VM plugin.
+    code = "CommonWasmTestContextCpp";
+  }
+  EXPECT_FALSE(code.empty());
+
+  setup(code, "context", "empty");
+  setupContext();
+
+  auto wasm = wasm_->wasm().get();
+  auto register_path = [wasm](absl::string_view path) {
+    uint32_t path_id;
+    EXPECT_EQ(WasmResult::Ok, wasm->registerPropertyPath(path, &path_id));
+    return path_id;
+  };
+  const uint32_t vm_id_path = register_path("plugin_vm_id");
+  EXPECT_EQ(vm_id_path, register_path("plugin_vm_id"));
+  const uint32_t missing_path = register_path(absl::string_view("node\0missing", 12));
+  EXPECT_NE(vm_id_path, missing_path);
+  EXPECT_EQ(PropertyLifetime::Context, wasm->propertyPath(vm_id_path)->lifetime_);
+  const uint32_t source_path = register_path(absl::string_view("source\0address", 14));
+  EXPECT_EQ(PropertyLifetime::Stream, wasm->propertyPath(source_path)->lifetime_);
+  const uint32_t mtls_path = register_path(absl::string_view("connection\0mtls", 15));
+  EXPECT_EQ(PropertyLifetime::Stream, wasm->propertyPath(mtls_path)->lifetime_);
+  const uint32_t header_path = register_path(absl::string_view("request\0headers\0x-a", 19));
+  EXPECT_EQ(PropertyLifetime::Callback, wasm->propertyPath(header_path)->lifetime_);
+  EXPECT_EQ(PropertyLifetime::Call, wasm->propertyPath(register_path("filter_state"))->lifetime_);
+
+  std::string expected;
+  EXPECT_EQ(WasmResult::Ok, context().getProperty("plugin_vm_id", &expected));
+  absl::string_view value;
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(WasmResult::Ok, context().getProperty(vm_id_path, &value));
+    EXPECT_EQ(expected, value);
+    EXPECT_EQ(WasmResult::NotFound, context().getProperty(missing_path, &value));
+  }
+  EXPECT_EQ(WasmResult::BadArgument, context().getProperty(Wasm::MaxPropertyPaths, &value));
+
+  // Header values are reused until the plugin modifies headers or the callback ends.
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  context().setDecoderFilterCallbacks(decoder_callbacks);
+  Http::TestRequestHeaderMapImpl headers{{"x-a", "1"}};
+  context().setRequestHeaders(&headers);
+  EXPECT_EQ(WasmResult::Ok, context().getProperty(header_path, &value));
+  EXPECT_EQ("1", value);
+  headers.setCopy(Http::LowerCaseString("x-a"), "2");
+  EXPECT_EQ(WasmResult::Ok, context().getProperty(header_path, &value));
+  EXPECT_EQ("1", value);
+  EXPECT_EQ(WasmResult::Ok,
+            context().replaceHeaderMapValue(WasmHeaderMapType::RequestHeaders, "x-a", "3"));
+  EXPECT_EQ(WasmResult::Ok, context().getProperty(header_path, &value));
+  EXPECT_EQ("3", value);
+  headers.setCopy(Http::LowerCaseString("x-a"), "4");
+  context().invalidateCallbackProperties();
+  EXPECT_EQ(WasmResult::Ok, context().getProperty(header_path, &value));
+  EXPECT_EQ("4", value);
+  context().setRequestHeaders(nullptr);
+
+  // The number of registered paths is bounded.
+  uint32_t path_id;
+  for (uint32_t i = 0; wasm->propertyPath(Wasm::MaxPropertyPaths - 1) == nullptr; i++) {
+    EXPECT_EQ(WasmResult::Ok, wasm->registerPropertyPath(absl::StrCat("path", i), &path_id));
+  }
+  EXPECT_EQ(WasmResult::BadArgument, wasm->registerPropertyPath("one_more", &path_id));
+  EXPECT_EQ(WasmResult::Ok, wasm->registerPropertyPath("plugin_vm_id", &path_id));
+  EXPECT_EQ(vm_id_path, path_id);
+}
+
+TEST_P(WasmCommonContextTest, SharedDataWatch) {
+  std::string code;
+  if (GetParam() != "null") {
+    code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(absl::StrCat(
+        "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_context_cpp.wasm")));
+  } else {
+    // The name of the Null VM plugin.
+    code = "CommonWasmTestContextCpp";
+  }
+  EXPECT_FALSE(code.empty());
+
+  setup(code, "context", "empty");
+  setupContext();
+  std::vector<Event::PostCb> posted;
+  ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([&posted](Event::PostCb cb) {
+    posted.push_back(std::move(cb));
+  }));
+
+  // A root context watches a key once, also when stream contexts watch it on its behalf.
+  uint32_t token = 0;
+  uint32_t same_token = 0;
+  uint32_t other_token = 0;
+  EXPECT_EQ(WasmResult::Ok, rootContext().watchSharedData("watched", &token));
+  EXPECT_EQ(WasmResult::Ok, context().watchSharedData("watched", &same_token));
+  EXPECT_EQ(token, same_token);
+  EXPECT_EQ(WasmResult::Ok, rootContext().watchSharedData("other", &other_token));
+  EXPECT_NE(token, other_token);
+  EXPECT_EQ(WasmResult::Ok, rootContext().setSharedData("watched", "1", 0));
+  EXPECT_EQ(1, posted.size());
+
+  // Nothing is notified once the key is unwatched, not even what was posted before.
+  EXPECT_EQ(WasmResult::Ok, context().unwatchSharedData(token));
+  EXPECT_EQ(WasmResult::NotFound, rootContext().unwatchSharedData(token));
+  EXPECT_EQ(WasmResult::Ok, rootContext().setSharedData("watched", "2", 0));
+  EXPECT_EQ(1, posted.size());
+  posted[0]();
+
+  // Watching the key again makes a new watch.
+  EXPECT_EQ(WasmResult::Ok, rootContext().watchSharedData("watched", &same_token));
+  EXPECT_NE(token, same_token);
+  EXPECT_EQ(WasmResult::Ok, rootContext().setSharedData("watched", "3", 0));
+  EXPECT_EQ(2, posted.size());
+  EXPECT_EQ(WasmResult::Ok, rootContext().unwatchSharedData(other_token));
+  EXPECT_EQ(WasmResult::Ok, rootContext().unwatchSharedData(same_token));
+}
+
+// Calls a foreign function as a plugin running in context would.
+static WasmResult callForeignFunction(ContextBase& context, const std::string& name,
+                                      absl::string_view arguments, std::string* result) {
+  auto function = proxy_wasm::getForeignFunction(name);
+  EXPECT_TRUE(function != nullptr);
+  proxy_wasm::current_context_ = &context;
+  auto call_result = function(*context.wasm(), arguments, [result](size_t size) -> void* {
+    result->resize(size);
+    return &(*result)[0];
+  });
+  proxy_wasm::current_context_ = nullptr;
+  return call_result;
+}
+
+static std::string serializeUint32s(const std::vector<uint32_t>& values) {
+  return std::string(reinterpret_cast<const char*>(values.data()),
+                     values.size() * sizeof(uint32_t));
+}
+
+static std::vector<uint32_t> parseUint32s(const std::string& data) {
+  std::vector<uint32_t> values(data.size() / sizeof(uint32_t));
+  memcpy(values.data(), data.data(), values.size() * sizeof(uint32_t));
+  return values;
+}
+
+TEST_P(WasmCommonContextTest, PatternSetForeignFunctions) {
+  std::string code;
+  if (GetParam() != "null") {
+    code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(absl::StrCat(
+        "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_context_cpp.wasm")));
+  } else {
+    // The name of the Null VM plugin.
+    code = "CommonWasmTestContextCpp";
+  }
+  EXPECT_FALSE(code.empty());
+
+  // The VM configuration is the buffer scanned.
+  setup(code, "The quick brown fox", "empty");
+  std::string result;
+  auto create = [&](const std::string& arguments) {
+    return callForeignFunction(rootContext(), "pattern_set_create", arguments, &result);
+  };
+  auto match = [&](uint32_t token, uint32_t type, uint32_t max_matches) {
+    return callForeignFunction(rootContext(), "pattern_set_match",
+                               serializeUint32s({token, type, max_matches}), &result);
+  };
+  const uint32_t vm_configuration = static_cast<uint32_t>(WasmBufferType::VmConfiguration);
+
+  // A case insensitive literal and a regex.
+  const std::string patterns = serializeUint32s({1, 2, 0, 3, 1, 6}) + std::string("FOXqu+ick");
+  ASSERT_EQ(WasmResult::Ok, create(patterns));
+  ASSERT_EQ(sizeof(uint32_t), result.size());
+  const uint32_t token = parseUint32s(result)[0];
+  ASSERT_EQ(WasmResult::Ok, match(token, vm_configuration, 10));
+  EXPECT_EQ(std::vector<uint32_t>({2, 0, 16, 3, 1, 4, 5}), parseUint32s(result));
+  ASSERT_EQ(WasmResult::Ok, match(token, vm_configuration, 1));
+  EXPECT_EQ(std::vector<uint32_t>({1, 0, 16, 3}), parseUint32s(result));
+
+  // Malformed arguments.
+  EXPECT_EQ(WasmResult::BadArgument, create(serializeUint32s({0})));
+  EXPECT_EQ(WasmResult::BadArgument, create(serializeUint32s({0, 2, 0, 3})));
+  EXPECT_EQ(WasmResult::BadArgument, create(serializeUint32s({0, 1, 2, 3}) + "fox"));
+  EXPECT_EQ(WasmResult::BadArgument, create(serializeUint32s({0, 1, 0, 4}) + "fox"));
+  EXPECT_EQ(WasmResult::BadArgument, create(serializeUint32s({0, 1, 0, 0})));
+  EXPECT_EQ(WasmResult::BadArgument, create(serializeUint32s({0, 1, 1, 1}) + "("));
+  EXPECT_EQ(WasmResult::BadArgument,
+            callForeignFunction(rootContext(), "pattern_set_match",
+                                serializeUint32s({token, vm_configuration}), &result));
+  EXPECT_EQ(WasmResult::BadArgument,
+            match(token, static_cast<uint32_t>(WasmBufferType::MAX) + 1, 10));
+  EXPECT_EQ(WasmResult::BadArgument,
+            callForeignFunction(rootContext(), "pattern_set_delete", "", &result));
+
+  // Literals whose automaton would exceed the memory budget.
+  std::string literal;
+  while ((literal.size() + 1) * 257 * sizeof(int32_t) <= MultiPatternMatcher::MaxAutomatonBytes) {
+    literal.push_back(static_cast<char>(literal.size()));
+  }
+  EXPECT_EQ(WasmResult::BadArgument,
+            create(serializeUint32s({0, 1, 0, static_cast<uint32_t>(literal.size())}) + literal));
+
+  // Unknown and deleted tokens.
+  EXPECT_EQ(WasmResult::NotFound, match(token + 1, vm_configuration, 10));
+  EXPECT_EQ(WasmResult::Ok, callForeignFunction(rootContext(), "pattern_set_delete",
+                                                serializeUint32s({token}), &result));
+  EXPECT_EQ(WasmResult::NotFound, match(token, vm_configuration, 10));
+}
+
+TEST_P(WasmCommonContextTest, StatsDeltaUpdate) {
+  std::string code;
+  if (GetParam() != "null") {
+    code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(absl::StrCat(
+        "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_context_cpp.wasm")));
+  } else {
+    // The name of the Null VM plugin.
+    code = "CommonWasmTestContextCpp";
+  }
+  EXPECT_FALSE(code.empty());
+
+  setup(code, "context", "empty");
+  setupContext();
+
+  auto last_update = [this]() {
+    auto buffer = static_cast<Buffer*>(root_context_->getBuffer(WasmBufferType::CallData));
+    std::string data(buffer->size(), '\0');
+    buffer->copyOut(0, data.size(), &data[0]);
+    return data;
+  };
+
+  auto& counter = stats_store_.counterFromString("delta_counter");
+  auto& late_counter = stats_store_.counterFromString("late_counter");
+  auto& gauge = stats_store_.gaugeFromString("delta_gauge", Stats::Gauge::ImportMode::Accumulate);
+  // The idle gauge is deleted later, so it is only referenced by the snapshot and the plugin.
+  Stats::AllocatorImpl allocator(stats_store_.symbolTable());
+  Stats::StatNameManagedStorage idle_gauge_name("idle_gauge", stats_store_.symbolTable());
+  Stats::GaugeSharedPtr idle_gauge =
+      allocator.makeGauge(idle_gauge_name.statName(), idle_gauge_name.statName(), {},
+                          Stats::Gauge::ImportMode::Accumulate);
+  counter.add(5);
+  gauge.set(3);
+  idle_gauge->set(1);
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  snapshot.counters_.push_back({5, counter});
+  snapshot.gauges_.push_back(gauge);
+  snapshot.gauges_.push_back(*idle_gauge);
+
+  // The first flush sends the names along with all of the values.
+  root_context_->onStatsDeltaUpdate(snapshot);
+  auto data = last_update();
+  auto update = proxy_wasm::null_plugin::parseStatDeltaResults(data);
+  ASSERT_EQ(3U, update.names.size());
+  EXPECT_EQ("delta_counter", update.names[0].name);
+  EXPECT_EQ("delta_gauge", update.names[1].name);
+  EXPECT_EQ("idle_gauge", update.names[2].name);
+  ASSERT_EQ(1U, update.counters.size());
+  EXPECT_EQ(update.names[0].id, update.counters[0].id);
+  EXPECT_EQ(5U, update.counters[0].value);
+  EXPECT_EQ(5U, update.counters[0].delta);
+  ASSERT_EQ(2U, update.gauges.size());
+  EXPECT_EQ(3U, update.gauges[0].value);
+  const uint32_t gauge_id = update.names[1].id;
+  const uint32_t idle_gauge_id = update.names[2].id;
+
+  // Nothing changed, so nothing is sent. Counters without a delta are not looked at, so a counter
+  // which is used but unchanged since the previous flush is not named yet.
+  snapshot.counters_[0].delta_ = 0;
+  late_counter.inc();
+  snapshot.counters_.push_back({0, late_counter});
+  root_context_->onStatsDeltaUpdate(snapshot);
+  EXPECT_EQ(data, last_update());
+
+  // Only the changed metrics are sent, by id, and the deleted gauge is removed.
+  gauge.set(4);
+  late_counter.inc();
+  snapshot.counters_[1].delta_ = 1;
+  snapshot.gauges_.pop_back();
+  idle_gauge.reset();
+  root_context_->onStatsDeltaUpdate(snapshot);
+  data = last_update();
+  update = proxy_wasm::null_plugin::parseStatDeltaResults(data);
+  ASSERT_EQ(1U, update.names.size());
+  EXPECT_EQ("late_counter", update.names[0].name);
+  ASSERT_EQ(1U, update.counters.size());
+  EXPECT_EQ(update.names[0].id, update.counters[0].id);
+  EXPECT_EQ(2U, update.counters[0].value);
+  EXPECT_EQ(1U, update.counters[0].delta);
+  ASSERT_EQ(1U, update.gauges.size());
+  EXPECT_EQ(gauge_id, update.gauges[0].id);
+  EXPECT_EQ(4U, update.gauges[0].value);
+  ASSERT_EQ(1U, update.removed.size());
+  EXPECT_EQ(idle_gauge_id, update.removed[0]);
+}
+
+TEST_P(WasmCommonContextTest, PluginVmStats) {
+  std::string code;
+  if (GetParam() != "null") {
+    code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(absl::StrCat(
+        "{{ test_rundir }}/test/extensions/common/wasm/test_data/test_context_cpp.wasm")));
+  } else {
+    // The name of the Null VM plugin.
+    code = "CommonWasmTestContextCpp";
+  }
+  EXPECT_FALSE(code.empty());
+
+  setup(code, "context", "empty");
+  setupContext();
+
+  const std::string prefix = absl::StrCat("wasm.wasm_vm.", GetParam(), ".plugin.plugin_name.");
+  auto find_histogram = [this](const std::string& name) {
+    Stats::StatNameManagedStorage storage(name, stats_store_.symbolTable());
+    return stats_store_.findHistogram(storage.statName()).has_value();
+  };
+  // Histograms are only created for the callbacks which are made.
+  EXPECT_FALSE(find_histogram(prefix + "on_done_us"));
+  context().onDestroy();
+  EXPECT_TRUE(find_histogram(prefix + "on_done_us"));
+  EXPECT_FALSE(find_histogram(prefix + "on_log_us"));
+
+  auto memory_bytes = TestUtility::findGauge(stats_store_, prefix + "memory_bytes");
+  ASSERT_NE(nullptr, memory_bytes);
+  if (GetParam() == "null") {
+    EXPECT_EQ(0U, memory_bytes->value());
+  } else {
+    EXPECT_EQ(wasm_->wasm()->wasm_vm()->getMemorySize(), memory_bytes->value());
+    EXPECT_EQ(1U, TestUtility::findCounter(stats_store_, prefix + "memory_grown")->value());
+  }
+}
+
+namespace {
+
+void appendUint32(std::string& s, uint32_t value) {
+  s.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::string serializeKeys(const std::vector<std::string>& keys) {
+  std::string s;
+  appendUint32(s, keys.size());
+  for (auto& k : keys) {
+    appendUint32(s, k.size());
+  }
+  for (auto& k : keys) {
+    s.append(k);
+    s.push_back('\0');
+  }
+  return s;
+}
+
+} // namespace
+
+TEST(WasmHeaderMapTest, SerializeHeaderMapValues) {
+  Http::TestRequestHeaderMapImpl headers{
+      {":path", "/"}, {"x-a", "1"}, {"x-b", ""}, {"authorization", "token"}};
+  const std::string keys = serializeKeys({":path", "x-missing", "x-b", "authorization"});
+  size_t result_size = 0;
+
+  EXPECT_EQ(WasmResult::BadArgument,
+            serializeHeaderMapValues(nullptr, keys, nullptr, 0, &result_size));
+  EXPECT_EQ(WasmResult::ParseFailure, serializeHeaderMapValues(&headers, keys.substr(0, 10),
+                                                               nullptr, 0, &result_size));
+
+  // The required size is returned when the buffer is too small.
+  EXPECT_EQ(WasmResult::ResultMismatch,
+            serializeHeaderMapValues(&headers, keys, nullptr, 0, &result_size));
+  EXPECT_EQ(5 * sizeof(uint32_t) + 2 + 1 + 6, result_size);
+
+  std::string buffer(result_size, 'x');
+  EXPECT_EQ(WasmResult::Ok,
+            serializeHeaderMapValues(&headers, keys, &buffer[0], buffer.size(), &result_size));
+  std::string expected;
+  appendUint32(expected, 4);
+  appendUint32(expected, 1);
+  appendUint32(expected, std::numeric_limits<uint32_t>::max());
+  appendUint32(expected, 0);
+  appendUint32(expected, 5);
+  expected.append(std::string("/\0\0token\0", 9));
+  EXPECT_EQ(expected, buffer);
+}
+
+TEST(WasmHeaderMapTest, ApplyHeaderMapMutations) {
+  Http::TestRequestHeaderMapImpl headers{{"x-a", "1"}, {"x-b", "2"}, {"x-c", "3"}};
+  std::string mutations;
+  appendUint32(mutations, 3);
+  // Replace x-a, add x-c and remove x-b.
+  for (uint32_t op : {0, 1, 2}) {
+    appendUint32(mutations, op);
+    appendUint32(mutations, 3);
+    appendUint32(mutations, op == 2 ? 0 : 1);
+  }
+  for (absl::string_view str : {"x-a", "9", "x-c", "4", "x-b", ""}) {
+    mutations.append(str.data(), str.size());
+    mutations.push_back('\0');
+  }
+  EXPECT_EQ(WasmResult::Ok, applyHeaderMapMutations(&headers, mutations));
+  EXPECT_EQ(headers, Http::TestRequestHeaderMapImpl({{"x-a", "9"}, {"x-c", "3"}, {"x-c", "4"}}));
+
+  // Truncated input is rejected without applying any of the mutations.
+  EXPECT_EQ(WasmResult::ParseFailure,
+            applyHeaderMapMutations(&headers, mutations.substr(0, mutations.size() - 1)));
+  EXPECT_EQ(headers, Http::TestRequestHeaderMapImpl({{"x-a", "9"}, {"x-c", "3"}, {"x-c", "4"}}));
+}
+
+TEST(WasmBufferTest, ScatterGather) {
+  Envoy::Buffer::OwnedImpl data;
+  data.appendSliceForTest("hello ");
+  data.appendSliceForTest("wasm ");
+  data.appendSliceForTest("world");
+  Extensions::Common::Wasm::Buffer buffer;
+  buffer.set(&data);
+
+  size_t result_size = 0;
+  EXPECT_EQ(WasmResult::ResultMismatch, buffer.getSliceSizes(nullptr, 0, &result_size));
+  EXPECT_EQ(4 * sizeof(uint32_t), result_size);
+  uint32_t sizes[4];
+  EXPECT_EQ(WasmResult::Ok,
+            buffer.getSliceSizes(reinterpret_cast<char*>(sizes), sizeof(sizes), &result_size));
+  EXPECT_THAT(sizes, testing::ElementsAre(3U, 6U, 5U, 5U));
+
+  // Copy a window spanning slices, then stream the rest in chunks which are clamped at the end.
+  char chunk[4];
+  EXPECT_EQ(4U, buffer.copyOut(4, 4, chunk));
+  EXPECT_EQ("o wa", absl::string_view(chunk, 4));
+  std::string streamed;
+  for (size_t start = 0, copied; (copied = buffer.copyOut(start, sizeof(chunk), chunk)) > 0;
+       start += copied) {
+    streamed.append(chunk, copied);
+  }
+  EXPECT_EQ("hello wasm world", streamed);
+  EXPECT_EQ(0U, buffer.copyOut(16, 4, chunk));
+
+  // Contiguous data is reported as a single slice.
+  buffer.set("contiguous");
+  EXPECT_EQ(WasmResult::Ok,
+            buffer.getSliceSizes(reinterpret_cast<char*>(sizes), sizeof(sizes), &result_size));
+  EXPECT_EQ(2 * sizeof(uint32_t), result_size);
+  EXPECT_EQ(1U, sizes[0]);
+  EXPECT_EQ(10U, sizes[1]);
+  EXPECT_EQ(3U, buffer.copyOut(7, 4, chunk));
+  EXPECT_EQ("ous", absl::string_view(chunk, 3));
+}
+
+TEST(WasmSharedDataTest, BatchedCas) {
+  SharedData shared_data;
+  std::pair<std::string, uint32_t> data;
+  EXPECT_EQ(WasmResult::NotFound, shared_data.get("vm", "a", &data));
+  EXPECT_EQ(WasmResult::Ok, shared_data.set("vm", "a", "1", 0));
+  EXPECT_EQ(WasmResult::Ok, shared_data.get("vm", "a", &data));
+  const uint32_t cas = data.second;
+  // Keys are scoped by vm_id.
+  EXPECT_EQ(WasmResult::NotFound, shared_data.get("other_vm", "a", &data));
+
+  // A batch is rejected as a whole if any cas is stale.
+  std::string updates;
+  appendUint32(updates, 2);
+  for (uint32_t update_cas : {0U, cas + 1}) {
+    appendUint32(updates, 1);
+    appendUint32(updates, 1);
+    appendUint32(updates, update_cas);
+  }
+  for (absl::string_view str : {"b", "2", "a", "3"}) {
+    updates.append(str.data(), str.size());
+    updates.push_back('\0');
+  }
+  EXPECT_EQ(WasmResult::CasMismatch, applySharedDataUpdates(shared_data, "vm", updates));
+  EXPECT_EQ(WasmResult::NotFound, shared_data.get("vm", "b", &data));
+
+  // Retry with the current cas for "a".
+  memcpy(&updates[6 * sizeof(uint32_t)], &cas, sizeof(cas));
+  EXPECT_EQ(WasmResult::Ok, applySharedDataUpdates(shared_data, "vm", updates));
+  EXPECT_EQ(WasmResult::ParseFailure,
+            applySharedDataUpdates(shared_data, "vm", updates.substr(0, updates.size() - 1)));
+
+  const std::string keys = serializeKeys({"a", "missing", "b"});
+  size_t result_size = 0;
+  EXPECT_EQ(WasmResult::ResultMismatch,
+            serializeSharedDataValues(shared_data, "vm", keys, nullptr, 0, &result_size));
+  std::string buffer(result_size, 'x');
+  EXPECT_EQ(WasmResult::Ok, serializeSharedDataValues(shared_data, "vm", keys, &buffer[0],
+                                                      buffer.size(), &result_size));
+  std::string expected;
+  appendUint32(expected, 3);
+  appendUint32(expected, 1);
+  appendUint32(expected, cas + 1);
+  appendUint32(expected, std::numeric_limits<uint32_t>::max());
+  appendUint32(expected, 0);
+  appendUint32(expected, 1);
+  appendUint32(expected, 1);
+  expected.append(std::string("3\0002\0", 4));
+  EXPECT_EQ(expected, buffer);
+}
+
+TEST(WasmSharedDataTest, Watch) {
+  SharedData shared_data;
+  NiceMock<Event::MockDispatcher> dispatcher;
+  std::vector<Event::PostCb> posted;
+  ON_CALL(dispatcher, post(_)).WillByDefault(Invoke([&posted](Event::PostCb cb) {
+    posted.push_back(std::move(cb));
+  }));
+  int changes = 0;
+  SharedData::WatchHandlePtr handle =
+      shared_data.watch("vm", "a", dispatcher, [&changes]() { changes++; });
+  EXPECT_EQ(WasmResult::Ok, shared_data.set("vm", "b", "1", 0));
+  EXPECT_EQ(0, posted.size());
+
+  // Sets made before the notification runs are coalesced into it.
+  EXPECT_EQ(WasmResult::Ok, shared_data.set("vm", "a", "1", 0));
+  EXPECT_EQ(WasmResult::Ok, shared_data.set("vm", "a", "2", 0));
+  ASSERT_EQ(1, posted.size());
+  posted[0]();
+  EXPECT_EQ(1, changes);
+  EXPECT_EQ(WasmResult::Ok, shared_data.set("vm", "a", "3", 0));
+  ASSERT_EQ(2, posted.size());
+  posted[1]();
+  EXPECT_EQ(2, changes);
+
+  // The watch is removed with its handle, along with the notification already posted.
+  EXPECT_EQ(WasmResult::Ok, shared_data.set("vm", "a", "4", 0));
+  ASSERT_EQ(3, posted.size());
+  handle.reset();
+  EXPECT_EQ(WasmResult::Ok, shared_data.set("vm", "a", "5", 0));
+  EXPECT_EQ(3, posted.size());
+  posted[2]();
+  EXPECT_EQ(2, changes);
+}
+
+TEST(WasmPatternMatcherTest, LiteralsAcrossSlices) {
+  std::string error;
+  auto matcher = MultiPatternMatcher::create(
+      {{false, "he"}, {false, "she"}, {false, "hers"}, {false, "his"}}, false, &error);
+  ASSERT_NE(nullptr, matcher);
+
+  Envoy::Buffer::OwnedImpl data;
+  data.appendSliceForTest("ush");
+  data.appendSliceForTest("ers his");
+  Extensions::Common::Wasm::Buffer buffer;
+  buffer.set(&data);
+  std::vector<MultiPatternMatcher::Match> matches;
+  matcher->match(buffer.slices(), 100, &matches);
+  // Overlapping matches and matches spanning slices are reported in order of their end.
+  std::vector<std::tuple<uint32_t, uint64_t, uint64_t>> found;
+  for (auto& m : matches) {
+    found.emplace_back(m.pattern, m.offset, m.length);
+  }
+  EXPECT_THAT(found, testing::ElementsAre(std::make_tuple(1U, 1U, 3U), std::make_tuple(0U, 2U, 2U),
+                                          std::make_tuple(2U, 2U, 4U),
+                                          std::make_tuple(3U, 7U, 3U)));
+
+  matches.clear();
+  matcher->match(buffer.slices(), 2, &matches);
+  EXPECT_EQ(2U, matches.size());
+
+  EXPECT_EQ(nullptr, MultiPatternMatcher::create({{false, ""}}, false, &error));
+}
+
+TEST(WasmPatternMatcherTest, CaseInsensitiveAndRegexes) {
+  std::string error;
+  auto matcher = MultiPatternMatcher::create(
+      {{false, "SeLeCt"}, {true, "union\\s+all"}, {true, "drop"}}, true, &error);
+  ASSERT_NE(nullptr, matcher);
+  EXPECT_TRUE(matcher->hasRegexes());
+
+  Extensions::Common::Wasm::Buffer buffer;
+  buffer.set("1 select 2 UNION  All");
+  std::vector<MultiPatternMatcher::Match> matches;
+  matcher->match(buffer.slices(), 10, &matches);
+  ASSERT_EQ(2U, matches.size());
+  EXPECT_EQ(0U, matches[0].pattern);
+  EXPECT_EQ(2U, matches[0].offset);
+  EXPECT_EQ(6U, matches[0].length);
+  EXPECT_EQ(1U, matches[1].pattern);
+  EXPECT_EQ(11U, matches[1].offset);
+  EXPECT_EQ(10U, matches[1].length);
+
+  EXPECT_EQ(nullptr, MultiPatternMatcher::create({{true, "("}}, false, &error));
+  EXPECT_THAT(error, testing::HasSubstr("invalid regex pattern 0"));
+}
+
+// A literal using every byte value makes 257 byte classes, and each of its bytes a state besides
+// the root.
+TEST(WasmPatternMatcherTest, MemoryBudget) {
+  const uint64_t max_states = MultiPatternMatcher::MaxAutomatonBytes / (257 * sizeof(int32_t));
+  std::string literal;
+  while (literal.size() + 1 < max_states) {
+    literal.push_back(static_cast<char>(literal.size()));
+  }
+  std::string error;
+  EXPECT_NE(nullptr, MultiPatternMatcher::create({{false, literal}}, false, &error));
+  EXPECT_EQ(nullptr, MultiPatternMatcher::create({{false, literal}, {false, "x"}}, false, &error));
+  EXPECT_EQ("literal patterns exceed the memory budget", error);
+}
+
 } // namespace Wasm
 } // namespace Common
 } // namespace Extensions
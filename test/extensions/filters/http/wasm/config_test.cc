@@ -15,6 +15,7 @@
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/environment.h"
 
+#include "absl/synchronization/mutex.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -194,6 +195,205 @@ TEST_P(WasmFilterConfigTest, YamlLoadInlineWasm) {
   cb(filter_callback);
 }
 
+TEST_P(WasmFilterConfigTest, YamlLoadInlineWasmWithContextPool) {
+  const std::string code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/test_cpp.wasm"));
+  EXPECT_FALSE(code.empty());
+  const std::string yaml = absl::StrCat(R"EOF(
+  context_pool_size: 2
+  config:
+    vm_config:
+      runtime: "envoy.wasm.runtime.)EOF",
+                                        GetParam(), R"EOF("
+      code:
+        local: { inline_bytes: ")EOF",
+                                        Base64::encode(code.data(), code.size()), R"EOF(" }
+                                        )EOF");
+  envoy::extensions::filters::http::wasm::v3::Wasm proto_config;
+  TestUtility::loadFromYaml(yaml, proto_config);
+  WasmFilterConfig factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context_);
+  EXPECT_CALL(init_watcher_, ready());
+  context_.initManager().initialize(init_watcher_);
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initialized);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_)).Times(3);
+  EXPECT_CALL(filter_callback, addAccessLogHandler(_)).Times(3);
+  // The mock dispatcher runs posted callbacks inline, so the pool is refilled after each stream.
+  cb(filter_callback);
+  cb(filter_callback);
+  cb(filter_callback);
+  EXPECT_EQ(3U, stats_store_.counter("stats.wasm.context_pool_hits").value());
+  EXPECT_EQ(0U, stats_store_.counter("stats.wasm.context_pool_misses").value());
+}
+
+TEST_P(WasmFilterConfigTest, YamlLoadInlineWasmInBackground) {
+  const std::string code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/test_cpp.wasm"));
+  EXPECT_FALSE(code.empty());
+  const std::string yaml = absl::StrCat(R"EOF(
+  config:
+    vm_config:
+      runtime: "envoy.wasm.runtime.)EOF",
+                                        GetParam(), R"EOF("
+      compile_in_background: true
+      code:
+        local: { inline_bytes: ")EOF",
+                                        Base64::encode(code.data(), code.size()), R"EOF(" }
+                                        )EOF");
+  envoy::extensions::filters::http::wasm::v3::Wasm proto_config;
+  TestUtility::loadFromYaml(yaml, proto_config);
+  // Capture what the background thread posts back to the main thread and run it on this thread.
+  absl::Mutex mutex;
+  std::vector<Event::PostCb> posted;
+  EXPECT_CALL(dispatcher_, post(_)).WillRepeatedly(Invoke([&](Event::PostCb cb) {
+    absl::MutexLock lock(&mutex);
+    posted.push_back(cb);
+  }));
+  WasmFilterConfig factory;
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context_);
+  context_.initManager().initialize(init_watcher_);
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initializing);
+  Event::PostCb complete;
+  {
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(
+        +[](std::vector<Event::PostCb>* posted) { return !posted->empty(); }, &posted));
+    complete = posted.front();
+  }
+  EXPECT_CALL(init_watcher_, ready());
+  complete();
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initialized);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  EXPECT_CALL(filter_callback, addAccessLogHandler(_));
+  cb(filter_callback);
+}
+
+// Destroying a filter config, e.g. when its listener is drained, while its code is being compiled
+// in the background cancels the creation of its VM. The compilation of the same code for another
+// config is not affected.
+TEST_P(WasmFilterConfigTest, YamlLoadInlineWasmInBackgroundDestroyedBeforeCompiled) {
+  const std::string code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/test_cpp.wasm"));
+  EXPECT_FALSE(code.empty());
+  const std::string yaml = absl::StrCat(R"EOF(
+  config:
+    vm_config:
+      runtime: "envoy.wasm.runtime.)EOF",
+                                        GetParam(), R"EOF("
+      compile_in_background: true
+      code:
+        local: { inline_bytes: ")EOF",
+                                        Base64::encode(code.data(), code.size()), R"EOF(" }
+                                        )EOF");
+  envoy::extensions::filters::http::wasm::v3::Wasm proto_config;
+  TestUtility::loadFromYaml(yaml, proto_config);
+  absl::Mutex mutex;
+  bool started = false;
+  bool released = false;
+  std::vector<Event::PostCb> posted;
+  // Holds the first compilation until the first config is destroyed.
+  Common::Wasm::setBackgroundCompileHookForTesting([&]() {
+    absl::MutexLock lock(&mutex);
+    started = true;
+    mutex.Await(absl::Condition(&released));
+  });
+  EXPECT_CALL(dispatcher_, post(_)).WillRepeatedly(Invoke([&](Event::PostCb cb) {
+    absl::MutexLock lock(&mutex);
+    posted.push_back(cb);
+  }));
+  WasmFilterConfig factory;
+  Http::FilterFactoryCb destroyed_cb =
+      factory.createFilterFactoryFromProto(proto_config, "stats", context_);
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context_);
+  {
+    absl::MutexLock lock(&mutex);
+    mutex.Await(absl::Condition(&started));
+  }
+  destroyed_cb = nullptr;
+  Event::PostCb complete;
+  {
+    absl::MutexLock lock(&mutex);
+    released = true;
+    mutex.Await(absl::Condition(
+        +[](std::vector<Event::PostCb>* posted) { return !posted->empty(); }, &posted));
+    complete = posted.front();
+  }
+  Common::Wasm::setBackgroundCompileHookForTesting(nullptr);
+  // The init target of the destroyed config is gone, so only the other one holds the
+  // initialization.
+  context_.initManager().initialize(init_watcher_);
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initializing);
+  EXPECT_CALL(init_watcher_, ready());
+  complete();
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initialized);
+  {
+    absl::MutexLock lock(&mutex);
+    EXPECT_EQ(1U, posted.size());
+  }
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  EXPECT_CALL(filter_callback, addAccessLogHandler(_));
+  cb(filter_callback);
+}
+
+// Destroying a filter config once its code is compiled in the background, but before the compiled
+// VM is handed to the main thread, leaves the VM to the compiler thread, which destroys it and
+// moves on to the next compilation.
+TEST_P(WasmFilterConfigTest, YamlLoadInlineWasmInBackgroundDestroyedWhileHandedOff) {
+  const std::string code = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/filters/http/wasm/test_data/test_cpp.wasm"));
+  EXPECT_FALSE(code.empty());
+  const std::string yaml = absl::StrCat(R"EOF(
+  config:
+    vm_config:
+      runtime: "envoy.wasm.runtime.)EOF",
+                                        GetParam(), R"EOF("
+      compile_in_background: true
+      code:
+        local: { inline_bytes: ")EOF",
+                                        Base64::encode(code.data(), code.size()), R"EOF(" }
+                                        )EOF");
+  envoy::extensions::filters::http::wasm::v3::Wasm proto_config;
+  TestUtility::loadFromYaml(yaml, proto_config);
+  struct Posted {
+    bool ready() const { return callbacks_.size() >= awaited_; }
+    std::vector<Event::PostCb> callbacks_;
+    size_t awaited_{0};
+  };
+  absl::Mutex mutex;
+  Posted posted;
+  EXPECT_CALL(dispatcher_, post(_)).WillRepeatedly(Invoke([&](Event::PostCb cb) {
+    absl::MutexLock lock(&mutex);
+    posted.callbacks_.push_back(cb);
+  }));
+  auto await_posted = [&](size_t count) {
+    absl::MutexLock lock(&mutex);
+    posted.awaited_ = count;
+    mutex.Await(absl::Condition(&posted, &Posted::ready));
+    return posted.callbacks_.back();
+  };
+  WasmFilterConfig factory;
+  Http::FilterFactoryCb destroyed_cb =
+      factory.createFilterFactoryFromProto(proto_config, "stats", context_);
+  Event::PostCb cancelled = await_posted(1);
+  destroyed_cb = nullptr;
+  // The compiler thread no longer waits for the VM to be taken.
+  Http::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, "stats", context_);
+  Event::PostCb complete = await_posted(2);
+  cancelled();
+  context_.initManager().initialize(init_watcher_);
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initializing);
+  EXPECT_CALL(init_watcher_, ready());
+  complete();
+  EXPECT_EQ(context_.initManager().state(), Init::Manager::State::Initialized);
+  Http::MockFilterChainFactoryCallbacks filter_callback;
+  EXPECT_CALL(filter_callback, addStreamFilter(_));
+  EXPECT_CALL(filter_callback, addAccessLogHandler(_));
+  cb(filter_callback);
+}
+
 TEST_P(WasmFilterConfigTest, YamlLoadInlineBadCode) {
   const std::string yaml = absl::StrCat(R"EOF(
   config:
@@ -0,0 +1,336 @@
+#include <chrono>
+#include <functional>
+
+#include "envoy/common/exception.h"
+#include "envoy/config/core/v3/address.pb.h"
+#include "envoy/extensions/network/socket_interface/io_uring/v3alpha/io_uring_socket_interface.pb.h"
+#include "envoy/registry/registry.h"
+
+#include "common/network/address_impl.h"
+#include "common/network/resolver_impl.h"
+#include "common/network/utility.h"
+
+#include "extensions/network/socket_interface/io_uring/config.h"
+#include "extensions/network/socket_interface/io_uring/io_uring_socket_handle.h"
+#include "extensions/network/socket_interface/io_uring/io_uring_worker.h"
+
+#include "test/mocks/server/instance.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace SocketInterfaces {
+namespace IoUring {
+namespace {
+
+class TestWorkerProvider : public IoUringWorkerProvider {
+public:
+  IoUringWorker* currentWorker() const override { return worker_; }
+
+  IoUringWorker* worker_{nullptr};
+};
+
+class IoUringSocketHandleTest : public testing::Test {
+protected:
+  IoUringSocketHandleTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  void SetUp() override {
+    createWorker(8);
+    if (worker_ == nullptr) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+  }
+
+  void createWorker(uint32_t read_buffers) {
+    worker_ = IoUringWorker::create(*dispatcher_, {64, 4096, read_buffers});
+    workers_.worker_ = worker_.get();
+  }
+
+  void TearDown() override {
+    accepted_.reset();
+    client_.reset();
+    listener_.reset();
+    worker_.reset();
+  }
+
+  std::unique_ptr<IoUringSocketHandle> newSocket() {
+    return std::make_unique<IoUringSocketHandle>(
+        workers_, socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0), false, false);
+  }
+
+  void runUntil(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition() && std::chrono::steady_clock::now() < deadline) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+    ASSERT_TRUE(condition());
+  }
+
+  // Connects client_ to listener_ and accepts the connection into accepted_.
+  void connect() {
+    listener_ = newSocket();
+    ASSERT_EQ(0, listener_->bind(Network::Utility::getCanonicalIpv4LoopbackAddress()).rc_);
+    ASSERT_EQ(0, listener_->listen(16).rc_);
+    listen_event_ = listener_->createFileEvent(
+        *dispatcher_,
+        [this](uint32_t) {
+          while (Network::IoHandlePtr accepted = listener_->accept(nullptr, nullptr)) {
+            accepted_ = std::move(accepted);
+          }
+        },
+        Event::FileTriggerType::Level, Event::FileReadyType::Read);
+
+    client_ = newSocket();
+    client_event_ = client_->createFileEvent(
+        *dispatcher_, [this](uint32_t events) { client_events_ |= events; },
+        Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+    const Api::SysCallIntResult result = client_->connect(listener_->localAddress());
+    ASSERT_TRUE(result.rc_ == 0 || result.errno_ == SOCKET_ERROR_IN_PROGRESS);
+    runUntil([this]() {
+      return accepted_ != nullptr && (client_events_ & Event::FileReadyType::Write);
+    });
+
+    accepted_event_ = accepted_->createFileEvent(
+        *dispatcher_, [this](uint32_t events) { accepted_events_ |= events; },
+        Event::FileTriggerType::Edge,
+        Event::FileReadyType::Read | Event::FileReadyType::Write | Event::FileReadyType::Closed);
+  }
+
+  // Writes data to handle, running the event loop whenever the socket's write buffer is full.
+  void writeAll(Network::IoHandle& handle, const std::string& data) {
+    uint64_t written = 0;
+    runUntil([&]() {
+      while (written < data.size()) {
+        Buffer::RawSlice slice{const_cast<char*>(data.data()) + written, data.size() - written};
+        Api::IoCallUint64Result result = handle.writev(&slice, 1);
+        if (!result.ok()) {
+          return false;
+        }
+        written += result.rc_;
+      }
+      return true;
+    });
+  }
+
+  // Reads from handle at most max_read bytes at a time until length bytes have been read.
+  std::string readAll(Network::IoHandle& handle, uint64_t length, uint64_t max_read) {
+    std::string received;
+    runUntil([&]() {
+      while (received.size() < length) {
+        std::string data(max_read, '\0');
+        Buffer::RawSlice slice{data.data(), data.size()};
+        Api::IoCallUint64Result result = handle.readv(max_read, &slice, 1);
+        if (!result.ok()) {
+          EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+          return false;
+        }
+        EXPECT_LE(result.rc_, max_read);
+        received.append(data.data(), result.rc_);
+      }
+      return true;
+    });
+    return received;
+  }
+
+  std::string read(Network::IoHandle& handle, uint64_t length) {
+    std::string data(length, '\0');
+    Buffer::RawSlice slice{data.data(), data.size()};
+    Api::IoCallUint64Result result = handle.readv(length, &slice, 1);
+    EXPECT_TRUE(result.ok());
+    data.resize(result.rc_);
+    return data;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::shared_ptr<IoUringWorker> worker_;
+  TestWorkerProvider workers_;
+  std::unique_ptr<IoUringSocketHandle> listener_;
+  std::unique_ptr<IoUringSocketHandle> client_;
+  Network::IoHandlePtr accepted_;
+  Event::FileEventPtr listen_event_;
+  Event::FileEventPtr client_event_;
+  Event::FileEventPtr accepted_event_;
+  uint32_t client_events_{0};
+  uint32_t accepted_events_{0};
+};
+
+TEST_F(IoUringSocketHandleTest, ReadWriteAndPeek) {
+  connect();
+
+  // Nothing has been read yet.
+  std::string data(16, '\0');
+  Buffer::RawSlice slice{data.data(), data.size()};
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again,
+            accepted_->readv(data.size(), &slice, 1).err_->getErrorCode());
+
+  std::string hello = "hello";
+  Buffer::RawSlice hello_slice{hello.data(), hello.size()};
+  EXPECT_EQ(5, client_->writev(&hello_slice, 1).rc_);
+  runUntil([this]() { return accepted_events_ & Event::FileReadyType::Read; });
+
+  char peeked[3];
+  EXPECT_EQ(3, accepted_->recv(peeked, sizeof(peeked), MSG_PEEK).rc_);
+  EXPECT_EQ("hel", absl::string_view(peeked, sizeof(peeked)));
+  EXPECT_EQ("hello", read(*accepted_, 16));
+
+  // Replies are read into provided buffers, split across slices.
+  std::string world = "world";
+  Buffer::RawSlice world_slice{world.data(), world.size()};
+  client_events_ = 0;
+  EXPECT_EQ(5, accepted_->writev(&world_slice, 1).rc_);
+  runUntil([this]() { return client_events_ & Event::FileReadyType::Read; });
+  std::string first(2, '\0');
+  std::string second(8, '\0');
+  Buffer::RawSlice slices[2] = {{first.data(), first.size()}, {second.data(), second.size()}};
+  EXPECT_EQ(5, client_->readv(16, slices, 2).rc_);
+  EXPECT_EQ("wo", first);
+  EXPECT_EQ("rld", second.substr(0, 3));
+}
+
+TEST_F(IoUringSocketHandleTest, ShutdownAfterPendingWrite) {
+  connect();
+
+  const std::string payload(64 * 1024, 'a');
+  Buffer::RawSlice slice{const_cast<char*>(payload.data()), payload.size()};
+  EXPECT_EQ(payload.size(), accepted_->writev(&slice, 1).rc_);
+  // The FIN is sent once the payload has been written.
+  EXPECT_EQ(0, accepted_->shutdown(SHUT_WR).rc_);
+
+  std::string received;
+  bool end_of_stream = false;
+  runUntil([&]() {
+    for (;;) {
+      std::string data(16384, '\0');
+      Buffer::RawSlice read_slice{data.data(), data.size()};
+      Api::IoCallUint64Result result = client_->readv(data.size(), &read_slice, 1);
+      if (!result.ok()) {
+        return false;
+      }
+      if (result.rc_ == 0) {
+        end_of_stream = true;
+        return true;
+      }
+      received.append(data.data(), result.rc_);
+    }
+  });
+  EXPECT_TRUE(end_of_stream);
+  EXPECT_EQ(payload, received);
+
+  // Closing hands the sockets to the worker, which closes them once their requests complete.
+  EXPECT_TRUE(accepted_->close().ok());
+  EXPECT_FALSE(accepted_->isOpen());
+  EXPECT_TRUE(client_->close().ok());
+}
+
+// Reads which are shorter than the completed reads consume them partially and in order.
+TEST_F(IoUringSocketHandleTest, ShortReads) {
+  connect();
+
+  std::string payload;
+  for (int i = 0; payload.size() < 3 * 4096; i++) {
+    absl::StrAppend(&payload, i, ",");
+  }
+  writeAll(*client_, payload);
+  EXPECT_EQ(payload, readAll(*accepted_, payload.size(), 100));
+
+  // A read into slices which are smaller than the data available fills them and leaves the rest.
+  writeAll(*client_, "0123456789");
+  runUntil([this]() { return accepted_->bytesAvailable().value_or(0) == 10; });
+  EXPECT_EQ("0123", read(*accepted_, 4));
+  EXPECT_EQ(6, accepted_->bytesAvailable().value_or(0));
+  EXPECT_EQ("456789", read(*accepted_, 16));
+  EXPECT_EQ(0, accepted_->bytesAvailable().value_or(0));
+}
+
+// Closing a socket with a read in flight cancels the read, after which the worker closes the file
+// descriptor and the peer sees the end of the stream.
+TEST_F(IoUringSocketHandleTest, CloseCancelsPendingRead) {
+  connect();
+
+  // The read submitted when the file event was created has not completed.
+  std::string data(16, '\0');
+  Buffer::RawSlice slice{data.data(), data.size()};
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again,
+            accepted_->readv(data.size(), &slice, 1).err_->getErrorCode());
+
+  EXPECT_TRUE(accepted_->close().ok());
+  EXPECT_FALSE(accepted_->isOpen());
+  accepted_event_.reset();
+
+  bool end_of_stream = false;
+  runUntil([&]() {
+    Api::IoCallUint64Result result = client_->readv(data.size(), &slice, 1);
+    end_of_stream = result.ok() && result.rc_ == 0;
+    return end_of_stream;
+  });
+  EXPECT_TRUE(end_of_stream);
+}
+
+// Reads complete into buffers of their own while every provided buffer is held by unconsumed data.
+TEST_F(IoUringSocketHandleTest, ProvidedBuffersExhausted) {
+  createWorker(1);
+  ASSERT_NE(nullptr, worker_);
+  connect();
+
+  // Each write is read separately, so that the unconsumed reads need more than one buffer.
+  std::string payload;
+  for (uint32_t i = 0; i < IoUringSocket::MaxReadBuffers; i++) {
+    const std::string chunk(1000, static_cast<char>('a' + i));
+    const uint64_t expected = payload.size() + chunk.size();
+    writeAll(*client_, chunk);
+    runUntil([&]() { return accepted_->bytesAvailable().value_or(0) == expected; });
+    payload.append(chunk);
+  }
+  EXPECT_EQ(payload, readAll(*accepted_, payload.size(), 16384));
+
+  // The provided buffer is given back once consumed, and used by the following reads.
+  writeAll(*client_, "hello");
+  EXPECT_EQ("hello", readAll(*accepted_, 5, 16));
+}
+
+TEST(IoUringSocketInterfaceTest, ReadBuffersLimit) {
+  auto* factory =
+      Registry::FactoryRegistry<Server::Configuration::BootstrapExtensionFactory>::getFactory(
+          "envoy.network.socket_interface.io_uring");
+  ASSERT_NE(nullptr, factory);
+  testing::NiceMock<Server::Configuration::MockServerFactoryContext> context;
+
+  envoy::extensions::network::socket_interface::io_uring::v3alpha::IoUringSocketInterface config;
+  config.mutable_read_buffer_size()->set_value(1024 * 1024);
+  config.mutable_read_buffers()->set_value(128);
+  EXPECT_THROW_WITH_MESSAGE(factory->createBootstrapExtension(config, context), EnvoyException,
+                            "io_uring socket interface: read_buffer_size * read_buffers is "
+                            "134217728 bytes, more than the 67108864 bytes allowed per worker");
+
+  config.mutable_read_buffers()->set_value(64);
+  EXPECT_NE(nullptr, factory->createBootstrapExtension(config, context));
+}
+
+TEST(IoUringResolverTest, ResolvesToIoUringSocketInterface) {
+  envoy::config::core::v3::SocketAddress socket_address;
+  socket_address.set_address("127.0.0.1");
+  socket_address.set_port_value(10000);
+  socket_address.set_resolver_name("envoy.network.resolvers.io_uring");
+  Network::Address::InstanceConstSharedPtr address =
+      Network::Address::resolveProtoSocketAddress(socket_address);
+  EXPECT_EQ("127.0.0.1:10000", address->asString());
+  EXPECT_EQ(Network::socketInterface("envoy.network.socket_interface.io_uring"),
+            &address->socketInterface());
+
+  socket_address.set_address("::1");
+  address = Network::Address::resolveProtoSocketAddress(socket_address);
+  EXPECT_EQ("[::1]:10000", address->asString());
+  EXPECT_EQ(Network::socketInterface("envoy.network.socket_interface.io_uring"),
+            &address->socketInterface());
+}
+
+} // namespace
+} // namespace IoUring
+} // namespace SocketInterfaces
+} // namespace Extensions
+} // namespace Envoy
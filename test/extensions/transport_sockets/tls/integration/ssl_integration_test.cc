@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 
+#include "envoy/common/platform.h"
 #include "envoy/config/bootstrap/v3/bootstrap.pb.h"
 #include "envoy/config/core/v3/address.pb.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -11,6 +12,7 @@
 #include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
 #include "envoy/extensions/transport_sockets/tap/v3/tap.pb.h"
 #include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
 
 #include "common/event/dispatcher_impl.h"
 #include "common/network/connection_impl.h"
@@ -168,6 +170,71 @@ TEST_P(SslIntegrationTest, RouterDownstreamDisconnectBeforeResponseComplete) {
   checkStats();
 }
 
+#ifdef __linux__
+namespace {
+
+// Whether the kernel lets a TCP connection switch to the TLS upper layer protocol, which kernel TLS
+// offload is built on. The protocol can only be set on a connected socket.
+bool kernelSupportsTlsUlp(Network::Address::IpVersion version) {
+  const Network::Address::InstanceConstSharedPtr address =
+      Network::Utility::parseInternetAddress(Network::Test::getLoopbackAddressString(version), 0);
+  const int domain = version == Network::Address::IpVersion::v4 ? AF_INET : AF_INET6;
+  const int listener = ::socket(domain, SOCK_STREAM, 0);
+  const int client = ::socket(domain, SOCK_STREAM, 0);
+  sockaddr_storage listener_address;
+  socklen_t listener_address_length = sizeof(listener_address);
+  bool supported = false;
+  if (listener >= 0 && client >= 0 &&
+      ::bind(listener, address->sockAddr(), address->sockAddrLen()) == 0 &&
+      ::listen(listener, 1) == 0 &&
+      ::getsockname(listener, reinterpret_cast<sockaddr*>(&listener_address),
+                    &listener_address_length) == 0 &&
+      ::connect(client, reinterpret_cast<sockaddr*>(&listener_address), listener_address_length) ==
+          0) {
+    static const char ulp[] = "tls";
+    supported = ::setsockopt(client, IPPROTO_TCP, 31 /* TCP_ULP */, ulp, sizeof(ulp)) == 0;
+  }
+  if (client >= 0) {
+    ::close(client);
+  }
+  if (listener >= 0) {
+    ::close(listener);
+  }
+  return supported;
+}
+
+} // namespace
+
+// With a TLS 1.2 AES-GCM connection, the downstream connection is offloaded to the kernel and
+// requests and responses still flow.
+TEST_P(SslIntegrationTest, RouterRequestAndResponseWithKernelTlsOffload) {
+  if (!kernelSupportsTlsUlp(version_)) {
+    GTEST_SKIP() << "the kernel does not support the TLS upper layer protocol";
+  }
+  config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+    auto* transport_socket = bootstrap.mutable_static_resources()
+                                 ->mutable_listeners(0)
+                                 ->mutable_filter_chains(0)
+                                 ->mutable_transport_socket();
+    envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+    transport_socket->typed_config().UnpackTo(&tls_context);
+    tls_context.mutable_common_tls_context()->set_kernel_tls_offload(true);
+    transport_socket->mutable_typed_config()->PackFrom(tls_context);
+  });
+  ConnectionCreationFunction creator = [&]() -> Network::ClientConnectionPtr {
+    return makeSslClientConnection(
+        ClientSslTransportOptions()
+            .setTlsVersion(envoy::extensions::transport_sockets::tls::v3::TlsParameters::TLSv1_2)
+            .setCipherSuites({"ECDHE-RSA-AES128-GCM-SHA256"}));
+  };
+  testRouterRequestAndResponseWithBody(1024 * 1024, 512 * 1024, false, false, &creator);
+  checkStats();
+  EXPECT_EQ(1, test_server_->counter(listenerStatPrefix("ssl.kernel_tls_offload"))->value());
+  EXPECT_EQ(0, test_server_->counter(listenerStatPrefix("ssl.kernel_tls_offload_unsupported"))
+                   ->value());
+}
+#endif
+
 // This test must be here vs integration_admin_test so that it tests a server with loaded certs.
 TEST_P(SslIntegrationTest, AdminCertEndpoint) {
   initialize();
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/transport_sockets/tls/ktls.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/io_handle.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#ifdef __linux__
+#include <linux/tls.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#ifdef __linux__
+class KernelTlsReadTest : public testing::Test {
+public:
+  KernelTlsReadTest() { ON_CALL(io_handle_, fdDoNotUse()).WillByDefault(Return(42)); }
+
+  // Makes the next recvmsg() return data, along with a TLS_GET_RECORD_TYPE control message at the
+  // given level if record_type is set, as the kernel does for records other than application data.
+  void expectRecord(std::string data, absl::optional<uint8_t> record_type, int level = SOL_TLS) {
+    EXPECT_CALL(os_sys_calls_, recvmsg(42, _, 0))
+        .WillOnce(Invoke([=](os_fd_t, msghdr* msg, int) -> Api::SysCallSizeResult {
+          size_t copied = 0;
+          for (size_t i = 0; i < msg->msg_iovlen && copied < data.size(); i++) {
+            const size_t length = std::min(msg->msg_iov[i].iov_len, data.size() - copied);
+            memcpy(msg->msg_iov[i].iov_base, data.data() + copied, length);
+            copied += length;
+          }
+          if (record_type.has_value()) {
+            EXPECT_GE(msg->msg_controllen, CMSG_SPACE(sizeof(uint8_t)));
+            cmsghdr* cmsg = CMSG_FIRSTHDR(msg);
+            cmsg->cmsg_level = level;
+            cmsg->cmsg_type = TLS_GET_RECORD_TYPE;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+            *CMSG_DATA(cmsg) = record_type.value();
+            msg->msg_controllen = CMSG_SPACE(sizeof(uint8_t));
+          } else {
+            msg->msg_controllen = 0;
+          }
+          return {static_cast<ssize_t>(copied), 0};
+        }));
+  }
+
+  Api::SysCallSizeResult read() { return KernelTls::read(io_handle_, buffer_, 16384, type_); }
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<Network::MockIoHandle> io_handle_;
+  Buffer::OwnedImpl buffer_;
+  KernelTls::RecordType type_{KernelTls::RecordType::Other};
+};
+
+// Without a control message, the kernel returned application data.
+TEST_F(KernelTlsReadTest, ApplicationData) {
+  expectRecord("hello", absl::nullopt);
+  EXPECT_EQ(5, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::ApplicationData, type_);
+  EXPECT_EQ("hello", buffer_.toString());
+}
+
+TEST_F(KernelTlsReadTest, ApplicationDataControlMessage) {
+  expectRecord("hello", 23);
+  EXPECT_EQ(5, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::ApplicationData, type_);
+  EXPECT_EQ("hello", buffer_.toString());
+}
+
+// Control messages of other levels do not carry a record type.
+TEST_F(KernelTlsReadTest, ForeignControlMessage) {
+  expectRecord("hello", 21, SOL_SOCKET);
+  EXPECT_EQ(5, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::ApplicationData, type_);
+  EXPECT_EQ("hello", buffer_.toString());
+}
+
+TEST_F(KernelTlsReadTest, CloseNotify) {
+  expectRecord(std::string("\x01\x00", 2), 21);
+  EXPECT_EQ(0, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::CloseNotify, type_);
+  EXPECT_EQ(0, buffer_.length());
+}
+
+TEST_F(KernelTlsReadTest, Alert) {
+  // A fatal handshake_failure alert.
+  expectRecord(std::string("\x02\x28", 2), 21);
+  EXPECT_EQ(0, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::Alert, type_);
+  EXPECT_EQ(0, buffer_.length());
+}
+
+// A close_notify alert followed by more data in the same read is not a clean close.
+TEST_F(KernelTlsReadTest, LongAlert) {
+  expectRecord(std::string("\x01\x00\x01\x00", 4), 21);
+  EXPECT_EQ(0, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::Alert, type_);
+  EXPECT_EQ(0, buffer_.length());
+}
+
+// Post-handshake messages, e.g. a HelloRequest, are consumed without being committed.
+TEST_F(KernelTlsReadTest, HandshakeRecord) {
+  expectRecord(std::string("\x00\x00\x00\x00", 4), 22);
+  EXPECT_EQ(0, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::Other, type_);
+  EXPECT_EQ(0, buffer_.length());
+}
+
+TEST_F(KernelTlsReadTest, EndOfStream) {
+  expectRecord("", absl::nullopt);
+  EXPECT_EQ(0, read().rc_);
+  EXPECT_EQ(KernelTls::RecordType::ApplicationData, type_);
+  EXPECT_EQ(0, buffer_.length());
+}
+
+TEST_F(KernelTlsReadTest, Error) {
+  EXPECT_CALL(os_sys_calls_, recvmsg(42, _, 0))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  const Api::SysCallSizeResult result = read();
+  EXPECT_EQ(-1, result.rc_);
+  EXPECT_EQ(SOCKET_ERROR_AGAIN, result.errno_);
+  EXPECT_EQ(KernelTls::RecordType::ApplicationData, type_);
+  EXPECT_EQ(0, buffer_.length());
+}
+#endif
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 
@@ -6,6 +7,7 @@
 #include "envoy/config/listener/v3/listener_components.pb.h"
 #include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/ssl/session_cache.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
@@ -793,6 +795,7 @@ protected:
   void testClientSessionResumption(const std::string& server_ctx_yaml,
                                    const std::string& client_ctx_yaml, bool expect_reuse,
                                    const Network::Address::IpVersion version);
+  void testSharedSessionCacheResumption(bool reject);
 
   Event::DispatcherPtr dispatcher_;
   StreamInfo::StreamInfoImpl stream_info_;
@@ -3155,6 +3158,157 @@ TEST_P(SslSocketTest, StatelessSessionResumptionEnabledByDefault) {
   testSupportForStatelessSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+namespace {
+
+// A process local Ssl::SessionCache, standing in for the shared memory cache.
+class TestSessionCache : public Envoy::Ssl::SessionCache {
+public:
+  InsertResult insert(absl::Span<const uint8_t> id, absl::Span<const uint8_t> session, SystemTime,
+                      SystemTime) override {
+    if (reject_) {
+      return InsertResult::Rejected;
+    }
+    sessions_[toString(id)] = toString(session);
+    return InsertResult::Inserted;
+  }
+  bool lookup(absl::Span<const uint8_t> id, SystemTime, std::vector<uint8_t>& session) override {
+    auto it = sessions_.find(toString(id));
+    if (it == sessions_.end()) {
+      return false;
+    }
+    session.assign(it->second.begin(), it->second.end());
+    return true;
+  }
+  void remove(absl::Span<const uint8_t> id) override { sessions_.erase(toString(id)); }
+
+  std::map<std::string, std::string> sessions_;
+  bool reject_{false};
+
+private:
+  static std::string toString(absl::Span<const uint8_t> data) {
+    return {reinterpret_cast<const char*>(data.data()), data.size()};
+  }
+};
+
+} // namespace
+
+// Test that a session ID issued by one listener is resumed by a second listener with the same
+// certificate through the shared session cache, as happens across hot restarts. If the shared
+// cache rejects the session, it is still resumed by the first listener.
+void SslSocketTest::testSharedSessionCacheResumption(bool reject) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_tmpdir }}/unittestcert.pem"
+      private_key:
+        filename: "{{ test_tmpdir }}/unittestkey.pem"
+  disable_stateless_session_resumption: true
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  TestSessionCache session_cache;
+  session_cache.reject_ = reject;
+  ContextManagerImpl manager(time_system_);
+  manager.setSessionCache(&session_cache);
+  Stats::TestUtil::TestStore server_stats_store;
+  ServerSslSocketFactory server_ssl_socket_factory(
+      std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_), manager,
+      server_stats_store, std::vector<std::string>{});
+  ServerSslSocketFactory server2_ssl_socket_factory(
+      std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_), manager,
+      server_stats_store, std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr, true);
+  auto socket2 = std::make_shared<Network::TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(GetParam()), nullptr, true);
+  Network::MockTcpListenerCallbacks callbacks;
+  Network::ListenerPtr listener =
+      dispatcher_->createListener(socket, callbacks, true, ENVOY_TCP_BACKLOG_SIZE);
+  Network::ListenerPtr listener2 =
+      dispatcher_->createListener(socket2, callbacks, true, ENVOY_TCP_BACKLOG_SIZE);
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+)EOF";
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext client_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), client_tls_context);
+  Stats::TestUtil::TestStore client_stats_store;
+  ClientSslSocketFactory ssl_socket_factory(
+      std::make_unique<ClientContextConfigImpl>(client_tls_context, factory_context_), manager,
+      client_stats_store);
+
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(callbacks, onAccept_(_))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Network::ConnectionSocketPtr& accepted_socket) -> void {
+        Network::TransportSocketFactory& tsf =
+            accepted_socket->localAddress() == socket->localAddress() ? server_ssl_socket_factory
+                                                                      : server2_ssl_socket_factory;
+        server_connection = dispatcher_->createServerConnection(
+            std::move(accepted_socket), tsf.createTransportSocket(nullptr), stream_info_);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+      }));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected)).Times(2);
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose)).Times(2);
+
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  SSL_SESSION* ssl_session = nullptr;
+  Network::ClientConnectionPtr client_connection;
+  auto connect = [&](const Network::Socket& listen_socket) {
+    client_connection = dispatcher_->createClientConnection(
+        listen_socket.localAddress(), Network::Address::InstanceConstSharedPtr(),
+        ssl_socket_factory.createTransportSocket(nullptr), nullptr);
+    client_connection->addConnectionCallbacks(client_connection_callbacks);
+    const SslHandshakerImpl* ssl_socket =
+        dynamic_cast<const SslHandshakerImpl*>(client_connection->ssl().get());
+    if (ssl_session != nullptr) {
+      SSL_set_session(ssl_socket->ssl(), ssl_session);
+      SSL_SESSION_free(ssl_session);
+      ssl_session = nullptr;
+    }
+    client_connection->connect();
+  };
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Network::ConnectionEvent) -> void {
+        const SslHandshakerImpl* ssl_socket =
+            dynamic_cast<const SslHandshakerImpl*>(client_connection->ssl().get());
+        ssl_session = SSL_get1_session(ssl_socket->ssl());
+        server_connection->close(Network::ConnectionCloseType::NoFlush);
+        client_connection->close(Network::ConnectionCloseType::NoFlush);
+        dispatcher_->exit();
+      }));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose)).Times(2);
+
+  connect(*socket);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(reject ? 0UL : 1UL, session_cache.sessions_.size());
+  EXPECT_EQ(0UL, server_stats_store.counter("ssl.session_reused").value());
+
+  connect(reject ? *socket : *socket2);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  SSL_SESSION_free(ssl_session);
+  EXPECT_EQ(reject ? 0UL : 1UL, server_stats_store.counter("ssl.session_cache_hit").value());
+  EXPECT_EQ(reject ? 1UL : 0UL,
+            server_stats_store.counter("ssl.session_cache_insert_failure").value());
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.session_reused").value());
+  EXPECT_EQ(1UL, client_stats_store.counter("ssl.session_reused").value());
+}
+
+TEST_P(SslSocketTest, SharedSessionCacheCrossListenerSessionResumption) {
+  testSharedSessionCacheResumption(false);
+}
+
+TEST_P(SslSocketTest, SharedSessionCacheRejectedSessionResumption) {
+  testSharedSessionCacheResumption(true);
+}
+
 // Test that if two listeners use the same cert and session ticket key, but
 // different client CA, that sessions cannot be resumed.
 TEST_P(SslSocketTest, ClientAuthCrossListenerSessionResumption) {
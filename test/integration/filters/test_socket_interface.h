@@ -57,7 +57,8 @@ public:
 
 private:
   // SocketInterfaceImpl
-  IoHandlePtr makeSocket(int socket_fd, bool socket_v6only) const override;
+  IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
+                         Socket::Type socket_type) const override;
 
   const TestIoSocketHandle::WritevOverrideProc writev_override_proc_;
 };
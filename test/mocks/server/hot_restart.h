@@ -26,6 +26,7 @@ public:
   MOCK_METHOD(std::string, version, ());
   MOCK_METHOD(Thread::BasicLockable&, logLock, ());
   MOCK_METHOD(Thread::BasicLockable&, accessLogLock, ());
+  MOCK_METHOD(Ssl::SessionCache*, sslSessionCache, (uint32_t max_sessions));
   MOCK_METHOD(Stats::Allocator&, statsAllocator, ());
 
 private:
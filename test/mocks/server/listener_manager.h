@@ -20,6 +20,7 @@ public:
   MOCK_METHOD(std::vector<std::reference_wrapper<Network::ListenerConfig>>, listeners,
               (ListenerState state));
   MOCK_METHOD(uint64_t, numConnections, (), (const));
+  MOCK_METHOD(std::vector<WorkerPlacement>, workerPlacements, (), (const));
   MOCK_METHOD(bool, removeListener, (const std::string& listener_name));
   MOCK_METHOD(void, startWorkers, (GuardDog & guard_dog));
   MOCK_METHOD(void, stopListeners, (StopListenersType listeners_type));
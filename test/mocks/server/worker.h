@@ -35,6 +35,7 @@ public:
               (absl::optional<uint64_t> overridden_listener, Network::ListenerConfig& listener,
                AddListenerCompletion completion));
   MOCK_METHOD(uint64_t, numConnections, (), (const));
+  MOCK_METHOD(WorkerPlacement, placement, (), (const));
   MOCK_METHOD(void, removeListener,
               (Network::ListenerConfig & listener, std::function<void()> completion));
   MOCK_METHOD(void, start, (GuardDog & guard_dog));
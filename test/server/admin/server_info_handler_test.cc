@@ -1,4 +1,5 @@
 #include "envoy/admin/v3/memory.pb.h"
+#include "envoy/admin/v3/workers.pb.h"
 
 #include "extensions/transport_sockets/tls/context_config_impl.h"
 
@@ -60,6 +61,29 @@ TEST_P(AdminInstanceTest, Memory) {
                                   Property(&envoy::admin::v3::Memory::total_thread_cache, Ge(0))));
 }
 
+TEST_P(AdminInstanceTest, Workers) {
+  std::vector<WorkerPlacement> placements(2);
+  placements[0].cpus_ = {2};
+  placements[0].numa_node_ = 1;
+  EXPECT_CALL(server_.listener_manager_, workerPlacements()).WillOnce(Return(placements));
+
+  Http::TestResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, getCallback("/workers", header_map, response));
+  envoy::admin::v3::Workers output_proto;
+  TestUtility::loadFromJson(response.toString(), output_proto);
+  envoy::admin::v3::Workers expected_proto;
+  TestUtility::loadFromYaml(R"EOF(
+workers:
+- name: worker_0
+  cpus: [2]
+  numa_node: 1
+- name: worker_1
+)EOF",
+                            expected_proto);
+  EXPECT_THAT(output_proto, ProtoEq(expected_proto));
+}
+
 TEST_P(AdminInstanceTest, GetReadyRequest) {
   NiceMock<Init::MockManager> initManager;
   ON_CALL(server_, initManager()).WillByDefault(ReturnRef(initManager));
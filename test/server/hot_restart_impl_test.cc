@@ -101,6 +101,105 @@ TEST_F(HotRestartImplTest, DomainSocketError) {
   EXPECT_THROW(std::make_unique<HotRestartImpl>(0, 0, "@envoy_domain_socket", 0), EnvoyException);
 }
 
+// Test that the TLS session cache segment is created by the first process, and by a hot restarted
+// process whose parent has none or one with another layout, and is otherwise reused.
+TEST_F(HotRestartImplTest, SessionCacheMemory) {
+  std::vector<uint64_t> segment;
+  auto expect_create = [&]() {
+    EXPECT_CALL(hot_restart_os_sys_calls_, shmUnlink(_));
+    EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR | O_CREAT | O_EXCL, _))
+        .WillOnce(Return(Api::SysCallIntResult{3, 0}));
+    EXPECT_CALL(os_sys_calls_, ftruncate(3, _)).WillOnce(WithArg<1>(Invoke([&](off_t size) {
+      segment.assign((size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+      return Api::SysCallIntResult{0, 0};
+    })));
+    EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, 3, _)).WillOnce(InvokeWithoutArgs([&]() {
+      return Api::SysCallPtrResult{segment.data(), 0};
+    }));
+    EXPECT_CALL(os_sys_calls_, close(3));
+  };
+
+  // The parent's segment is checked to be fully there before anything of it is mapped.
+  auto expect_fstat = [&](off_t size) {
+    EXPECT_CALL(os_sys_calls_, fstat(4, _)).WillOnce(WithArg<1>(Invoke([size](struct stat* buf) {
+      buf->st_size = size;
+      return Api::SysCallIntResult{0, 0};
+    })));
+  };
+
+  expect_create();
+  SessionCacheMemory* memory = attachSessionCacheMemory(0, 0, 1000);
+  ASSERT_EQ(memory, reinterpret_cast<SessionCacheMemory*>(segment.data()));
+  EXPECT_EQ(SessionCacheMemory::size(8), memory->size_);
+  EXPECT_EQ(HOT_RESTART_VERSION, memory->version_);
+
+  // The segment of the parent is reused by a child configured with the same size. The header,
+  // which is mapped on its own to check the layout, is unmapped again.
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmUnlink(_)).Times(0);
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR, _))
+      .WillOnce(Return(Api::SysCallIntResult{4, 0}));
+  expect_fstat(SessionCacheMemory::size(8));
+  EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, 4, _))
+      .Times(2)
+      .WillRepeatedly(InvokeWithoutArgs([&]() {
+        return Api::SysCallPtrResult{segment.data(), 0};
+      }));
+  EXPECT_CALL(os_sys_calls_, munmap(segment.data(), sizeof(SessionCacheMemory)));
+  EXPECT_CALL(os_sys_calls_, close(4));
+  EXPECT_EQ(memory, attachSessionCacheMemory(0, 1, 1000));
+  testing::Mock::VerifyAndClearExpectations(&hot_restart_os_sys_calls_);
+  testing::Mock::VerifyAndClearExpectations(&os_sys_calls_);
+
+  // A child whose parent's segment has the right size but another version replaces it.
+  memory->version_ = HOT_RESTART_VERSION + 1;
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR, _))
+      .WillOnce(Return(Api::SysCallIntResult{4, 0}));
+  expect_fstat(SessionCacheMemory::size(8));
+  EXPECT_CALL(os_sys_calls_, mmap(_, sizeof(SessionCacheMemory), _, _, 4, _))
+      .WillOnce(InvokeWithoutArgs([&]() { return Api::SysCallPtrResult{segment.data(), 0}; }));
+  EXPECT_CALL(os_sys_calls_, munmap(segment.data(), sizeof(SessionCacheMemory)));
+  EXPECT_CALL(os_sys_calls_, close(4));
+  expect_create();
+  memory = attachSessionCacheMemory(0, 2, 1000);
+  ASSERT_NE(memory, nullptr);
+  EXPECT_EQ(HOT_RESTART_VERSION, memory->version_);
+  testing::Mock::VerifyAndClearExpectations(&os_sys_calls_);
+
+  // So does a child configured with another size, without mapping anything of the parent's segment.
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR, _))
+      .WillOnce(Return(Api::SysCallIntResult{4, 0}));
+  expect_fstat(SessionCacheMemory::size(8));
+  EXPECT_CALL(os_sys_calls_, close(4));
+  expect_create();
+  memory = attachSessionCacheMemory(0, 2, 2000);
+  ASSERT_NE(memory, nullptr);
+  EXPECT_EQ(SessionCacheMemory::size(16), memory->size_);
+  testing::Mock::VerifyAndClearExpectations(&os_sys_calls_);
+
+  // And so does a child whose parent's segment was truncated, e.g. as the parent crashed while
+  // creating it, which would fault when accessed.
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR, _))
+      .WillOnce(Return(Api::SysCallIntResult{4, 0}));
+  expect_fstat(0);
+  EXPECT_CALL(os_sys_calls_, close(4));
+  expect_create();
+  memory = attachSessionCacheMemory(0, 3, 2000);
+  ASSERT_NE(memory, nullptr);
+  EXPECT_EQ(SessionCacheMemory::size(16), memory->size_);
+
+  // And so does a child whose parent has no cache.
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOENT}));
+  expect_create();
+  EXPECT_NE(nullptr, attachSessionCacheMemory(0, 4, 2000));
+
+  // Failing to create the segment leaves TLS sessions unshared.
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmUnlink(_));
+  EXPECT_CALL(hot_restart_os_sys_calls_, shmOpen(_, O_RDWR | O_CREAT | O_EXCL, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EACCES}));
+  EXPECT_EQ(nullptr, attachSessionCacheMemory(0, 0, 1000));
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
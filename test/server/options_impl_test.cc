@@ -75,6 +75,11 @@ TEST_F(OptionsImplTest, InvalidSocketMode) {
       MalformedArgvException, "error: invalid socket-mode 'foo'");
 }
 
+TEST_F(OptionsImplTest, InvalidWorkerCpuAffinity) {
+  EXPECT_THROW_WITH_REGEX(createOptionsImpl("envoy --worker-cpu-affinity 3-1"),
+                          MalformedArgvException, "error: invalid CPU list '3-1'");
+}
+
 TEST_F(OptionsImplTest, V1Disallowed) {
   std::unique_ptr<OptionsImpl> options = createOptionsImpl(
       "envoy --mode validate --concurrency 2 -c hello --admin-address-path path --restart-epoch 1 "
@@ -96,7 +101,8 @@ TEST_F(OptionsImplTest, All) {
       "--disable-hot-restart --cpuset-threads --allow-unknown-static-fields "
       "--reject-unknown-dynamic-fields --use-fake-symbol-table 0 --base-id 5 "
       "--use-dynamic-base-id --base-id-path /foo/baz "
-      "--socket-path /foo/envoy_domain_socket --socket-mode 644");
+      "--socket-path /foo/envoy_domain_socket --socket-mode 644 "
+      "--worker-cpu-affinity 2-3,6 --numa-local-workers");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -116,6 +122,8 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
   EXPECT_TRUE(options->hotRestartDisabled());
   EXPECT_TRUE(options->cpusetThreadsEnabled());
+  EXPECT_EQ(std::vector<uint32_t>({2, 3, 6}), options->workerCpuAffinity());
+  EXPECT_TRUE(options->numaLocalWorkersEnabled());
   EXPECT_TRUE(options->allowUnknownStaticFields());
   EXPECT_TRUE(options->rejectUnknownDynamicFields());
   EXPECT_FALSE(options->fakeSymbolTableEnabled());
@@ -180,6 +188,8 @@ TEST_F(OptionsImplTest, SetAll) {
   options->setHotRestartDisabled(!options->hotRestartDisabled());
   options->setSignalHandling(!options->signalHandlingEnabled());
   options->setCpusetThreads(!options->cpusetThreadsEnabled());
+  options->setWorkerCpuAffinity({1, 3});
+  options->setNumaLocalWorkers(true);
   options->setAllowUnkownFields(true);
   options->setRejectUnknownFieldsDynamic(true);
   options->setFakeSymbolTableEnabled(!options->fakeSymbolTableEnabled());
@@ -210,6 +220,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(!hot_restart_disabled, options->hotRestartDisabled());
   EXPECT_EQ(!signal_handling_enabled, options->signalHandlingEnabled());
   EXPECT_EQ(!cpuset_threads_enabled, options->cpusetThreadsEnabled());
+  EXPECT_EQ(std::vector<uint32_t>({1, 3}), options->workerCpuAffinity());
+  EXPECT_TRUE(options->numaLocalWorkersEnabled());
   EXPECT_TRUE(options->allowUnknownStaticFields());
   EXPECT_TRUE(options->rejectUnknownDynamicFields());
   EXPECT_EQ(!fake_symbol_table_enabled, options->fakeSymbolTableEnabled());
@@ -244,6 +256,8 @@ TEST_F(OptionsImplTest, SetAll) {
   EXPECT_EQ(options->hotRestartDisabled(), command_line_options->disable_hot_restart());
   EXPECT_EQ(options->mutexTracingEnabled(), command_line_options->enable_mutex_tracing());
   EXPECT_EQ(options->cpusetThreadsEnabled(), command_line_options->cpuset_threads());
+  EXPECT_THAT(command_line_options->worker_cpu_affinity(), testing::ElementsAre(1, 3));
+  EXPECT_EQ(options->numaLocalWorkersEnabled(), command_line_options->numa_local_workers());
   EXPECT_EQ(options->socketPath(), command_line_options->socket_path());
   EXPECT_EQ(options->socketMode(), command_line_options->socket_mode());
 }
@@ -261,6 +275,8 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(0, options->socketMode());
   EXPECT_FALSE(options->hotRestartDisabled());
   EXPECT_FALSE(options->cpusetThreadsEnabled());
+  EXPECT_TRUE(options->workerCpuAffinity().empty());
+  EXPECT_FALSE(options->numaLocalWorkersEnabled());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();
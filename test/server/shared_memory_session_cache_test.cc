@@ -0,0 +1,135 @@
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "server/shared_memory_session_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class SharedMemorySessionCacheTest : public testing::Test {
+public:
+  static constexpr uint32_t MaxSessions = 1000;
+
+  SharedMemorySessionCacheTest()
+      : sets_per_shard_(SessionCacheMemory::setsPerShard(MaxSessions)),
+        buffer_((SessionCacheMemory::size(sets_per_shard_) + sizeof(uint64_t) - 1) /
+                sizeof(uint64_t)),
+        memory_(reinterpret_cast<SessionCacheMemory*>(buffer_.data())) {
+    SharedMemorySessionCache::initialize(*memory_, sets_per_shard_, 1);
+    cache_ = std::make_unique<SharedMemorySessionCache>(*memory_);
+  }
+
+  static std::vector<uint8_t> makeId(uint32_t n) {
+    std::vector<uint8_t> id(SessionCacheMemory::MaxIdLength);
+    memcpy(id.data(), &n, sizeof(n));
+    return id;
+  }
+
+  const SystemTime now_{std::chrono::seconds(1000)};
+  const SystemTime expiry_{std::chrono::seconds(2000)};
+  const std::vector<uint8_t> session_{1, 2, 3};
+  const uint32_t sets_per_shard_;
+  // Zero filled, like a new shared memory segment.
+  std::vector<uint64_t> buffer_;
+  SessionCacheMemory* const memory_;
+  std::unique_ptr<SharedMemorySessionCache> cache_;
+};
+
+TEST_F(SharedMemorySessionCacheTest, Layout) {
+  // The number of sessions is rounded up to a multiple of the number of entries in a set of every
+  // shard.
+  EXPECT_EQ(8, sets_per_shard_);
+  EXPECT_EQ(SessionCacheMemory::size(sets_per_shard_), memory_->size_);
+  EXPECT_EQ(1, memory_->version_);
+  EXPECT_EQ(1, SessionCacheMemory::setsPerShard(1));
+  EXPECT_EQ(1, SessionCacheMemory::setsPerShard(128));
+  EXPECT_EQ(2, SessionCacheMemory::setsPerShard(129));
+}
+
+TEST_F(SharedMemorySessionCacheTest, InsertLookupRemove) {
+  const std::vector<uint8_t> id = makeId(1);
+  std::vector<uint8_t> session;
+  EXPECT_FALSE(cache_->lookup(id, now_, session));
+
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Inserted, cache_->insert(id, session_, expiry_, now_));
+  EXPECT_TRUE(cache_->lookup(id, now_, session));
+  EXPECT_EQ(session_, session);
+
+  // Inserting under the same id replaces the session without evicting anything.
+  const std::vector<uint8_t> other_session{4, 5};
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Inserted,
+            cache_->insert(id, other_session, expiry_, now_));
+  EXPECT_TRUE(cache_->lookup(id, now_, session));
+  EXPECT_EQ(other_session, session);
+
+  cache_->remove(id);
+  EXPECT_FALSE(cache_->lookup(id, now_, session));
+}
+
+TEST_F(SharedMemorySessionCacheTest, Expiry) {
+  const std::vector<uint8_t> id = makeId(1);
+  std::vector<uint8_t> session;
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Inserted, cache_->insert(id, session_, expiry_, now_));
+  EXPECT_FALSE(cache_->lookup(id, expiry_, session));
+  EXPECT_FALSE(cache_->lookup(id, now_, session));
+
+  // Sessions which have already expired are not stored.
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Rejected, cache_->insert(id, session_, now_, now_));
+  EXPECT_FALSE(cache_->lookup(id, now_, session));
+}
+
+TEST_F(SharedMemorySessionCacheTest, Limits) {
+  std::vector<uint8_t> session;
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Rejected, cache_->insert({}, session_, expiry_, now_));
+  const std::vector<uint8_t> long_id(SessionCacheMemory::MaxIdLength + 1);
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Rejected,
+            cache_->insert(long_id, session_, expiry_, now_));
+  EXPECT_FALSE(cache_->lookup(long_id, now_, session));
+
+  const std::vector<uint8_t> id = makeId(1);
+  const std::vector<uint8_t> large_session(SessionCacheMemory::MaxSessionLength + 1);
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Rejected,
+            cache_->insert(id, large_session, expiry_, now_));
+  EXPECT_FALSE(cache_->lookup(id, now_, session));
+}
+
+// Once the cache is full, each new session evicts the least recently used session of its set.
+TEST_F(SharedMemorySessionCacheTest, Eviction) {
+  const uint32_t capacity =
+      SessionCacheMemory::Shards * sets_per_shard_ * SessionCacheMemory::Ways;
+  EXPECT_LE(MaxSessions, capacity);
+  const uint32_t sessions = 4 * capacity;
+  uint32_t evictions = 0;
+  for (uint32_t i = 0; i < sessions; i++) {
+    const Ssl::SessionCache::InsertResult result =
+        cache_->insert(makeId(i), session_, expiry_, now_);
+    EXPECT_NE(Ssl::SessionCache::InsertResult::Rejected, result);
+    if (result == Ssl::SessionCache::InsertResult::Evicted) {
+      evictions++;
+    }
+  }
+  EXPECT_LE(sessions - capacity, evictions);
+
+  // The most recent session is always kept.
+  std::vector<uint8_t> session;
+  EXPECT_TRUE(cache_->lookup(makeId(sessions - 1), now_, session));
+}
+
+// A second cache attached to the same memory, e.g. in a hot restarted process, sees the sessions.
+TEST_F(SharedMemorySessionCacheTest, SharedAcrossAttachments) {
+  const std::vector<uint8_t> id = makeId(1);
+  EXPECT_EQ(Ssl::SessionCache::InsertResult::Inserted, cache_->insert(id, session_, expiry_, now_));
+
+  SharedMemorySessionCache other(*memory_);
+  std::vector<uint8_t> session;
+  EXPECT_TRUE(other.lookup(id, now_, session));
+  EXPECT_EQ(session_, session);
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,154 @@
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#endif
+
+#include "server/worker_placement.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ElementsAre;
+using testing::Return;
+using testing::Throw;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+NumaTopology twoNodeTopology() {
+  return NumaTopology({{0, {0, 1, 2, 3}}, {1, {4, 5, 6, 7}}});
+}
+
+TEST(WorkerPlacementUtilityTest, ParseCpuList) {
+  EXPECT_THAT(WorkerPlacementUtility::parseCpuList("").value(), ElementsAre());
+  EXPECT_THAT(WorkerPlacementUtility::parseCpuList("3").value(), ElementsAre(3));
+  EXPECT_THAT(WorkerPlacementUtility::parseCpuList("0-3,8,10-11").value(),
+              ElementsAre(0, 1, 2, 3, 8, 10, 11));
+  EXPECT_THAT(WorkerPlacementUtility::parseCpuList("5,1").value(), ElementsAre(5, 1));
+
+  EXPECT_FALSE(WorkerPlacementUtility::parseCpuList("a").has_value());
+  EXPECT_FALSE(WorkerPlacementUtility::parseCpuList("1-").has_value());
+  EXPECT_FALSE(WorkerPlacementUtility::parseCpuList("3-1").has_value());
+  EXPECT_FALSE(WorkerPlacementUtility::parseCpuList("-1").has_value());
+  EXPECT_FALSE(WorkerPlacementUtility::parseCpuList("0-4000000000").has_value());
+}
+
+TEST(WorkerPlacementUtilityTest, NoPlacement) {
+  const WorkerPlacement placement =
+      WorkerPlacementUtility::placementFor(0, {}, false, twoNodeTopology());
+  EXPECT_TRUE(placement.cpus_.empty());
+  EXPECT_FALSE(placement.numa_node_.has_value());
+}
+
+TEST(WorkerPlacementUtilityTest, CpuAffinity) {
+  const std::vector<uint32_t> cpus{2, 5};
+  EXPECT_THAT(WorkerPlacementUtility::placementFor(0, cpus, false, {}).cpus_, ElementsAre(2));
+  EXPECT_THAT(WorkerPlacementUtility::placementFor(1, cpus, false, {}).cpus_, ElementsAre(5));
+  // Wraps around when there are more workers than CPUs.
+  EXPECT_THAT(WorkerPlacementUtility::placementFor(2, cpus, false, {}).cpus_, ElementsAre(2));
+  EXPECT_FALSE(WorkerPlacementUtility::placementFor(1, cpus, false, twoNodeTopology())
+                   .numa_node_.has_value());
+}
+
+TEST(WorkerPlacementUtilityTest, CpuAffinityNumaLocal) {
+  const std::vector<uint32_t> cpus{2, 5, 9};
+  const NumaTopology topology = twoNodeTopology();
+  EXPECT_EQ(0, WorkerPlacementUtility::placementFor(0, cpus, true, topology).numa_node_.value());
+  EXPECT_EQ(1, WorkerPlacementUtility::placementFor(1, cpus, true, topology).numa_node_.value());
+  // CPU 9 isn't part of any node.
+  const WorkerPlacement placement = WorkerPlacementUtility::placementFor(2, cpus, true, topology);
+  EXPECT_THAT(placement.cpus_, ElementsAre(9));
+  EXPECT_FALSE(placement.numa_node_.has_value());
+}
+
+TEST(WorkerPlacementUtilityTest, NumaLocalWithoutCpuAffinity) {
+  const NumaTopology topology = twoNodeTopology();
+  WorkerPlacement placement = WorkerPlacementUtility::placementFor(0, {}, true, topology);
+  EXPECT_THAT(placement.cpus_, ElementsAre(0, 1, 2, 3));
+  EXPECT_EQ(0, placement.numa_node_.value());
+  placement = WorkerPlacementUtility::placementFor(3, {}, true, topology);
+  EXPECT_THAT(placement.cpus_, ElementsAre(4, 5, 6, 7));
+  EXPECT_EQ(1, placement.numa_node_.value());
+
+  // Without a topology workers are not placed.
+  placement = WorkerPlacementUtility::placementFor(0, {}, true, {});
+  EXPECT_TRUE(placement.cpus_.empty());
+  EXPECT_FALSE(placement.numa_node_.has_value());
+}
+
+TEST(NumaTopologyTest, Load) {
+  Filesystem::MockInstance file_system;
+  EXPECT_CALL(file_system, fileReadToEnd("/sys/devices/system/node/online"))
+      .WillOnce(Return("0-1\n"));
+  EXPECT_CALL(file_system, fileReadToEnd("/sys/devices/system/node/node0/cpulist"))
+      .WillOnce(Return("0-1,4\n"));
+  EXPECT_CALL(file_system, fileReadToEnd("/sys/devices/system/node/node1/cpulist"))
+      .WillOnce(Return("2-3\n"));
+  const NumaTopology topology = NumaTopology::load(file_system);
+  ASSERT_EQ(2, topology.nodes().size());
+  EXPECT_THAT(topology.nodes()[0].cpus_, ElementsAre(0, 1, 4));
+  EXPECT_EQ(1, topology.nodes()[1].id_);
+  EXPECT_EQ(0, topology.nodeOfCpu(4).value());
+  EXPECT_EQ(1, topology.nodeOfCpu(3).value());
+  EXPECT_FALSE(topology.nodeOfCpu(5).has_value());
+}
+
+TEST(NumaTopologyTest, LoadUnavailable) {
+  Filesystem::MockInstance file_system;
+  EXPECT_CALL(file_system, fileReadToEnd(_)).WillOnce(Throw(EnvoyException("no such file")));
+  EXPECT_TRUE(NumaTopology::load(file_system).nodes().empty());
+}
+
+#ifdef __linux__
+class WorkerPlacementApplyTest : public testing::Test {
+protected:
+  Api::MockLinuxOsSysCalls linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+};
+
+TEST_F(WorkerPlacementApplyTest, Apply) {
+  EXPECT_CALL(linux_os_sys_calls_, sched_setaffinity(0, sizeof(cpu_set_t), _))
+      .WillOnce([](pid_t, size_t, const cpu_set_t* mask) -> Api::SysCallIntResult {
+        EXPECT_EQ(1, CPU_COUNT(mask));
+        EXPECT_TRUE(CPU_ISSET(5, mask));
+        return {0, 0};
+      });
+  EXPECT_CALL(linux_os_sys_calls_, set_mempolicy(MPOL_PREFERRED, _, _))
+      .WillOnce([](int, const unsigned long* node_mask, unsigned long) -> Api::SysCallIntResult {
+        EXPECT_EQ(1UL << 1, node_mask[0]);
+        return {0, 0};
+      });
+  WorkerPlacement placement;
+  placement.cpus_ = {5};
+  placement.numa_node_ = 1;
+  EXPECT_TRUE(WorkerPlacementUtility::applyToCurrentThread(placement));
+}
+
+TEST_F(WorkerPlacementApplyTest, AffinityFailure) {
+  EXPECT_CALL(linux_os_sys_calls_, sched_setaffinity(_, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  EXPECT_CALL(linux_os_sys_calls_, set_mempolicy(_, _, _)).Times(0);
+  WorkerPlacement placement;
+  placement.cpus_ = {5};
+  placement.numa_node_ = 1;
+  EXPECT_FALSE(WorkerPlacementUtility::applyToCurrentThread(placement));
+}
+
+TEST_F(WorkerPlacementApplyTest, MemoryPolicyFailure) {
+  EXPECT_CALL(linux_os_sys_calls_, sched_setaffinity(_, _, _)).Times(0);
+  EXPECT_CALL(linux_os_sys_calls_, set_mempolicy(_, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOSYS}));
+  WorkerPlacement placement;
+  placement.numa_node_ = 0;
+  EXPECT_FALSE(WorkerPlacementUtility::applyToCurrentThread(placement));
+}
+#endif
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
@@ -77,7 +77,7 @@ public:
     // Passes ownership of root_context_.
     Extensions::Common::Wasm::createWasm(
         vm_config, plugin_, scope_, cluster_manager_, init_manager_, dispatcher_, random_, *api,
-        lifecycle_notifier_, remote_data_provider_,
+        lifecycle_notifier_, remote_data_provider_, create_wasm_handle_,
         [this](WasmHandleSharedPtr wasm) { wasm_ = wasm; }, create_root);
     if (wasm_) {
       wasm_ = getOrCreateThreadLocalWasm(
@@ -111,6 +111,7 @@ public:
   envoy::config::core::v3::Metadata listener_metadata_;
   Context* root_context_ = nullptr; // Unowned.
   Config::DataSource::RemoteAsyncDataProviderPtr remote_data_provider_;
+  Extensions::Common::Wasm::CreateWasmHandlePtr create_wasm_handle_;
 };
 
 template <typename Base = testing::Test> class WasmHttpFilterTestBase : public WasmTestBase<Base> {